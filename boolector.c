@@ -18,11 +18,13 @@
  */
 
 #include "boolector.h"
+#include "btorapitrace.h"
 #include "btorexp.h"
 #include "btorexit.h"
 #include "btorutil.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <limits.h>
 
 /*------------------------------------------------------------------------*/
@@ -52,7 +54,7 @@
 
 #define BTOR_ABORT_REFS_NOT_POS_BOOLECTOR(arg) \
   do { \
-    if (BTOR_REAL_ADDR_EXP((arg))->refs < 1) \
+    if (BTOR_REFS_EXP (BTOR_REAL_ADDR_EXP((arg))) < 1) \
       { \
         printf ("[boolector] %s: ", __func__); \
         printf ("reference counter of '%s' must not be < 1\n", #arg); \
@@ -83,6 +85,49 @@
       } \
   } while (0)
 
+/* If thread safe usage has been enabled, creating, copying, releasing
+ * and querying expressions only takes the read lock of 'btor', so these
+ * calls run concurrently and only synchronize on the lock of the
+ * expression layer (see 'BTOR_LOCK_EXP').  All other calls, e.g. setting
+ * options, asserting, 'boolector_sat' and querying assignments, take the
+ * write lock and thus exclude any other call.  While an API trace is
+ * written every call takes the write lock to keep the trace in order.
+ */
+#ifdef BTOR_THREADS
+#define BTOR_LOCK_BOOLECTOR(btor) \
+  do { \
+    if ((btor)->rwlock != NULL) \
+      pthread_rwlock_wrlock ((btor)->rwlock); \
+  } while (0)
+
+#define BTOR_LOCK_SHARED_BOOLECTOR(btor) \
+  do { \
+    if ((btor)->rwlock == NULL) \
+      break; \
+    if ((btor)->apitrace != NULL) \
+      pthread_rwlock_wrlock ((btor)->rwlock); \
+    else \
+      pthread_rwlock_rdlock ((btor)->rwlock); \
+  } while (0)
+
+#define BTOR_UNLOCK_BOOLECTOR(btor) \
+  do { \
+    if ((btor)->rwlock != NULL) \
+      pthread_rwlock_unlock ((btor)->rwlock); \
+  } while (0)
+
+#define BTOR_INC_EXT_REFS_BOOLECTOR(btor) \
+  ((void) __atomic_add_fetch (&(btor)->external_refs, 1, __ATOMIC_RELAXED))
+#define BTOR_DEC_EXT_REFS_BOOLECTOR(btor) \
+  ((void) __atomic_sub_fetch (&(btor)->external_refs, 1, __ATOMIC_RELAXED))
+#else
+#define BTOR_LOCK_BOOLECTOR(btor) do { } while (0)
+#define BTOR_LOCK_SHARED_BOOLECTOR(btor) do { } while (0)
+#define BTOR_UNLOCK_BOOLECTOR(btor) do { } while (0)
+#define BTOR_INC_EXT_REFS_BOOLECTOR(btor) ((void) (btor)->external_refs++)
+#define BTOR_DEC_EXT_REFS_BOOLECTOR(btor) ((void) (btor)->external_refs--)
+#endif
+
 #define BTOR_ABORT_NE_BW(arg1,arg2) \
   do { \
     if (BTOR_REAL_ADDR_EXP ((arg1))->len != BTOR_REAL_ADDR_EXP ((arg2))->len) \
@@ -106,257 +151,495 @@
 Btor *
 boolector_new (void)
 {
-  return btor_new_btor ();
+  const char *name;
+  FILE *file;
+  Btor *btor;
+  btor = btor_new_btor ();
+  name = getenv ("BTORAPITRACE");
+  if (name != NULL)
+    {
+      file = fopen (name, "wb");
+      BTOR_ABORT_BOOLECTOR (file == NULL, "can not open API trace file");
+      btor->apitrace = btor_new_api_trace (btor->mm, file, 1);
+    }
+  return btor;
+}
+
+void
+boolector_set_api_trace (Btor * btor, FILE * file)
+{
+  BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
+  BTOR_ABORT_ARG_NULL_BOOLECTOR (file);
+  BTOR_ABORT_BOOLECTOR (btor->apitrace != NULL,
+                        "API trace has already been set");
+  BTOR_ABORT_BOOLECTOR (btor->id != 1 || btor->model_gen || btor->inc_enabled,
+                        "setting API trace must be done directly after 'boolector_new'");
+  btor->apitrace = btor_new_api_trace (btor->mm, file, 0);
+  BTOR_UNLOCK_BOOLECTOR (btor);
+}
+
+void
+boolector_set_trace_file (FILE * file)
+{
+  BTOR_ABORT_ARG_NULL_BOOLECTOR (file);
+  btor_set_trace_file (file);
+}
+
+void
+boolector_set_trace_callback (BtorTraceCallback fun, void *state)
+{
+  btor_set_trace_callback (fun, state);
 }
 
 void
 boolector_set_rewrite_level (Btor * btor, int rewrite_level)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (rewrite_level < 0
                         || rewrite_level > 3,
                         "'rewrite_level' has to be in [0,3]");
   BTOR_ABORT_BOOLECTOR (btor->id != 1,
                         "setting rewrite level must be done before creating expressions");
+  btor_trace_api (btor->apitrace, BTOR_API_SET_REWRITE_LEVEL, rewrite_level);
   btor_set_rewrite_level_btor (btor, rewrite_level);
+  BTOR_UNLOCK_BOOLECTOR (btor);
+}
+
+void
+boolector_set_read_over_write_limit (Btor * btor, int limit)
+{
+  BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
+  BTOR_ABORT_BOOLECTOR (limit < 1, "'limit' has to be greater than zero");
+  btor_trace_api (btor->apitrace, BTOR_API_SET_READ_OVER_WRITE_LIMIT, limit);
+  btor_set_read_over_write_limit (btor, limit);
+  BTOR_UNLOCK_BOOLECTOR (btor);
+}
+
+void
+boolector_set_write_chain_bound (Btor * btor, int bound)
+{
+  BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
+  BTOR_ABORT_BOOLECTOR (bound < 0, "'bound' must not be negative");
+  btor_trace_api (btor->apitrace, BTOR_API_SET_WRITE_CHAIN_BOUND, bound);
+  btor_set_write_chain_bound (btor, bound);
+  BTOR_UNLOCK_BOOLECTOR (btor);
+}
+
+void
+boolector_set_memory_limit (Btor * btor, int limit)
+{
+  BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
+  BTOR_ABORT_BOOLECTOR (limit < 0, "'limit' must not be negative");
+  btor_trace_api (btor->apitrace, BTOR_API_SET_MEMORY_LIMIT, limit);
+  btor_set_limit_mem_mgr (btor->mm, ((size_t) limit) << 20);
+  BTOR_UNLOCK_BOOLECTOR (btor);
 }
 
 void
 boolector_enable_model_gen (Btor * btor)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (btor->id != 1, "enabling model generation must be done before creating expressions");
+  btor_trace_api (btor->apitrace, BTOR_API_ENABLE_MODEL_GEN);
   btor_enable_model_gen (btor);
+  BTOR_UNLOCK_BOOLECTOR (btor);
 }
 
 void
 boolector_enable_inc_usage (Btor * btor)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (btor->btor_sat_btor_called > 0, "enabling incremental usage must be done before calling 'boolector_sat'");
+  btor_trace_api (btor->apitrace, BTOR_API_ENABLE_INC_USAGE);
   btor_enable_inc_usage (btor);
+  BTOR_UNLOCK_BOOLECTOR (btor);
+}
+
+void
+boolector_enable_thread_safety (Btor * btor)
+{
+#ifdef BTOR_THREADS
+  pthread_mutexattr_t attr;
+  BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_ABORT_BOOLECTOR (btor->mutex != NULL,
+                        "thread safe usage has already been enabled");
+  BTOR_ABORT_BOOLECTOR (btor->id != 1,
+                        "enabling thread safe usage must be done "
+                        "before creating expressions");
+  btor_trace_api (btor->apitrace, BTOR_API_ENABLE_THREAD_SAFETY);
+  BTOR_NEW (btor->mm, btor->mutex);
+  pthread_mutexattr_init (&attr);
+  pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init (btor->mutex, &attr);
+  pthread_mutexattr_destroy (&attr);
+  BTOR_NEW (btor->mm, btor->rwlock);
+  pthread_rwlock_init (btor->rwlock, NULL);
+#else
+  BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_ABORT_BOOLECTOR (1, "compiled without thread support "
+                        "(configure -threads)");
+#endif
 }
 
 int
 boolector_get_refs (Btor * btor)
 {
+  int res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
-  return btor->external_refs;
+  BTOR_LOCK_BOOLECTOR (btor);
+  btor_trace_api (btor->apitrace, BTOR_API_GET_REFS);
+  res = btor_trace_api_int_result (btor->apitrace, btor->external_refs);
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 void
 boolector_delete (Btor * btor)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
+  btor_trace_api (btor->apitrace, BTOR_API_DELETE);
+  if (btor->apitrace != NULL)
+    btor_delete_api_trace (btor->apitrace);
+  BTOR_UNLOCK_BOOLECTOR (btor);
+#ifdef BTOR_THREADS
+  if (btor->mutex != NULL)
+    {
+      pthread_rwlock_destroy (btor->rwlock);
+      BTOR_DELETE (btor->mm, btor->rwlock);
+      pthread_mutex_destroy (btor->mutex);
+      BTOR_DELETE (btor->mm, btor->mutex);
+      /* the instance is deleted by a single thread */
+      btor->rwlock = NULL;
+      btor->mutex = NULL;
+    }
+#endif
   btor_delete_btor (btor);
 }
 
 BtorExp *
 boolector_const (Btor * btor, const char *bits)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (bits);
   BTOR_ABORT_BOOLECTOR (*bits == '\0', "'bits' must not be empty");
-  btor->external_refs++;
-  return btor_const_exp (btor, bits);
+  btor_trace_api (btor->apitrace, BTOR_API_CONST, bits);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_const_exp (btor, bits));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_zero (Btor * btor, int width)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (width < 1, "'width' must not be < 1");
-  btor->external_refs++;
-  return btor_zero_exp (btor, width);
+  btor_trace_api (btor->apitrace, BTOR_API_ZERO, width);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_zero_exp (btor, width));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_false (Btor * btor)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
-  btor->external_refs++;
-  return btor_false_exp (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
+  btor_trace_api (btor->apitrace, BTOR_API_FALSE);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_false_exp (btor));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_ones (Btor * btor, int width)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (width < 1, "'width' must not be < 1");
-  btor->external_refs++;
-  return btor_ones_exp (btor, width);
+  btor_trace_api (btor->apitrace, BTOR_API_ONES, width);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_ones_exp (btor, width));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_true (Btor * btor)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
-  btor->external_refs++;
-  return btor_true_exp (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
+  btor_trace_api (btor->apitrace, BTOR_API_TRUE);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_true_exp (btor));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_one (Btor * btor, int width)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (width < 1, "'width' must not be < 1");
-  btor->external_refs++;
-  return btor_one_exp (btor, width);
+  btor_trace_api (btor->apitrace, BTOR_API_ONE, width);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_one_exp (btor, width));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_unsigned_int (Btor * btor, unsigned int u, int width)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (width < 1, "'width' must not be < 1");
-  btor->external_refs++;
-  return btor_unsigned_to_exp (btor, u, width);
+  btor_trace_api (btor->apitrace, BTOR_API_UNSIGNED_INT, u, width);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_unsigned_to_exp (btor, u, width));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_int (Btor * btor, int i, int width)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (width < 1, "'width' must not be < 1");
-  btor->external_refs++;
-  return btor_int_to_exp (btor, i, width);
+  btor_trace_api (btor->apitrace, BTOR_API_INT, i, width);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_int_to_exp (btor, i, width));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_var (Btor * btor, int width, const char *symbol)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (width < 1, "'width' must not be < 1");
-  btor->external_refs++;
+  btor_trace_api (btor->apitrace, BTOR_API_VAR, width, symbol);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
   if (symbol == NULL)
-    return btor_var_exp (btor, width, "DVN");
+    res = btor_trace_api_exp_result (btor->apitrace,
+                                     btor_var_exp (btor, width, "DVN"));
   else
-    return btor_var_exp (btor, width, symbol);
+    res = btor_trace_api_exp_result (btor->apitrace,
+                                     btor_var_exp (btor, width, symbol));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_array (Btor * btor, int elem_width, int index_width, const char *symbol)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (elem_width < 1, "'elem_width' must not be < 1");
   BTOR_ABORT_BOOLECTOR (index_width < 1, "'index_width' must not be < 1");
-  btor->external_refs++;
+  btor_trace_api (btor->apitrace, BTOR_API_ARRAY,
+                  elem_width, index_width, symbol);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
   if (symbol == NULL)
-    return btor_array_exp (btor, elem_width, index_width, "DAN");
+    res = btor_trace_api_exp_result (btor->apitrace,
+                                     btor_array_exp (btor, elem_width,
+                                                     index_width, "DAN"));
   else
-    return btor_array_exp (btor, elem_width, index_width, symbol);
+    res = btor_trace_api_exp_result (btor->apitrace,
+                                     btor_array_exp (btor, elem_width,
+                                                     index_width, symbol));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_not (Btor * btor, BtorExp * exp)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_NOT, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
-  btor->external_refs++;
-  return btor_not_exp (btor, exp);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_not_exp (btor, exp));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_neg (Btor * btor, BtorExp * exp)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_NEG, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
-  btor->external_refs++;
-  return btor_neg_exp (btor, exp);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_neg_exp (btor, exp));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_redor (Btor * btor, BtorExp * exp)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_REDOR, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
-  btor->external_refs++;
-  return btor_redor_exp (btor, exp);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_redor_exp (btor, exp));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_redxor (Btor * btor, BtorExp * exp)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_REDXOR, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
-  btor->external_refs++;
-  return btor_redxor_exp (btor, exp);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_redxor_exp (btor, exp));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_redand (Btor * btor, BtorExp * exp)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_REDAND, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
-  btor->external_refs++;
-  return btor_redand_exp (btor, exp);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_redand_exp (btor, exp));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_slice (Btor * btor, BtorExp * exp, int upper, int lower)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_SLICE, exp, upper, lower);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
   BTOR_ABORT_BOOLECTOR (lower < 0, "'lower' must not be negative");
   BTOR_ABORT_BOOLECTOR (upper < lower, "'upper' must not be < 'lower'");
   BTOR_ABORT_BOOLECTOR (upper >= BTOR_REAL_ADDR_EXP (exp)->len,
                         "'upper' must not be >= width of 'exp'");
-  btor->external_refs++;
-  return btor_slice_exp (btor, exp, upper, lower);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_slice_exp (btor, exp, upper, lower));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_uext (Btor * btor, BtorExp * exp, int width)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_UEXT, exp, width);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
   BTOR_ABORT_BOOLECTOR (width < 0, "'width' must not be negative");
-  btor->external_refs++;
-  return btor_uext_exp (btor, exp, width);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_uext_exp (btor, exp, width));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_sext (Btor * btor, BtorExp * exp, int width)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_SEXT, exp, width);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
   BTOR_ABORT_BOOLECTOR (width < 0, "'width' must not be negative");
-  btor->external_refs++;
-  return btor_sext_exp (btor, exp, width);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_sext_exp (btor, exp, width));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_implies (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_IMPLIES, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
@@ -364,18 +647,24 @@ boolector_implies (Btor * btor, BtorExp * e0, BtorExp * e1)
   BTOR_ABORT_BOOLECTOR (BTOR_REAL_ADDR_EXP (e0)->len != 1 ||
                         BTOR_REAL_ADDR_EXP (e1)->len != 1,
                         "bit-width of 'e0' and 'e1' must not be unequal to 1");
-  btor->external_refs++;
-  return btor_implies_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_implies_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_iff (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_IFF, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
@@ -383,110 +672,148 @@ boolector_iff (Btor * btor, BtorExp * e0, BtorExp * e1)
   BTOR_ABORT_BOOLECTOR (BTOR_REAL_ADDR_EXP (e0)->len != 1 ||
                         BTOR_REAL_ADDR_EXP (e1)->len != 1,
                         "bit-width of 'e0' and 'e1' must not be unequal to 1");
-  btor->external_refs++;
-  return btor_iff_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_iff_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_xor (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_XOR, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_xor_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_xor_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_xnor (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_XNOR, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_xnor_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_xnor_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_and (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_AND, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_and_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_and_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_nand (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_NAND, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_nand_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_nand_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_or (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_OR, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_or_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_or_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_nor (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_NOR, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_nor_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_nor_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
@@ -494,12 +821,15 @@ boolector_eq (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *real_e0, *real_e1;
   int is_array_e0, is_array_e1;
+  BtorExp *res;
 
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_EQ, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   real_e0 = BTOR_REAL_ADDR_EXP (e0);
@@ -517,8 +847,10 @@ boolector_eq (Btor * btor, BtorExp * e0, BtorExp * e1)
   BTOR_ABORT_BOOLECTOR (is_array_e0
                         && real_e0->index_len != real_e1->index_len,
                         "arrays must not have unequal index bit-width");
-  btor->external_refs++;
-  return btor_eq_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_eq_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
@@ -526,11 +858,14 @@ boolector_ne (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *real_e0, *real_e1;
   int is_array_e0, is_array_e1;
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_NE, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   real_e0 = BTOR_REAL_ADDR_EXP (e0);
@@ -545,258 +880,347 @@ boolector_ne (Btor * btor, BtorExp * e0, BtorExp * e1)
   BTOR_ABORT_BOOLECTOR (is_array_e0
                         && real_e0->index_len != real_e1->index_len,
                         "arrays must not have unequal index bit-width");
-  btor->external_refs++;
-  return btor_ne_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_ne_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_add (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_ADD, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_add_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_add_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_uaddo (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_UADDO, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_uaddo_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_uaddo_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_saddo (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SADDO, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_saddo_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_saddo_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_mul (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_MUL, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_mul_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_mul_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_umulo (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_UMULO, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_umulo_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_umulo_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_smulo (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SMULO, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_smulo_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_smulo_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_ult (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_ULT, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_ult_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_ult_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_slt (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SLT, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_slt_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_slt_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_ulte (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_ULTE, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_ulte_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_ulte_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_slte (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SLTE, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_slte_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_slte_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_ugt (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_UGT, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_ugt_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_ugt_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_sgt (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SGT, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_sgt_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_sgt_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_ugte (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_UGTE, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_ugte_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_ugte_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_sgte (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SGTE, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_sgte_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_sgte_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_sll (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   int len;
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SLL, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
@@ -806,19 +1230,25 @@ boolector_sll (Btor * btor, BtorExp * e0, BtorExp * e1)
                         "bit-width of 'e0' must be a power of 2");
   BTOR_ABORT_BOOLECTOR (btor_log_2_util (len) != BTOR_REAL_ADDR_EXP (e1)->len,
                         "bit-width of 'e1' must be equal to log2(bit-width of 'e0')");
-  btor->external_refs++;
-  return btor_sll_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_sll_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_srl (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   int len;
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SRL, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
@@ -828,19 +1258,25 @@ boolector_srl (Btor * btor, BtorExp * e0, BtorExp * e1)
                         "bit-width of 'e0' must be a power of 2");
   BTOR_ABORT_BOOLECTOR (btor_log_2_util (len) != BTOR_REAL_ADDR_EXP (e1)->len,
                         "bit-width of 'e1' must be equal to log2(bit-width of 'e0')");
-  btor->external_refs++;
-  return btor_srl_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_srl_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_sra (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   int len;
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SRA, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
@@ -850,19 +1286,25 @@ boolector_sra (Btor * btor, BtorExp * e0, BtorExp * e1)
                         "bit-width of 'e0' must be a power of 2");
   BTOR_ABORT_BOOLECTOR (btor_log_2_util (len) != BTOR_REAL_ADDR_EXP (e1)->len,
                         "bit-width of 'e1' must be equal to log2(bit-width of 'e0')");
-  btor->external_refs++;
-  return btor_sra_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_sra_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_rol (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   int len;
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_ROL, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
@@ -872,19 +1314,25 @@ boolector_rol (Btor * btor, BtorExp * e0, BtorExp * e1)
                         "bit-width of 'e0' must be a power of 2");
   BTOR_ABORT_BOOLECTOR (btor_log_2_util (len) != BTOR_REAL_ADDR_EXP (e1)->len,
                         "bit-width of 'e1' must be equal to log2(bit-width of 'e0')");
-  btor->external_refs++;
-  return btor_rol_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_rol_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_ror (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   int len;
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_ROR, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
@@ -894,171 +1342,231 @@ boolector_ror (Btor * btor, BtorExp * e0, BtorExp * e1)
                         "bit-width of 'e0' must be a power of 2");
   BTOR_ABORT_BOOLECTOR (btor_log_2_util (len) != BTOR_REAL_ADDR_EXP (e1)->len,
                         "bit-width of 'e1' must be equal to log2(bit-width of 'e0')");
-  btor->external_refs++;
-  return btor_ror_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_ror_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_sub (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SUB, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_sub_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_sub_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_usubo (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_USUBO, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_usubo_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_usubo_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_ssubo (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SSUBO, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_ssubo_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_ssubo_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_udiv (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_UDIV, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_udiv_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_udiv_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_sdiv (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SDIV, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_sdiv_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_sdiv_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_sdivo (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SDIVO, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_sdivo_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_sdivo_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_urem (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_UREM, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_urem_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_urem_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_srem (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SREM, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_srem_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_srem_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_smod (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_SMOD, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
   BTOR_ABORT_ARRAY_BOOLECTOR (e1);
   BTOR_ABORT_NE_BW (e0, e1);
-  btor->external_refs++;
-  return btor_smod_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_smod_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_concat (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e0);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e1);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e0);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e1);
+  btor_trace_api (btor->apitrace, BTOR_API_CONCAT, e0, e1);
   e0 = btor_pointer_chase_simplified_exp (btor, e0);
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   BTOR_ABORT_ARRAY_BOOLECTOR (e0);
@@ -1066,39 +1574,51 @@ boolector_concat (Btor * btor, BtorExp * e0, BtorExp * e1)
   BTOR_ABORT_BOOLECTOR (BTOR_REAL_ADDR_EXP (e0)->len >
                         INT_MAX - BTOR_REAL_ADDR_EXP (e1)->len,
                         "bit-width of result is too large");
-  btor->external_refs++;
-  return btor_concat_exp (btor, e0, e1);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_concat_exp (btor, e0, e1));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_read (Btor * btor, BtorExp * e_array, BtorExp * e_index)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e_array);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e_index);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e_array);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e_index);
+  btor_trace_api (btor->apitrace, BTOR_API_READ, e_array, e_index);
   e_array = btor_pointer_chase_simplified_exp (btor, e_array);
   e_index = btor_pointer_chase_simplified_exp (btor, e_index);
   BTOR_ABORT_BV_BOLECTOR (e_array);
   BTOR_ABORT_ARRAY_BOOLECTOR (e_index);
   BTOR_ABORT_BOOLECTOR (e_array->index_len != BTOR_REAL_ADDR_EXP (e_index)->len,
                         "index bit-width of 'e_array' and bit-width of 'e_index' must not be unequal");
-  btor->external_refs++;
-  return btor_read_exp (btor, e_array, e_index);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_read_exp (btor, e_array, e_index));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_write (Btor * btor, BtorExp * e_array, BtorExp * e_index,
                  BtorExp * e_value)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e_array);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e_index);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e_value);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e_array);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e_index);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e_value);
+  btor_trace_api (btor->apitrace, BTOR_API_WRITE, e_array, e_index, e_value);
   e_array = btor_pointer_chase_simplified_exp (btor, e_array);
   e_index = btor_pointer_chase_simplified_exp (btor, e_index);
   e_value = btor_pointer_chase_simplified_exp (btor, e_value);
@@ -1109,8 +1629,12 @@ boolector_write (Btor * btor, BtorExp * e_array, BtorExp * e_index,
                         "index bit-width of 'e_array' and bit-width of 'e_index' must not be unequal");
   BTOR_ABORT_BOOLECTOR (e_array->len != BTOR_REAL_ADDR_EXP (e_value)->len,
                         "element bit-width of 'e_array' and bit-width of 'e_value' must not be unequal");
-  btor->external_refs++;
-  return btor_write_exp (btor, e_array, e_index, e_value);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_write_exp (btor, e_array, e_index,
+                                                   e_value));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
@@ -1118,14 +1642,17 @@ boolector_cond (Btor * btor, BtorExp * e_cond, BtorExp * e_if, BtorExp * e_else)
 {
   BtorExp *real_e_if, *real_e_else;
   int is_array_e_if, is_array_e_else;
+  BtorExp *res;
 
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e_cond);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e_if);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e_else);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e_cond);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e_if);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e_else);
+  btor_trace_api (btor->apitrace, BTOR_API_COND, e_cond, e_if, e_else);
   e_cond = btor_pointer_chase_simplified_exp (btor, e_cond);
   e_if = btor_pointer_chase_simplified_exp (btor, e_if);
   e_else = btor_pointer_chase_simplified_exp (btor, e_else);
@@ -1147,184 +1674,298 @@ boolector_cond (Btor * btor, BtorExp * e_cond, BtorExp * e_if, BtorExp * e_else)
   BTOR_ABORT_BOOLECTOR (is_array_e_if
                         && real_e_if->index_len != real_e_else->index_len,
                         "arrays must not have unequal index bit-width");
-  btor->external_refs++;
-  return btor_cond_exp (btor, e_cond, e_if, e_else);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace,
+                                   btor_cond_exp (btor, e_cond, e_if, e_else));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_inc (Btor * btor, BtorExp * exp)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_INC, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
                         
-  btor->external_refs++;
-  return btor_inc_exp (btor, exp);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_inc_exp (btor, exp));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_dec (Btor * btor, BtorExp * exp)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_DEC, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
                         
-  btor->external_refs++;
-  return btor_dec_exp (btor, exp);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_dec_exp (btor, exp));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 int
 boolector_get_width (Btor * btor, BtorExp * exp)
 {
+  int res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
-  return btor_get_exp_len (btor, exp);
+  btor_trace_api (btor->apitrace, BTOR_API_GET_WIDTH, exp);
+  res = btor_trace_api_int_result (btor->apitrace,
+                                   btor_get_exp_len (btor, exp));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 int
 boolector_is_array (Btor * btor, BtorExp * exp)
 {
+  int res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_IS_ARRAY, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
-  return btor_is_array_exp (btor, exp);
+  res = btor_trace_api_int_result (btor->apitrace,
+                                   btor_is_array_exp (btor, exp));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 int
 boolector_get_width_index (Btor * btor, BtorExp * e_array)
 {
+  int res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e_array);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e_array);
+  btor_trace_api (btor->apitrace, BTOR_API_GET_INDEX_WIDTH, e_array);
   e_array = btor_pointer_chase_simplified_exp (btor, e_array);
   BTOR_ABORT_BV_BOLECTOR (e_array);
-  return btor_get_index_exp_len (btor, e_array);
+  res = btor_trace_api_int_result (btor->apitrace,
+                                   btor_get_index_exp_len (btor, e_array));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 const char *
 boolector_get_symbol_of_var (Btor * btor, BtorExp * exp)
 {
+  const char *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
-  return (const char *) btor_get_symbol_exp (btor, exp);
+  btor_trace_api (btor->apitrace, BTOR_API_GET_SYMBOL_OF_VAR, exp);
+  res = (const char *) btor_get_symbol_exp (btor, exp);
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 BtorExp *
 boolector_copy (Btor * btor, BtorExp * exp)
 {
+  BtorExp *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
-  btor->external_refs++;
-  return btor_copy_exp (btor, exp);
+  btor_trace_api (btor->apitrace, BTOR_API_COPY, exp);
+  BTOR_INC_EXT_REFS_BOOLECTOR (btor);
+  res = btor_trace_api_exp_result (btor->apitrace, btor_copy_exp (btor, exp));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 void
 boolector_release (Btor * btor, BtorExp * exp)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_SHARED_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
-  btor->external_refs--;
+  btor_trace_api (btor->apitrace, BTOR_API_RELEASE, exp);
+  BTOR_DEC_EXT_REFS_BOOLECTOR (btor);
   btor_release_exp (btor, exp);
+  BTOR_UNLOCK_BOOLECTOR (btor);
 }
 
 void
 boolector_dump_btor (Btor * btor, FILE * file, BtorExp * exp)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (file);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_DUMP_BTOR, exp);
   btor_dump_exp (btor, file, exp);
+  BTOR_UNLOCK_BOOLECTOR (btor);
 }
 
 void
 boolector_dump_smt (Btor * btor, FILE * file, BtorExp * exp)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (file);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_DUMP_SMT, exp);
   btor_dump_smt (btor, file, exp);
+  BTOR_UNLOCK_BOOLECTOR (btor);
 }
 
 void
 boolector_assert (Btor * btor, BtorExp * exp)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_ASSERT, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
   BTOR_ABORT_BOOLECTOR (BTOR_REAL_ADDR_EXP (exp)->len != 1,
                         "'exp' must have bit-width one");
   btor_add_constraint_exp (btor, exp);
+  BTOR_UNLOCK_BOOLECTOR (btor);
 }
 
 void
 boolector_assume (Btor * btor, BtorExp * exp)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (!btor->inc_enabled, "incremental usage has not been enabled");
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_ASSUME, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
   BTOR_ABORT_BOOLECTOR (BTOR_REAL_ADDR_EXP (exp)->len != 1,
                         "'exp' must have bit-width one");
   btor_add_assumption_exp (btor, exp);
+  BTOR_UNLOCK_BOOLECTOR (btor);
 }
 
 int
 boolector_sat (Btor * btor)
 {
+  int res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_BOOLECTOR (!btor->inc_enabled && btor->btor_sat_btor_called > 0,
                         "incremental usage has not been enabled. 'boolector_sat' may only be called once");
-  return btor_sat_btor (btor);
+  btor_trace_api (btor->apitrace, BTOR_API_SAT);
+  res = btor_trace_api_int_result (btor->apitrace, btor_sat_btor (btor));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
+}
+
+void
+boolector_restart_sat (Btor * btor)
+{
+  BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
+  BTOR_ABORT_BOOLECTOR (btor->ua.enabled || btor->la.enabled,
+                        "restarting is not supported with "
+                        "under-approximation or lazy arithmetic");
+  btor_trace_api (btor->apitrace, BTOR_API_RESTART_SAT);
+  btor_restart_sat_btor (btor);
+  BTOR_UNLOCK_BOOLECTOR (btor);
+}
+
+BoolectorStats
+boolector_get_stats (Btor * btor)
+{
+  BoolectorStats stats;
+  int i;
+  BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
+  btor_trace_api (btor->apitrace, BTOR_API_GET_STATS);
+  stats.solve_time = btor->time.solve;
+  stats.rewrite_time = btor->time.rewrite;
+  stats.synthesis_time = btor->time.synthesis;
+  stats.sat_time = btor->time.sat;
+  stats.lemmas_time = btor->time.lemmas;
+  stats.sat_calls = btor->stats.sat_calls;
+  stats.lod_refinements = btor->stats.lod_refinements;
+  stats.lemma_cache_hits = btor->stats.lemma_cache_hits;
+  stats.var_substitutions = btor->stats.var_substitutions;
+  stats.array_substitutions = btor->stats.array_substitutions;
+  stats.linear_equations = btor->stats.linear_equations;
+  stats.vreads = btor->stats.vreads;
+  /* proxies are not counted */
+  stats.exps = 0;
+  for (i = 1; i < BTOR_NUM_OPS_EXP - 1; i++)
+    stats.exps += btor->ops[i];
+  stats.ands =
+    btor_num_ands_aig_mgr (btor_get_aig_mgr_aigvec_mgr (btor->avmgr));
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return stats;
 }
 
 char *
 boolector_bv_assignment (Btor * btor, BtorExp * exp)
 {
+  char *res;
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (exp);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (exp);
+  btor_trace_api (btor->apitrace, BTOR_API_BV_ASSIGNMENT, exp);
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   BTOR_ABORT_ARRAY_BOOLECTOR (exp);
   BTOR_ABORT_BOOLECTOR (!btor->model_gen, "model generation has not been enabled");
-  return btor_bv_assignment_exp (btor, exp);
+  res = btor_bv_assignment_exp (btor, exp);
+  BTOR_UNLOCK_BOOLECTOR (btor);
+  return res;
 }
 
 void 
 boolector_array_assignment (Btor * btor, BtorExp * e_array, char ***indices, char ***values, int *size)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (e_array);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (indices);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (values);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (size);
   BTOR_ABORT_REFS_NOT_POS_BOOLECTOR (e_array);
+  btor_trace_api (btor->apitrace, BTOR_API_ARRAY_ASSIGNMENT, e_array);
   e_array = btor_pointer_chase_simplified_exp (btor, e_array);
   BTOR_ABORT_BV_BOLECTOR (e_array);
   BTOR_ABORT_BOOLECTOR (!btor->model_gen, "model generation has not been enabled");
   btor_array_assignment_exp (btor, e_array, indices, values, size);
+  BTOR_UNLOCK_BOOLECTOR (btor);
 }
 
 void
 boolector_free_bv_assignment (Btor * btor, char * assignment)
 {
   BTOR_ABORT_ARG_NULL_BOOLECTOR (btor);
+  BTOR_LOCK_BOOLECTOR (btor);
   BTOR_ABORT_ARG_NULL_BOOLECTOR (assignment);
   btor_free_bv_assignment_exp (btor, assignment);
+  BTOR_UNLOCK_BOOLECTOR (btor);
 }
 
 
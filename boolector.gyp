@@ -34,6 +34,10 @@
     # martignlo: disabled precosat since it does not yet support serilization
     # 'use_precosat': 1,
     'use_precosat': 0,
+    # static trace probes, see 'btortrace.h'
+    'use_trace': 0,
+    # thread safe usage, see 'boolector_enable_thread_safety'
+    'use_threads': 0,
   },
   'target_defaults': {
     'cflags': [
@@ -58,8 +62,12 @@
         'btoraig.h',
         'btoraigvec.c',
         'btoraigvec.h',
+        'btorapitrace.c',
+        'btorapitrace.h',
         'btorbtor.c',
         'btorbtor.h',
+        'btorcaig.c',
+        'btorcaig.h',
         'btorconfig.h',
         'btorconst.c',
         'btorconst.h',
@@ -73,6 +81,8 @@
         'btormain.h',
         'btormem.c',
         'btormem.h',
+        'btoroahash.c',
+        'btoroahash.h',
         'btorparse.h',
         'btorpreco.cc',
         'btorpreco.h',
@@ -86,6 +96,8 @@
         'btorsmt.c',
         'btorsmt.h',
         'btorstack.h',
+        'btortrace.c',
+        'btortrace.h',
         'btorutil.c',
         'btorutil.h',
       ], # sources
@@ -101,6 +113,21 @@
             'BTOR_USE_PRECOSAT',
           ],
         }],
+        ['use_trace==1', {
+          'defines': [
+            'BTOR_TRACE',
+          ],
+        }],
+        ['use_threads==1', {
+          'defines': [
+            'BTOR_THREADS',
+          ],
+          'link_settings': {
+            'libraries': [
+              '-lpthread',
+            ],
+          },
+        }],
       ], # conditions
       'direct_dependent_settings': {
         'include_dirs': [
@@ -151,5 +178,25 @@
         'deltabtor.c',
       ],
     }, # target deltabtor
+    {
+      'target_name': 'btorbench',
+      'type': 'executable',
+      'dependencies': [
+        'libboolector',
+      ],
+      'sources': [
+        'btorbench.c',
+      ],
+    }, # target btorbench
+    {
+      'target_name': 'btorreplay',
+      'type': 'executable',
+      'dependencies': [
+        'libboolector',
+      ],
+      'sources': [
+        'btorreplay.c',
+      ],
+    }, # target btorreplay
   ], # 'targets'
 }
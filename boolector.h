@@ -27,6 +27,7 @@ Boolector is copyrighted 2007 - 2009 by Robert Brummayer, Armin
 */
 
 #include "btorexp.h"
+#include "btortrace.h"
 
 #include <stdio.h>
 
@@ -143,6 +144,38 @@ Boolector is copyrighted 2007 - 2009 by Robert Brummayer, Armin
  * \see boolector_sat
  */
 #define BOOLECTOR_UNSAT 20
+/**
+ * Preprocessor constant representing status 'unknown', which is returned
+ * if the memory limit has been exceeded.
+ * \see boolector_set_memory_limit
+ */
+#define BOOLECTOR_UNKNOWN 0
+
+/**
+ * Statistics of a Boolector instance as returned by
+ * \ref boolector_get_stats. Times are cumulative wall clock seconds over
+ * all calls of \ref boolector_sat. Lemma generation includes the lazy
+ * synthesis of expressions involved in conflicts.
+ */
+typedef struct BoolectorStats BoolectorStats;
+
+struct BoolectorStats
+{
+  double solve_time;		/**< Total time in \ref boolector_sat. */
+  double rewrite_time;		/**< Time in the rewriting engine. */
+  double synthesis_time;	/**< Time to bit-blast constraints. */
+  double sat_time;		/**< Time in the SAT solver. */
+  double lemmas_time;		/**< Time to find conflicts and add lemmas. */
+  int sat_calls;		/**< Number of SAT solver calls. */
+  int lod_refinements;		/**< Number of lemmas on demand refinements. */
+  int lemma_cache_hits;		/**< Lemmas reusing a lemma literal. */
+  int var_substitutions;	/**< Substituted variables. */
+  int array_substitutions;	/**< Substituted arrays. */
+  int linear_equations;		/**< Linear constraint equations. */
+  int vreads;			/**< Virtual reads. */
+  int exps;			/**< Expressions currently in the DAG. */
+  int ands;			/**< AND gates of the AIG layer. */
+};
 
 /*------------------------------------------------------------------------*/
 /* Boolector                                                              */
@@ -157,6 +190,42 @@ Boolector is copyrighted 2007 - 2009 by Robert Brummayer, Armin
  */ 
 Btor *boolector_new (void);
 
+/**
+ * Logs all following calls of the public interface together with their
+ * arguments and results to 'file' in a compact binary format. The log
+ * can be re-executed by 'btorreplay', which reports the time spent in
+ * each call. Call this function directly after \ref boolector_new.
+ * Alternatively, the log is written to the file named by the environment
+ * variable 'BTORAPITRACE' if it is set when \ref boolector_new is called.
+ * The file is flushed before each call of \ref boolector_sat and it is
+ * not closed by \ref boolector_delete.
+ * \param btor Boolector instance.
+ * \param file Output file opened in binary mode.
+ */
+void boolector_set_api_trace (Btor * btor, FILE * file);
+
+/**
+ * Writes the events of the static trace probes, e.g. SAT solver calls
+ * with the size of the CNF, lemmas and resizes of unique tables, to
+ * 'file' in the Chrome trace event format. Alternatively, the events are
+ * written to the file named by the environment variable 'BTORTRACE'.
+ * The probes are only compiled in if Boolector is configured with
+ * '-trace', otherwise this function has no effect. Tracing is global
+ * to the process and not bound to a Boolector instance.
+ * \param file Output file, which is not closed.
+ */
+void boolector_set_trace_file (FILE * file);
+
+/**
+ * Passes the events of the static trace probes to 'fun' instead of
+ * writing them to a file. 'state' is passed to 'fun' as first argument.
+ * Passing NULL as 'fun' removes the callback. See
+ * \ref boolector_set_trace_file.
+ * \param fun Callback function.
+ * \param state Argument of the callback.
+ */
+void boolector_set_trace_callback (BtorTraceCallback fun, void *state);
+
 /** 
  * Enables model generation. If you want Boolector to produce 
  * a model in the satisfiable case, call this function 
@@ -175,7 +244,25 @@ void boolector_enable_model_gen (Btor * btor);
  */
 void boolector_enable_inc_usage (Btor * btor);
 
-/** 
+/**
+ * Enables thread safe usage. Afterwards several threads may call
+ * functions on the instance concurrently, e.g. to build expressions with
+ * common subexpressions in one shared DAG. Creating, copying, releasing
+ * and querying the width of expressions run in parallel and only
+ * synchronize on the unique table and reference counts. All other
+ * functions, e.g. \ref boolector_assert and \ref boolector_sat, exclude
+ * any other call on the instance, and so does every call while an API
+ * trace is written. Call this function before creating any
+ * expressions. Requires that Boolector has been configured with
+ * '-threads', otherwise Boolector aborts.
+ * Note that two different instances still must not run
+ * \ref boolector_sat concurrently, since the SAT solver PicoSAT and the
+ * internal tracing keep their state in process wide globals.
+ * \param btor Boolector instance.
+ */
+void boolector_enable_thread_safety (Btor * btor);
+
+/**
  * Sets the rewrite level of the rewriting engine. 
  * Boolector uses rewrite level 3 per default. Call this function
  * before creating any expressions.
@@ -185,6 +272,38 @@ void boolector_enable_inc_usage (Btor * btor);
  */
 void boolector_set_rewrite_level (Btor * btor, int rewrite_level);
 
+/**
+ * Sets the maximum number of writes a read is propagated over when it is
+ * created. Reads at constant indices skip consecutive writes at constant
+ * indices at once, which counts as one propagation.
+ * Boolector uses 1024 per default.
+ * \param btor Boolector instance.
+ * \param limit Maximum number of propagations, greater than zero.
+ */
+void boolector_set_read_over_write_limit (Btor * btor, int limit);
+
+/**
+ * Sets the maximum depth up to which write chains are searched for an
+ * earlier write to the same index when a write is created. The earlier
+ * write is eliminated. Boolector uses 20 per default.
+ * \param btor Boolector instance.
+ * \param bound Maximum depth, 0 disables the search.
+ */
+void boolector_set_write_chain_bound (Btor * btor, int bound);
+
+/**
+ * Sets a limit on the memory allocated by the instance including the SAT
+ * solver. If the limit is exceeded, bit-blasting and SAT solving stop and
+ * \ref boolector_sat returns \ref BOOLECTOR_UNKNOWN. The instance remains
+ * usable, e.g. expressions can be released and, if incremental usage is
+ * enabled, \ref boolector_sat can be called again after raising the limit.
+ * Per default the limit is taken from the environment variable
+ * 'BTORMEMLIMIT' in MB, otherwise memory is unlimited.
+ * \param btor Boolector instance.
+ * \param limit Limit in MB, 0 removes the limit.
+ */
+void boolector_set_memory_limit (Btor * btor, int limit);
+
 /** 
  * Returns the number of external references to the boolector library. 
  * Internally, Boolector manages an expression DAG with reference counting. Use
@@ -971,6 +1090,31 @@ void boolector_assume (Btor * btor, BtorExp * exp);
  **/
 int boolector_sat (Btor * btor);
 
+/**
+ * Restarts the SAT backend to bound memory in long running incremental
+ * sessions. The AIGs of all expressions are released and the SAT solver
+ * is reset, which drops all clauses including lemmas and learned
+ * clauses. The next call to \ref boolector_sat synthesizes and encodes
+ * the current constraints and assumptions again and has to derive
+ * lemmas anew, thus it is usually slower than without a restart.
+ * Expressions are not affected. Assignments are not available between
+ * this call and the next call to \ref boolector_sat. Boolector aborts if
+ * under-approximation or lazy arithmetic is enabled, since their
+ * refinements only live in the SAT solver.
+ * \param btor Boolector instance.
+ */
+void boolector_restart_sat (Btor * btor);
+
+/**
+ * Returns the statistics collected so far, e.g. to export them to a
+ * metrics system. The counters and times accumulate over all calls of
+ * \ref boolector_sat.
+ * \param btor Boolector instance.
+ * \return Statistics of the instance.
+ * \see BoolectorStats
+ */
+BoolectorStats boolector_get_stats (Btor * btor);
+
 /**
  * Builds assignment string for bit-vector expression if \ref boolector_sat
  * has returned \ref BOOLECTOR_SAT and model generation has been enabled. 
@@ -22,6 +22,7 @@
 #include "btorsat.h"
 #include "btorhash.h"
 #include "btorexit.h"
+#include "btortrace.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -78,6 +79,7 @@ struct BtorAIGMgr
   BtorMemMgr *mm;
   BtorAIGUniqueTable table;
   int id;
+  int num_vars;                 /* AIG variables alive */
   int verbosity;
   BtorSATMgr *smgr;
   BtorCNFEnc cnf_enc;
@@ -114,7 +116,7 @@ new_and_aig (BtorAIGMgr * amgr, BtorAIG * left, BtorAIG * right)
   assert (amgr != NULL);
   assert (!BTOR_IS_CONST_AIG (left));
   assert (!BTOR_IS_CONST_AIG (right));
-  BTOR_NEW (amgr->mm, aig);
+  BTOR_NEW (BTOR_VIEW_MEM_MGR (amgr->mm, BTOR_MEM_AIG), aig);
   BTOR_ABORT_AIG (amgr->id == INT_MAX, "AIG id overflow");
   aig->id = amgr->id++;
   BTOR_LEFT_CHILD_AIG (aig) = left;
@@ -133,7 +135,14 @@ delete_aig_node (BtorAIGMgr * amgr, BtorAIG * aig)
 {
   assert (amgr != NULL);
   if (!BTOR_IS_CONST_AIG (aig))
-    BTOR_DELETE (amgr->mm, aig);
+    {
+      if (BTOR_IS_VAR_AIG (aig))
+        {
+          assert (amgr->num_vars > 0);
+          amgr->num_vars--;
+        }
+      BTOR_DELETE (BTOR_VIEW_MEM_MGR (amgr->mm, BTOR_MEM_AIG), aig);
+    }
 }
 
 static unsigned int
@@ -242,7 +251,8 @@ enlarge_aig_unique_table (BtorAIGMgr * amgr)
   size = amgr->table.size;
   new_size = size << 1;
   assert (new_size / size == 2);
-  mm = amgr->mm;
+  mm = BTOR_VIEW_MEM_MGR (amgr->mm, BTOR_MEM_AIG);
+  BTOR_TRACE_BEGIN ("aig table resize");
   BTOR_CNEWN (mm, new_chains, new_size);
   for (i = 0; i < size; i++)
     {
@@ -261,6 +271,8 @@ enlarge_aig_unique_table (BtorAIGMgr * amgr)
   BTOR_DELETEN (mm, amgr->table.chains, size);
   amgr->table.size = new_size;
   amgr->table.chains = new_chains;
+  BTOR_TRACE_END ("aig table resize", "size", new_size,
+                  "aigs", amgr->table.num_elements);
 }
 
 BtorAIG *
@@ -355,9 +367,10 @@ btor_var_aig (BtorAIGMgr * amgr)
 {
   BtorAIG *aig;
   assert (amgr != NULL);
-  BTOR_NEW (amgr->mm, aig);
+  BTOR_NEW (BTOR_VIEW_MEM_MGR (amgr->mm, BTOR_MEM_AIG), aig);
   BTOR_ABORT_AIG (amgr->id == INT_MAX, "AIG id overflow");
   aig->id = amgr->id++;
+  amgr->num_vars++;
   BTOR_LEFT_CHILD_AIG (aig) = NULL;
   BTOR_RIGHT_CHILD_AIG (aig) = NULL;
   aig->refs = 1u;
@@ -722,12 +735,16 @@ btor_dump_aigs (BtorAIGMgr * amgr,
   btor_dump_aiger (amgr, binary, file, naigs, aigs, 0, 0, 0, backannotation);
 }
 
+/* AIGER literal of aig. The side array 'map' holds for every AIG id the
+ * input ordinal (> 0) resp. the negative latch ordinal of variables
+ * and the ordinal of AND gates in the order they are written.
+ */
 static unsigned
-btor_aiger_encode_aig (BtorPtrHashTable * table, BtorAIG * aig)
+btor_aiger_encode_aig (int *map, int I, int L, BtorAIG * aig)
 {
-  BtorPtrHashBucket *b;
   BtorAIG *real_aig;
   unsigned res;
+  int idx;
 
   if (aig == BTOR_AIG_FALSE)
     return 0;
@@ -736,11 +753,15 @@ btor_aiger_encode_aig (BtorPtrHashTable * table, BtorAIG * aig)
     return 1;
 
   real_aig = BTOR_REAL_ADDR_AIG (aig);
+  idx = map[real_aig->id];
+  assert (idx != 0);
 
-  b = btor_find_in_ptr_hash_table (table, real_aig);
-  assert (b);
+  if (BTOR_IS_AND_AIG (real_aig))
+    idx += I + L;
+  else if (idx < 0)
+    idx = I - idx;
 
-  res = 2 * (unsigned) b->data.asInt;
+  res = 2 * (unsigned) idx;
 
   if (BTOR_IS_INVERTED_AIG (aig))
     res ^= 1;
@@ -748,6 +769,23 @@ btor_aiger_encode_aig (BtorPtrHashTable * table, BtorAIG * aig)
   return res;
 }
 
+static void
+btor_aiger_put_delta (FILE * file, unsigned delta)
+{
+  unsigned char ch;
+
+  while (delta & ~0x7f)
+    {
+      ch = delta & 0x7f;
+      ch |= 0x80;
+      putc (ch, file);
+      delta >>= 7;
+    }
+
+  ch = delta;
+  putc (ch, file);
+}
+
 void
 btor_dump_aiger (BtorAIGMgr * amgr,
                  int binary, FILE * file,
@@ -755,207 +793,124 @@ btor_dump_aiger (BtorAIGMgr * amgr,
 		 int nregs, BtorAIG ** regs, BtorAIG ** nexts,
 		 BtorPtrHashTable * backannotation)
 {
-  unsigned aig_id, left_id, right_id, tmp, delta;
-  BtorPtrHashTable *table, *latches;
+  unsigned aig_id, left_id, right_id, tmp;
+  BtorAIGPtrStack stack, inputs, ands;
   BtorAIG *aig, *left, *right;
-  BtorPtrHashBucket *p, *b;
+  BtorPtrHashBucket *b;
   int M, I, L, O, A, i;
-  BtorAIGPtrStack stack;
-  unsigned char ch;
   BtorMemMgr *mm;
+  int *map;
 
   assert (naigs > 0);
 
   mm = amgr->mm;
 
-  table = btor_new_ptr_hash_table (amgr->mm, 0, 0);
-  latches = btor_new_ptr_hash_table (amgr->mm, 0, 0);
+  BTOR_CNEWN (mm, map, amgr->id);
 
-  /* First add latches and inputs to hash tables.
+  /* Latches are numbered after the inputs and in the given order.
    */
-  for (i = nregs - 1; i >= 0; i--)
-
+  for (i = 0; i < nregs; i++)
     {
       aig = regs[i];
       assert (!BTOR_IS_CONST_AIG (aig));
-      assert (!btor_find_in_ptr_hash_table (latches, aig));
-      btor_insert_in_ptr_hash_table (latches, aig);
+      assert (!BTOR_IS_INVERTED_AIG (aig));
+      assert (BTOR_IS_VAR_AIG (aig));
+      assert (map[aig->id] == 0);
+      map[aig->id] = -(i + 1);
     }
 
+  /* One post order pass numbers the inputs and collects the AND gates
+   * in topological order.
+   */
   BTOR_INIT_STACK (stack);
-  for (i = naigs - 1; i >= 0; i--)
+  BTOR_INIT_STACK (inputs);
+  BTOR_INIT_STACK (ands);
+  for (i = nregs - 1; i >= 0; i--)
     {
-      aig = aigs[i];
+      aig = nexts[i];
       if (!BTOR_IS_CONST_AIG (aig))
-        BTOR_PUSH_STACK (mm, stack, aig);
+        BTOR_PUSH_STACK (mm, stack, BTOR_REAL_ADDR_AIG (aig));
     }
-  for (i = nregs - 1; i >= 0; i--)
+  for (i = naigs - 1; i >= 0; i--)
     {
-      aig = nexts[i];
+      aig = aigs[i];
       if (!BTOR_IS_CONST_AIG (aig))
-        BTOR_PUSH_STACK (mm, stack, aig);
+        BTOR_PUSH_STACK (mm, stack, BTOR_REAL_ADDR_AIG (aig));
     }
 
-  M = 0;
-
   while (!BTOR_EMPTY_STACK (stack))
     {
       aig = BTOR_POP_STACK (stack);
+      assert (!BTOR_IS_INVERTED_AIG (aig));
 
-    CONTINUE_WITHOUT_POP:
-
-      assert (!BTOR_IS_CONST_AIG (aig));
-      aig = BTOR_REAL_ADDR_AIG (aig);
-
-      if (aig->mark)
+      if (map[aig->id])
         continue;
 
-      aig->mark = 1;
-
       if (BTOR_IS_VAR_AIG (aig))
         {
-	  if (btor_find_in_ptr_hash_table (latches, aig))
-	    continue;
-
-          p = btor_insert_in_ptr_hash_table (table, aig);
-          p->data.asInt = ++M;
-          assert (M > 0);
-        }
-      else
-        {
-          assert (BTOR_IS_AND_AIG (aig));
-
-          right = BTOR_RIGHT_CHILD_AIG (aig);
-          BTOR_PUSH_STACK (mm, stack, right);
-
-          aig = BTOR_LEFT_CHILD_AIG (aig);
-          goto CONTINUE_WITHOUT_POP;
+          BTOR_PUSH_STACK (mm, inputs, aig);
+          map[aig->id] = BTOR_COUNT_STACK (inputs);
+          continue;
         }
-    }
-
-  for (i = nregs - 1; i >= 0; i--)
-    {
-      aig = regs[i];
-      assert (!BTOR_IS_CONST_AIG (aig));
-      assert (btor_find_in_ptr_hash_table (latches, aig));
-      assert (!btor_find_in_ptr_hash_table (table, aig));
-      p = btor_insert_in_ptr_hash_table (table, aig);
-      p->data.asInt = ++M;
-      assert (M > 0);
-    }
-
-  L = nregs;
-  assert (L <= M);
-  I = M - L;
 
-  /* Then start adding ANG gates in postfix order.
-   */
-  assert (BTOR_EMPTY_STACK (stack));
-  for (i = nregs - 1; i >= 0; i--)
-    {
-      aig = nexts[i];
-      if (!BTOR_IS_CONST_AIG (aig))
-        BTOR_PUSH_STACK (mm, stack, aig);
-    }
-  for (i = naigs - 1; i >= 0; i--)
-    {
-      aig = aigs[i];
-      if (!BTOR_IS_CONST_AIG (aig))
-        BTOR_PUSH_STACK (mm, stack, aig);
-    }
-
-  while (!BTOR_EMPTY_STACK (stack))
-    {
-      aig = BTOR_POP_STACK (stack);
+      assert (BTOR_IS_AND_AIG (aig));
 
-      if (aig)
+      if (aig->mark)
         {
-        CONTINUE_WITH_NON_ZERO_AIG:
-
-          assert (!BTOR_IS_CONST_AIG (aig));
-          aig = BTOR_REAL_ADDR_AIG (aig);
-
-          if (!aig->mark)
-            continue;
-
           aig->mark = 0;
-
-          if (BTOR_IS_VAR_AIG (aig))
-            continue;
-
-          BTOR_PUSH_STACK (mm, stack, aig);
-          BTOR_PUSH_STACK (mm, stack, 0);
-
-          right = BTOR_RIGHT_CHILD_AIG (aig);
-          BTOR_PUSH_STACK (mm, stack, right);
-
-          aig = BTOR_LEFT_CHILD_AIG (aig);
-          goto CONTINUE_WITH_NON_ZERO_AIG;
+          BTOR_PUSH_STACK (mm, ands, aig);
+          map[aig->id] = BTOR_COUNT_STACK (ands);
+          continue;
         }
-      else
-        {
-          assert (!BTOR_EMPTY_STACK (stack));
 
-          aig = BTOR_POP_STACK (stack);
-          assert (!aig->mark);
+      aig->mark = 1;
+      BTOR_PUSH_STACK (mm, stack, aig);
 
-          assert (aig);
-          assert (BTOR_REAL_ADDR_AIG (aig) == aig);
-          assert (BTOR_IS_AND_AIG (aig));
+      right = BTOR_REAL_ADDR_AIG (BTOR_RIGHT_CHILD_AIG (aig));
+      if (!map[right->id])
+        BTOR_PUSH_STACK (mm, stack, right);
 
-          p = btor_insert_in_ptr_hash_table (table, aig);
-          p->data.asInt = ++M;
-          assert (M > 0);
-        }
+      left = BTOR_REAL_ADDR_AIG (BTOR_LEFT_CHILD_AIG (aig));
+      if (!map[left->id])
+        BTOR_PUSH_STACK (mm, stack, left);
     }
 
-  A = M - I - L;
-
   BTOR_RELEASE_STACK (mm, stack);
 
+  I = BTOR_COUNT_STACK (inputs);
+  L = nregs;
+  A = BTOR_COUNT_STACK (ands);
+  M = I + L + A;
   O = naigs;
 
   fprintf (file, "a%cg %d %d %d %d %d\n", binary ? 'i' : 'a', M, I, L, O, A);
 
   /* Only need to print inputs in non binary mode.
    */
-  for (p = table->first; p; p = p->next)
-    {
-      aig = p->key;
-
-      assert (aig);
-      assert (!BTOR_IS_INVERTED_AIG (aig));
-
-      if (!BTOR_IS_VAR_AIG (aig))
-        break;
-
-      if (btor_find_in_ptr_hash_table (latches, aig))
-	continue;
-
-      if (!binary)
-        fprintf (file, "%d\n", 2 * p->data.asInt);
-    }
+  if (!binary)
+    for (i = 1; i <= I; i++)
+      fprintf (file, "%d\n", 2 * i);
 
   /* Now the latches aka regs.
    */
   for (i = 0; i < nregs; i++)
     {
       if (!binary)
-	fprintf (file, "%u ", btor_aiger_encode_aig (table, regs[i]));
+	fprintf (file, "%u ", btor_aiger_encode_aig (map, I, L, regs[i]));
 
-      fprintf (file, "%u\n", btor_aiger_encode_aig (table, nexts[i]));
+      fprintf (file, "%u\n", btor_aiger_encode_aig (map, I, L, nexts[i]));
     }
 
   /* Then the outputs ...
    */
   for (i = 0; i < naigs; i++)
-    fprintf (file, "%u\n", btor_aiger_encode_aig (table, aigs[i]));
+    fprintf (file, "%u\n", btor_aiger_encode_aig (map, I, L, aigs[i]));
 
   /* And finally all the AND gates.
    */
-  while (p)
+  for (i = 0; i < A; i++)
     {
-      aig = p->key;
+      aig = ands.start[i];
 
       assert (aig);
       assert (!BTOR_IS_INVERTED_AIG (aig));
@@ -964,9 +919,9 @@ btor_dump_aiger (BtorAIGMgr * amgr,
       left = BTOR_LEFT_CHILD_AIG (aig);
       right = BTOR_RIGHT_CHILD_AIG (aig);
 
-      aig_id = 2 * (unsigned) p->data.asInt;
-      left_id = btor_aiger_encode_aig (table, left);
-      right_id = btor_aiger_encode_aig (table, right);
+      aig_id = 2 * (unsigned) (I + L + i + 1);
+      left_id = btor_aiger_encode_aig (map, I, L, left);
+      right_id = btor_aiger_encode_aig (map, I, L, right);
 
       if (left_id < right_id)
         {
@@ -980,44 +935,20 @@ btor_dump_aiger (BtorAIGMgr * amgr,
 
       if (binary)
         {
-          for (i = 0; i < 2; i++)
-            {
-              delta = i ? left_id - right_id : aig_id - left_id;
-              tmp = delta;
-
-              while (tmp & ~0x7f)
-                {
-                  ch = tmp & 0x7f;
-                  ch |= 0x80;
-
-                  putc (ch, file);
-                  tmp >>= 7;
-                }
-
-              ch = tmp;
-              putc (ch, file);
-            }
+          btor_aiger_put_delta (file, aig_id - left_id);
+          btor_aiger_put_delta (file, left_id - right_id);
         }
       else
         fprintf (file, "%u %u %u\n", aig_id, left_id, right_id);
-
-      p = p->next;
     }
 
   /* If we have back annotation add a symbol table.
    */
-  i = 0;
   if (backannotation)
     {
-      for (p = table->first; p; p = p->next)
+      for (i = 0; i < I; i++)
         {
-          aig = p->key;
-          if (!BTOR_IS_VAR_AIG (aig))
-            break;
-
-	  if (btor_find_in_ptr_hash_table (latches, aig))
-	    continue;
-
+          aig = inputs.start[i];
           b = btor_find_in_ptr_hash_table (backannotation, aig);
 
           /* If there is back annotation then we assume that all the
@@ -1028,14 +959,302 @@ btor_dump_aiger (BtorAIGMgr * amgr,
           assert (b->key == aig);
           assert (b->data.asStr);
 
-          assert (p->data.asInt == i + 1);
+          fprintf (file, "i%d %s\n", i, b->data.asStr);
+        }
+    }
+
+  BTOR_RELEASE_STACK (mm, inputs);
+  BTOR_RELEASE_STACK (mm, ands);
+  BTOR_DELETEN (mm, map, amgr->id);
+}
+
+static int
+btor_aiger_get_char (FILE * file)
+{
+  int ch;
+  ch = getc (file);
+  /* normalize CR LF */
+  if (ch == '\r')
+    {
+      ch = getc (file);
+      if (ch != '\n')
+        return EOF;
+    }
+  return ch;
+}
+
+/* Reads unsigned number terminated by 'term', returns 0 on error. */
+static int
+btor_aiger_read_unsigned (FILE * file, unsigned *res, int term)
+{
+  unsigned tmp;
+  int ch;
+
+  ch = btor_aiger_get_char (file);
+  if (ch < '0' || ch > '9')
+    return 0;
+
+  tmp = ch - '0';
+  while ((ch = btor_aiger_get_char (file)) >= '0' && ch <= '9')
+    {
+      if (tmp > (UINT_MAX - (ch - '0')) / 10)
+        return 0;
+      tmp = 10 * tmp + (ch - '0');
+    }
+
+  if (ch != term)
+    return 0;
+
+  *res = tmp;
+  return 1;
+}
+
+static int
+btor_aiger_get_delta (FILE * file, unsigned *res)
+{
+  unsigned tmp, i;
+  int ch;
+
+  tmp = 0;
+  i = 0;
+  do
+    {
+      if (i > 28)
+        return 0;
+      ch = getc (file);
+      if (ch == EOF)
+        return 0;
+      tmp |= (unsigned) (ch & 0x7f) << i;
+      i += 7;
+    }
+  while (ch & 0x80);
+
+  *res = tmp;
+  return 1;
+}
+
+static BtorAIG *
+btor_aiger_decode_lit (BtorAIG ** aigs, unsigned lit)
+{
+  BtorAIG *res;
+  res = aigs[lit / 2];
+  if (lit & 1)
+    res = BTOR_INVERT_AIG (res);
+  return res;
+}
+
+const char *
+btor_parse_aiger (BtorAIGMgr * amgr, FILE * file,
+                  BtorAIGPtrStack * inputs, BtorAIGPtrStack * latches,
+                  BtorAIGPtrStack * nexts, BtorAIGPtrStack * outputs)
+{
+  unsigned M, I, L, O, A, i, lhs, rhs0, rhs1, delta, lit, idx;
+  unsigned char *marks;
+  unsigned *lits, *defs;
+  const char *err;
+  BtorIntStack stack;
+  BtorAIG **aigs;
+  BtorMemMgr *mm;
+  int binary;
+
+  assert (amgr != NULL);
+  assert (file != NULL);
+  assert (inputs != NULL);
+  assert (latches != NULL);
+  assert (nexts != NULL);
+  assert (outputs != NULL);
+
+  mm = amgr->mm;
+
+  if (getc (file) != 'a')
+    return "expected 'aag' or 'aig' header";
+  binary = getc (file);
+  if ((binary != 'a' && binary != 'i') || getc (file) != 'g' ||
+      getc (file) != ' ')
+    return "expected 'aag' or 'aig' header";
+  binary = (binary == 'i');
+
+  if (!btor_aiger_read_unsigned (file, &M, ' ') ||
+      !btor_aiger_read_unsigned (file, &I, ' ') ||
+      !btor_aiger_read_unsigned (file, &L, ' ') ||
+      !btor_aiger_read_unsigned (file, &O, ' ') ||
+      !btor_aiger_read_unsigned (file, &A, '\n'))
+    return "invalid header";
+
+  if (M >= (unsigned) INT_MAX / 2 || O >= (unsigned) INT_MAX ||
+      I > M || L > M || A > M || I + L + A > M)
+    return "invalid header";
+
+  /* 'aigs' maps AIGER variables to AIGs, 'marks' tells whether they are
+   * built (2) or in progress (1). 'defs' holds for each variable the
+   * next literal of a latch resp. the two children of an AND gate.
+   */
+  BTOR_NEWN (mm, aigs, M + 1);
+  BTOR_CNEWN (mm, marks, M + 1);
+  BTOR_CNEWN (mm, defs, 2 * (M + 1));
+  BTOR_NEWN (mm, lits, O + 1);
+  aigs[0] = BTOR_AIG_FALSE;
+  marks[0] = 2;
+  err = 0;
+
+  for (i = 1; !err && i <= I; i++)
+    {
+      if (binary)
+        lit = 2 * i;
+      else if (!btor_aiger_read_unsigned (file, &lit, '\n'))
+        err = "invalid input";
+      if (!err && lit != 2 * i)
+        err = "inputs have to be numbered consecutively";
+      if (!err)
+        {
+          aigs[i] = btor_var_aig (amgr);
+          marks[i] = 2;
+        }
+    }
+
+  for (i = I + 1; !err && i <= I + L; i++)
+    {
+      if (binary)
+        lit = 2 * i;
+      else if (!btor_aiger_read_unsigned (file, &lit, ' '))
+        err = "invalid latch";
+      if (!err && lit != 2 * i)
+        err = "latches have to be numbered consecutively";
+      if (!err && !btor_aiger_read_unsigned (file, &defs[2 * i], '\n'))
+        err = "invalid latch";
+      if (!err && defs[2 * i] / 2 > M)
+        err = "latch literal out of range";
+      if (!err)
+        {
+          aigs[i] = btor_var_aig (amgr);
+          marks[i] = 2;
+        }
+    }
+
+  for (i = 0; !err && i < O; i++)
+    {
+      if (!btor_aiger_read_unsigned (file, &lits[i], '\n'))
+        err = "invalid output";
+      else if (lits[i] / 2 > M)
+        err = "output literal out of range";
+    }
 
-          fprintf (file, "i%d %s\n", i++, b->data.asStr);
+  /* ASCII files may leave variables unused, thus read exactly A gates. */
+  for (i = I + L + 1; !err && i <= I + L + A; i++)
+    {
+      if (binary)
+        {
+          lhs = 2 * i;
+          if (!btor_aiger_get_delta (file, &delta) || delta == 0 ||
+              delta > lhs)
+            err = "invalid AND gate";
+          else
+            {
+              rhs0 = lhs - delta;
+              if (!btor_aiger_get_delta (file, &delta) || delta > rhs0)
+                err = "invalid AND gate";
+              else
+                rhs1 = rhs0 - delta;
+            }
+        }
+      else if (!btor_aiger_read_unsigned (file, &lhs, ' ') ||
+               !btor_aiger_read_unsigned (file, &rhs0, ' ') ||
+               !btor_aiger_read_unsigned (file, &rhs1, '\n'))
+        err = "invalid AND gate";
+      else if ((lhs & 1) || lhs / 2 <= I + L || lhs / 2 > M ||
+               rhs0 / 2 > M || rhs1 / 2 > M)
+        err = "AND gate literal out of range";
+      else if (defs[lhs + 1])
+        err = "AND gate defined twice";
+
+      if (!err)
+        {
+          /* shifted by 2 to distinguish defined from undefined gates */
+          defs[lhs] = rhs0 + 2;
+          defs[lhs + 1] = rhs1 + 2;
         }
     }
 
-  btor_delete_ptr_hash_table (table);
-  btor_delete_ptr_hash_table (latches);
+  /* Build AND gates in post order. Binary files are already in
+   * topological order, thus the stack is only needed for ASCII files.
+   */
+  BTOR_INIT_STACK (stack);
+  for (i = I + L + 1; !err && i <= M; i++)
+    {
+      if (marks[i] == 2 || !defs[2 * i + 1])
+        continue;
+      BTOR_PUSH_STACK (mm, stack, (int) i);
+      while (!err && !BTOR_EMPTY_STACK (stack))
+        {
+          idx = (unsigned) BTOR_POP_STACK (stack);
+          if (marks[idx] == 2)
+            continue;
+          if (!defs[2 * idx + 1])
+            {
+              err = "undefined AND gate";
+              continue;
+            }
+          rhs0 = defs[2 * idx] - 2;
+          rhs1 = defs[2 * idx + 1] - 2;
+          if (marks[idx] == 0)
+            {
+              marks[idx] = 1;
+              BTOR_PUSH_STACK (mm, stack, (int) idx);
+              if (marks[rhs0 / 2] == 1 || marks[rhs1 / 2] == 1)
+                err = "cyclic AND gates";
+              if (marks[rhs1 / 2] == 0)
+                BTOR_PUSH_STACK (mm, stack, (int) (rhs1 / 2));
+              if (marks[rhs0 / 2] == 0)
+                BTOR_PUSH_STACK (mm, stack, (int) (rhs0 / 2));
+              continue;
+            }
+          assert (marks[idx] == 1);
+          assert (marks[rhs0 / 2] == 2);
+          assert (marks[rhs1 / 2] == 2);
+          aigs[idx] = btor_and_aig (amgr,
+                                    btor_aiger_decode_lit (aigs, rhs0),
+                                    btor_aiger_decode_lit (aigs, rhs1));
+          marks[idx] = 2;
+        }
+    }
+  BTOR_RELEASE_STACK (mm, stack);
+
+  for (i = I + 1; !err && i <= I + L; i++)
+    if (marks[defs[2 * i] / 2] != 2)
+      err = "undefined latch literal";
+
+  for (i = 0; !err && i < O; i++)
+    if (marks[lits[i] / 2] != 2)
+      err = "undefined output literal";
+
+  if (!err)
+    {
+      for (i = 1; i <= I; i++)
+        BTOR_PUSH_STACK (mm, *inputs, btor_copy_aig (amgr, aigs[i]));
+      for (i = I + 1; i <= I + L; i++)
+        {
+          BTOR_PUSH_STACK (mm, *latches, btor_copy_aig (amgr, aigs[i]));
+          BTOR_PUSH_STACK (mm, *nexts,
+                           btor_copy_aig (amgr,
+                                          btor_aiger_decode_lit
+                                          (aigs, defs[2 * i])));
+        }
+      for (i = 0; i < O; i++)
+        BTOR_PUSH_STACK (mm, *outputs,
+                         btor_copy_aig (amgr,
+                                        btor_aiger_decode_lit (aigs, lits[i])));
+    }
+
+  for (i = 1; i <= M; i++)
+    if (marks[i] == 2)
+      btor_release_aig (amgr, aigs[i]);
+
+  BTOR_DELETEN (mm, aigs, M + 1);
+  BTOR_DELETEN (mm, marks, M + 1);
+  BTOR_DELETEN (mm, defs, 2 * (M + 1));
+  BTOR_DELETEN (mm, lits, O + 1);
+
+  return err;
 }
 
 BtorAIGMgr *
@@ -1045,8 +1264,10 @@ btor_new_aig_mgr (BtorMemMgr * mm)
   assert (mm != NULL);
   BTOR_NEW (mm, amgr);
   amgr->mm = mm;
-  BTOR_INIT_AIG_UNIQUE_TABLE (mm, amgr->table);
+  BTOR_INIT_AIG_UNIQUE_TABLE (BTOR_VIEW_MEM_MGR (mm, BTOR_MEM_AIG),
+                              amgr->table);
   amgr->id = 1;
+  amgr->num_vars = 0;
   amgr->verbosity = 0;
   amgr->smgr = btor_new_sat_mgr (mm);
   amgr->cnf_enc = BTOR_TSEITIN_CNF_ENC;
@@ -1068,7 +1289,8 @@ btor_delete_aig_mgr (BtorAIGMgr * amgr)
   assert (amgr != NULL);
   assert (amgr->table.num_elements == 0);
   mm = amgr->mm;
-  BTOR_RELEASE_AIG_UNIQUE_TABLE (mm, amgr->table);
+  BTOR_RELEASE_AIG_UNIQUE_TABLE (BTOR_VIEW_MEM_MGR (mm, BTOR_MEM_AIG),
+                                 amgr->table);
   btor_delete_sat_mgr (amgr->smgr);
   BTOR_DELETE (mm, amgr);
 }
@@ -1384,6 +1606,23 @@ btor_get_sat_mgr_aig_mgr (const BtorAIGMgr * amgr)
   return (amgr->smgr);
 }
 
+int
+btor_num_ands_aig_mgr (const BtorAIGMgr * amgr)
+{
+  assert (amgr != NULL);
+  return amgr->table.num_elements;
+}
+
+int
+btor_restart_ids_aig_mgr (BtorAIGMgr * amgr)
+{
+  assert (amgr != NULL);
+  if (amgr->table.num_elements > 0 || amgr->num_vars > 0)
+    return 0;
+  amgr->id = 1;
+  return 1;
+}
+
 int
 btor_get_assignment_aig (BtorAIGMgr * amgr, BtorAIG * aig)
 {
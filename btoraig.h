@@ -86,6 +86,14 @@ BtorSATMgr *btor_get_sat_mgr_aig_mgr (const BtorAIGMgr * amgr);
 /* Deletes AIG manager from memory. */
 void btor_delete_aig_mgr (BtorAIGMgr * amgr);
 
+/* Number of AND nodes. */
+int btor_num_ands_aig_mgr (const BtorAIGMgr * amgr);
+
+/* Restarts AIG ids at 1 if no AIG is alive anymore.
+ * Returns non-zero if the ids have been restarted.
+ */
+int btor_restart_ids_aig_mgr (BtorAIGMgr * amgr);
+
 /* Variable representing 1 bit. */
 BtorAIG *btor_var_aig (BtorAIGMgr * amgr);
 
@@ -135,6 +143,17 @@ void btor_dump_aiger (BtorAIGMgr * amgr,
 		      int nregs, BtorAIG ** regs, BtorAIG ** nexts,
 		      BtorPtrHashTable * back_annotation);
 
+/* Reads combinational or sequential AIGER model in ASCII or binary format.
+ * Inputs and latches become new AIG variables. Pushes references to
+ * the inputs, latches, next state functions and outputs onto the stacks.
+ * Returns NULL on success and an error message otherwise.
+ */
+const char *btor_parse_aiger (BtorAIGMgr * amgr, FILE * input,
+                              BtorAIGPtrStack * inputs,
+                              BtorAIGPtrStack * latches,
+                              BtorAIGPtrStack * nexts,
+                              BtorAIGPtrStack * outputs);
+
 /* Translates AIG into SAT instance. */ 
 void btor_aig_to_sat (BtorAIGMgr * amgr, BtorAIG * aig);
 
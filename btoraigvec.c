@@ -37,6 +37,16 @@ struct BtorAIGVecMgr
   BtorAIGMgr *amgr;
 };
 
+/* Every AIG of the storage is referenced exactly once by the storage,
+ * independent of the number of AIG vectors sharing it.
+ */
+struct BtorAIGVecStore
+{
+  BtorAIG **aigs;
+  int len;
+  unsigned int refs;            /* number of AIG vectors using the storage */
+};
+
 /*------------------------------------------------------------------------*/
 /* END OF DECLARATIONS                                                    */
 /*------------------------------------------------------------------------*/
@@ -48,15 +58,63 @@ struct BtorAIGVecMgr
 static BtorAIGVec *
 new_aigvec (BtorAIGVecMgr * avmgr, int len)
 {
+  BtorAIGVecStore *store;
   BtorAIGVec *result;
   assert (avmgr != NULL);
   assert (len > 0);
+  BTOR_NEW (avmgr->mm, store);
+  BTOR_NEWN (avmgr->mm, store->aigs, len);
+  store->len = len;
+  store->refs = 1u;
   BTOR_NEW (avmgr->mm, result);
-  BTOR_NEWN (avmgr->mm, result->aigs, len);
+  result->aigs = store->aigs;
   result->len = len;
+  result->store = store;
   return result;
 }
 
+/* Creates AIG vector sharing 'len' AIGs of av starting at 'pos' */
+static BtorAIGVec *
+new_view_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av, int pos, int len)
+{
+  BtorAIGVec *result;
+  assert (avmgr != NULL);
+  assert (av != NULL);
+  assert (pos >= 0);
+  assert (len > 0);
+  assert (pos + len <= av->len);
+  assert (av->store->refs < UINT_MAX);
+  BTOR_NEW (avmgr->mm, result);
+  result->aigs = av->aigs + pos;
+  result->len = len;
+  result->store = av->store;
+  result->store->refs++;
+  return result;
+}
+
+void
+btor_unshare_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av)
+{
+  BtorAIGVecStore *store;
+  int i, len;
+  assert (avmgr != NULL);
+  assert (av != NULL);
+  assert (av->len > 0);
+  assert (av->store->refs > 0u);
+  if (av->store->refs == 1u)
+    return;
+  len = av->len;
+  BTOR_NEW (avmgr->mm, store);
+  BTOR_NEWN (avmgr->mm, store->aigs, len);
+  store->len = len;
+  store->refs = 1u;
+  for (i = 0; i < len; i++)
+    store->aigs[i] = btor_copy_aig (avmgr->amgr, av->aigs[i]);
+  av->store->refs--;
+  av->aigs = store->aigs;
+  av->store = store;
+}
+
 BtorAIGVec *
 btor_const_aigvec (BtorAIGVecMgr * avmgr, const char *bits)
 {
@@ -93,6 +151,7 @@ btor_invert_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av)
   assert (avmgr != NULL);
   assert (av != NULL);
   assert (av->len > 0);
+  btor_unshare_aigvec (avmgr, av);
   len = av->len;
   for (i = 0; i < len; i++)
     av->aigs[i] = BTOR_INVERT_AIG (av->aigs[i]);
@@ -116,21 +175,13 @@ btor_not_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av)
 BtorAIGVec *
 btor_slice_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av, int upper, int lower)
 {
-  BtorAIGVec *result;
-  int i, len, diff, counter;
   assert (avmgr != NULL);
   assert (av != NULL);
   assert (av->len > 0);
   assert (upper < av->len);
   assert (lower >= 0);
   assert (lower <= upper);
-  counter = 0;
-  len = av->len;
-  diff = upper - lower;
-  result = new_aigvec (avmgr, diff + 1);
-  for (i = len - upper - 1; i <= len - upper - 1 + diff; i++)
-    result->aigs[counter++] = btor_copy_aig (avmgr->amgr, av->aigs[i]);
-  return result;
+  return new_view_aigvec (avmgr, av, av->len - upper - 1, upper - lower + 1);
 }
 
 BtorAIGVec *
@@ -5778,6 +5829,13 @@ btor_concat_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av1, BtorAIGVec * av2)
   amgr = avmgr->amgr;
   len_av1 = av1->len;
   len_av2 = av2->len;
+  /* adjacent slices of the same vector */
+  if (av1->store == av2->store && av1->aigs + len_av1 == av2->aigs)
+    {
+      result = new_view_aigvec (avmgr, av1, 0, len_av1);
+      result->len += len_av2;
+      return result;
+    }
   result = new_aigvec (avmgr, len_av1 + len_av2);
   for (i = 0; i < len_av1; i++)
     result->aigs[pos++] = btor_copy_aig (amgr, av1->aigs[i]);
@@ -5812,17 +5870,9 @@ btor_cond_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av_cond,
 BtorAIGVec *
 btor_copy_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av)
 {
-  BtorAIGMgr *amgr;
-  BtorAIGVec *result;
-  int i, len;
   assert (avmgr != NULL);
   assert (av != NULL);
-  amgr = avmgr->amgr;
-  len = av->len;
-  result = new_aigvec (avmgr, len);
-  for (i = 0; i < len; i++)
-    result->aigs[i] = btor_copy_aig (amgr, av->aigs[i]);
-  return result;
+  return new_view_aigvec (avmgr, av, 0, av->len);
 }
 
 void
@@ -5841,6 +5891,7 @@ btor_aigvec_to_sat_both_phases (BtorAIGVecMgr * avmgr, BtorAIGVec * av)
 void
 btor_release_delete_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av)
 {
+  BtorAIGVecStore *store;
   BtorMemMgr *mm;
   BtorAIGMgr *amgr;
   int i, len;
@@ -5849,11 +5900,16 @@ btor_release_delete_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av)
   assert (av->len > 0);
   mm = avmgr->mm;
   amgr = avmgr->amgr;
-  len = av->len;
-  for (i = 0; i < len; i++)
-    btor_release_aig (amgr, av->aigs[i]);
-  BTOR_DELETEN (mm, av->aigs, len);
+  store = av->store;
   BTOR_DELETE (mm, av);
+  assert (store->refs > 0u);
+  if (--store->refs > 0u)
+    return;
+  len = store->len;
+  for (i = 0; i < len; i++)
+    btor_release_aig (amgr, store->aigs[i]);
+  BTOR_DELETEN (mm, store->aigs, len);
+  BTOR_DELETE (mm, store);
 }
 
 BtorAIGVecMgr *
@@ -28,10 +28,17 @@
 /*------------------------------------------------------------------------*/
 
 
+typedef struct BtorAIGVecStore BtorAIGVecStore;
+
+/* The AIGs of an AIG vector may be shared with other AIG vectors, e.g.
+ * slices and copies are views on the storage of the original vector.
+ * Therefore 'aigs' must not be modified directly, see 'btor_unshare_aigvec'.
+ */
 struct BtorAIGVec
 {
   BtorAIG **aigs;                /* vector of AIGs */
   int len;                       /* length of the AIG vector */
+  BtorAIGVecStore *store;        /* reference counted storage of AIGs */
 };
 
 typedef struct BtorAIGVec BtorAIGVec;
@@ -68,15 +75,21 @@ BtorAIGVec *btor_const_aigvec (BtorAIGVecMgr * avmgr, const char *bits);
  */
 BtorAIGVec *btor_var_aigvec (BtorAIGVecMgr * avmgr, int len);
 
-/* Inverts all AIGs of the AIG vector */
+/* Inverts all AIGs of the AIG vector (copy-on-write) */
 void btor_invert_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av);
 
+/* Makes sure that the AIGs of the AIG vector are not shared with other
+ * AIG vectors, such that they can be modified in place.
+ */
+void btor_unshare_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av);
+
 /* Creates new AIG vector representing ones's complement of av.
  * len(result) = len(av)
  */
 BtorAIGVec *btor_not_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av);
 
 /* Creates new AIG vector representing a slice of av.
+ * The result shares the AIGs of av.
  * upper < len(av)
  * lower >= 0
  * upper >= lower
@@ -150,6 +163,7 @@ BtorAIGVec *btor_urem_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av1,
                               BtorAIGVec * av2);
 
 /* Creates new AIG vector representing the concatenation av1.av2.
+ * If av1 and av2 are adjacent slices, then the result shares their AIGs.
  * len(result) = len(av1) + len(av2)
  */
 BtorAIGVec *btor_concat_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av1,
@@ -164,6 +178,7 @@ BtorAIGVec *btor_cond_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av_cond,
                               BtorAIGVec * av_if, BtorAIGVec * av_else);
 
 /* Creates new AIG vector representing a copy of av.
+ * The result shares the AIGs of av.
  * len(result) = len(av)
  */
 BtorAIGVec *btor_copy_aigvec (BtorAIGVecMgr * avmgr, BtorAIGVec * av);
@@ -0,0 +1,352 @@
+/*  Boolector: Satisfiablity Modulo Theories (SMT) solver.
+ *  Copyright (C) 2010  Robert Daniel Brummayer, Armin Biere
+ *
+ *  This file is part of Boolector.
+ *
+ *  Boolector is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Boolector is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "btorapitrace.h"
+
+#include <assert.h>
+#include <stdarg.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------*/
+/* BEGIN OF DECLARATIONS                                                  */
+/*------------------------------------------------------------------------*/
+
+#define BTOR_API_TRACE_MAGIC "BTORAPI"
+#define BTOR_API_TRACE_VERSION 1
+
+struct BtorApiTrace
+{
+  BtorMemMgr *mm;
+  FILE *file;
+  int close;
+};
+
+struct BtorApiReader
+{
+  BtorMemMgr *mm;
+  FILE *file;
+  BtorApiOp op;                 /* last call read */
+  char *buf;                    /* string argument of the last call */
+  int size;
+};
+
+static const char *const g_api_op2name[BTOR_API_NUM_OPS] = {
+  "invalid", "enable_model_gen", "enable_inc_usage", "set_rewrite_level",
+  "set_read_over_write_limit", "set_write_chain_bound", "get_refs",
+  "delete", "const", "zero", "false", "ones", "true", "one",
+  "unsigned_int", "int", "var", "array", "not", "neg", "redor", "redxor",
+  "redand", "slice", "uext", "sext", "implies", "iff", "xor", "xnor",
+  "and", "nand", "or", "nor", "eq", "ne", "add", "uaddo", "saddo", "mul",
+  "umulo", "smulo", "ult", "slt", "ulte", "slte", "ugt", "sgt", "ugte",
+  "sgte", "sll", "srl", "sra", "rol", "ror", "sub", "usubo", "ssubo",
+  "udiv", "sdiv", "sdivo", "urem", "srem", "smod", "concat", "read",
+  "write", "cond", "inc", "dec", "get_width", "is_array",
+  "get_index_width", "get_symbol_of_var", "copy", "release", "dump_btor",
+  "dump_smt", "assert", "assume", "sat", "get_stats", "bv_assignment",
+  "array_assignment", "set_memory_limit", "enable_thread_safety",
+  "restart_sat"
+};
+
+static const char *const g_api_op2signature[BTOR_API_NUM_OPS] = {
+  "", "", "", "i", "i", "i", ":i", "", "s:e", "i:e", ":e", "i:e", ":e",
+  "i:e", "ui:e", "ii:e", "is:e", "iis:e", "e:e", "e:e", "e:e", "e:e",
+  "e:e", "eii:e", "ei:e", "ei:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e",
+  "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e",
+  "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e",
+  "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e",
+  "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "ee:e", "eee:e",
+  "eee:e", "e:e", "e:e", "e:i", "e:i", "e:i", "e", "e:e", "e", "e", "e",
+  "e", "e", ":i", "", "e", "e", "i", "", ""
+};
+
+/*------------------------------------------------------------------------*/
+/* END OF DECLARATIONS                                                    */
+/*------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------*/
+/* BEGIN OF IMPLEMENTATION                                                */
+/*------------------------------------------------------------------------*/
+
+const char *
+btor_name_api_op (BtorApiOp op)
+{
+  assert (op > BTOR_API_INVALID);
+  assert (op < BTOR_API_NUM_OPS);
+  return g_api_op2name[op];
+}
+
+const char *
+btor_signature_api_op (BtorApiOp op)
+{
+  assert (op > BTOR_API_INVALID);
+  assert (op < BTOR_API_NUM_OPS);
+  return g_api_op2signature[op];
+}
+
+static unsigned
+exp2code_api_trace (BtorExp * exp)
+{
+  assert (exp != NULL);
+  return 2u * (unsigned) BTOR_REAL_ADDR_EXP (exp)->id
+    + (unsigned) BTOR_IS_INVERTED_EXP (exp);
+}
+
+static void
+write_unsigned_api_trace (BtorApiTrace * trace, unsigned u)
+{
+  while (u > 127u)
+    {
+      putc ((int) (128u | (u & 127u)), trace->file);
+      u >>= 7;
+    }
+  putc ((int) u, trace->file);
+}
+
+static void
+write_int_api_trace (BtorApiTrace * trace, int i)
+{
+  unsigned u = (unsigned) i;
+  write_unsigned_api_trace (trace, i < 0 ? ~(u << 1) : u << 1);
+}
+
+static void
+write_str_api_trace (BtorApiTrace * trace, const char *str)
+{
+  size_t len;
+  if (str == NULL)
+    {
+      write_unsigned_api_trace (trace, 0u);
+      return;
+    }
+  len = strlen (str);
+  write_unsigned_api_trace (trace, (unsigned) len + 1u);
+  fwrite (str, 1, len, trace->file);
+}
+
+BtorApiTrace *
+btor_new_api_trace (BtorMemMgr * mm, FILE * file, int close)
+{
+  BtorApiTrace *trace;
+  assert (mm != NULL);
+  assert (file != NULL);
+  BTOR_NEW (mm, trace);
+  trace->mm = mm;
+  trace->file = file;
+  trace->close = close;
+  fputs (BTOR_API_TRACE_MAGIC, file);
+  putc (BTOR_API_TRACE_VERSION, file);
+  return trace;
+}
+
+void
+btor_delete_api_trace (BtorApiTrace * trace)
+{
+  assert (trace != NULL);
+  if (trace->close)
+    fclose (trace->file);
+  else
+    fflush (trace->file);
+  BTOR_DELETE (trace->mm, trace);
+}
+
+void
+btor_trace_api (BtorApiTrace * trace, BtorApiOp op, ...)
+{
+  const char *p;
+  va_list ap;
+  if (trace == NULL)
+    return;
+  putc ((int) op, trace->file);
+  va_start (ap, op);
+  for (p = btor_signature_api_op (op); *p && *p != ':'; p++)
+    {
+      switch (*p)
+        {
+        case 'e':
+          write_unsigned_api_trace (trace,
+                                    exp2code_api_trace (va_arg (ap,
+                                                                BtorExp *)));
+          break;
+        case 'i':
+          write_int_api_trace (trace, va_arg (ap, int));
+          break;
+        case 'u':
+          write_unsigned_api_trace (trace, va_arg (ap, unsigned));
+          break;
+        default:
+          assert (*p == 's');
+          write_str_api_trace (trace, va_arg (ap, const char *));
+          break;
+        }
+    }
+  va_end (ap);
+  if (op == BTOR_API_SAT || op == BTOR_API_DELETE)
+    fflush (trace->file);
+}
+
+BtorExp *
+btor_trace_api_exp_result (BtorApiTrace * trace, BtorExp * exp)
+{
+  if (trace != NULL)
+    write_unsigned_api_trace (trace, exp2code_api_trace (exp));
+  return exp;
+}
+
+int
+btor_trace_api_int_result (BtorApiTrace * trace, int result)
+{
+  if (trace != NULL)
+    write_int_api_trace (trace, result);
+  return result;
+}
+
+static int
+read_unsigned_api_reader (BtorApiReader * reader, unsigned *res)
+{
+  unsigned u;
+  int ch, shift;
+  u = 0;
+  for (shift = 0; shift < 35; shift += 7)
+    {
+      ch = getc (reader->file);
+      if (ch == EOF)
+        return 0;
+      u |= ((unsigned) ch & 127u) << shift;
+      if (!(ch & 128))
+        {
+          *res = u;
+          return 1;
+        }
+    }
+  return 0;
+}
+
+static int
+read_int_api_reader (BtorApiReader * reader, int *res)
+{
+  unsigned u;
+  if (!read_unsigned_api_reader (reader, &u))
+    return 0;
+  *res = (u & 1u) ? (int) ~(u >> 1) : (int) (u >> 1);
+  return 1;
+}
+
+static int
+read_str_api_reader (BtorApiReader * reader, const char **res)
+{
+  unsigned len;
+  if (!read_unsigned_api_reader (reader, &len))
+    return 0;
+  if (len == 0u)
+    {
+      *res = NULL;
+      return 1;
+    }
+  if ((int) len > reader->size)
+    {
+      BTOR_REALLOC (reader->mm, reader->buf, reader->size, (int) len);
+      reader->size = (int) len;
+    }
+  len--;
+  if (fread (reader->buf, 1, len, reader->file) != len)
+    return 0;
+  reader->buf[len] = '\0';
+  *res = reader->buf;
+  return 1;
+}
+
+BtorApiReader *
+btor_new_api_reader (BtorMemMgr * mm, FILE * file)
+{
+  char header[sizeof (BTOR_API_TRACE_MAGIC)];
+  BtorApiReader *reader;
+  size_t len;
+  assert (mm != NULL);
+  assert (file != NULL);
+  len = sizeof (BTOR_API_TRACE_MAGIC) - 1;
+  if (fread (header, 1, len, file) != len
+      || memcmp (header, BTOR_API_TRACE_MAGIC, len)
+      || getc (file) != BTOR_API_TRACE_VERSION)
+    return NULL;
+  BTOR_CNEW (mm, reader);
+  reader->mm = mm;
+  reader->file = file;
+  return reader;
+}
+
+void
+btor_delete_api_reader (BtorApiReader * reader)
+{
+  assert (reader != NULL);
+  BTOR_DELETEN (reader->mm, reader->buf, reader->size);
+  BTOR_DELETE (reader->mm, reader);
+}
+
+int
+btor_read_api_call (BtorApiReader * reader, BtorApiCall * call)
+{
+  const char *p;
+  int ch, i, ok;
+  assert (reader != NULL);
+  assert (call != NULL);
+  reader->op = BTOR_API_INVALID;
+  ch = getc (reader->file);
+  if (ch == EOF)
+    return 0;
+  if (ch <= BTOR_API_INVALID || ch >= BTOR_API_NUM_OPS)
+    return -1;
+  call->op = (BtorApiOp) ch;
+  i = 0;
+  for (p = btor_signature_api_op (call->op); *p && *p != ':'; p++)
+    {
+      assert (i < BTOR_API_MAX_ARGS);
+      if (*p == 'e')
+        ok = read_unsigned_api_reader (reader, &call->args[i].exp);
+      else if (*p == 'i')
+        ok = read_int_api_reader (reader, &call->args[i].i);
+      else if (*p == 'u')
+        ok = read_unsigned_api_reader (reader, &call->args[i].u);
+      else
+        ok = read_str_api_reader (reader, &call->args[i].str);
+      if (!ok)
+        return -1;
+      i++;
+    }
+  reader->op = call->op;
+  return 1;
+}
+
+int
+btor_read_api_result (BtorApiReader * reader, BtorApiArg * result)
+{
+  const char *p;
+  assert (reader != NULL);
+  assert (result != NULL);
+  assert (reader->op != BTOR_API_INVALID);
+  p = strchr (btor_signature_api_op (reader->op), ':');
+  assert (p != NULL);
+  if (p[1] == 'e')
+    return read_unsigned_api_reader (reader, &result->exp);
+  assert (p[1] == 'i');
+  return read_int_api_reader (reader, &result->i);
+}
+
+/*------------------------------------------------------------------------*/
+/* END OF IMPLEMENTATION                                                  */
+/*------------------------------------------------------------------------*/
@@ -0,0 +1,204 @@
+/*  Boolector: Satisfiablity Modulo Theories (SMT) solver.
+ *  Copyright (C) 2010  Robert Daniel Brummayer, Armin Biere
+ *
+ *  This file is part of Boolector.
+ *
+ *  Boolector is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Boolector is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BTORAPITRACE_H_INCLUDED
+#define BTORAPITRACE_H_INCLUDED
+
+#include "btorexp.h"
+#include "btormem.h"
+
+#include <stdio.h>
+
+/*------------------------------------------------------------------------*/
+/* PRIVATE INTERFACE                                                      */
+/*------------------------------------------------------------------------*/
+
+/* Binary log of the calls of the public interface, which is replayed by
+ * 'btorreplay'.  The log starts with the magic string "BTORAPI" and a
+ * version byte.  Each call is one record consisting of the operation as
+ * one byte, the arguments and, if the function returns an expression or
+ * an integer, the result.  Unsigned integers are written in 7 bit groups,
+ * least significant group first, with the high bit of a byte set if more
+ * groups follow.  Signed integers are zig-zag encoded first.  Expressions
+ * are written as twice their id plus one if they are inverted.  Strings
+ * are written as their length plus one, or zero for NULL, followed by the
+ * characters.
+ *
+ * The signature of an operation lists its arguments, 'e' for expressions,
+ * 'i' for integers, 'u' for unsigned integers and 's' for strings, and
+ * after a colon the type of the result if it is recorded.
+ */
+enum BtorApiOp
+{
+  BTOR_API_INVALID = 0,
+  BTOR_API_ENABLE_MODEL_GEN = 1,
+  BTOR_API_ENABLE_INC_USAGE = 2,
+  BTOR_API_SET_REWRITE_LEVEL = 3,
+  BTOR_API_SET_READ_OVER_WRITE_LIMIT = 4,
+  BTOR_API_SET_WRITE_CHAIN_BOUND = 5,
+  BTOR_API_GET_REFS = 6,
+  BTOR_API_DELETE = 7,
+  BTOR_API_CONST = 8,
+  BTOR_API_ZERO = 9,
+  BTOR_API_FALSE = 10,
+  BTOR_API_ONES = 11,
+  BTOR_API_TRUE = 12,
+  BTOR_API_ONE = 13,
+  BTOR_API_UNSIGNED_INT = 14,
+  BTOR_API_INT = 15,
+  BTOR_API_VAR = 16,
+  BTOR_API_ARRAY = 17,
+  BTOR_API_NOT = 18,
+  BTOR_API_NEG = 19,
+  BTOR_API_REDOR = 20,
+  BTOR_API_REDXOR = 21,
+  BTOR_API_REDAND = 22,
+  BTOR_API_SLICE = 23,
+  BTOR_API_UEXT = 24,
+  BTOR_API_SEXT = 25,
+  BTOR_API_IMPLIES = 26,
+  BTOR_API_IFF = 27,
+  BTOR_API_XOR = 28,
+  BTOR_API_XNOR = 29,
+  BTOR_API_AND = 30,
+  BTOR_API_NAND = 31,
+  BTOR_API_OR = 32,
+  BTOR_API_NOR = 33,
+  BTOR_API_EQ = 34,
+  BTOR_API_NE = 35,
+  BTOR_API_ADD = 36,
+  BTOR_API_UADDO = 37,
+  BTOR_API_SADDO = 38,
+  BTOR_API_MUL = 39,
+  BTOR_API_UMULO = 40,
+  BTOR_API_SMULO = 41,
+  BTOR_API_ULT = 42,
+  BTOR_API_SLT = 43,
+  BTOR_API_ULTE = 44,
+  BTOR_API_SLTE = 45,
+  BTOR_API_UGT = 46,
+  BTOR_API_SGT = 47,
+  BTOR_API_UGTE = 48,
+  BTOR_API_SGTE = 49,
+  BTOR_API_SLL = 50,
+  BTOR_API_SRL = 51,
+  BTOR_API_SRA = 52,
+  BTOR_API_ROL = 53,
+  BTOR_API_ROR = 54,
+  BTOR_API_SUB = 55,
+  BTOR_API_USUBO = 56,
+  BTOR_API_SSUBO = 57,
+  BTOR_API_UDIV = 58,
+  BTOR_API_SDIV = 59,
+  BTOR_API_SDIVO = 60,
+  BTOR_API_UREM = 61,
+  BTOR_API_SREM = 62,
+  BTOR_API_SMOD = 63,
+  BTOR_API_CONCAT = 64,
+  BTOR_API_READ = 65,
+  BTOR_API_WRITE = 66,
+  BTOR_API_COND = 67,
+  BTOR_API_INC = 68,
+  BTOR_API_DEC = 69,
+  BTOR_API_GET_WIDTH = 70,
+  BTOR_API_IS_ARRAY = 71,
+  BTOR_API_GET_INDEX_WIDTH = 72,
+  BTOR_API_GET_SYMBOL_OF_VAR = 73,
+  BTOR_API_COPY = 74,
+  BTOR_API_RELEASE = 75,
+  BTOR_API_DUMP_BTOR = 76,
+  BTOR_API_DUMP_SMT = 77,
+  BTOR_API_ASSERT = 78,
+  BTOR_API_ASSUME = 79,
+  BTOR_API_SAT = 80,
+  BTOR_API_GET_STATS = 81,
+  BTOR_API_BV_ASSIGNMENT = 82,
+  BTOR_API_ARRAY_ASSIGNMENT = 83,
+  BTOR_API_SET_MEMORY_LIMIT = 84,
+  BTOR_API_ENABLE_THREAD_SAFETY = 85,
+  BTOR_API_RESTART_SAT = 86,
+  BTOR_API_NUM_OPS = 87
+};
+
+typedef enum BtorApiOp BtorApiOp;
+
+#define BTOR_API_MAX_ARGS 3
+
+typedef struct BtorApiTrace BtorApiTrace;
+typedef struct BtorApiReader BtorApiReader;
+typedef struct BtorApiCall BtorApiCall;
+
+typedef union BtorApiArg BtorApiArg;
+
+union BtorApiArg
+{
+  unsigned exp;                 /* twice the id plus one if inverted */
+  int i;
+  unsigned u;
+  const char *str;              /* owned by the reader */
+};
+
+struct BtorApiCall
+{
+  BtorApiOp op;
+  BtorApiArg args[BTOR_API_MAX_ARGS];
+};
+
+/* Name of the public function of 'op' without the 'boolector_' prefix. */
+const char *btor_name_api_op (BtorApiOp op);
+
+/* Signature of 'op' as described above. */
+const char *btor_signature_api_op (BtorApiOp op);
+
+/* Writes the header.  If 'close' is set the file is closed when the trace
+ * is deleted.
+ */
+BtorApiTrace *btor_new_api_trace (BtorMemMgr * mm, FILE * file, int close);
+
+void btor_delete_api_trace (BtorApiTrace * trace);
+
+/* Writes the operation and the arguments of a call, which follow 'op' in
+ * the order of the signature.  Does nothing if 'trace' is NULL.  Calls
+ * which may run for a long time, e.g. 'boolector_sat', are flushed
+ * immediately, such that they can be replayed even if they never return.
+ */
+void btor_trace_api (BtorApiTrace * trace, BtorApiOp op, ...);
+
+/* Write the result of the last call and return it. */
+BtorExp *btor_trace_api_exp_result (BtorApiTrace * trace, BtorExp * exp);
+
+int btor_trace_api_int_result (BtorApiTrace * trace, int result);
+
+/* Returns NULL if the file does not start with a valid header. */
+BtorApiReader *btor_new_api_reader (BtorMemMgr * mm, FILE * file);
+
+void btor_delete_api_reader (BtorApiReader * reader);
+
+/* Reads operation and arguments of the next call.  Returns 1 on success,
+ * 0 at the end of the log and -1 if the log is corrupted.  Strings are
+ * valid until the next call is read.
+ */
+int btor_read_api_call (BtorApiReader * reader, BtorApiCall * call);
+
+/* Reads the result of the last call.  Returns 0 if it is missing, which
+ * happens if the traced program did not return from the call.
+ */
+int btor_read_api_result (BtorApiReader * reader, BtorApiArg * result);
+
+#endif
@@ -0,0 +1,848 @@
+/*  Boolector: Satisfiablity Modulo Theories (SMT) solver.
+ *  Copyright (C) 2010  Robert Daniel Brummayer, Armin Biere
+ *
+ *  This file is part of Boolector.
+ *
+ *  Boolector is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Boolector is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Latency benchmark for the construction of large expression DAGs.
+ * Every single insertion into the expression unique table and into a
+ * pointer hash table is timed and the latency percentiles are reported.
+ * With '-l' an array instance is solved instead, which stresses the
+ * lemma on demand loop.  With '-e' path conditions with address
+ * arithmetic are solved with and without equality saturation and the
+ * number of AIG nodes is compared.  With '-f' families of seeded random
+ * instances generated by 'btorrand' are solved, and with '-d' all BTOR
+ * and SMT files of a directory are replayed.  In these two modes one JSON
+ * object per instance with the time spent in parsing (or generating),
+ * rewriting, synthesis, SAT solving and lemma generation is printed.
+ * With '-t' 1, 2, 4, ... threads build expressions with shared
+ * subexpressions in one thread safe instance and the throughput is
+ * reported.
+ */
+
+#include "boolector.h"
+#include "btorexp.h"
+#include "btoraig.h"
+#include "btoraigvec.h"
+#include "btorconst.h"
+#include "btorhash.h"
+#include "btoroahash.h"
+#include "btormem.h"
+#include "btorbtor.h"
+#include "btorsmt.h"
+#include "btorrand.h"
+#include "btorutil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/time.h>
+#ifdef BTOR_THREADS
+#include <pthread.h>
+#endif
+
+static const char *g_usage =
+  "usage: btorbench [<option> ...]\n"
+  "\n"
+  "  -h|--help       print this message and exit\n"
+  "  -n <num>        number of expressions (default 1000000)\n"
+  "  -w <width>      bit width of expressions (default 32)\n"
+  "  -s <seed>       random seed (default 0)\n"
+  "  -rwl<n>         rewrite level [0,3] (default 0, solver default for -f/-d)\n"
+  "  -l <num>        solve array instance with <num> reads\n"
+  "  -e <num>        solve <num> path conditions with and without ES\n"
+  "  -f <family>     solve random instances of <family>, which is one of\n"
+  "                  'bv', 'array', 'chain', 'muldiv' or 'all'\n"
+  "  -k <num>        number of random instances per family (default 10)\n"
+  "  -d <dir>        replay all '.btor' and '.smt' files in <dir>\n"
+  "  -t <threads>    build shared DAG with up to <threads> threads\n"
+  "                  (requires 'configure -threads')\n";
+
+static void
+die (const char *fmt, ...)
+{
+  va_list ap;
+  fputs ("*** btorbench: ", stdout);
+  va_start (ap, fmt);
+  vfprintf (stdout, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stdout);
+  exit (1);
+}
+
+/* wall clock time in micro seconds */
+static double
+wall_clock_usecs (void)
+{
+  struct timeval tv;
+  if (gettimeofday (&tv, 0))
+    return 0;
+  return 1e6 * tv.tv_sec + tv.tv_usec;
+}
+
+static unsigned
+next_rand (unsigned *state)
+{
+  *state = *state * 1664525u + 1013904223u;
+  return *state >> 8;
+}
+
+static int
+cmp_double (const void *p, const void *q)
+{
+  double a = *(const double *) p, b = *(const double *) q;
+  if (a < b)
+    return -1;
+  if (a > b)
+    return 1;
+  return 0;
+}
+
+static double
+percentile (double *sorted, int n, double p)
+{
+  int i;
+  i = (int) (p * (n - 1));
+  return sorted[i];
+}
+
+/* Sorts the latencies and prints one summary line. */
+static void
+report (const char *name, double *latencies, int n)
+{
+  double sum;
+  int i;
+  if (n <= 0)
+    return;
+  sum = 0;
+  for (i = 0; i < n; i++)
+    sum += latencies[i];
+  qsort (latencies, n, sizeof *latencies, cmp_double);
+  printf ("%-10s %9d insertions %9.3f seconds "
+          "(usecs p50 %.1f p99 %.1f p99.9 %.1f max %.1f)\n",
+          name, n, sum / 1e6,
+          percentile (latencies, n, 0.5),
+          percentile (latencies, n, 0.99),
+          percentile (latencies, n, 0.999), latencies[n - 1]);
+}
+
+/* Builds a random DAG by combining two previously constructed
+ * expressions with a random operator.
+ */
+static void
+bench_exp (BtorMemMgr * mm, int num, int width, int rwl, unsigned seed,
+           double *latencies)
+{
+  BtorExp **exps, *e0, *e1;
+  unsigned state;
+  int i, nvars;
+  double start;
+  Btor *btor;
+
+  btor = btor_new_btor ();
+  btor_set_rewrite_level_btor (btor, rwl);
+  BTOR_NEWN (mm, exps, num);
+  state = seed;
+
+  nvars = num < 64 ? num : 64;
+  for (i = 0; i < nvars; i++)
+    exps[i] = btor_var_exp (btor, width, "v");
+
+  for (i = nvars; i < num; i++)
+    {
+      e0 = exps[next_rand (&state) % i];
+      e1 = exps[next_rand (&state) % i];
+      if (next_rand (&state) & 1)
+        e1 = BTOR_INVERT_EXP (e1);
+      start = wall_clock_usecs ();
+      switch (next_rand (&state) % 3)
+        {
+        case 0:
+          exps[i] = btor_and_exp (btor, e0, e1);
+          break;
+        case 1:
+          exps[i] = btor_add_exp (btor, e0, e1);
+          break;
+        default:
+          exps[i] = btor_mul_exp (btor, e0, e1);
+          break;
+        }
+      latencies[i - nvars] = wall_clock_usecs () - start;
+    }
+
+  for (i = 0; i < num; i++)
+    btor_release_exp (btor, exps[i]);
+  BTOR_DELETEN (mm, exps, num);
+  btor_delete_btor (btor);
+
+  report ("exp", latencies, num - nvars);
+}
+
+static void
+bench_ptr_hash_table (BtorMemMgr * mm, int num, double *latencies)
+{
+  BtorPtrHashTable *table;
+  double start;
+  char *keys;
+  int i;
+
+  BTOR_NEWN (mm, keys, num);
+  table = btor_new_ptr_hash_table (mm, 0, 0);
+
+  for (i = 0; i < num; i++)
+    {
+      start = wall_clock_usecs ();
+      btor_insert_in_ptr_hash_table (table, keys + i);
+      latencies[i] = wall_clock_usecs () - start;
+    }
+
+  btor_delete_ptr_hash_table (table);
+  BTOR_DELETEN (mm, keys, num);
+
+  report ("ptr hash", latencies, num);
+}
+
+static void
+bench_oa_ptr_hash_table (BtorMemMgr * mm, int num, double *latencies)
+{
+  BtorOAPtrHashTable *table;
+  double start;
+  char *keys;
+  int i;
+
+  BTOR_NEWN (mm, keys, num);
+  table = btor_new_oa_ptr_hash_table (mm, 0, 0);
+
+  for (i = 0; i < num; i++)
+    {
+      start = wall_clock_usecs ();
+      btor_insert_in_oa_ptr_hash_table (table, keys + i);
+      latencies[i] = wall_clock_usecs () - start;
+    }
+
+  btor_delete_oa_ptr_hash_table (table);
+  BTOR_DELETEN (mm, keys, num);
+
+  report ("oa hash", latencies, num);
+}
+
+/* Reads from a chain of writes, many of which have to be different, such
+ * that the lemma on demand loop has to separate the read indices.
+ */
+static void
+bench_lod (BtorMemMgr * mm, int num, int rwl, unsigned seed)
+{
+  BtorExp *array, *tmp, *ne, **indices, **reads;
+  double start, delta;
+  unsigned state;
+  Btor *btor;
+  int i, j, res;
+
+  btor = btor_new_btor ();
+  btor_set_rewrite_level_btor (btor, rwl);
+  BTOR_NEWN (mm, indices, num);
+  BTOR_NEWN (mm, reads, num);
+  state = seed;
+
+  array = btor_array_exp (btor, 16, 16, "a");
+  for (i = 0; i < num / 4; i++)
+    {
+      indices[i] = btor_var_exp (btor, 16, "j");
+      reads[i] = btor_var_exp (btor, 16, "v");
+      tmp = btor_write_exp (btor, array, indices[i], reads[i]);
+      btor_release_exp (btor, array);
+      btor_release_exp (btor, indices[i]);
+      btor_release_exp (btor, reads[i]);
+      array = tmp;
+    }
+
+  for (i = 0; i < num; i++)
+    {
+      indices[i] = btor_var_exp (btor, 16, "i");
+      reads[i] = btor_read_exp (btor, array, indices[i]);
+    }
+
+  for (i = 1; i < num; i++)
+    {
+      j = next_rand (&state) % i;
+      ne = btor_ne_exp (btor, reads[i], reads[j]);
+      btor_add_constraint_exp (btor, ne);
+      btor_release_exp (btor, ne);
+    }
+
+  start = wall_clock_usecs ();
+  res = btor_sat_btor (btor);
+  delta = wall_clock_usecs () - start;
+
+  printf ("lod        %9d reads      %9.3f seconds "
+          "(%s, %d refinements, %d lemmas)\n",
+          num, delta / 1e6, res == BTOR_SAT ? "sat" : "unsat",
+          btor->stats.lod_refinements,
+          btor->stats.array_axiom_1_conflicts +
+          btor->stats.array_axiom_2_conflicts);
+
+  for (i = 0; i < num; i++)
+    {
+      btor_release_exp (btor, reads[i]);
+      btor_release_exp (btor, indices[i]);
+    }
+  btor_release_exp (btor, array);
+  BTOR_DELETEN (mm, reads, num);
+  BTOR_DELETEN (mm, indices, num);
+  btor_delete_btor (btor);
+}
+
+static BtorExp *
+unsigned_exp (Btor * btor, unsigned x, int width)
+{
+  BtorExp *result;
+  char *bits;
+  bits = btor_unsigned_to_const (btor->mm, x, width);
+  result = btor_const_exp (btor, bits);
+  btor_delete_const (btor->mm, bits);
+  return result;
+}
+
+static BtorExp *
+binary_exp (Btor * btor, BtorExp * (*op) (Btor *, BtorExp *, BtorExp *),
+            BtorExp * e0, BtorExp * e1)
+{
+  BtorExp *result;
+  result = op (btor, e0, e1);
+  btor_release_exp (btor, e0);
+  btor_release_exp (btor, e1);
+  return result;
+}
+
+/* Path conditions over address arithmetic as emitted by compilers,
+ * e.g. '(a * c1 + b) << 2) - ((a * c1) << 2)' for the offset of
+ * 'x[a][b] - x[a][0]' with row size 'c1'.
+ */
+static void
+solve_paths (int num, int width, int rwl, unsigned seed, int es)
+{
+  BtorExp *vars[8], *a, *b, *t1, *t2, *off, *cond, *two;
+  double start, delta;
+  unsigned state, c1, c2, bound;
+  BtorAIGMgr *amgr;
+  Btor *btor;
+  int i, res, log_width;
+
+  btor = btor_new_btor ();
+  btor_set_rewrite_level_btor (btor, rwl);
+  if (es)
+    btor_enable_eqsat (btor);
+  state = seed;
+
+  for (log_width = 0; (1 << log_width) < width; log_width++)
+    ;
+  two = unsigned_exp (btor, 2, log_width);
+  for (i = 0; i < 8; i++)
+    vars[i] = btor_var_exp (btor, width, "v");
+
+  for (i = 0; i < num; i++)
+    {
+      a = vars[next_rand (&state) % 8];
+      b = vars[next_rand (&state) % 8];
+      c1 = next_rand (&state) % 16 + 3;
+      c2 = next_rand (&state) % 16 + 3;
+      bound = next_rand (&state) % 1000 + 1000;
+
+      t1 = binary_exp (btor, btor_mul_exp, btor_copy_exp (btor, a),
+                       unsigned_exp (btor, c1, width));
+      t2 = btor_add_exp (btor, t1, b);
+      t2 = binary_exp (btor, btor_sll_exp, t2, btor_copy_exp (btor, two));
+      t1 = binary_exp (btor, btor_sll_exp, t1, btor_copy_exp (btor, two));
+      off = binary_exp (btor, btor_sub_exp, t2, t1);
+      off = binary_exp (btor, btor_add_exp, off,
+                        binary_exp (btor, btor_mul_exp,
+                                    btor_copy_exp (btor, b),
+                                    unsigned_exp (btor, c2, width)));
+      cond = binary_exp (btor, btor_ult_exp, off,
+                         unsigned_exp (btor, bound, width));
+      btor_add_constraint_exp (btor, cond);
+      btor_release_exp (btor, cond);
+    }
+
+  start = wall_clock_usecs ();
+  res = btor_sat_btor (btor);
+  delta = wall_clock_usecs () - start;
+  amgr = btor_get_aig_mgr_aigvec_mgr (btor->avmgr);
+
+  printf ("%-10s %9d paths      %9.3f seconds (%s, %d AIG ands)\n",
+          es ? "es" : "no es", num, delta / 1e6,
+          res == BTOR_SAT ? "sat" : "unsat", btor_num_ands_aig_mgr (amgr));
+
+  for (i = 0; i < 8; i++)
+    btor_release_exp (btor, vars[i]);
+  btor_release_exp (btor, two);
+  btor_delete_btor (btor);
+}
+
+/* Random instance families.  The parameters are chosen such that a
+ * single instance is solved within a second or so.
+ */
+static struct
+{
+  const char *name;
+  BtorRandExpParams params;
+} g_families[] = {
+  /* name     cons vars arrs terms preds forms {data addr} lin eqs write */
+  {"bv",     {4,   8,   0,   60,   10,   10,   {32,  0},   0,  0,  0}},
+  {"array",  {4,   8,   2,   60,   10,   10,   {32,  8},   0,  0,  1}},
+  {"chain",  {2,   16,  1,   200,  8,    4,    {32,  8},   1,  0,  1}},
+  {"muldiv", {2,   6,   0,   12,   4,    2,    {64,  0},   0,  0,  0}},
+};
+
+#define NUM_FAMILIES ((int) (sizeof g_families / sizeof g_families[0]))
+
+static void
+print_json_string (const char *str)
+{
+  const char *p;
+  putchar ('"');
+  for (p = str; *p; p++)
+    {
+      if (*p == '"' || *p == '\\')
+        printf ("\\%c", *p);
+      else if ((unsigned char) *p < 0x20)
+        printf ("\\u%04x", *p);
+      else
+        putchar (*p);
+    }
+  putchar ('"');
+}
+
+/* Prints the time breakdown of one solved instance as JSON object. */
+static void
+print_json_result (const char *name, Btor * btor, int res, double parse,
+                   double total)
+{
+  fputs ("{\"name\": ", stdout);
+  print_json_string (name);
+  printf (", \"result\": \"%s\", ",
+          res == BTOR_SAT ? "sat" : res == BTOR_UNSAT ? "unsat" : "unknown");
+  printf ("\"time\": {\"parse\": %.3f, \"rewrite\": %.3f, "
+          "\"synthesis\": %.3f, \"sat\": %.3f, \"lemmas\": %.3f, "
+          "\"solve\": %.3f, \"total\": %.3f}, ",
+          parse, btor->time.rewrite, btor->time.synthesis,
+          btor->time.sat, btor->time.lemmas, btor->time.solve, total);
+  printf ("\"refinements\": %d, \"lemma_cache_hits\": %d, "
+          "\"ands\": %d}\n",
+          btor->stats.lod_refinements, btor->stats.lemma_cache_hits,
+          btor_num_ands_aig_mgr (btor_get_aig_mgr_aigvec_mgr (btor->avmgr)));
+  fflush (stdout);
+}
+
+static void
+print_json_error (const char *name, const char *msg)
+{
+  fputs ("{\"name\": ", stdout);
+  print_json_string (name);
+  fputs (", \"error\": ", stdout);
+  print_json_string (msg);
+  fputs ("}\n", stdout);
+  fflush (stdout);
+}
+
+static void
+solve_family (BtorMemMgr * mm, int family, int num, int rwl, unsigned seed)
+{
+  double start, parse;
+  BtorExp *formula;
+  char name[64];
+  BtorRand *rand;
+  Btor *btor;
+  int i, res;
+
+  for (i = 0; i < num; i++)
+    {
+      start = btor_monotonic_time_stamp ();
+      btor = btor_new_btor ();
+      if (rwl >= 0)
+        btor_set_rewrite_level_btor (btor, rwl);
+      rand = btor_new_rand (mm, seed + i);
+      formula = btor_new_rand_exp (btor, rand, &g_families[family].params);
+      btor_delete_rand (mm, rand);
+      btor_add_constraint_exp (btor, formula);
+      btor_release_exp (btor, formula);
+      parse = btor_monotonic_time_stamp () - start;
+
+      res = btor_sat_btor (btor);
+
+      sprintf (name, "%s/%u", g_families[family].name, seed + i);
+      print_json_result (name, btor, res, parse,
+                         btor_monotonic_time_stamp () - start);
+      btor_delete_btor (btor);
+    }
+}
+
+static int
+has_suffix (const char *str, const char *suffix)
+{
+  size_t len, suffix_len;
+  len = strlen (str);
+  suffix_len = strlen (suffix);
+  return len >= suffix_len && !strcmp (str + len - suffix_len, suffix);
+}
+
+static int
+cmp_string (const void *p, const void *q)
+{
+  return strcmp (*(char *const *) p, *(char *const *) q);
+}
+
+/* Parses and solves one recorded query the same way as 'boolector' does
+ * without further options.
+ */
+static void
+replay_file (const char *path, int rwl)
+{
+  const BtorParserAPI *parser_api;
+  BtorParseResult parse_res;
+  BtorParser *parser;
+  double start, parse;
+  BtorExp *root;
+  char *error;
+  FILE *file;
+  Btor *btor;
+  int i, res;
+
+  file = fopen (path, "r");
+  if (!file)
+    {
+      print_json_error (path, "can not read file");
+      return;
+    }
+
+  start = btor_monotonic_time_stamp ();
+  btor = btor_new_btor ();
+  if (rwl >= 0)
+    btor_set_rewrite_level_btor (btor, rwl);
+
+  if (has_suffix (path, ".smt"))
+    parser_api = btor_smt_parser_api ();
+  else
+    parser_api = btor_btor_parser_api ();
+
+  parser = parser_api->init (btor, 0);
+  error = parser_api->parse (parser, file, path, &parse_res);
+  fclose (file);
+
+  if (error)
+    print_json_error (path, error);
+  else if (parse_res.nregs)
+    print_json_error (path, "sequential models are not supported");
+  else
+    {
+      for (i = 0; i < parse_res.noutputs; i++)
+        {
+          root = parse_res.outputs[i];
+          if (btor_get_exp_len (btor, root) > 1)
+            root = btor_redor_exp (btor, root);
+          else
+            root = btor_copy_exp (btor, root);
+          btor_add_constraint_exp (btor, root);
+          btor_release_exp (btor, root);
+        }
+    }
+
+  parser_api->reset (parser);
+
+  if (!error && !parse_res.nregs)
+    {
+      parse = btor_monotonic_time_stamp () - start;
+      res = btor_sat_btor (btor);
+      print_json_result (path, btor, res, parse,
+                         btor_monotonic_time_stamp () - start);
+    }
+
+  btor_delete_btor (btor);
+}
+
+static void
+replay_dir (BtorMemMgr * mm, const char *dir_name, int rwl)
+{
+  BtorCharPtrStack paths;
+  struct dirent *entry;
+  char *path;
+  DIR *dir;
+  int i, len;
+
+  dir = opendir (dir_name);
+  if (!dir)
+    die ("can not open directory '%s'", dir_name);
+
+  BTOR_INIT_STACK (paths);
+  while ((entry = readdir (dir)))
+    {
+      if (!has_suffix (entry->d_name, ".btor")
+          && !has_suffix (entry->d_name, ".smt"))
+        continue;
+      len = strlen (dir_name) + strlen (entry->d_name) + 2;
+      BTOR_NEWN (mm, path, len);
+      sprintf (path, "%s/%s", dir_name, entry->d_name);
+      BTOR_PUSH_STACK (mm, paths, path);
+    }
+  closedir (dir);
+
+  /* replay in a deterministic order */
+  qsort (paths.start, BTOR_COUNT_STACK (paths), sizeof (char *), cmp_string);
+
+  for (i = 0; i < BTOR_COUNT_STACK (paths); i++)
+    {
+      path = paths.start[i];
+      replay_file (path, rwl);
+      BTOR_DELETEN (mm, path, strlen (path) + 1);
+    }
+  BTOR_RELEASE_STACK (mm, paths);
+}
+
+#ifdef BTOR_THREADS
+
+#define NUM_SHARED_VARS 8
+
+typedef struct SharedDAGWorker SharedDAGWorker;
+
+struct SharedDAGWorker
+{
+  Btor *btor;
+  BtorExp **vars;
+  int num;
+  int width;
+  unsigned seed;
+};
+
+/* Every worker combines the same few variables with small constants.
+ * Hence most expressions built by one thread are also built by the
+ * others and are found in the unique table of the shared instance.
+ */
+static void *
+build_shared_dag (void *arg)
+{
+  SharedDAGWorker *worker = arg;
+  BtorExp *a, *b, *c, *sum, *prod;
+  Btor *btor = worker->btor;
+  unsigned state;
+  int i;
+
+  state = worker->seed;
+  for (i = 0; i < worker->num; i++)
+    {
+      a = worker->vars[next_rand (&state) % NUM_SHARED_VARS];
+      b = worker->vars[next_rand (&state) % NUM_SHARED_VARS];
+      c = boolector_unsigned_int (btor, next_rand (&state) % 256,
+                                  worker->width);
+      sum = boolector_add (btor, a, c);
+      prod = boolector_mul (btor, sum, b);
+      boolector_release (btor, prod);
+      boolector_release (btor, sum);
+      boolector_release (btor, c);
+    }
+  return 0;
+}
+
+static void
+bench_threads (BtorMemMgr * mm, int max_threads, int num, int width,
+               int rwl, unsigned seed)
+{
+  BtorExp *vars[NUM_SHARED_VARS];
+  SharedDAGWorker *workers;
+  pthread_t *threads;
+  double start, delta;
+  int i, num_threads;
+  Btor *btor;
+
+  BTOR_NEWN (mm, workers, max_threads);
+  BTOR_NEWN (mm, threads, max_threads);
+
+  for (num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+      btor = boolector_new ();
+      boolector_enable_thread_safety (btor);
+      boolector_set_rewrite_level (btor, rwl);
+      for (i = 0; i < NUM_SHARED_VARS; i++)
+        vars[i] = boolector_var (btor, width, "v");
+
+      for (i = 0; i < num_threads; i++)
+        {
+          workers[i].btor = btor;
+          workers[i].vars = vars;
+          workers[i].num = num / num_threads;
+          workers[i].width = width;
+          workers[i].seed = seed + (unsigned) i;
+        }
+
+      start = wall_clock_usecs ();
+      for (i = 0; i < num_threads; i++)
+        if (pthread_create (threads + i, 0, build_shared_dag, workers + i))
+          die ("can not create thread");
+      for (i = 0; i < num_threads; i++)
+        pthread_join (threads[i], 0);
+      delta = wall_clock_usecs () - start;
+
+      printf ("%2d threads %9d expressions %9.3f seconds "
+              "(%.0f expressions per second)\n",
+              num_threads, 2 * num_threads * (num / num_threads),
+              delta / 1e6,
+              delta > 0 ? 2e6 * num_threads * (num / num_threads) / delta : 0);
+
+      for (i = 0; i < NUM_SHARED_VARS; i++)
+        boolector_release (btor, vars[i]);
+      boolector_delete (btor);
+    }
+
+  BTOR_DELETEN (mm, threads, max_threads);
+  BTOR_DELETEN (mm, workers, max_threads);
+}
+
+#endif
+
+int
+main (int argc, char **argv)
+{
+  int i, num, width, rwl, lod, paths, family, instances, threads;
+  const char *family_name, *dir_name;
+  double *latencies;
+  BtorMemMgr *mm;
+  unsigned seed;
+
+  num = 1000000;
+  width = 32;
+  seed = 0;
+  rwl = -1;
+  lod = 0;
+  paths = 0;
+  family_name = 0;
+  dir_name = 0;
+  instances = 10;
+  threads = 0;
+
+  for (i = 1; i < argc; i++)
+    {
+      if (!strcmp (argv[i], "-h") || !strcmp (argv[i], "--help"))
+        {
+          fputs (g_usage, stdout);
+          exit (0);
+        }
+      else if (!strcmp (argv[i], "-n") && i + 1 < argc)
+        num = atoi (argv[++i]);
+      else if (!strcmp (argv[i], "-w") && i + 1 < argc)
+        width = atoi (argv[++i]);
+      else if (!strcmp (argv[i], "-s") && i + 1 < argc)
+        seed = (unsigned) atoi (argv[++i]);
+      else if (!strcmp (argv[i], "-l") && i + 1 < argc)
+        lod = atoi (argv[++i]);
+      else if (!strcmp (argv[i], "-e") && i + 1 < argc)
+        paths = atoi (argv[++i]);
+      else if (!strcmp (argv[i], "-f") && i + 1 < argc)
+        family_name = argv[++i];
+      else if (!strcmp (argv[i], "-k") && i + 1 < argc)
+        instances = atoi (argv[++i]);
+      else if (!strcmp (argv[i], "-d") && i + 1 < argc)
+        dir_name = argv[++i];
+      else if (!strcmp (argv[i], "-t") && i + 1 < argc)
+        threads = atoi (argv[++i]);
+      else if (!strncmp (argv[i], "-rwl", 4))
+        rwl = atoi (argv[i] + 4);
+      else
+        die ("invalid command line option '%s' (try '-h')", argv[i]);
+    }
+
+  if (num <= 0)
+    die ("number of expressions has to be positive");
+  if (width <= 0)
+    die ("bit width has to be positive");
+  if (rwl != -1 && (rwl < 0 || rwl > 3))
+    die ("rewrite level has to be in [0,3]");
+  if (lod < 0)
+    die ("number of reads has to be positive");
+  if (paths < 0)
+    die ("number of path conditions has to be positive");
+  if (instances <= 0)
+    die ("number of instances has to be positive");
+  if (threads < 0)
+    die ("number of threads has to be positive");
+#ifndef BTOR_THREADS
+  if (threads)
+    die ("compiled without thread support (configure -threads)");
+#endif
+
+  family = -1;
+  if (family_name && strcmp (family_name, "all"))
+    {
+      for (family = 0; family < NUM_FAMILIES; family++)
+        if (!strcmp (family_name, g_families[family].name))
+          break;
+      if (family == NUM_FAMILIES)
+        die ("unknown family '%s' (try '-h')", family_name);
+    }
+
+  mm = btor_new_mem_mgr ();
+
+  if (family_name || dir_name)
+    {
+      if (family_name && family >= 0)
+        solve_family (mm, family, instances, rwl, seed);
+      else if (family_name)
+        for (family = 0; family < NUM_FAMILIES; family++)
+          solve_family (mm, family, instances, rwl, seed);
+      if (dir_name)
+        replay_dir (mm, dir_name, rwl);
+      btor_delete_mem_mgr (mm);
+      return 0;
+    }
+
+  if (rwl < 0)
+    rwl = 0;
+
+  if (lod)
+    {
+      bench_lod (mm, lod, rwl, seed);
+      btor_delete_mem_mgr (mm);
+      return 0;
+    }
+
+#ifdef BTOR_THREADS
+  if (threads)
+    {
+      bench_threads (mm, threads, num, width, rwl, seed);
+      btor_delete_mem_mgr (mm);
+      return 0;
+    }
+#endif
+
+  if (paths)
+    {
+      /* equality saturation needs rewrite level 2 */
+      solve_paths (paths, width, rwl > 1 ? rwl : 2, seed, 0);
+      solve_paths (paths, width, rwl > 1 ? rwl : 2, seed, 1);
+      btor_delete_mem_mgr (mm);
+      return 0;
+    }
+
+  BTOR_NEWN (mm, latencies, num);
+
+  bench_exp (mm, num, width, rwl, seed, latencies);
+  bench_ptr_hash_table (mm, num, latencies);
+  bench_oa_ptr_hash_table (mm, num, latencies);
+
+  BTOR_DELETEN (mm, latencies, num);
+  btor_delete_mem_mgr (mm);
+  return 0;
+}
@@ -23,6 +23,7 @@
 #include "btorconst.h"
 #include "btorparse.h"
 #include "btorutil.h"
+#include "btortrace.h"
 
 #include <assert.h>
 #include <string.h>
@@ -158,7 +159,12 @@ btor_nextch_btor (BtorBTORParser * parser)
       parser->saved = 0;
     }
   else
-    ch = getc (parser->file);
+    {
+      ch = getc (parser->file);
+      if (ch == '\n' && !((parser->lineno + 1) % BTOR_TRACE_PARSE_CHUNK))
+        BTOR_TRACE_INSTANT ("parse chunk", "lines", parser->lineno + 1,
+                            NULL, 0);
+    }
 
   if (ch == '\n')
     parser->lineno++;
@@ -1692,7 +1698,7 @@ find_parser (BtorBTORParser * parser, const char *op)
 static BtorBTORParser *
 btor_new_btor_parser (Btor * btor, int verbosity)
 {
-  BtorMemMgr *mem = btor->mm;
+  BtorMemMgr *mem = BTOR_VIEW_MEM_MGR (btor->mm, BTOR_MEM_PARSER);
   BtorBTORParser *res;
 
   assert (verbosity >= -1);
@@ -1834,9 +1840,8 @@ remove_regs_from_vars (BtorBTORParser * parser)
 }
 
 static const char *
-btor_parse_btor_parser (BtorBTORParser * parser,
-		        FILE * file, const char *name,
-		        BtorParseResult * res)
+parse_btor_parser (BtorBTORParser * parser,
+                   FILE * file, const char *name, BtorParseResult * res)
 {
   BtorOpParser op_parser;
   int ch, len;
@@ -1974,6 +1979,18 @@ SKIP:
   goto NEXT;
 }
 
+static const char *
+btor_parse_btor_parser (BtorBTORParser * parser,
+		        FILE * file, const char *name,
+		        BtorParseResult * res)
+{
+  const char *err;
+  BTOR_TRACE_BEGIN ("parse");
+  err = parse_btor_parser (parser, file, name, res);
+  BTOR_TRACE_END ("parse", "lines", parser->lineno, NULL, 0);
+  return err;
+}
+
 static BtorParserAPI static_btor_btor_parser_api =
 {
   (BtorInitParser) btor_new_btor_parser,
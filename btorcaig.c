@@ -0,0 +1,625 @@
+/*  Boolector: Satisfiablity Modulo Theories (SMT) solver.
+ *  Copyright (C) 2010  Robert Daniel Brummayer, Armin Biere
+ *
+ *  This file is part of Boolector.
+ *
+ *  Boolector is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Boolector is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "btorcaig.h"
+#include "btorutil.h"
+#include "btorsat.h"
+#include "btorhash.h"
+#include "btorexit.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <limits.h>
+
+
+/*------------------------------------------------------------------------*/
+/* BEGIN OF DECLARATIONS                                                  */
+/*------------------------------------------------------------------------*/
+
+#define BTOR_ABORT_CAIG(cond,msg) \
+  do { \
+    if (cond) \
+      { \
+        fputs ("[btorcaig] " msg "\n", stdout); \
+        exit (BTOR_ERR_EXIT); \
+      } \
+  } while (0)
+
+#define BTOR_CAIG_UNIQUE_TABLE_LIMIT 30
+#define BTOR_CAIG_UNIQUE_TABLE_PRIME 2000000137u
+
+/* literals are 32 bit, thus indices are restricted to 31 bit */
+#define BTOR_CAIG_MAX_NODES (1u << 31)
+
+/* 8 bytes per node, variables have two FALSE children */
+struct BtorCAIGNode
+{
+  BtorCAIG children[2];
+};
+
+typedef struct BtorCAIGNode BtorCAIGNode;
+
+struct BtorCAIGMgr
+{
+  BtorMemMgr *mm;
+  int verbosity;
+  BtorSATMgr *smgr;
+  /* node array and side arrays, all of 'size' elements */
+  BtorCAIGNode *nodes;
+  unsigned int *next;           /* unique table chains */
+  int *cnf_ids;
+  unsigned char *marks;
+  unsigned int size;
+  unsigned int num_nodes;       /* including the constant at index 0 */
+  /* unique table of AND nodes, 0 terminates chains */
+  unsigned int *chains;
+  unsigned int table_size;
+  unsigned int num_ands;
+};
+
+#define BTOR_IS_VAR_CAIG_NODE(cmgr,idx) \
+  ((cmgr)->nodes[idx].children[0] == BTOR_CAIG_FALSE)
+
+#define BTOR_GET_CNF_ID_CAIG(cmgr,lit) \
+  (BTOR_IS_INVERTED_CAIG (lit) ? \
+     -(cmgr)->cnf_ids[BTOR_INDEX_CAIG (lit)] : \
+     (cmgr)->cnf_ids[BTOR_INDEX_CAIG (lit)])
+
+/*------------------------------------------------------------------------*/
+/* END OF DECLARATIONS                                                    */
+/*------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------*/
+/* BEGIN OF IMPLEMENTATION                                                */
+/*------------------------------------------------------------------------*/
+
+static unsigned int
+hash_caig (BtorCAIG left, BtorCAIG right, unsigned int table_size)
+{
+  assert (table_size > 0u);
+  assert (btor_is_power_of_2_util ((int) table_size));
+  return ((left + right) * BTOR_CAIG_UNIQUE_TABLE_PRIME) & (table_size - 1);
+}
+
+static void
+enlarge_nodes_caig (BtorCAIGMgr * cmgr)
+{
+  BtorMemMgr *mm;
+  unsigned int new_size;
+  assert (cmgr != NULL);
+  assert (cmgr->num_nodes == cmgr->size);
+  BTOR_ABORT_CAIG (cmgr->size == BTOR_CAIG_MAX_NODES,
+                   "compact AIG index overflow");
+  mm = BTOR_VIEW_MEM_MGR (cmgr->mm, BTOR_MEM_AIG);
+  new_size = cmgr->size << 1;
+  BTOR_REALLOC (mm, cmgr->nodes, cmgr->size, new_size);
+  BTOR_REALLOC (mm, cmgr->next, cmgr->size, new_size);
+  BTOR_REALLOC (mm, cmgr->cnf_ids, cmgr->size, new_size);
+  BTOR_REALLOC (mm, cmgr->marks, cmgr->size, new_size);
+  cmgr->size = new_size;
+}
+
+static void
+rehash_caig (BtorCAIGMgr * cmgr, unsigned int new_table_size)
+{
+  unsigned int idx, hash;
+  BtorCAIGNode *node;
+  BtorMemMgr *mm;
+  assert (cmgr != NULL);
+  mm = BTOR_VIEW_MEM_MGR (cmgr->mm, BTOR_MEM_AIG);
+  BTOR_DELETEN (mm, cmgr->chains, cmgr->table_size);
+  BTOR_CNEWN (mm, cmgr->chains, new_table_size);
+  cmgr->table_size = new_table_size;
+  for (idx = 1; idx < cmgr->num_nodes; idx++)
+    {
+      if (BTOR_IS_VAR_CAIG_NODE (cmgr, idx))
+        continue;
+      node = cmgr->nodes + idx;
+      hash = hash_caig (node->children[0], node->children[1], new_table_size);
+      cmgr->next[idx] = cmgr->chains[hash];
+      cmgr->chains[hash] = idx;
+    }
+}
+
+static unsigned int
+new_node_caig (BtorCAIGMgr * cmgr, BtorCAIG left, BtorCAIG right)
+{
+  unsigned int idx;
+  assert (cmgr != NULL);
+  if (cmgr->num_nodes == cmgr->size)
+    enlarge_nodes_caig (cmgr);
+  idx = cmgr->num_nodes++;
+  cmgr->nodes[idx].children[0] = left;
+  cmgr->nodes[idx].children[1] = right;
+  cmgr->next[idx] = 0u;
+  cmgr->cnf_ids[idx] = 0;
+  cmgr->marks[idx] = 0;
+  return idx;
+}
+
+BtorCAIGMgr *
+btor_new_caig_mgr (BtorMemMgr * mm)
+{
+  BtorCAIGMgr *cmgr;
+  BtorMemMgr *amm;
+  assert (mm != NULL);
+  amm = BTOR_VIEW_MEM_MGR (mm, BTOR_MEM_AIG);
+  BTOR_CNEW (amm, cmgr);
+  cmgr->mm = mm;
+  cmgr->smgr = btor_new_sat_mgr (mm);
+  cmgr->size = 1u;
+  BTOR_NEWN (amm, cmgr->nodes, 1);
+  BTOR_NEWN (amm, cmgr->next, 1);
+  BTOR_NEWN (amm, cmgr->cnf_ids, 1);
+  BTOR_NEWN (amm, cmgr->marks, 1);
+  /* the constant */
+  (void) new_node_caig (cmgr, BTOR_CAIG_FALSE, BTOR_CAIG_FALSE);
+  cmgr->table_size = 1u;
+  BTOR_CNEWN (amm, cmgr->chains, 1);
+  return cmgr;
+}
+
+void
+btor_set_verbosity_caig_mgr (BtorCAIGMgr * cmgr, int verbosity)
+{
+  assert (cmgr != NULL);
+  assert (verbosity >= -1 && verbosity <= 3);
+  cmgr->verbosity = verbosity;
+}
+
+BtorSATMgr *
+btor_get_sat_mgr_caig_mgr (const BtorCAIGMgr * cmgr)
+{
+  assert (cmgr != NULL);
+  return cmgr->smgr;
+}
+
+void
+btor_delete_caig_mgr (BtorCAIGMgr * cmgr)
+{
+  BtorMemMgr *mm;
+  assert (cmgr != NULL);
+  mm = BTOR_VIEW_MEM_MGR (cmgr->mm, BTOR_MEM_AIG);
+  BTOR_DELETEN (mm, cmgr->nodes, cmgr->size);
+  BTOR_DELETEN (mm, cmgr->next, cmgr->size);
+  BTOR_DELETEN (mm, cmgr->cnf_ids, cmgr->size);
+  BTOR_DELETEN (mm, cmgr->marks, cmgr->size);
+  BTOR_DELETEN (mm, cmgr->chains, cmgr->table_size);
+  btor_delete_sat_mgr (cmgr->smgr);
+  BTOR_DELETE (mm, cmgr);
+}
+
+int
+btor_num_nodes_caig_mgr (const BtorCAIGMgr * cmgr)
+{
+  assert (cmgr != NULL);
+  return (int) cmgr->num_nodes - 1;
+}
+
+BtorCAIG
+btor_var_caig (BtorCAIGMgr * cmgr)
+{
+  assert (cmgr != NULL);
+  return 2u * new_node_caig (cmgr, BTOR_CAIG_FALSE, BTOR_CAIG_FALSE);
+}
+
+BtorCAIG
+btor_and_caig (BtorCAIGMgr * cmgr, BtorCAIG left, BtorCAIG right)
+{
+  unsigned int idx, hash;
+  BtorCAIGNode *node;
+  BtorCAIG tmp;
+
+  assert (cmgr != NULL);
+  assert (BTOR_INDEX_CAIG (left) < cmgr->num_nodes);
+  assert (BTOR_INDEX_CAIG (right) < cmgr->num_nodes);
+
+  if (left == BTOR_CAIG_FALSE || right == BTOR_CAIG_FALSE)
+    return BTOR_CAIG_FALSE;
+  if (left == BTOR_CAIG_TRUE)
+    return right;
+  if (right == BTOR_CAIG_TRUE)
+    return left;
+  if (left == right)
+    return left;
+  if (left == BTOR_INVERT_CAIG (right))
+    return BTOR_CAIG_FALSE;
+
+  if (right < left)
+    {
+      tmp = left;
+      left = right;
+      right = tmp;
+    }
+
+  hash = hash_caig (left, right, cmgr->table_size);
+  for (idx = cmgr->chains[hash]; idx; idx = cmgr->next[idx])
+    {
+      node = cmgr->nodes + idx;
+      if (node->children[0] == left && node->children[1] == right)
+        return 2u * idx;
+    }
+
+  if (cmgr->num_ands >= cmgr->table_size &&
+      cmgr->table_size < (1u << BTOR_CAIG_UNIQUE_TABLE_LIMIT))
+    {
+      rehash_caig (cmgr, cmgr->table_size << 1);
+      hash = hash_caig (left, right, cmgr->table_size);
+    }
+
+  idx = new_node_caig (cmgr, left, right);
+  cmgr->next[idx] = cmgr->chains[hash];
+  cmgr->chains[hash] = idx;
+  cmgr->num_ands++;
+  return 2u * idx;
+}
+
+BtorCAIG
+btor_or_caig (BtorCAIGMgr * cmgr, BtorCAIG left, BtorCAIG right)
+{
+  assert (cmgr != NULL);
+  return BTOR_INVERT_CAIG (btor_and_caig (cmgr, BTOR_INVERT_CAIG (left),
+                                          BTOR_INVERT_CAIG (right)));
+}
+
+BtorCAIG
+btor_eq_caig (BtorCAIGMgr * cmgr, BtorCAIG left, BtorCAIG right)
+{
+  BtorCAIG eq_left, eq_right;
+  assert (cmgr != NULL);
+  eq_left = BTOR_INVERT_CAIG (btor_and_caig (cmgr, left,
+                                             BTOR_INVERT_CAIG (right)));
+  eq_right = BTOR_INVERT_CAIG (btor_and_caig (cmgr,
+                                              BTOR_INVERT_CAIG (left), right));
+  return btor_and_caig (cmgr, eq_left, eq_right);
+}
+
+BtorCAIG
+btor_xor_caig (BtorCAIGMgr * cmgr, BtorCAIG left, BtorCAIG right)
+{
+  assert (cmgr != NULL);
+  return BTOR_INVERT_CAIG (btor_eq_caig (cmgr, left, right));
+}
+
+BtorCAIG
+btor_cond_caig (BtorCAIGMgr * cmgr, BtorCAIG lit_cond, BtorCAIG lit_if,
+                BtorCAIG lit_else)
+{
+  BtorCAIG and1, and2;
+  assert (cmgr != NULL);
+  and1 = btor_and_caig (cmgr, lit_if, lit_cond);
+  and2 = btor_and_caig (cmgr, lit_else, BTOR_INVERT_CAIG (lit_cond));
+  return btor_or_caig (cmgr, and1, and2);
+}
+
+int
+btor_is_var_caig (const BtorCAIGMgr * cmgr, BtorCAIG lit)
+{
+  assert (cmgr != NULL);
+  assert (!BTOR_IS_CONST_CAIG (lit));
+  assert (BTOR_INDEX_CAIG (lit) < cmgr->num_nodes);
+  return BTOR_IS_VAR_CAIG_NODE (cmgr, BTOR_INDEX_CAIG (lit));
+}
+
+BtorCAIG
+btor_left_child_caig (const BtorCAIGMgr * cmgr, BtorCAIG lit)
+{
+  assert (cmgr != NULL);
+  assert (!btor_is_var_caig (cmgr, lit));
+  return cmgr->nodes[BTOR_INDEX_CAIG (lit)].children[0];
+}
+
+BtorCAIG
+btor_right_child_caig (const BtorCAIGMgr * cmgr, BtorCAIG lit)
+{
+  assert (cmgr != NULL);
+  assert (!btor_is_var_caig (cmgr, lit));
+  return cmgr->nodes[BTOR_INDEX_CAIG (lit)].children[1];
+}
+
+BtorCAIG
+btor_import_aig_caig (BtorCAIGMgr * cmgr, BtorPtrHashTable * table,
+                      BtorAIG * aig)
+{
+  BtorPtrHashBucket *b, *b_left, *b_right;
+  BtorAIG *cur, *left, *right;
+  BtorAIGPtrStack stack;
+  BtorCAIG result;
+  BtorMemMgr *mm;
+
+  assert (cmgr != NULL);
+  assert (table != NULL);
+
+  if (aig == BTOR_AIG_FALSE)
+    return BTOR_CAIG_FALSE;
+  if (aig == BTOR_AIG_TRUE)
+    return BTOR_CAIG_TRUE;
+
+  mm = cmgr->mm;
+  BTOR_INIT_STACK (stack);
+  BTOR_PUSH_STACK (mm, stack, BTOR_REAL_ADDR_AIG (aig));
+  while (!BTOR_EMPTY_STACK (stack))
+    {
+      cur = BTOR_POP_STACK (stack);
+      if (btor_find_in_ptr_hash_table (table, cur))
+        continue;
+      if (BTOR_IS_VAR_AIG (cur))
+        {
+          b = btor_insert_in_ptr_hash_table (table, cur);
+          b->data.asInt = (int) btor_var_caig (cmgr);
+          continue;
+        }
+      left = BTOR_REAL_ADDR_AIG (BTOR_LEFT_CHILD_AIG (cur));
+      right = BTOR_REAL_ADDR_AIG (BTOR_RIGHT_CHILD_AIG (cur));
+      b_left = btor_find_in_ptr_hash_table (table, left);
+      b_right = btor_find_in_ptr_hash_table (table, right);
+      if (b_left != NULL && b_right != NULL)
+        {
+          b = btor_insert_in_ptr_hash_table (table, cur);
+          b->data.asInt = (int)
+            btor_and_caig (cmgr,
+                           BTOR_COND_INVERT_CAIG (BTOR_IS_INVERTED_AIG
+                                                  (BTOR_LEFT_CHILD_AIG (cur)),
+                                                  (BtorCAIG) b_left->
+                                                  data.asInt),
+                           BTOR_COND_INVERT_CAIG (BTOR_IS_INVERTED_AIG
+                                                  (BTOR_RIGHT_CHILD_AIG
+                                                   (cur)),
+                                                  (BtorCAIG) b_right->
+                                                  data.asInt));
+          continue;
+        }
+      BTOR_PUSH_STACK (mm, stack, cur);
+      if (b_right == NULL)
+        BTOR_PUSH_STACK (mm, stack, right);
+      if (b_left == NULL)
+        BTOR_PUSH_STACK (mm, stack, left);
+    }
+  BTOR_RELEASE_STACK (mm, stack);
+
+  b = btor_find_in_ptr_hash_table (table, BTOR_REAL_ADDR_AIG (aig));
+  assert (b != NULL);
+  result = (BtorCAIG) b->data.asInt;
+  return BTOR_COND_INVERT_CAIG (BTOR_IS_INVERTED_AIG (aig), result);
+}
+
+void
+btor_gc_caig_mgr (BtorCAIGMgr * cmgr, BtorCAIG * roots, int nroots)
+{
+  unsigned int idx, new_idx, old_num_nodes, new_size;
+  BtorCAIGNode *node;
+  unsigned int *map;
+  BtorMemMgr *mm;
+  int i;
+
+  assert (cmgr != NULL);
+  assert (nroots >= 0);
+  assert (nroots == 0 || roots != NULL);
+
+  mm = BTOR_VIEW_MEM_MGR (cmgr->mm, BTOR_MEM_AIG);
+  old_num_nodes = cmgr->num_nodes;
+
+  /* Nodes are topologically sorted, thus one backward sweep marks
+   * everything reachable.
+   */
+  for (i = 0; i < nroots; i++)
+    cmgr->marks[BTOR_INDEX_CAIG (roots[i])] = 1;
+  for (idx = old_num_nodes - 1; idx > 0; idx--)
+    {
+      if (!cmgr->marks[idx] || BTOR_IS_VAR_CAIG_NODE (cmgr, idx))
+        continue;
+      node = cmgr->nodes + idx;
+      cmgr->marks[BTOR_INDEX_CAIG (node->children[0])] = 1;
+      cmgr->marks[BTOR_INDEX_CAIG (node->children[1])] = 1;
+    }
+
+  /* The chains are rebuilt anyhow, so reuse them for the index map. */
+  map = cmgr->next;
+  map[0] = 0u;
+  new_idx = 1u;
+  cmgr->num_ands = 0u;
+  for (idx = 1; idx < old_num_nodes; idx++)
+    {
+      if (!cmgr->marks[idx])
+        continue;
+      cmgr->marks[idx] = 0;
+      map[idx] = new_idx;
+      node = cmgr->nodes + idx;
+      if (!BTOR_IS_VAR_CAIG_NODE (cmgr, idx))
+        {
+          node->children[0] = 2u * map[BTOR_INDEX_CAIG (node->children[0])]
+            | BTOR_IS_INVERTED_CAIG (node->children[0]);
+          node->children[1] = 2u * map[BTOR_INDEX_CAIG (node->children[1])]
+            | BTOR_IS_INVERTED_CAIG (node->children[1]);
+          cmgr->num_ands++;
+        }
+      cmgr->nodes[new_idx] = *node;
+      cmgr->cnf_ids[new_idx] = cmgr->cnf_ids[idx];
+      new_idx++;
+    }
+  cmgr->marks[0] = 0;
+  cmgr->num_nodes = new_idx;
+
+  for (i = 0; i < nroots; i++)
+    roots[i] = 2u * map[BTOR_INDEX_CAIG (roots[i])]
+      | BTOR_IS_INVERTED_CAIG (roots[i]);
+
+  /* shrink node and side arrays */
+  new_size = cmgr->size;
+  while (new_size > 1u && (new_size >> 2) >= cmgr->num_nodes)
+    new_size >>= 1;
+  if (new_size < cmgr->size)
+    {
+      BTOR_REALLOC (mm, cmgr->nodes, cmgr->size, new_size);
+      BTOR_REALLOC (mm, cmgr->next, cmgr->size, new_size);
+      BTOR_REALLOC (mm, cmgr->cnf_ids, cmgr->size, new_size);
+      BTOR_REALLOC (mm, cmgr->marks, cmgr->size, new_size);
+      cmgr->size = new_size;
+    }
+
+  new_size = cmgr->table_size;
+  while (new_size > 1u && (new_size >> 1) >= cmgr->num_ands)
+    new_size >>= 1;
+  rehash_caig (cmgr, new_size);
+
+  if (cmgr->verbosity > 1)
+    {
+      fprintf (stdout, "[btorcaig] collected %u of %u nodes\n",
+               old_num_nodes - cmgr->num_nodes, old_num_nodes - 1);
+      fflush (stdout);
+    }
+}
+
+void
+btor_caig_to_sat (BtorCAIGMgr * cmgr, BtorCAIG lit)
+{
+  unsigned int idx, left_idx, right_idx;
+  BtorSATMgr *smgr;
+  BtorIntStack stack;
+  BtorCAIGNode *node;
+  BtorMemMgr *mm;
+  int x, y, z;
+
+  assert (cmgr != NULL);
+
+  if (BTOR_IS_CONST_CAIG (lit) || cmgr->cnf_ids[BTOR_INDEX_CAIG (lit)])
+    return;
+
+  mm = cmgr->mm;
+  smgr = cmgr->smgr;
+  BTOR_INIT_STACK (stack);
+  BTOR_PUSH_STACK (mm, stack, (int) BTOR_INDEX_CAIG (lit));
+  while (!BTOR_EMPTY_STACK (stack))
+    {
+      idx = (unsigned int) BTOR_POP_STACK (stack);
+      if (cmgr->cnf_ids[idx])
+        continue;
+      if (BTOR_IS_VAR_CAIG_NODE (cmgr, idx))
+        {
+          cmgr->cnf_ids[idx] = btor_next_cnf_id_sat_mgr (smgr);
+          continue;
+        }
+      node = cmgr->nodes + idx;
+      if (!cmgr->marks[idx])
+        {
+          cmgr->marks[idx] = 1;
+          BTOR_PUSH_STACK (mm, stack, (int) idx);
+          left_idx = BTOR_INDEX_CAIG (node->children[0]);
+          right_idx = BTOR_INDEX_CAIG (node->children[1]);
+          if (!cmgr->cnf_ids[right_idx])
+            BTOR_PUSH_STACK (mm, stack, (int) right_idx);
+          if (!cmgr->cnf_ids[left_idx])
+            BTOR_PUSH_STACK (mm, stack, (int) left_idx);
+          continue;
+        }
+      cmgr->marks[idx] = 0;
+      x = btor_next_cnf_id_sat_mgr (smgr);
+      cmgr->cnf_ids[idx] = x;
+      y = BTOR_GET_CNF_ID_CAIG (cmgr, node->children[0]);
+      z = BTOR_GET_CNF_ID_CAIG (cmgr, node->children[1]);
+      assert (y != 0 && z != 0);
+      btor_add_sat (smgr, -y);
+      btor_add_sat (smgr, -z);
+      btor_add_sat (smgr, x);
+      btor_add_sat (smgr, 0);
+      btor_add_sat (smgr, -x);
+      btor_add_sat (smgr, y);
+      btor_add_sat (smgr, 0);
+      btor_add_sat (smgr, -x);
+      btor_add_sat (smgr, z);
+      btor_add_sat (smgr, 0);
+    }
+  BTOR_RELEASE_STACK (mm, stack);
+}
+
+void
+btor_add_toplevel_caig_to_sat (BtorCAIGMgr * cmgr, BtorCAIG root)
+{
+  BtorCAIG lit, left, right;
+  BtorSATMgr *smgr;
+  BtorCAIGStack stack;
+  BtorCAIGNode *node;
+  BtorMemMgr *mm;
+
+  assert (cmgr != NULL);
+
+  mm = cmgr->mm;
+  smgr = cmgr->smgr;
+
+  if (root == BTOR_CAIG_TRUE)
+    return;
+
+  if (root == BTOR_CAIG_FALSE)
+    {
+      /* Add empty clause.
+       */
+      btor_add_sat (smgr, 0);
+      return;
+    }
+
+  BTOR_INIT_STACK (stack);
+  BTOR_PUSH_STACK (mm, stack, root);
+  while (!BTOR_EMPTY_STACK (stack))
+    {
+      lit = BTOR_POP_STACK (stack);
+      node = cmgr->nodes + BTOR_INDEX_CAIG (lit);
+      if (BTOR_IS_VAR_CAIG_NODE (cmgr, BTOR_INDEX_CAIG (lit)))
+        {
+          btor_caig_to_sat (cmgr, lit);
+          btor_add_sat (smgr, BTOR_GET_CNF_ID_CAIG (cmgr, lit));
+          btor_add_sat (smgr, 0);
+        }
+      else if (!BTOR_IS_INVERTED_CAIG (lit))
+        {
+          BTOR_PUSH_STACK (mm, stack, node->children[1]);
+          BTOR_PUSH_STACK (mm, stack, node->children[0]);
+        }
+      else
+        {
+          left = BTOR_INVERT_CAIG (node->children[0]);
+          right = BTOR_INVERT_CAIG (node->children[1]);
+          btor_caig_to_sat (cmgr, left);
+          btor_caig_to_sat (cmgr, right);
+          btor_add_sat (smgr, BTOR_GET_CNF_ID_CAIG (cmgr, left));
+          btor_add_sat (smgr, BTOR_GET_CNF_ID_CAIG (cmgr, right));
+          btor_add_sat (smgr, 0);
+        }
+    }
+  BTOR_RELEASE_STACK (mm, stack);
+}
+
+int
+btor_get_assignment_caig (BtorCAIGMgr * cmgr, BtorCAIG lit)
+{
+  int cnf_id;
+  assert (cmgr != NULL);
+  if (lit == BTOR_CAIG_TRUE)
+    return 1;
+  if (lit == BTOR_CAIG_FALSE)
+    return -1;
+  cnf_id = BTOR_GET_CNF_ID_CAIG (cmgr, lit);
+  if (cnf_id == 0)
+    return 0;
+  return btor_deref_sat (cmgr->smgr, cnf_id);
+}
+
+/*------------------------------------------------------------------------*/
+/* END OF IMPLEMENTATION                                                  */
+/*------------------------------------------------------------------------*/
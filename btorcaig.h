@@ -0,0 +1,124 @@
+/*  Boolector: Satisfiablity Modulo Theories (SMT) solver.
+ *  Copyright (C) 2010  Robert Daniel Brummayer, Armin Biere
+ *
+ *  This file is part of Boolector.
+ *
+ *  Boolector is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Boolector is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BTORCAIG_H_INCLUDED
+#define BTORCAIG_H_INCLUDED
+
+#include "btorstack.h"
+#include "btormem.h"
+#include "btorsat.h"
+#include "btorhash.h"
+#include "btoraig.h"
+
+/*------------------------------------------------------------------------*/
+/* PRIVATE INTERFACE                                                      */
+/*------------------------------------------------------------------------*/
+
+/* Compact AIGs. All nodes of a manager are kept in one contiguous array
+ * and are referenced by 32 bit AIGER style literals '2 * index + sign'.
+ * Index 0 is reserved for the constant, i.e. literal 0 is FALSE and
+ * literal 1 is TRUE. Children always have smaller indices than their
+ * parents, thus the node array is in topological order. CNF ids, marks
+ * and the unique table chains are kept in side arrays. Nodes are not
+ * reference counted, instead unreachable nodes are collected in bulk
+ * by 'btor_gc_caig_mgr'.
+ */
+typedef unsigned int BtorCAIG;
+
+#define BTOR_CAIG_FALSE ((BtorCAIG) 0u)
+#define BTOR_CAIG_TRUE ((BtorCAIG) 1u)
+#define BTOR_IS_CONST_CAIG(lit) ((lit) < 2u)
+#define BTOR_INVERT_CAIG(lit) ((BtorCAIG) (1u ^ (lit)))
+#define BTOR_IS_INVERTED_CAIG(lit) (1u & (lit))
+#define BTOR_REAL_CAIG(lit) ((BtorCAIG) (~1u & (lit)))
+#define BTOR_INDEX_CAIG(lit) ((lit) >> 1)
+#define BTOR_COND_INVERT_CAIG(cond,lit) ((BtorCAIG) ((cond) ? 1u ^ (lit) : (lit)))
+
+typedef struct BtorCAIGMgr BtorCAIGMgr;
+
+BTOR_DECLARE_STACK (CAIG, BtorCAIG);
+
+
+/* Creates new compact AIG manager. */
+BtorCAIGMgr *btor_new_caig_mgr (BtorMemMgr * mm);
+
+/* Sets verbosity [-1,3] */
+void btor_set_verbosity_caig_mgr (BtorCAIGMgr * cmgr, int verbosity);
+
+/* Gets SAT manager of compact AIG manager. */
+BtorSATMgr *btor_get_sat_mgr_caig_mgr (const BtorCAIGMgr * cmgr);
+
+/* Deletes compact AIG manager and all of its nodes from memory. */
+void btor_delete_caig_mgr (BtorCAIGMgr * cmgr);
+
+/* Number of variables and AND nodes (without the constant). */
+int btor_num_nodes_caig_mgr (const BtorCAIGMgr * cmgr);
+
+/* Variable representing 1 bit. */
+BtorCAIG btor_var_caig (BtorCAIGMgr * cmgr);
+
+/* Logical AND. */
+BtorCAIG btor_and_caig (BtorCAIGMgr * cmgr, BtorCAIG left, BtorCAIG right);
+
+/* Logical OR. */
+BtorCAIG btor_or_caig (BtorCAIGMgr * cmgr, BtorCAIG left, BtorCAIG right);
+
+/* Logical EQUIVALENCE. */
+BtorCAIG btor_eq_caig (BtorCAIGMgr * cmgr, BtorCAIG left, BtorCAIG right);
+
+/* Logical XOR. */
+BtorCAIG btor_xor_caig (BtorCAIGMgr * cmgr, BtorCAIG left, BtorCAIG right);
+
+/* If then Else. */
+BtorCAIG btor_cond_caig (BtorCAIGMgr * cmgr, BtorCAIG lit_cond,
+                         BtorCAIG lit_if, BtorCAIG lit_else);
+
+/* Is the (non constant) literal a variable? */
+int btor_is_var_caig (const BtorCAIGMgr * cmgr, BtorCAIG lit);
+
+/* Children of non constant and non variable literals.
+ * The sign of lit is ignored.
+ */
+BtorCAIG btor_left_child_caig (const BtorCAIGMgr * cmgr, BtorCAIG lit);
+BtorCAIG btor_right_child_caig (const BtorCAIGMgr * cmgr, BtorCAIG lit);
+
+/* Translates AIG of an ordinary AIG manager into a compact AIG.
+ * The table maps already translated real AIGs to compact AIG literals
+ * (stored in 'data.asInt') and can be shared between several calls.
+ * Variables are translated into fresh variables.
+ */
+BtorCAIG btor_import_aig_caig (BtorCAIGMgr * cmgr, BtorPtrHashTable * table,
+                               BtorAIG * aig);
+
+/* Deletes all nodes which are not reachable from roots and compacts
+ * the node array. The roots are updated in place. All other literals
+ * of the manager are invalidated. CNF ids of surviving nodes are kept.
+ */
+void btor_gc_caig_mgr (BtorCAIGMgr * cmgr, BtorCAIG * roots, int nroots);
+
+/* Translates compact AIG into SAT instance in both phases. */
+void btor_caig_to_sat (BtorCAIGMgr * cmgr, BtorCAIG lit);
+
+/* As 'btor_caig_to_sat' but also add the argument as new SAT constraint. */
+void btor_add_toplevel_caig_to_sat (BtorCAIGMgr * cmgr, BtorCAIG root);
+
+/* Gets current assignment of compact AIG (in the SAT case). */
+int btor_get_assignment_caig (BtorCAIGMgr * cmgr, BtorCAIG lit);
+
+#endif
@@ -27,8 +27,10 @@
 #include "btorconfig.h"
 #include "btorexit.h"
 #include "btorrewrite.h"
+#include "btortrace.h"
 #include "../picosat/picosat.h"
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
@@ -59,20 +61,38 @@ static const char* const g_op2string[] = { "invalid", "const", "var", "array", "
     (table).size = 1; \
     (table).num_elements = 0; \
     BTOR_CNEW (mm, (table).chains); \
+    (table).old_size = 0; \
+    (table).old_pos = 0; \
+    (table).old_chains = NULL; \
   } while (0)
 
 #define BTOR_RELEASE_EXP_UNIQUE_TABLE(mm, table) \
   do { \
     assert (mm != NULL); \
     BTOR_DELETEN (mm, (table).chains, (table).size); \
+    BTOR_DELETEN (mm, (table).old_chains, (table).old_size); \
   } while (0)
 
 
 #define BTOR_EXP_UNIQUE_TABLE_LIMIT 30
 #define BTOR_EXP_UNIQUE_TABLE_PRIME 2000000137u
 
+/* number of old chains moved per lookup while enlarging */
+#define BTOR_EXP_UNIQUE_TABLE_REHASH_STEPS 4
+
+/* constants are packed into words of this many bits for hashing */
+#define BTOR_CONST_WORD_BITS 64
+#define BTOR_CONST_WORD_PRIME 1000000007u
+
 #define BTOR_EXP_FAILED_EQ_LIMIT 4096
 
+/* initial size of traversal stacks and queues, and the maximum size of
+ * stacks and queues kept for reuse */
+#define BTOR_TRV_INIT_SIZE 256
+#define BTOR_TRV_KEEP_SIZE (1 << 16)
+
+#define BTOR_LA_DEFAULT_MIN_WIDTH 16
+
 struct BtorUAData
 {
   int last_e;
@@ -83,6 +103,14 @@ struct BtorUAData
 
 typedef struct BtorUAData BtorUAData;
 
+/* Multiplication or division which is abstracted by a fresh AIG vector */
+struct BtorLazyArithOp
+{
+  BtorExpKind kind;
+  BtorAIGVec *av[3];            /* operands and result */
+  int encoded;                  /* axioms have been added to SAT solver */
+};
+
 
 struct BtorExpPair
 {
@@ -137,6 +165,9 @@ static void add_constraint (Btor *, BtorExp *);
 static void run_rewrite_engine (Btor *, int);
 static void abstract_domain_bv_variables (Btor *);
 static void eliminate_slices_on_bv_vars (Btor *);
+static void reduce_bit_widths (Btor *);
+static void eliminate_linear_equations (Btor *);
+static void eliminate_unconstrained_exps (Btor *);
 
 /*------------------------------------------------------------------------*/
 /* END OF DECLARATIONS                                                    */
@@ -469,7 +500,7 @@ inc_exp_ref_counter (Btor * btor, BtorExp * exp)
   (void) btor;
   real_exp = BTOR_REAL_ADDR_EXP (exp);
   BTOR_ABORT_EXP (real_exp->refs == INT_MAX, "Reference counter overflow");
-  real_exp->refs++;
+  BTOR_INC_REFS_EXP (real_exp);
 }
 
 BtorExp *
@@ -477,10 +508,107 @@ btor_copy_exp (Btor * btor, BtorExp * exp)
 {
   assert (btor != NULL);
   assert (exp != NULL);
+  BTOR_LOCK_EXP (btor);
   inc_exp_ref_counter (btor, exp);
+  BTOR_UNLOCK_EXP (btor);
   return exp;
 }
 
+/* Traversal stacks and queues are taken from a pool, which keeps their
+ * memory from one traversal to the next.  They may be released in any
+ * order.
+ */
+static void
+init_trv_stack (Btor * btor, BtorExpPtrStack * stack)
+{
+  assert (btor != NULL);
+  assert (stack != NULL);
+  if (btor->trv.num_stacks > 0)
+    {
+      *stack = btor->trv.stacks[--btor->trv.num_stacks];
+      assert (BTOR_EMPTY_STACK (*stack));
+    }
+  else
+    {
+      BTOR_NEWN (btor->mm, stack->start, BTOR_TRV_INIT_SIZE);
+      stack->top = stack->start;
+      stack->end = stack->start + BTOR_TRV_INIT_SIZE;
+    }
+}
+
+static void
+release_trv_stack (Btor * btor, BtorExpPtrStack * stack)
+{
+  assert (btor != NULL);
+  assert (stack != NULL);
+  if (btor->trv.num_stacks < BTOR_TRV_POOL_SIZE
+      && BTOR_SIZE_STACK (*stack) <= BTOR_TRV_KEEP_SIZE)
+    {
+      BTOR_RESET_STACK (*stack);
+      btor->trv.stacks[btor->trv.num_stacks++] = *stack;
+      BTOR_INIT_STACK (*stack);
+    }
+  else
+    BTOR_RELEASE_STACK (btor->mm, *stack);
+}
+
+static void
+init_trv_queue (Btor * btor, BtorExpPtrQueue * queue)
+{
+  assert (btor != NULL);
+  assert (queue != NULL);
+  if (btor->trv.num_queues > 0)
+    {
+      *queue = btor->trv.queues[--btor->trv.num_queues];
+      assert (BTOR_EMPTY_QUEUE (*queue));
+    }
+  else
+    {
+      BTOR_NEWN (btor->mm, queue->start, BTOR_TRV_INIT_SIZE);
+      queue->head = queue->tail = queue->start;
+      queue->end = queue->start + BTOR_TRV_INIT_SIZE;
+    }
+}
+
+static void
+release_trv_queue (Btor * btor, BtorExpPtrQueue * queue)
+{
+  assert (btor != NULL);
+  assert (queue != NULL);
+  if (btor->trv.num_queues < BTOR_TRV_POOL_SIZE
+      && BTOR_SIZE_QUEUE (*queue) <= BTOR_TRV_KEEP_SIZE)
+    {
+      BTOR_RESET_QUEUE (*queue);
+      btor->trv.queues[btor->trv.num_queues++] = *queue;
+      BTOR_INIT_QUEUE (*queue);
+    }
+  else
+    BTOR_RELEASE_QUEUE (btor->mm, *queue);
+}
+
+static void
+delete_trv_pool (Btor * btor)
+{
+  int i;
+  assert (btor != NULL);
+  for (i = 0; i < btor->trv.num_stacks; i++)
+    BTOR_RELEASE_STACK (btor->mm, btor->trv.stacks[i]);
+  btor->trv.num_stacks = 0;
+  for (i = 0; i < btor->trv.num_queues; i++)
+    BTOR_RELEASE_QUEUE (btor->mm, btor->trv.queues[i]);
+  btor->trv.num_queues = 0;
+}
+
+/* Starts a new traversal, which visits expressions by setting their
+ * 'epoch' to the returned one. */
+static long long
+new_trv_epoch (Btor * btor)
+{
+  assert (btor != NULL);
+  assert (btor->trv.epoch < LLONG_MAX);
+  return ++btor->trv.epoch;
+}
+
 static BtorUAData *
 new_ua_data (Btor * btor, int eff_width)
 {
@@ -660,7 +788,7 @@ compute_hash_exp (BtorExp * exp, int table_size)
   assert (!BTOR_IS_BV_VAR_EXP (exp));
   assert (!BTOR_IS_ARRAY_VAR_EXP (exp));
   if (BTOR_IS_BV_CONST_EXP (exp))
-    hash = btor_hashstr ((void *) exp->bits);
+    hash = exp->key;
   else
     {
       switch (exp->arity)
@@ -689,6 +817,59 @@ compute_hash_exp (BtorExp * exp, int table_size)
   return hash;
 }
 
+/* Moves chain 'pos' of the old unique table into the current one. */
+static void
+rehash_chain_exp (Btor * btor, int pos)
+{
+  unsigned int hash;
+  BtorExp *cur, *temp;
+  assert (btor != NULL);
+  assert (btor->table.old_chains != NULL);
+  assert (pos >= 0);
+  assert (pos < btor->table.old_size);
+  cur = btor->table.old_chains[pos];
+  while (cur != NULL)
+    {
+      assert (BTOR_IS_REGULAR_EXP (cur));
+      assert (!BTOR_IS_BV_VAR_EXP (cur));
+      assert (!BTOR_IS_ARRAY_VAR_EXP (cur));
+      temp = cur->next;
+      hash = compute_hash_exp (cur, btor->table.size);
+      cur->next = btor->table.chains[hash];
+      btor->table.chains[hash] = cur;
+      cur = temp;
+    }
+  btor->table.old_chains[pos] = NULL;
+}
+
+/* Bounded amount of work for an incremental enlargement. Moves the old
+ * chain of the (not yet masked) hash value 'hash' first, such that the
+ * expressions with this hash value can be found in the current table,
+ * and then the next few old chains. The old table is released as soon
+ * as all of its chains have been moved.
+ */
+static void
+rehash_exp_unique_table (Btor * btor, unsigned int hash)
+{
+  int pos, steps;
+  assert (btor != NULL);
+  if (btor->table.old_chains == NULL)
+    return;
+  pos = (int) (hash & (btor->table.old_size - 1));
+  if (pos >= btor->table.old_pos)
+    rehash_chain_exp (btor, pos);
+  for (steps = 0; steps < BTOR_EXP_UNIQUE_TABLE_REHASH_STEPS &&
+       btor->table.old_pos < btor->table.old_size; steps++)
+    rehash_chain_exp (btor, btor->table.old_pos++);
+  if (btor->table.old_pos == btor->table.old_size)
+    {
+      BTOR_DELETEN (btor->mm, btor->table.old_chains, btor->table.old_size);
+      btor->table.old_chains = NULL;
+      btor->table.old_size = 0;
+      btor->table.old_pos = 0;
+    }
+}
+
 static void
 remove_from_unique_table_exp (Btor * btor, BtorExp * exp)
 {
@@ -704,6 +885,12 @@ remove_from_unique_table_exp (Btor * btor, BtorExp * exp)
   assert (btor != NULL);
   assert (btor->table.num_elements > 0);
 
+  if (btor->table.old_chains != NULL)
+    {
+      hash = compute_hash_exp (exp, btor->table.old_size);
+      if ((int) hash >= btor->table.old_pos)
+        rehash_chain_exp (btor, (int) hash);
+    }
   hash = compute_hash_exp (exp, btor->table.size);
   prev = NULL;
   cur = btor->table.chains[hash];
@@ -802,6 +989,26 @@ disconnect_children_exp (Btor * btor, BtorExp * exp)
   exp->disconnected = 1;
 }
 
+/* Removes constant from the zero, one and ones cache. */
+static void
+uncache_const_exp (Btor * btor, BtorExp * exp)
+{
+  int len;
+  assert (btor != NULL);
+  assert (exp != NULL);
+  assert (BTOR_IS_REGULAR_EXP (exp));
+  assert (BTOR_IS_BV_CONST_EXP (exp));
+  len = exp->len;
+  if (len > BTOR_CONST_CACHE_LEN)
+    return;
+  if (BTOR_REAL_ADDR_EXP (btor->cc.zero[len]) == exp)
+    btor->cc.zero[len] = NULL;
+  if (BTOR_REAL_ADDR_EXP (btor->cc.one[len]) == exp)
+    btor->cc.one[len] = NULL;
+  if (BTOR_REAL_ADDR_EXP (btor->cc.ones[len]) == exp)
+    btor->cc.ones[len] = NULL;
+}
+
 /* Delete local data of expression.
  *
  * Virtual reads and simplified expressions have to be handled by the
@@ -829,8 +1036,11 @@ erase_local_data_exp (Btor * btor, BtorExp * exp, int free_symbol)
   switch (exp->kind)
     {
       case BTOR_BV_CONST_EXP:
-	btor_freestr (mm, exp->bits);
+	uncache_const_exp (btor, exp);
+	btor_freestr (BTOR_VIEW_MEM_MGR (mm, BTOR_MEM_CONST), exp->bits);
 	exp->bits = NULL;
+	exp->value = 0;
+	exp->key = 0;
 	break;
       case BTOR_ARRAY_VAR_EXP:
 	if (free_symbol)
@@ -841,9 +1051,11 @@ erase_local_data_exp (Btor * btor, BtorExp * exp, int free_symbol)
 	/* fall through wanted */
       case BTOR_WRITE_EXP:
       case BTOR_ACOND_EXP:
+	if (BTOR_IS_WRITE_EXP (exp))
+	  btor_erase_write_index (btor, exp);
 	if (exp->rho != NULL)
 	  {
-	    btor_delete_ptr_hash_table (exp->rho);
+	    btor_delete_oa_ptr_hash_table (exp->rho);
 	    exp->rho = NULL;
 	  }
 	break;
@@ -926,7 +1138,7 @@ recursively_release_exp (Btor * btor, BtorExp * root)
 
   mm = btor->mm;
 
-  BTOR_INIT_STACK (stack);
+  init_trv_stack (btor, &stack);
   cur = root;
   goto RECURSIVELY_RELEASE_EXP_ENTER_WITHOUT_POP;
 
@@ -934,7 +1146,7 @@ recursively_release_exp (Btor * btor, BtorExp * root)
     {
       cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
       if (cur->refs > 1)
-        cur->refs--;
+        BTOR_DEC_REFS_EXP (cur);
       else
         {
 RECURSIVELY_RELEASE_EXP_ENTER_WITHOUT_POP:
@@ -968,7 +1180,7 @@ RECURSIVELY_RELEASE_EXP_ENTER_WITHOUT_POP:
         }
     }
   while (!BTOR_EMPTY_STACK (stack));
-  BTOR_RELEASE_STACK (mm, stack);
+  release_trv_stack (btor, &stack);
 }
 
 void
@@ -979,12 +1191,13 @@ btor_release_exp (Btor * btor, BtorExp * root)
 
   root = BTOR_REAL_ADDR_EXP (root);
 
+  BTOR_LOCK_EXP (btor);
   assert (root->refs > 0);
-
   if (root->refs > 1)
-    root->refs--;
+    BTOR_DEC_REFS_EXP (root);
   else
     recursively_release_exp (btor, root);
+  BTOR_UNLOCK_EXP (btor);
 }
 
 static void
@@ -997,6 +1210,17 @@ delete_exp_pair (Btor * btor, BtorExpPair * pair)
   BTOR_DELETE (btor->mm, pair);
 }
 
+static void
+delete_lazy_arith_op (Btor * btor, BtorLazyArithOp * op)
+{
+  int i;
+  assert (btor != NULL);
+  assert (op != NULL);
+  for (i = 0; i < 3; i++)
+    btor_release_delete_aigvec (btor->avmgr, op->av[i]);
+  BTOR_DELETE (btor->mm, op);
+}
+
 static unsigned int
 hash_exp_pair (BtorExpPair * pair)
 {
@@ -1056,6 +1280,21 @@ init_acond_parent_iterator (BtorPartialParentIterator * it, BtorExp * exp)
   it->cur = BTOR_REAL_ADDR_EXP (exp)->last_aeq_acond_parent;
 }
 
+/* Proxies of arrays keep their array equality and array conditional
+ * parents until these are rebuilt.
+ */
+static int
+has_aeq_acond_parent_list_exp (BtorExp * exp)
+{
+  exp = BTOR_REAL_ADDR_EXP (exp);
+  while (BTOR_IS_PROXY_EXP (exp))
+    {
+      assert (exp->simplified != NULL);
+      exp = BTOR_REAL_ADDR_EXP (exp->simplified);
+    }
+  return BTOR_IS_ARRAY_EXP (exp);
+}
+
 static void
 init_full_parent_iterator (BtorFullParentIterator * it, BtorExp * exp)
 {
@@ -1070,7 +1309,7 @@ init_full_parent_iterator (BtorFullParentIterator * it, BtorExp * exp)
   else
     {
       it->regular_parents_done = 1;
-      if (BTOR_IS_ARRAY_EXP (BTOR_REAL_ADDR_EXP (exp)))
+      if (has_aeq_acond_parent_list_exp (exp))
         it->cur = BTOR_REAL_ADDR_EXP (exp)->first_aeq_acond_parent;
       else
         it->cur = NULL;
@@ -1145,7 +1384,7 @@ next_parent_full_parent_iterator (BtorFullParentIterator * it)
         {
           it->regular_parents_done = 1;
           /* traverse aeq acond parent list */
-          if (BTOR_IS_ARRAY_EXP (BTOR_REAL_ADDR_EXP (it->exp)))
+          if (has_aeq_acond_parent_list_exp (it->exp))
             it->cur = BTOR_REAL_ADDR_EXP (it->exp)->first_aeq_acond_parent;
         }
     }
@@ -1257,7 +1496,7 @@ assignment_always_unequal (Btor * btor, BtorExpPair * pair, int *hashed_pair)
   BtorAIGVec *av1, *av2;
   BtorAIG *aig1, *aig2;
   BtorExp *exp1, *exp2;
-  BtorPtrHashTable *exp_pair_ass_unequal_table;
+  BtorOAPtrHashTable *exp_pair_ass_unequal_table;
 
   assert (btor != NULL);
   assert (pair != NULL);
@@ -1266,7 +1505,7 @@ assignment_always_unequal (Btor * btor, BtorExpPair * pair, int *hashed_pair)
   *hashed_pair = 0;
 
   exp_pair_ass_unequal_table = btor->exp_pair_ass_unequal_table;
-  if (btor_find_in_ptr_hash_table (exp_pair_ass_unequal_table, pair)) 
+  if (btor_find_in_oa_ptr_hash_table (exp_pair_ass_unequal_table, pair))
     return 1;
 
   exp1 = pair->exp1;
@@ -1301,8 +1540,8 @@ assignment_always_unequal (Btor * btor, BtorExpPair * pair, int *hashed_pair)
 
 	  if (val2 != 0 && val1 != val2)
 	    {
-	      (void) btor_insert_in_ptr_hash_table (exp_pair_ass_unequal_table,
-		                                    pair); 
+	      (void) btor_insert_in_oa_ptr_hash_table (exp_pair_ass_unequal_table,
+		                                       pair);
 	      *hashed_pair = 1;
 	      return 1;
 	    }
@@ -1315,11 +1554,15 @@ assignment_always_unequal (Btor * btor, BtorExpPair * pair, int *hashed_pair)
  * The stack 'writes' contains intermediate writes. 
  * The stack 'aeqs' contains intermediate array equalities (true).
  * The stacks 'aconds' constain intermediate array conditionals.
+ * The conclusion i != j \/ a = b is encoded once per access pair
+ * 'acc1', 'acc2' into a lemma literal l with l -> (i != j \/ a = b),
+ * which is reused by all further lemmas of the same access pair.
+ * Premisses which are false at the top level are dropped.
  */
 static void
 encode_lemma (Btor * btor, BtorPtrHashTable * writes, BtorPtrHashTable * aeqs,
               BtorPtrHashTable * aconds_sel1, BtorPtrHashTable * aconds_sel2,
-              BtorExp * i, BtorExp * j, BtorExp * a, BtorExp * b)
+              BtorExp * acc1, BtorExp * acc2)
 {
   BtorMemMgr *mm;
   BtorAIGVecMgr *avmgr;
@@ -1329,23 +1572,36 @@ encode_lemma (Btor * btor, BtorPtrHashTable * writes, BtorPtrHashTable * aeqs,
   BtorAIG *aig1, *aig2;
   BtorExp *w_index, *cur_write, *aeq, *acond, *cond;
   BtorExpPair *pair;
-  BtorPtrHashTable *exp_pair_cnf_diff_id_table, *exp_pair_cnf_eq_id_table;
-  BtorPtrHashBucket *bucket, *bucket_temp;
+  BtorOAPtrHashTable *exp_pair_cnf_diff_id_table, *exp_pair_cnf_eq_id_table;
+  BtorOAPtrHashEntry *entry;
+  BtorPtrHashBucket *bucket;
   BtorIntStack clauses;
+  BtorIntStack conclusion;
   BtorIntStack linking_clause;
-  int len_a_b, len_i_j_w, e, hashed_pair;
+  BtorExp *i, *j, *a, *b;
+  int len_a_b, len_i_j_w, e, l, hashed_pair;
   int k, d_k;
   int a_k = 0;
   int b_k = 0;
   int i_k = 0;
   int j_k = 0;
   int w_k = 0;
-  int *lit;
+  int *lit, *end;
   assert (btor != NULL);
   assert (writes != NULL);
   assert (aeqs != NULL);
   assert (aconds_sel1 != NULL);
   assert (aconds_sel2 != NULL);
+  assert (acc1 != NULL);
+  assert (acc2 != NULL);
+  assert (BTOR_IS_REGULAR_EXP (acc1));
+  assert (BTOR_IS_REGULAR_EXP (acc2));
+  assert (BTOR_IS_ACC_EXP (acc1));
+  assert (BTOR_IS_ACC_EXP (acc2));
+  i = BTOR_GET_INDEX_ACC_EXP (acc1);
+  j = BTOR_GET_INDEX_ACC_EXP (acc2);
+  a = BTOR_GET_VALUE_ACC_EXP (acc1);
+  b = BTOR_GET_VALUE_ACC_EXP (acc2);
   assert (i != NULL);
   assert (j != NULL);
   assert (a != NULL);
@@ -1384,23 +1640,41 @@ encode_lemma (Btor * btor, BtorPtrHashTable * writes, BtorPtrHashTable * aeqs,
   assert (BTOR_REAL_ADDR_EXP (j)->sat_both_phases);
 
   BTOR_INIT_STACK (clauses);
+  BTOR_INIT_STACK (conclusion);
   BTOR_INIT_STACK (linking_clause);
 
+  /* already encoded lemma literal of access pair ? */
+  pair = new_exp_pair (btor, acc1, acc2);
+  entry = btor_find_in_oa_ptr_hash_table (btor->lemma_lit_table, pair);
+  if (entry != NULL)
+    {
+      /* the conclusion has been encoded by a previous lemma,
+       * we simply reuse l for the linking clause */
+      l = entry->data.asInt;
+      delete_exp_pair (btor, pair);
+      btor->stats.lemma_cache_hits++;
+      goto ENCODE_PREMISSES;
+    }
+  l = btor_next_cnf_id_sat_mgr (smgr);
+  btor_insert_in_oa_ptr_hash_table (btor->lemma_lit_table, pair)->data.asInt =
+    l;
+  BTOR_PUSH_STACK (mm, conclusion, -l);
+
   /* encode i != j */
   pair = new_exp_pair (btor, i, j);
   hashed_pair = 0;
   if (i != j && !assignment_always_unequal (btor, pair, &hashed_pair))
     {
       /* already encoded i != j into SAT ? */
-      bucket = btor_find_in_ptr_hash_table (exp_pair_cnf_diff_id_table, pair);
+      entry = btor_find_in_oa_ptr_hash_table (exp_pair_cnf_diff_id_table, pair);
       /* no? */
-      if (bucket == NULL)
+      if (entry == NULL)
         {
           /* hash starting cnf id - 1 for d_k */
           d_k = btor_get_last_cnf_id_sat_mgr (smgr);
           assert (d_k != 0);
-          btor_insert_in_ptr_hash_table (exp_pair_cnf_diff_id_table,
-                                         pair)->data.asInt = d_k;
+          btor_insert_in_oa_ptr_hash_table (exp_pair_cnf_diff_id_table,
+                                            pair)->data.asInt = d_k;
 	  hashed_pair = 1;
           for (k = 0; k < len_i_j_w; k++)
             {
@@ -1424,7 +1698,7 @@ encode_lemma (Btor * btor, BtorPtrHashTable * writes, BtorPtrHashTable * aeqs,
                       != 1ul);
               d_k = btor_next_cnf_id_sat_mgr (smgr);
               assert (d_k != 0);
-              BTOR_PUSH_STACK (mm, linking_clause, d_k);
+              BTOR_PUSH_STACK (mm, conclusion, d_k);
               if (aig1 != BTOR_AIG_TRUE && aig2 != BTOR_AIG_TRUE)
                 {
                   if (!BTOR_IS_CONST_AIG (aig1))
@@ -1448,13 +1722,13 @@ encode_lemma (Btor * btor, BtorPtrHashTable * writes, BtorPtrHashTable * aeqs,
       else
         {
           /* we have already encoded i != j,
-           * we simply reuse all diffs for the linking clause */
-          d_k = bucket->data.asInt;
+           * we simply reuse all diffs for the conclusion */
+          d_k = entry->data.asInt;
           assert (d_k != 0);
           for (k = 0; k < len_i_j_w; k++)
             {
               d_k++;
-              BTOR_PUSH_STACK (mm, linking_clause, d_k);
+              BTOR_PUSH_STACK (mm, conclusion, d_k);
             }
         }
     }
@@ -1471,14 +1745,14 @@ encode_lemma (Btor * btor, BtorPtrHashTable * writes, BtorPtrHashTable * aeqs,
 
   pair = new_exp_pair (btor, a, b);
   /* already encoded a = b ? */
-  bucket = btor_find_in_ptr_hash_table (exp_pair_cnf_eq_id_table, pair);
+  entry = btor_find_in_oa_ptr_hash_table (exp_pair_cnf_eq_id_table, pair);
   /* no ? */
-  if (bucket == NULL)
+  if (entry == NULL)
     {
       e = btor_next_cnf_id_sat_mgr (smgr);
       /* hash e */
-      btor_insert_in_ptr_hash_table (exp_pair_cnf_eq_id_table,
-                                     pair)->data.asInt = e;
+      btor_insert_in_oa_ptr_hash_table (exp_pair_cnf_eq_id_table,
+                                        pair)->data.asInt = e;
       for (k = 0; k < len_a_b; k++)
         {
           aig1 = BTOR_COND_INVERT_AIG_EXP (a, av_a->aigs[k]);
@@ -1520,12 +1794,16 @@ encode_lemma (Btor * btor, BtorPtrHashTable * writes, BtorPtrHashTable * aeqs,
   else
     {
       /* we have already encoded a = b into SAT
-       * we simply reuse e for the linking clause */
-      e = bucket->data.asInt;
+       * we simply reuse e for the conclusion */
+      e = entry->data.asInt;
       delete_exp_pair (btor, pair);
     }
   assert (e != 0);
-  BTOR_PUSH_STACK (mm, linking_clause, e);
+  BTOR_PUSH_STACK (mm, conclusion, e);
+
+ENCODE_PREMISSES:
+  BTOR_PUSH_STACK (mm, linking_clause, l);
+
   /* encode i != write index premisses */
   for (bucket = writes->last; bucket != NULL; bucket = bucket->prev)
     {
@@ -1545,14 +1823,14 @@ encode_lemma (Btor * btor, BtorPtrHashTable * writes, BtorPtrHashTable * aeqs,
       if (!assignment_always_unequal (btor, pair, &hashed_pair))
         {
           /* already encoded i != w_index into SAT ? */
-          bucket_temp =
-            btor_find_in_ptr_hash_table (exp_pair_cnf_eq_id_table, pair);
+          entry =
+            btor_find_in_oa_ptr_hash_table (exp_pair_cnf_eq_id_table, pair);
           /* no ? */
-          if (bucket_temp == NULL)
+          if (entry == NULL)
             {
               e = btor_next_cnf_id_sat_mgr (smgr);
-              btor_insert_in_ptr_hash_table (exp_pair_cnf_eq_id_table,
-                                             pair)->data.asInt = e;
+              btor_insert_in_oa_ptr_hash_table (exp_pair_cnf_eq_id_table,
+                                                pair)->data.asInt = e;
 	      hashed_pair = 1;
               for (k = 0; k < len_i_j_w; k++)
                 {
@@ -1596,11 +1874,13 @@ encode_lemma (Btor * btor, BtorPtrHashTable * writes, BtorPtrHashTable * aeqs,
             {
               /* we have already encoded i != w_j into SAT
                * we simply reuse e for the linking clause */
-              e = bucket_temp->data.asInt;
+              e = entry->data.asInt;
             }
           assert (e != 0);
           BTOR_PUSH_STACK (mm, linking_clause, e);
         }
+      else
+        btor->stats.lemma_premisses_dropped++;
 
       if (!hashed_pair)
 	delete_exp_pair (btor, pair);
@@ -1673,23 +1953,47 @@ encode_lemma (Btor * btor, BtorPtrHashTable * writes, BtorPtrHashTable * aeqs,
   /* linking clause must not be true */
   for (lit = linking_clause.start; lit != linking_clause.top; lit++)
     assert (btor_deref_sat (smgr, *lit) != 1);
+  for (lit = conclusion.start; lit != conclusion.top; lit++)
+    assert (*lit == -l || btor_deref_sat (smgr, *lit) != 1);
 #endif
 
-  btor->stats.lclause_size_sum += BTOR_COUNT_STACK (linking_clause);
-
   /* add clauses */
   for (lit = clauses.start; lit != clauses.top; lit++)
     btor_add_sat (smgr, *lit);
   BTOR_RELEASE_STACK (mm, clauses);
 
-  /* add linking clause */
-  while (!BTOR_EMPTY_STACK (linking_clause))
+  /* add conclusion */
+  if (!BTOR_EMPTY_STACK (conclusion))
+    {
+      for (lit = conclusion.start; lit != conclusion.top; lit++)
+        if (!picosat_deref_toplevel (*lit))
+          btor_add_sat (smgr, *lit);
+      btor_add_sat (smgr, 0);
+    }
+  BTOR_RELEASE_STACK (mm, conclusion);
+
+  /* add linking clause, premisses may occur more than once
+   * (e.g. writes with the same index), thus we sort it first */
+  qsort (linking_clause.start, BTOR_COUNT_STACK (linking_clause),
+         sizeof (int), compare_int_ptr);
+  end = linking_clause.start;
+  for (lit = linking_clause.start; lit != linking_clause.top; lit++)
     {
-      k = BTOR_POP_STACK (linking_clause);
-      assert (k != 0);
-      if (!picosat_deref_toplevel (k))
-        btor_add_sat (smgr, k);
+      assert (*lit != 0);
+      if (lit != linking_clause.start && *lit == lit[-1])
+        continue;
+      if (picosat_deref_toplevel (*lit))
+        {
+          assert (picosat_deref_toplevel (*lit) == -1);
+          if (*lit != l)
+            btor->stats.lemma_premisses_dropped++;
+          continue;
+        }
+      *end++ = *lit;
     }
+  btor->stats.lclause_size_sum += end - linking_clause.start;
+  for (lit = linking_clause.start; lit != end; lit++)
+    btor_add_sat (smgr, *lit);
   btor_add_sat (smgr, 0);
   BTOR_RELEASE_STACK (mm, linking_clause);
 }
@@ -2032,6 +2336,9 @@ set_simplified_exp (Btor * btor, BtorExp * exp, BtorExp * simplified,
 
   exp->simplified = btor_copy_exp (btor, simplified);
 
+  /* invalidates rewrite cache */
+  btor->rwc.epoch++;
+
   if (!overwrite)
     return;
 
@@ -2138,6 +2445,15 @@ btor_pointer_chase_simplified_exp (Btor * btor, BtorExp * exp)
         return BTOR_INVERT_EXP (real_exp->simplified);
       return exp->simplified;
     }
+#ifdef BTOR_THREADS
+  /* shortening the path would race with other threads chasing it */
+  if (btor->mutex != NULL)
+    {
+      while (BTOR_REAL_ADDR_EXP (exp)->simplified != NULL)
+        exp = BTOR_COND_INVERT_EXP (exp, BTOR_REAL_ADDR_EXP (exp)->simplified);
+      return exp;
+    }
+#endif
   return recursively_pointer_chase_simplified_exp (btor, exp);
 }
 
@@ -2224,7 +2540,8 @@ connect_child_exp (Btor * btor, BtorExp * parent, BtorExp * child, int pos)
 }
 
 static BtorExp *
-new_const_exp_node (Btor * btor, const char *bits, int len)
+new_const_exp_node (Btor * btor, const char *bits, int len,
+                    unsigned long long value, unsigned int key)
 {
   BtorBVConstExp *exp;
   int i;
@@ -2238,10 +2555,13 @@ new_const_exp_node (Btor * btor, const char *bits, int len)
   btor->ops[BTOR_BV_CONST_EXP]++;
   exp->kind = BTOR_BV_CONST_EXP;
   exp->bytes = sizeof *exp;
-  BTOR_NEWN (btor->mm, exp->bits, len + 1);
+  BTOR_NEWN (BTOR_VIEW_MEM_MGR (btor->mm, BTOR_MEM_CONST), exp->bits,
+             len + 1);
   for (i = 0; i < len; i++)
     exp->bits[i] = bits[i];
   exp->bits[len] = '\0';
+  exp->value = value;
+  exp->key = key;
   exp->len = len;
   BTOR_ABORT_EXP (btor->id == INT_MAX, "expression id overflow");
   exp->id = btor->id++;
@@ -2490,10 +2810,45 @@ btor_compare_exp_by_id (BtorExp * exp0, BtorExp * exp1)
   return 0;
 }
 
+/* Packs the bits of a constant into words and hashes the words.  The
+ * first word, which holds all bits of constants not wider than a word,
+ * is stored in 'value'.
+ */
+static unsigned int
+hash_const_bits (const char *bits, int len, unsigned long long *value)
+{
+  unsigned long long word;
+  unsigned int hash;
+  int i, j, end;
+  assert (bits != NULL);
+  assert (len > 0);
+  assert (value != NULL);
+  *value = 0;
+  word = 0;
+  hash = (unsigned int) len;
+  for (i = 0; i < len; i = end)
+    {
+      end = BTOR_MIN_UTIL (i + BTOR_CONST_WORD_BITS, len);
+      word = 0;
+      for (j = i; j < end; j++)
+        {
+          assert (bits[j] == '0' || bits[j] == '1');
+          word = (word << 1) | (unsigned long long) (bits[j] == '1');
+        }
+      if (i == 0)
+        *value = word;
+      hash = (hash ^ (unsigned int) word ^ (unsigned int) (word >> 32))
+        * BTOR_CONST_WORD_PRIME;
+    }
+  return hash;
+}
+
 /* Finds constant expression in hash table. Returns NULL if it could not be
- * found. */
+ * found. Constants not wider than a word are compared by their packed
+ * bits only, wider constants by their first word and then as strings. */
 static BtorExp **
-find_const_exp (Btor * btor, const char *bits, int len)
+find_const_exp (Btor * btor, const char *bits, int len,
+                unsigned long long value, unsigned int key)
 {
   BtorExp *cur, **result;
   unsigned int hash;
@@ -2501,15 +2856,17 @@ find_const_exp (Btor * btor, const char *bits, int len)
   assert (bits != NULL);
   assert (len > 0);
   assert ((int) strlen (bits) == len);
-  hash = btor_hashstr ((void *) bits);
-  hash = (hash * BTOR_EXP_UNIQUE_TABLE_PRIME) & (btor->table.size - 1);
+  hash = key * BTOR_EXP_UNIQUE_TABLE_PRIME;
+  rehash_exp_unique_table (btor, hash);
+  hash &= btor->table.size - 1;
   result = btor->table.chains + hash;
   cur = *result;
   while (cur != NULL)
     {
       assert (BTOR_IS_REGULAR_EXP (cur));
       if (BTOR_IS_BV_CONST_EXP (cur) && cur->len == len
-          && strcmp (cur->bits, bits) == 0)
+          && cur->key == key && cur->value == value
+          && (len <= BTOR_CONST_WORD_BITS || strcmp (cur->bits, bits) == 0))
         break;
       else
         {
@@ -2520,21 +2877,27 @@ find_const_exp (Btor * btor, const char *bits, int len)
   return result;
 }
 
+static unsigned int
+hash_slice_exp (BtorExp * e0, int upper, int lower)
+{
+  return ((unsigned int) BTOR_REAL_ADDR_EXP (e0)->id + (unsigned int) upper +
+          (unsigned int) lower) * BTOR_EXP_UNIQUE_TABLE_PRIME;
+}
+
 /* Finds slice expression in hash table. Returns NULL if it could not be
- * found. */
+ * found. The hash is computed by 'hash_slice_exp'. */
 static BtorExp **
-find_slice_exp (Btor * btor, BtorExp * e0, int upper, int lower)
+find_slice_exp (Btor * btor, BtorExp * e0, int upper, int lower,
+                unsigned int hash)
 {
   BtorExp *cur, **result;
-  unsigned int hash;
   assert (btor != NULL);
   assert (e0 != NULL);
   assert (lower >= 0);
   assert (upper >= lower);
-  hash =
-    (((unsigned int) BTOR_REAL_ADDR_EXP (e0)->id + (unsigned int) upper +
-      (unsigned int) lower) * BTOR_EXP_UNIQUE_TABLE_PRIME) &
-    (btor->table.size - 1);
+  assert (hash == hash_slice_exp (e0, upper, lower));
+  rehash_exp_unique_table (btor, hash);
+  hash &= btor->table.size - 1;
   result = btor->table.chains + hash;
   cur = *result;
   while (cur != NULL)
@@ -2553,13 +2916,21 @@ find_slice_exp (Btor * btor, BtorExp * e0, int upper, int lower)
 
 }
 
+static unsigned int
+hash_binary_exp (BtorExp * e0, BtorExp * e1)
+{
+  return ((unsigned int) BTOR_REAL_ADDR_EXP (e0)->id +
+          (unsigned int) BTOR_REAL_ADDR_EXP (e1)->id) *
+    BTOR_EXP_UNIQUE_TABLE_PRIME;
+}
+
 /* Finds binary expression in hash table. Returns NULL if it could not be
- * found. */
+ * found. The hash is computed by 'hash_binary_exp'. */
 static BtorExp **
-find_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
+find_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1,
+                 unsigned int hash)
 {
   BtorExp *cur, **result;
-  unsigned int hash;
   assert (btor != NULL);
   assert (BTOR_IS_BINARY_EXP_KIND (kind));
   assert (e0 != NULL);
@@ -2567,10 +2938,9 @@ find_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
   assert (btor->rewrite_level == 0 ||
           !BTOR_IS_BINARY_COMMUTATIVE_EXP_KIND (kind) ||
           BTOR_REAL_ADDR_EXP (e0)->id <= BTOR_REAL_ADDR_EXP (e1)->id);
-  hash =
-    (((unsigned int) BTOR_REAL_ADDR_EXP (e0)->id +
-      (unsigned int) BTOR_REAL_ADDR_EXP (e1)->id) *
-     BTOR_EXP_UNIQUE_TABLE_PRIME) & (btor->table.size - 1);
+  assert (hash == hash_binary_exp (e0, e1));
+  rehash_exp_unique_table (btor, hash);
+  hash &= btor->table.size - 1;
   result = btor->table.chains + hash;
   cur = *result;
   while (cur != NULL)
@@ -2588,24 +2958,30 @@ find_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
 }
 
 
+static unsigned int
+hash_ternary_exp (BtorExp * e0, BtorExp * e1, BtorExp * e2)
+{
+  return ((unsigned) BTOR_REAL_ADDR_EXP (e0)->id +
+          (unsigned) BTOR_REAL_ADDR_EXP (e1)->id +
+          (unsigned) BTOR_REAL_ADDR_EXP (e2)->id) *
+    BTOR_EXP_UNIQUE_TABLE_PRIME;
+}
+
 /* Finds ternary expression in hash table. Returns NULL if it could not be
- * found. */
+ * found. The hash is computed by 'hash_ternary_exp'. */
 static BtorExp **
 find_ternary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0,
-                  BtorExp * e1, BtorExp * e2)
+                  BtorExp * e1, BtorExp * e2, unsigned int hash)
 {
   BtorExp *cur, **result;
-  unsigned int hash;
   assert (btor != NULL);
   assert (BTOR_IS_TERNARY_EXP_KIND (kind));
   assert (e0 != NULL);
   assert (e1 != NULL);
   assert (e2 != NULL);
-  hash =
-    (((unsigned) BTOR_REAL_ADDR_EXP (e0)->id +
-      (unsigned) BTOR_REAL_ADDR_EXP (e1)->id +
-      (unsigned) BTOR_REAL_ADDR_EXP (e2)->id) *
-     BTOR_EXP_UNIQUE_TABLE_PRIME) & (btor->table.size - 1);
+  assert (hash == hash_ternary_exp (e0, e1, e2));
+  rehash_exp_unique_table (btor, hash);
+  hash &= btor->table.size - 1;
   result = btor->table.chains + hash;
   cur = *result;
   while (cur != NULL)
@@ -2623,68 +2999,29 @@ find_ternary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0,
   return result;
 }
 
-/* Enlarges unique table and rehashes expressions. */
+/* Enlarges unique table. The expressions are not rehashed at once but
+ * moved chain by chain during the following lookups, which bounds the
+ * work per insertion (see 'rehash_exp_unique_table').
+ */
 static void
 enlarge_exp_unique_table (Btor * btor)
 {
   BtorMemMgr *mm;
-  int size, new_size, i;
-  unsigned int hash;
-  BtorExp *cur, *temp, **new_chains;
+  int size, new_size;
   assert (btor != NULL);
   mm = btor->mm;
+  while (btor->table.old_chains != NULL)
+    rehash_exp_unique_table (btor, (unsigned int) btor->table.old_pos);
   size = btor->table.size;
   new_size = size << 1;
   assert (new_size / size == 2);
-  BTOR_CNEWN (mm, new_chains, new_size);
-  for (i = 0; i < size; i++)
-    {
-      cur = btor->table.chains[i];
-      while (cur != NULL)
-        {
-          assert (BTOR_IS_REGULAR_EXP (cur));
-          assert (!BTOR_IS_BV_VAR_EXP (cur));
-          assert (!BTOR_IS_ARRAY_VAR_EXP (cur));
-          temp = cur->next;
-          hash = compute_hash_exp (cur, new_size);
-          cur->next = new_chains[hash];
-          new_chains[hash] = cur;
-          cur = temp;
-        }
-    }
-  BTOR_DELETEN (mm, btor->table.chains, size);
+  btor->table.old_chains = btor->table.chains;
+  btor->table.old_size = size;
+  btor->table.old_pos = 0;
+  BTOR_CNEWN (mm, btor->table.chains, new_size);
   btor->table.size = new_size;
-  btor->table.chains = new_chains;
-}
-
-static void
-mark_synth_mark_exp (Btor * btor, BtorExp * exp, int new_mark)
-{
-  BtorMemMgr *mm;
-  BtorExpPtrStack stack;
-  BtorExp *cur;
-  int i;
-
-  assert (btor != NULL);
-  assert (exp != NULL);
-
-  mm = btor->mm;
-  BTOR_INIT_STACK (stack);
-  cur = BTOR_REAL_ADDR_EXP (exp);
-  goto MARK_SYNTH_MARK_EXP_ENTER_WITHOUT_POP;
-
-  while (!BTOR_EMPTY_STACK (stack))
-    {
-      cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
-MARK_SYNTH_MARK_EXP_ENTER_WITHOUT_POP:
-      if (cur->synth_mark != new_mark)
-        {
-          cur->synth_mark = new_mark;
-          for (i = cur->arity - 1; i >= 0; i--)
-            BTOR_PUSH_STACK (mm, stack, cur->e[i]);
-        }
-    }
-  BTOR_RELEASE_STACK (mm, stack);
+  BTOR_TRACE_INSTANT ("exp table resize", "size", new_size,
+                      "exps", btor->table.num_elements);
 }
 
 void
@@ -2699,7 +3036,7 @@ btor_mark_exp (Btor * btor, BtorExp * exp, int new_mark)
   assert (exp != NULL);
 
   mm = btor->mm;
-  BTOR_INIT_STACK (stack);
+  init_trv_stack (btor, &stack);
   cur = BTOR_REAL_ADDR_EXP (exp);
   goto BTOR_MARK_EXP_ENTER_WITHOUT_POP;
 
@@ -2714,13 +3051,15 @@ BTOR_MARK_EXP_ENTER_WITHOUT_POP:
             BTOR_PUSH_STACK (mm, stack, cur->e[i]);
         }
     }
-  BTOR_RELEASE_STACK (mm, stack);
+  release_trv_stack (btor, &stack);
 }
 
 BtorExp *
 btor_const_exp (Btor * btor, const char *bits)
 {
-  BtorExp **lookup;
+  unsigned long long value;
+  BtorExp **lookup, *result;
+  unsigned int key;
   int inv, len;
   char *lookupbits;
 
@@ -2730,6 +3069,7 @@ btor_const_exp (Btor * btor, const char *bits)
 
   len = (int) strlen (bits);
   assert (len > 0);
+  value = 0;
   inv = 0;
   lookupbits = (char *) bits;
   if (btor->rewrite_level > 0)
@@ -2741,29 +3081,60 @@ btor_const_exp (Btor * btor, const char *bits)
           inv = 1;
         }
     }
-  lookup = find_const_exp (btor, lookupbits, len);
+  key = hash_const_bits (lookupbits, len, &value);
+  BTOR_LOCK_EXP (btor);
+  lookup = find_const_exp (btor, lookupbits, len, value, key);
   if (*lookup == NULL)
     {
       if (btor->table.num_elements == btor->table.size &&
           btor_log_2_util (btor->table.size) < BTOR_EXP_UNIQUE_TABLE_LIMIT)
         {
           enlarge_exp_unique_table (btor);
-          lookup = find_const_exp (btor, lookupbits, len);
+          lookup = find_const_exp (btor, lookupbits, len, value, key);
         }
-      *lookup = new_const_exp_node (btor, lookupbits, len);
+      *lookup = new_const_exp_node (btor, lookupbits, len, value, key);
       assert (btor->table.num_elements < INT_MAX);
       btor->table.num_elements++;
       (*lookup)->unique = 1;
     }
   else
     inc_exp_ref_counter (btor, *lookup);
-  assert (BTOR_IS_REGULAR_EXP (*lookup));
+  result = *lookup;
+  BTOR_UNLOCK_EXP (btor);
+  assert (BTOR_IS_REGULAR_EXP (result));
   if (inv)
     {
       btor_delete_const (btor->mm, lookupbits);
-      return BTOR_INVERT_EXP (*lookup);
+      return BTOR_INVERT_EXP (result);
+    }
+  return result;
+}
+
+/* Looks up zero, one and ones constants of width 'len' in 'cache'
+ * before building them from a string by 'new_const'. */
+static BtorExp *
+cached_const_exp (Btor * btor, BtorExp ** cache,
+                  char *(*new_const) (BtorMemMgr *, int), int len)
+{
+  char *string;
+  BtorExp *result;
+  assert (btor != NULL);
+  assert (cache != NULL);
+  assert (new_const != NULL);
+  assert (len > 0);
+  BTOR_LOCK_EXP (btor);
+  if (len <= BTOR_CONST_CACHE_LEN && cache[len] != NULL)
+    result = btor_copy_exp (btor, cache[len]);
+  else
+    {
+      string = new_const (btor->mm, len);
+      result = btor_const_exp (btor, string);
+      btor_delete_const (btor->mm, string);
+      if (len <= BTOR_CONST_CACHE_LEN)
+        cache[len] = result;
     }
-  return *lookup;
+  BTOR_UNLOCK_EXP (btor);
+  return result;
 }
 
 static BtorExp *
@@ -2783,16 +3154,9 @@ int_min_exp (Btor * btor, int len)
 BtorExp *
 btor_zero_exp (Btor * btor, int len)
 {
-  char *string;
-  BtorExp *result;
-
   assert (btor != NULL);
   assert (len > 0);
-
-  string = btor_zero_const (btor->mm, len);
-  result = btor_const_exp (btor, string);
-  btor_delete_const (btor->mm, string);
-  return result;
+  return cached_const_exp (btor, btor->cc.zero, btor_zero_const, len);
 }
 
 BtorExp *
@@ -2805,31 +3169,17 @@ btor_false_exp (Btor * btor)
 BtorExp *
 btor_ones_exp (Btor * btor, int len)
 {
-  char *string;
-  BtorExp *result;
-
   assert (btor != NULL);
   assert (len > 0);
-
-  string = btor_ones_const (btor->mm, len);
-  result = btor_const_exp (btor, string);
-  btor_delete_const (btor->mm, string);
-  return result;
+  return cached_const_exp (btor, btor->cc.ones, btor_ones_const, len);
 }
 
 BtorExp *
 btor_one_exp (Btor * btor, int len)
 {
-  char *string;
-  BtorExp *result;
-
   assert (btor != NULL);
   assert (len > 0);
-
-  string = btor_one_const (btor->mm, len);
-  result = btor_const_exp (btor, string);
-  btor_delete_const (btor->mm, string);
-  return result;
+  return cached_const_exp (btor, btor->cc.one, btor_one_const, len);
 }
 
 BtorExp *
@@ -2880,6 +3230,7 @@ btor_var_exp (Btor * btor, int len, const char *symbol)
   assert (symbol != NULL);
 
   mm = btor->mm;
+  BTOR_LOCK_EXP (btor);
   BTOR_CNEW (mm, exp);
   btor->stats.expressions++;
   btor->ops[BTOR_BV_VAR_EXP]++;
@@ -2895,6 +3246,7 @@ btor_var_exp (Btor * btor, int len, const char *symbol)
   if (btor->ua.enabled)
     hash_var_read_for_ua (btor, (BtorExp *) exp);
   (void) btor_insert_in_ptr_hash_table (btor->bv_vars, exp);
+  BTOR_UNLOCK_EXP (btor);
   return (BtorExp *) exp;
 }
 
@@ -2910,6 +3262,7 @@ btor_array_exp (Btor * btor, int elem_len, int index_len, const char *symbol)
   assert (symbol != NULL);
 
   mm = btor->mm;
+  BTOR_LOCK_EXP (btor);
   BTOR_CNEW (mm, exp);
   btor->stats.expressions++;
   btor->ops[BTOR_ARRAY_VAR_EXP]++;
@@ -2923,13 +3276,15 @@ btor_array_exp (Btor * btor, int elem_len, int index_len, const char *symbol)
   exp->refs = 1;
   exp->btor = btor;
   (void) btor_insert_in_ptr_hash_table (btor->array_vars, exp);
+  BTOR_UNLOCK_EXP (btor);
   return (BtorExp *) exp;
 }
 
 static BtorExp *
 unary_exp_slice_exp (Btor * btor, BtorExp * exp, int upper, int lower)
 {
-  BtorExp **lookup;
+  BtorExp **lookup, *result;
+  unsigned int hash;
   assert (btor != NULL);
   assert (exp != NULL);
   int inv;
@@ -2949,14 +3304,16 @@ unary_exp_slice_exp (Btor * btor, BtorExp * exp, int upper, int lower)
   else
     inv = 0;
 
-  lookup = find_slice_exp (btor, exp, upper, lower);
+  hash = hash_slice_exp (exp, upper, lower);
+  BTOR_LOCK_EXP (btor);
+  lookup = find_slice_exp (btor, exp, upper, lower, hash);
   if (*lookup == NULL)
     {
       if (btor->table.num_elements == btor->table.size &&
           btor_log_2_util (btor->table.size) < BTOR_EXP_UNIQUE_TABLE_LIMIT)
         {
           enlarge_exp_unique_table (btor);
-          lookup = find_slice_exp (btor, exp, upper, lower);
+          lookup = find_slice_exp (btor, exp, upper, lower, hash);
         }
       *lookup = new_slice_exp_node (btor, exp, upper, lower);
       inc_exp_ref_counter (btor, exp);
@@ -2966,10 +3323,12 @@ unary_exp_slice_exp (Btor * btor, BtorExp * exp, int upper, int lower)
     }
   else
     inc_exp_ref_counter (btor, *lookup);
-  assert (BTOR_IS_REGULAR_EXP (*lookup));
+  result = *lookup;
+  BTOR_UNLOCK_EXP (btor);
+  assert (BTOR_IS_REGULAR_EXP (result));
   if (inv)
-    return BTOR_INVERT_EXP (*lookup);
-  return *lookup;
+    return BTOR_INVERT_EXP (result);
+  return result;
 }
 
 BtorExp *
@@ -2984,7 +3343,8 @@ btor_slice_exp_node (Btor * btor, BtorExp * exp, int upper, int lower)
 static BtorExp *
 binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1, int len)
 {
-  BtorExp **lookup, *temp;
+  BtorExp **lookup, *temp, *result;
+  unsigned int hash;
   assert (btor != NULL);
   assert (BTOR_IS_BINARY_EXP_KIND (kind));
   assert (e0 != NULL);
@@ -3004,14 +3364,16 @@ binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1, int len)
   assert (btor->rewrite_level == 0 ||
           !BTOR_IS_BINARY_COMMUTATIVE_EXP_KIND (kind) ||
           BTOR_REAL_ADDR_EXP (e0)->id <= BTOR_REAL_ADDR_EXP (e1)->id);
-  lookup = find_binary_exp (btor, kind, e0, e1);
+  hash = hash_binary_exp (e0, e1);
+  BTOR_LOCK_EXP (btor);
+  lookup = find_binary_exp (btor, kind, e0, e1, hash);
   if (*lookup == NULL)
     {
       if (btor->table.num_elements == btor->table.size
           && btor_log_2_util (btor->table.size) < BTOR_EXP_UNIQUE_TABLE_LIMIT)
         {
           enlarge_exp_unique_table (btor);
-          lookup = find_binary_exp (btor, kind, e0, e1);
+          lookup = find_binary_exp (btor, kind, e0, e1, hash);
         }
       if (kind == BTOR_AEQ_EXP)
         *lookup = new_aeq_exp_node (btor, e0, e1);
@@ -3025,8 +3387,10 @@ binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1, int len)
     }
   else
     inc_exp_ref_counter (btor, *lookup);
-  assert (BTOR_IS_REGULAR_EXP (*lookup));
-  return *lookup;
+  result = *lookup;
+  BTOR_UNLOCK_EXP (btor);
+  assert (BTOR_IS_REGULAR_EXP (result));
+  return result;
 }
 
 BtorExp *
@@ -3143,7 +3507,8 @@ static BtorExp *
 ternary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0,
              BtorExp * e1, BtorExp * e2, int len)
 {
-  BtorExp **lookup;
+  BtorExp **lookup, *result;
+  unsigned int hash;
   assert (btor != NULL);
   assert (BTOR_IS_TERNARY_EXP_KIND (kind));
   assert (e0 != NULL);
@@ -3154,14 +3519,16 @@ ternary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0,
   e1 = btor_pointer_chase_simplified_exp (btor, e1);
   e2 = btor_pointer_chase_simplified_exp (btor, e2);
 
-  lookup = find_ternary_exp (btor, kind, e0, e1, e2);
+  hash = hash_ternary_exp (e0, e1, e2);
+  BTOR_LOCK_EXP (btor);
+  lookup = find_ternary_exp (btor, kind, e0, e1, e2, hash);
   if (*lookup == NULL)
     {
       if (btor->table.num_elements == btor->table.size &&
           btor_log_2_util (btor->table.size) < BTOR_EXP_UNIQUE_TABLE_LIMIT)
         {
           enlarge_exp_unique_table (btor);
-          lookup = find_ternary_exp (btor, kind, e0, e1, e2);
+          lookup = find_ternary_exp (btor, kind, e0, e1, e2, hash);
         }
       switch (kind)
         {
@@ -3185,8 +3552,10 @@ ternary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0,
     }
   else
     inc_exp_ref_counter (btor, *lookup);
-  assert (BTOR_IS_REGULAR_EXP (*lookup));
-  return *lookup;
+  result = *lookup;
+  BTOR_UNLOCK_EXP (btor);
+  assert (BTOR_IS_REGULAR_EXP (result));
+  return result;
 }
 
 BtorExp *
@@ -3226,8 +3595,9 @@ btor_not_exp (Btor * btor, BtorExp * exp)
   exp = btor_pointer_chase_simplified_exp (btor, exp);
   assert (btor_precond_regular_unary_bv_exp_dbg (btor, exp));
 
-  (void) btor;
+  BTOR_LOCK_EXP (btor);
   inc_exp_ref_counter (btor, exp);
+  BTOR_UNLOCK_EXP (btor);
   return BTOR_INVERT_EXP (exp);
 }
 
@@ -5145,6 +5515,9 @@ btor_new_btor (void)
 {
   BtorMemMgr *mm;
   Btor *btor;
+  /* 'bytes' has 8 bits, hot fields end at the first cache line */
+  assert (sizeof (BtorExp) < 256);
+  assert (sizeof (void *) != 8 || offsetof (BtorExp, epoch) == 64);
   mm = btor_new_mem_mgr ();
   BTOR_CNEW (mm, btor);
   btor->mm = mm;
@@ -5164,16 +5537,21 @@ btor_new_btor (void)
   btor->valid_assignments = 1;
   btor->rewrite_level = 3;
   btor->vread_index_id = 1;
+  btor->row.read_prop_limit = BTOR_READ_OVER_WRITE_DOWN_PROPAGATION_LIMIT;
+  btor->row.write_chain_bound = BTOR_WRITE_CHAIN_EXP_RW_BOUND;
 
   btor->exp_pair_cnf_diff_id_table =
-    btor_new_ptr_hash_table (mm, (BtorHashPtr) hash_exp_pair,
-                             (BtorCmpPtr) compare_exp_pair);
+    btor_new_oa_ptr_hash_table (mm, (BtorHashPtr) hash_exp_pair,
+                                (BtorCmpPtr) compare_exp_pair);
   btor->exp_pair_cnf_eq_id_table =
-    btor_new_ptr_hash_table (mm, (BtorHashPtr) hash_exp_pair,
-                             (BtorCmpPtr) compare_exp_pair);
+    btor_new_oa_ptr_hash_table (mm, (BtorHashPtr) hash_exp_pair,
+                                (BtorCmpPtr) compare_exp_pair);
   btor->exp_pair_ass_unequal_table =
-    btor_new_ptr_hash_table (mm, (BtorHashPtr) hash_exp_pair,
-                             (BtorCmpPtr) compare_exp_pair);
+    btor_new_oa_ptr_hash_table (mm, (BtorHashPtr) hash_exp_pair,
+                                (BtorCmpPtr) compare_exp_pair);
+  btor->lemma_lit_table =
+    btor_new_oa_ptr_hash_table (mm, (BtorHashPtr) hash_exp_pair,
+                                (BtorCmpPtr) compare_exp_pair);
   btor->varsubst_constraints =
     btor_new_ptr_hash_table (mm, (BtorHashPtr) btor_hash_exp_by_id,
                              (BtorCmpPtr) btor_compare_exp_by_id);
@@ -5263,45 +5641,90 @@ btor_set_under_approx_initial_effective_width (Btor * btor,
 }
 
 void
-btor_set_under_approx_mode (Btor * btor, BtorUAMode mode)
+btor_enable_lazy_arith (Btor * btor)
 {
   assert (btor != NULL);
   assert (btor->id == 1);
-  btor->ua.mode = mode;
+  assert (!btor->la.enabled);
+  btor->la.enabled = 1;
+  btor->la.min_width = BTOR_LA_DEFAULT_MIN_WIDTH;
+  BTOR_INIT_STACK (btor->la.ops);
 }
 
 void
-btor_set_under_approx_ref (Btor * btor, BtorUARef ref)
+btor_enable_eqsat (Btor * btor)
 {
   assert (btor != NULL);
   assert (btor->id == 1);
-  btor->ua.ref = ref;
+  btor->eqsat = 1;
 }
 
 void
-btor_set_under_approx_enc (Btor * btor, BtorUAEnc enc)
+btor_set_lazy_arith_min_width (Btor * btor, int min_width)
 {
   assert (btor != NULL);
   assert (btor->id == 1);
-  btor->ua.enc = enc;
+  assert (btor->la.enabled);
+  assert (min_width > 0);
+  btor->la.min_width = min_width;
 }
 
 void
-btor_set_replay_btor (Btor * btor, int replay)
+btor_set_read_over_write_limit (Btor * btor, int limit)
 {
   assert (btor != NULL);
-  assert (btor->varsubst_constraints->count +
-          btor->embedded_constraints->count +
-          btor->unsynthesized_constraints->count +
-          btor->synthesized_constraints->count + btor->assumptions->count ==
-          0u);
-  btor->replay = replay;
+  assert (limit > 0);
+  btor->row.read_prop_limit = limit;
 }
 
 void
-btor_set_verbosity_btor (Btor * btor, int verbosity)
+btor_set_write_chain_bound (Btor * btor, int bound)
 {
-  BtorAIGVecMgr *avmgr;
+  assert (btor != NULL);
+  assert (bound >= 0);
+  btor->row.write_chain_bound = bound;
+}
+
+void
+btor_set_under_approx_mode (Btor * btor, BtorUAMode mode)
+{
+  assert (btor != NULL);
+  assert (btor->id == 1);
+  btor->ua.mode = mode;
+}
+
+void
+btor_set_under_approx_ref (Btor * btor, BtorUARef ref)
+{
+  assert (btor != NULL);
+  assert (btor->id == 1);
+  btor->ua.ref = ref;
+}
+
+void
+btor_set_under_approx_enc (Btor * btor, BtorUAEnc enc)
+{
+  assert (btor != NULL);
+  assert (btor->id == 1);
+  btor->ua.enc = enc;
+}
+
+void
+btor_set_replay_btor (Btor * btor, int replay)
+{
+  assert (btor != NULL);
+  assert (btor->varsubst_constraints->count +
+          btor->embedded_constraints->count +
+          btor->unsynthesized_constraints->count +
+          btor->synthesized_constraints->count + btor->assumptions->count ==
+          0u);
+  btor->replay = replay;
+}
+
+void
+btor_set_verbosity_btor (Btor * btor, int verbosity)
+{
+  BtorAIGVecMgr *avmgr;
   BtorAIGMgr *amgr;
   BtorSATMgr *smgr;
 
@@ -5330,17 +5753,28 @@ btor_delete_btor (Btor * btor)
 
   mm = btor->mm;
 
-  for (b = btor->exp_pair_cnf_diff_id_table->first; b != NULL; b = b->next)
-    delete_exp_pair (btor, (BtorExpPair *) b->key);
-  btor_delete_ptr_hash_table (btor->exp_pair_cnf_diff_id_table);
+  btor_delete_rw_cache (btor);
+  btor_delete_write_index (btor);
+
+  for (i = 0; i < btor->exp_pair_cnf_diff_id_table->count; i++)
+    delete_exp_pair (btor,
+                     (BtorExpPair *) btor->exp_pair_cnf_diff_id_table->entries[i].key);
+  btor_delete_oa_ptr_hash_table (btor->exp_pair_cnf_diff_id_table);
 
-  for (b = btor->exp_pair_cnf_eq_id_table->first; b != NULL; b = b->next)
-    delete_exp_pair (btor, (BtorExpPair *) b->key);
-  btor_delete_ptr_hash_table (btor->exp_pair_cnf_eq_id_table);
+  for (i = 0; i < btor->exp_pair_cnf_eq_id_table->count; i++)
+    delete_exp_pair (btor,
+                     (BtorExpPair *) btor->exp_pair_cnf_eq_id_table->entries[i].key);
+  btor_delete_oa_ptr_hash_table (btor->exp_pair_cnf_eq_id_table);
 
-  for (b = btor->exp_pair_ass_unequal_table->first; b != NULL; b = b->next)
-    delete_exp_pair (btor, (BtorExpPair *) b->key);
-  btor_delete_ptr_hash_table (btor->exp_pair_ass_unequal_table);
+  for (i = 0; i < btor->exp_pair_ass_unequal_table->count; i++)
+    delete_exp_pair (btor,
+                     (BtorExpPair *) btor->exp_pair_ass_unequal_table->entries[i].key);
+  btor_delete_oa_ptr_hash_table (btor->exp_pair_ass_unequal_table);
+
+  for (i = 0; i < btor->lemma_lit_table->count; i++)
+    delete_exp_pair (btor,
+                     (BtorExpPair *) btor->lemma_lit_table->entries[i].key);
+  btor_delete_oa_ptr_hash_table (btor->lemma_lit_table);
 
 
   /* delete constraints and assumptions */
@@ -5394,6 +5828,15 @@ btor_delete_btor (Btor * btor)
       btor_delete_ptr_hash_table (btor->ua.writes_aconds);
     }
 
+  if (btor->la.enabled)
+    {
+      while (!BTOR_EMPTY_STACK (btor->la.ops))
+        delete_lazy_arith_op (btor, BTOR_POP_STACK (btor->la.ops));
+      BTOR_RELEASE_STACK (mm, btor->la.ops);
+    }
+
+  delete_trv_pool (btor);
+
   btor_delete_aigvec_mgr (btor->avmgr);
   assert (btor->rec_rw_calls == 0);
   BTOR_DELETE (mm, btor);
@@ -5719,13 +6162,15 @@ btor_print_stats_btor (Btor * btor)
   int max_var_width, max_read_width, min_var_width, min_read_width;
   int max_var_eff_width, max_read_eff_width, min_var_eff_width;
   int min_read_eff_width, verbosity, min_width;
-  int max_width, min_eff_width, max_eff_width, i;
+  int max_width, min_eff_width, max_eff_width, i, kind;
   int num_final_ops;
   BtorUAMode ua_mode;
+  BtorMemMgr *mm;
 
   assert (btor != NULL);
   assert (btor->verbosity > 0);
 
+  mm = btor->mm;
   ua_mode = btor->ua.mode;
   verbosity = btor->verbosity;
 
@@ -5736,6 +6181,12 @@ btor_print_stats_btor (Btor * btor)
                      btor->stats.array_substitutions);
   btor_msg_exp ("embedded constraint substitutions: %d",
                      btor->stats.ec_substitutions);
+  btor_msg_exp ("rebuild rounds (rebuilt expressions): %d (%lld)",
+                btor->stats.rebuild_rounds, btor->stats.rebuilds);
+  if (btor->stats.components > 1)
+    btor_msg_exp ("components (solved, max. seconds): %d (%d, %.2f)",
+                  btor->stats.components, btor->stats.components_solved,
+                  btor->stats.component_time_max);
   btor_msg_exp ("assumptions: %u", btor->assumptions->count);
   if (btor->ops[BTOR_AEQ_EXP])
     btor_msg_exp ("virtual reads: %d", btor->stats.vreads);
@@ -5744,6 +6195,11 @@ btor_print_stats_btor (Btor * btor)
     {
       btor_msg_exp ("max rec. RW: %d", btor->stats.max_rec_rw_calls);
       btor_msg_exp ("domain abstractions: %d", btor->stats.domain_abst);
+      btor_msg_exp ("bit-width reductions: %d", btor->stats.bw_reductions);
+      if (btor->eqsat)
+        btor_msg_exp ("equality saturation (nodes, rewrites, seconds): "
+                      "%lld (%d, %.2f)", btor->stats.es_nodes,
+                      btor->stats.es_rewrites, btor->stats.es_time);
 #if BTOR_ENABLE_PROBING_OPT
       btor_msg_exp ("probed equalites: %d", btor->stats.probed_equalities);
 #endif
@@ -5751,6 +6207,8 @@ btor_print_stats_btor (Btor * btor)
 	            btor->stats.bv_uc_props);
       btor_msg_exp ("unconstrained array propagations: %d", 
 	            btor->stats.array_uc_props);
+      btor_msg_exp ("unconstrained clauses saved (estimated): %lld",
+                    btor->stats.uc_clauses);
       btor_msg_exp ("number of expressions ever created: %lld", 
 	            btor->stats.expressions);
       num_final_ops = number_of_ops (btor);
@@ -5760,6 +6218,12 @@ btor_print_stats_btor (Btor * btor)
         for (i = 1; i < BTOR_NUM_OPS_EXP - 1; i++)
 	  if (btor->ops[i])
 	    btor_msg_exp (" %s:%d", g_op2string[i], btor->ops[i]);
+      btor_msg_exp ("rewrite calls (cached, rewritten, seconds):");
+      for (i = 1; i < BTOR_NUM_OPS_EXP - 1; i++)
+        if (btor->stats.rw[i].calls)
+          btor_msg_exp (" %s:%lld (%lld, %lld, %.2f)", g_op2string[i],
+                        btor->stats.rw[i].calls, btor->stats.rw[i].cached,
+                        btor->stats.rw[i].rewritten, btor->stats.rw[i].time);
     }
 
   if (btor->ua.enabled)
@@ -5839,6 +6303,14 @@ btor_print_stats_btor (Btor * btor)
     }
 
 BTOR_CONTINUE_BASIC_STATS_OUTPUT:
+  if (btor->la.enabled)
+    {
+      btor_msg_exp ("");
+      btor_msg_exp ("lazy arithmetic (LA) statistics:");
+      btor_msg_exp (" LA abstractions: %d", btor->stats.la_abstractions);
+      btor_msg_exp (" LA refinements: %d", btor->stats.la_refinements);
+    }
+
   btor_msg_exp ("");
   btor_msg_exp ("lemmas on demand statistics:");
   btor_msg_exp (" LOD refinements: %d", btor->stats.lod_refinements);
@@ -5854,15 +6326,44 @@ BTOR_CONTINUE_BASIC_STATS_OUTPUT:
       btor_msg_exp (" average linking clause size: %.1f",
                          BTOR_AVERAGE_UTIL (btor->stats.lclause_size_sum,
                                             btor->stats.lod_refinements));
+      btor_msg_exp (" lemma literal cache hits: %d",
+                         btor->stats.lemma_cache_hits);
+      btor_msg_exp (" premisses dropped at top level: %lld",
+                         btor->stats.lemma_premisses_dropped);
     }
   btor_msg_exp ("");
 
+  btor_msg_exp ("phase times (wall clock seconds):");
+  btor_msg_exp (" solve: %.2f (SAT calls: %d)",
+                btor->time.solve, btor->stats.sat_calls);
+  btor_msg_exp (" rewriting: %.2f", btor->time.rewrite);
+  btor_msg_exp (" synthesis: %.2f", btor->time.synthesis);
+  btor_msg_exp (" SAT solving: %.2f", btor->time.sat);
+  btor_msg_exp (" lemma generation: %.2f", btor->time.lemmas);
+  btor_msg_exp ("");
+
+  btor_msg_exp ("memory (MB current/max):");
+  for (kind = BTOR_MEM_EXP; kind < BTOR_NUM_MEM_KINDS; kind++)
+    btor_msg_exp (" %s: %.1f/%.1f", btor_name_mem_kind ((BtorMemKind) kind),
+                  mm->kind_allocated[kind] / (double) (1 << 20),
+                  mm->kind_maxallocated[kind] / (double) (1 << 20));
+  if (mm->limited)
+    btor_msg_exp (" limit: %.1f%s", mm->limitallocated / (double) (1 << 20),
+                  btor_is_limit_exceeded_mem_mgr (mm) ? " (exceeded)" : "");
+  if (btor->stats.sat_restarts)
+    btor_msg_exp (" SAT restarts: %d", btor->stats.sat_restarts);
+  btor_msg_exp ("");
+
   btor_msg_exp ("linear constraint equations: %d",
                      btor->stats.linear_equations);
+  btor_msg_exp ("gaussian elimination (equations, substitutions): %d (%d)",
+                btor->stats.gauss_equations, btor->stats.gauss_substs);
   btor_msg_exp ("add normalizations: %d", btor->stats.adds_normalized);
   btor_msg_exp ("mul normalizations: %d", btor->stats.muls_normalized);
   btor_msg_exp ("read over write propagations during construction: %d",
                      btor->stats.read_props_construct);
+  btor_msg_exp ("read over write index skips during construction: %d",
+                btor->stats.read_props_index);
   btor_msg_exp ("synthesis assignment inconsistencies: %d",
                      btor->stats.synthesis_assignment_inconsistencies);
 }
@@ -6017,6 +6518,7 @@ propagate_3vl_to_aigvec (Btor * btor, BtorExp * exp)
 
       if (!BTOR_IS_CONST_AIG (av->aigs[i]) && bits[i] != 'x')
         {
+          btor_unshare_aigvec (btor->avmgr, av);
           btor_release_aig (amgr, av->aigs[i]);
           if (bits[i] == '0')
             av->aigs[i] = BTOR_AIG_FALSE;
@@ -6028,10 +6530,291 @@ propagate_3vl_to_aigvec (Btor * btor, BtorExp * exp)
 
 #endif
 
+static int
+is_lazy_arith_exp (Btor * btor, BtorExp * exp)
+{
+  assert (btor != NULL);
+  assert (exp != NULL);
+  assert (BTOR_IS_REGULAR_EXP (exp));
+  return btor->la.enabled && exp->len >= btor->la.min_width
+    && (exp->kind == BTOR_MUL_EXP || exp->kind == BTOR_UDIV_EXP
+        || exp->kind == BTOR_UREM_EXP);
+}
+
+/* Converts one bit AIG vector into AIG and deletes vector */
+static BtorAIG *
+aigvec_to_aig_lazy_arith (Btor * btor, BtorAIGVec * av)
+{
+  BtorAIGMgr *amgr;
+  BtorAIG *result;
+  assert (btor != NULL);
+  assert (av != NULL);
+  assert (av->len == 1);
+  amgr = btor_get_aig_mgr_aigvec_mgr (btor->avmgr);
+  result = btor_copy_aig (amgr, av->aigs[0]);
+  btor_release_delete_aigvec (btor->avmgr, av);
+  return result;
+}
+
+/* Adds 'premise -> conclusion' to the SAT solver and releases both */
+static void
+add_lazy_arith_axiom (Btor * btor, BtorAIG * premise, BtorAIG * conclusion)
+{
+  BtorAIGMgr *amgr;
+  BtorAIG *axiom;
+  assert (btor != NULL);
+  amgr = btor_get_aig_mgr_aigvec_mgr (btor->avmgr);
+  axiom = btor_or_aig (amgr, BTOR_INVERT_AIG (premise), conclusion);
+  btor_add_toplevel_aig_to_sat (amgr, axiom);
+  btor_release_aig (amgr, axiom);
+  btor_release_aig (amgr, premise);
+  btor_release_aig (amgr, conclusion);
+}
+
+/* Adds cheap axioms for abstracted operation to the SAT solver */
+static void
+encode_lazy_arith_axioms (Btor * btor, BtorLazyArithOp * op)
+{
+  BtorAIGVecMgr *avmgr;
+  BtorAIGMgr *amgr;
+  BtorAIGVec *a, *b, *r, *zero, *one;
+  BtorAIG *a_zero, *b_zero, *b_one, *a_ult_b, *lsb;
+  char *bits;
+  int len;
+
+  assert (btor != NULL);
+  assert (op != NULL);
+
+  avmgr = btor->avmgr;
+  amgr = btor_get_aig_mgr_aigvec_mgr (avmgr);
+  a = op->av[0];
+  b = op->av[1];
+  r = op->av[2];
+  len = r->len;
+
+  bits = btor_zero_const (btor->mm, len);
+  zero = btor_const_aigvec (avmgr, bits);
+  btor_delete_const (btor->mm, bits);
+  bits = btor_one_const (btor->mm, len);
+  one = btor_const_aigvec (avmgr, bits);
+  btor_delete_const (btor->mm, bits);
+
+  b_zero = aigvec_to_aig_lazy_arith (btor, btor_eq_aigvec (avmgr, b, zero));
+  b_one = aigvec_to_aig_lazy_arith (btor, btor_eq_aigvec (avmgr, b, one));
+
+  switch (op->kind)
+    {
+    case BTOR_MUL_EXP:
+      /* a = 0 -> r = 0, b = 0 -> r = 0, a = 1 -> r = b, b = 1 -> r = a */
+      a_zero = aigvec_to_aig_lazy_arith (btor,
+                                         btor_eq_aigvec (avmgr, a, zero));
+      add_lazy_arith_axiom (btor, a_zero,
+                            aigvec_to_aig_lazy_arith (btor,
+                              btor_eq_aigvec (avmgr, r, zero)));
+      add_lazy_arith_axiom (btor, btor_copy_aig (amgr, b_zero),
+                            aigvec_to_aig_lazy_arith (btor,
+                              btor_eq_aigvec (avmgr, r, zero)));
+      add_lazy_arith_axiom (btor,
+                            aigvec_to_aig_lazy_arith (btor,
+                              btor_eq_aigvec (avmgr, a, one)),
+                            aigvec_to_aig_lazy_arith (btor,
+                              btor_eq_aigvec (avmgr, r, b)));
+      add_lazy_arith_axiom (btor, btor_copy_aig (amgr, b_one),
+                            aigvec_to_aig_lazy_arith (btor,
+                              btor_eq_aigvec (avmgr, r, a)));
+      /* least significant bit is the conjunction of the operand bits */
+      lsb = btor_and_aig (amgr, a->aigs[len - 1], b->aigs[len - 1]);
+      add_lazy_arith_axiom (btor, btor_copy_aig (amgr, BTOR_AIG_TRUE),
+                            btor_eq_aig (amgr, lsb, r->aigs[len - 1]));
+      btor_release_aig (amgr, lsb);
+      break;
+    case BTOR_UDIV_EXP:
+      /* b = 1 -> r = a, a < b -> r = 0, b != 0 -> r <= a */
+      add_lazy_arith_axiom (btor, btor_copy_aig (amgr, b_one),
+                            aigvec_to_aig_lazy_arith (btor,
+                              btor_eq_aigvec (avmgr, r, a)));
+      a_ult_b = aigvec_to_aig_lazy_arith (btor,
+                                          btor_ult_aigvec (avmgr, a, b));
+      add_lazy_arith_axiom (btor, a_ult_b,
+                            aigvec_to_aig_lazy_arith (btor,
+                              btor_eq_aigvec (avmgr, r, zero)));
+      add_lazy_arith_axiom (btor, btor_not_aig (amgr, b_zero),
+                            BTOR_INVERT_AIG (aigvec_to_aig_lazy_arith
+                                             (btor, btor_ult_aigvec (avmgr,
+                                                                     a, r))));
+      break;
+    default:
+      assert (op->kind == BTOR_UREM_EXP);
+      /* b = 1 -> r = 0, a < b -> r = a, b != 0 -> r < b and r <= a */
+      add_lazy_arith_axiom (btor, btor_copy_aig (amgr, b_one),
+                            aigvec_to_aig_lazy_arith (btor,
+                              btor_eq_aigvec (avmgr, r, zero)));
+      a_ult_b = aigvec_to_aig_lazy_arith (btor,
+                                          btor_ult_aigvec (avmgr, a, b));
+      add_lazy_arith_axiom (btor, a_ult_b,
+                            aigvec_to_aig_lazy_arith (btor,
+                              btor_eq_aigvec (avmgr, r, a)));
+      add_lazy_arith_axiom (btor, btor_not_aig (amgr, b_zero),
+                            aigvec_to_aig_lazy_arith (btor,
+                              btor_ult_aigvec (avmgr, r, b)));
+      add_lazy_arith_axiom (btor, btor_not_aig (amgr, b_zero),
+                            BTOR_INVERT_AIG (aigvec_to_aig_lazy_arith
+                                             (btor, btor_ult_aigvec (avmgr,
+                                                                     a, r))));
+      break;
+    }
+
+  btor_release_aig (amgr, b_zero);
+  btor_release_aig (amgr, b_one);
+  btor_release_delete_aigvec (avmgr, zero);
+  btor_release_delete_aigvec (avmgr, one);
+}
+
+/* Registers synthesized expression which is abstracted by a fresh
+ * AIG vector. Encoding into CNF is delayed as synthesis may happen
+ * while assignments of the SAT solver are inspected.
+ */
+static void
+abstract_lazy_arith_exp (Btor * btor, BtorExp * exp)
+{
+  BtorLazyArithOp *op;
+
+  assert (btor != NULL);
+  assert (exp != NULL);
+  assert (BTOR_IS_REGULAR_EXP (exp));
+  assert (BTOR_IS_SYNTH_EXP (exp));
+  assert (is_lazy_arith_exp (btor, exp));
+
+  BTOR_NEW (btor->mm, op);
+  op->kind = exp->kind;
+  op->av[0] = BTOR_AIGVEC_EXP (btor, exp->e[0]);
+  op->av[1] = BTOR_AIGVEC_EXP (btor, exp->e[1]);
+  op->av[2] = btor_copy_aigvec (btor->avmgr, exp->av);
+  op->encoded = 0;
+  BTOR_PUSH_STACK (btor->mm, btor->la.ops, op);
+  btor->stats.la_abstractions++;
+}
+
+/* Encodes operands, results and axioms of new abstracted operations.
+ * Returns number of encoded operations.
+ */
+static int
+encode_lazy_arith_ops (Btor * btor)
+{
+  BtorLazyArithOp **temp, **top, *op;
+  int i, encoded;
+
+  assert (btor != NULL);
+  assert (btor->la.enabled);
+
+  encoded = 0;
+  top = btor->la.ops.top;
+  for (temp = btor->la.ops.start; temp != top; temp++)
+    {
+      op = *temp;
+      if (op->encoded)
+        continue;
+      /* we need assignments of operands and result for refinement */
+      for (i = 0; i < 3; i++)
+        btor_aigvec_to_sat_both_phases (btor->avmgr, op->av[i]);
+      encode_lazy_arith_axioms (btor, op);
+      op->encoded = 1;
+      encoded++;
+    }
+  return encoded;
+}
+
+/* Checks assignments of abstracted operations against their concrete
+ * semantics. Operations with wrong assignments are bit-blasted.
+ * Returns number of encoded or refined operations.
+ */
+static int
+refine_lazy_arith (Btor * btor)
+{
+  BtorLazyArithOpPtrStack wrong;
+  BtorLazyArithOp *op;
+  BtorAIGVecMgr *avmgr;
+  BtorAIGMgr *amgr;
+  BtorAIGVec *av, *eq;
+  BtorMemMgr *mm;
+  char *a, *b, *r, *expected;
+  int i, refined;
+
+  assert (btor != NULL);
+  assert (btor->la.enabled);
+
+  /* operations which have been synthesized during lemma generation
+   * are not encoded yet, and hence have no assignment */
+  refined = encode_lazy_arith_ops (btor);
+  if (refined > 0)
+    return refined;
+
+  mm = btor->mm;
+  avmgr = btor->avmgr;
+  amgr = btor_get_aig_mgr_aigvec_mgr (avmgr);
+  BTOR_INIT_STACK (wrong);
+
+  /* adding clauses invalidates assignments, hence we check all first */
+  i = 0;
+  while (i < BTOR_COUNT_STACK (btor->la.ops))
+    {
+      op = btor->la.ops.start[i];
+      a = btor_assignment_aigvec (avmgr, op->av[0]);
+      b = btor_assignment_aigvec (avmgr, op->av[1]);
+      r = btor_assignment_aigvec (avmgr, op->av[2]);
+      if (op->kind == BTOR_MUL_EXP)
+        expected = btor_mul_const (mm, a, b);
+      else if (op->kind == BTOR_UDIV_EXP)
+        expected = btor_udiv_const (mm, a, b);
+      else
+        {
+          assert (op->kind == BTOR_UREM_EXP);
+          expected = btor_urem_const (mm, a, b);
+        }
+
+      if (strcmp (expected, r) != 0)
+        {
+          BTOR_PUSH_STACK (mm, wrong, op);
+          btor->la.ops.start[i] = BTOR_POP_STACK (btor->la.ops);
+        }
+      else
+        i++;
+
+      btor_delete_const (mm, expected);
+      btor_freestr (mm, r);
+      btor_freestr (mm, b);
+      btor_freestr (mm, a);
+    }
+
+  refined = BTOR_COUNT_STACK (wrong);
+  while (!BTOR_EMPTY_STACK (wrong))
+    {
+      op = BTOR_POP_STACK (wrong);
+      if (op->kind == BTOR_MUL_EXP)
+        av = btor_mul_aigvec (avmgr, op->av[0], op->av[1]);
+      else if (op->kind == BTOR_UDIV_EXP)
+        av = btor_udiv_aigvec (avmgr, op->av[0], op->av[1]);
+      else
+        av = btor_urem_aigvec (avmgr, op->av[0], op->av[1]);
+      eq = btor_eq_aigvec (avmgr, av, op->av[2]);
+      btor_add_toplevel_aig_to_sat (amgr, eq->aigs[0]);
+      btor_release_delete_aigvec (avmgr, eq);
+      btor_release_delete_aigvec (avmgr, av);
+      delete_lazy_arith_op (btor, op);
+    }
+  BTOR_RELEASE_STACK (mm, wrong);
+
+  if (refined > 0 && btor->verbosity > 2)
+    btor_msg_exp ("LA: refined %d operations", refined);
+  btor->stats.la_refinements += refined;
+  return refined;
+}
+
 static void
 synthesize_exp (Btor * btor, BtorExp * exp, BtorPtrHashTable * backannoation)
 {
   BtorExpPtrStack exp_stack;
+  long long epoch;
   BtorExp *cur;
   BtorAIGVec *av0, *av1, *av2;
   BtorMemMgr *mm;
@@ -6055,21 +6838,24 @@ synthesize_exp (Btor * btor, BtorExp * exp, BtorPtrHashTable * backannoation)
   avmgr = btor->avmgr;
   count = 0;
 
-  BTOR_INIT_STACK (exp_stack);
+  init_trv_stack (btor, &exp_stack);
+  epoch = new_trv_epoch (btor);
   cur = BTOR_REAL_ADDR_EXP (exp);
   goto SYNTHESIZE_EXP_ENTER_WITHOUT_POP;
 
+  /* Operators are visited twice, the first visit pushes the children and
+   * sets 'epoch', the second one synthesizes the operator.  Synthesized
+   * expressions are skipped, which also covers operators synthesized by
+   * nested calls for array equalities. */
   do
     {
       cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (exp_stack));
 SYNTHESIZE_EXP_ENTER_WITHOUT_POP:
-      assert (cur->synth_mark >= 0);
-      assert (cur->synth_mark <= 2);
-      if (!BTOR_IS_SYNTH_EXP (cur) && cur->synth_mark < 2)
+      if (!BTOR_IS_SYNTH_EXP (cur))
         {
           count++;
 
-          if (cur->synth_mark == 0)
+          if (cur->epoch != epoch)
             {
               cur->reachable = 1;
               if (BTOR_IS_BV_CONST_EXP (cur))
@@ -6135,7 +6921,7 @@ SYNTHESIZE_EXP_ENTER_WITHOUT_POP:
                     {
 
                       /* regular cases */
-                      cur->synth_mark = 1;
+                      cur->epoch = epoch;
                       BTOR_PUSH_STACK (mm, exp_stack, cur);
                       for (i = cur->arity - 1; i >= 0; i--)
                         BTOR_PUSH_STACK (mm, exp_stack, cur->e[i]);
@@ -6144,8 +6930,6 @@ SYNTHESIZE_EXP_ENTER_WITHOUT_POP:
             }
           else
             {
-              assert (cur->synth_mark == 1);
-              cur->synth_mark = 2;
               assert (!BTOR_IS_READ_EXP (cur));
               switch (cur->arity)
                 {
@@ -6201,7 +6985,10 @@ SYNTHESIZE_EXP_ENTER_WITHOUT_POP:
                       cur->av = btor_add_aigvec (avmgr, av0, av1);
                       break;
                     case BTOR_MUL_EXP:
-                      cur->av = btor_mul_aigvec (avmgr, av0, av1);
+                      if (is_lazy_arith_exp (btor, cur))
+                        cur->av = btor_var_aigvec (avmgr, cur->len);
+                      else
+                        cur->av = btor_mul_aigvec (avmgr, av0, av1);
                       break;
                     case BTOR_ULT_EXP:
                       cur->av = btor_ult_aigvec (avmgr, av0, av1);
@@ -6213,10 +7000,16 @@ SYNTHESIZE_EXP_ENTER_WITHOUT_POP:
                       cur->av = btor_srl_aigvec (avmgr, av0, av1);
                       break;
                     case BTOR_UDIV_EXP:
-                      cur->av = btor_udiv_aigvec (avmgr, av0, av1);
+                      if (is_lazy_arith_exp (btor, cur))
+                        cur->av = btor_var_aigvec (avmgr, cur->len);
+                      else
+                        cur->av = btor_udiv_aigvec (avmgr, av0, av1);
                       break;
                     case BTOR_UREM_EXP:
-                      cur->av = btor_urem_aigvec (avmgr, av0, av1);
+                      if (is_lazy_arith_exp (btor, cur))
+                        cur->av = btor_var_aigvec (avmgr, cur->len);
+                      else
+                        cur->av = btor_urem_aigvec (avmgr, av0, av1);
                       break;
                     default:
                       assert (cur->kind == BTOR_CONCAT_EXP);
@@ -6297,13 +7090,15 @@ SYNTHESIZE_EXP_ENTER_WITHOUT_POP:
                 propagate_3vl_to_aigvec (btor, cur);
 #endif
 
+              if (is_lazy_arith_exp (btor, cur))
+                abstract_lazy_arith_exp (btor, cur);
+
             }
         }
     }
   while (!BTOR_EMPTY_STACK (exp_stack));
 
-  BTOR_RELEASE_STACK (mm, exp_stack);
-  mark_synth_mark_exp (btor, exp, 0);
+  release_trv_stack (btor, &exp_stack);
 
   if (count > 0 && btor->verbosity > 2)
     btor_msg_exp ("synthesized %u expressions into AIG vectors", count);
@@ -6457,9 +7252,9 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
   BtorMemMgr *mm;
   BtorAIGMgr *amgr;
   BtorExpPtrQueue queue;
-  BtorExpPtrStack unmark_stack;
   BtorPartialParentIterator it;
   int found, assignment, has_array_equalities;
+  long long epoch;
   assert (btor != NULL);
   assert (acc != NULL);
   assert (array != NULL);
@@ -6476,14 +7271,12 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
   cur = BTOR_ACC_TARGET_EXP (acc);
   assert (BTOR_IS_REGULAR_EXP (cur));
   assert (BTOR_IS_ARRAY_EXP (cur));
-  assert (cur->mark == 0);
+  epoch = new_trv_epoch (btor);
   cur->parent = acc;
-  cur->mark = 1;
+  cur->epoch = epoch;
 
-  BTOR_INIT_STACK (unmark_stack);
-  BTOR_INIT_QUEUE (queue);
+  init_trv_queue (btor, &queue);
   BTOR_ENQUEUE (mm, queue, cur);
-  BTOR_PUSH_STACK (mm, unmark_stack, cur);
   do
     {
       cur = BTOR_DEQUEUE (queue);
@@ -6499,16 +7292,15 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
       /* lazy_synthesize_and_encode_acc_exp sets the 'sat_both_phases' flag.
        * If this flag is not set, we have to find an other way
        * to the conflict. */
-      if (BTOR_IS_WRITE_EXP (cur) && cur->e[0]->mark == 0 &&
+      if (BTOR_IS_WRITE_EXP (cur) && cur->e[0]->epoch != epoch &&
           BTOR_REAL_ADDR_EXP (cur->e[1])->sat_both_phases &&
           compare_assignments (cur->e[1], index) != 0)
         {
           assert (BTOR_IS_SYNTH_EXP (BTOR_REAL_ADDR_EXP (cur->e[1])));
           next = cur->e[0];
-          next->mark = 1;
+          next->epoch = epoch;
           next->parent = cur;
           BTOR_ENQUEUE (mm, queue, next);
-          BTOR_PUSH_STACK (mm, unmark_stack, next);
         }
       /* lazy_synthesize_and_encode_acond_exp sets the 'sat_both_phases' flag.
        * If this flag is not set, we have to find an other way
@@ -6529,12 +7321,11 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
             next = cur->e[1];
           else
             next = cur->e[2];
-          if (next->mark == 0)
+          if (next->epoch != epoch)
             {
-              next->mark = 1;
+              next->epoch = epoch;
               next->parent = cur;
               BTOR_ENQUEUE (mm, queue, next);
-              BTOR_PUSH_STACK (mm, unmark_stack, next);
             }
         }
       if (has_array_equalities)
@@ -6547,7 +7338,7 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
               cur_aeq = next_parent_aeq_parent_iterator (&it);
               assert (BTOR_IS_REGULAR_EXP (cur_aeq));
               check_not_simplified_or_const (btor, cur_aeq);
-              if (cur_aeq->reachable && cur_aeq->mark == 0)
+              if (cur_aeq->reachable && cur_aeq->epoch != epoch)
                 {
                   /* array equalities are synthesized eagerly */
                   assert (BTOR_IS_SYNTH_EXP (cur_aeq));
@@ -6562,14 +7353,13 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
                         next = cur_aeq->e[0];
                       assert (BTOR_IS_REGULAR_EXP (next));
                       assert (BTOR_IS_ARRAY_EXP (next));
-                      if (next->mark == 0)
+                      if (next->epoch != epoch)
                         {
                           /* set parent of array equality */
                           cur_aeq->parent = cur;
                           next->parent = cur_aeq;
-                          next->mark = 1;
+                          next->epoch = epoch;
                           BTOR_ENQUEUE (mm, queue, next);
-                          BTOR_PUSH_STACK (mm, unmark_stack, next);
                         }
                     }
                 }
@@ -6586,7 +7376,7 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
                * 'sat_both_phases' flag.
                * If this flag is not set, we have to find an other way
                * to the conflict. */
-              if (next->reachable && next->mark == 0
+              if (next->reachable && next->epoch != epoch
                   && BTOR_REAL_ADDR_EXP (next->e[0])->sat_both_phases)
                 {
                   cond = next->e[0];
@@ -6601,10 +7391,9 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
                   if ((assignment == 1 && cur == next->e[1]) ||
                       (assignment == -1 && cur == next->e[2]))
                     {
-                      next->mark = 1;
+                      next->epoch = epoch;
                       next->parent = cur;
                       BTOR_ENQUEUE (mm, queue, next);
-                      BTOR_PUSH_STACK (mm, unmark_stack, next);
                     }
                 }
             }
@@ -6615,7 +7404,7 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
               assert (BTOR_IS_REGULAR_EXP (next));
               assert (BTOR_IS_ARRAY_EXP (next));
               assert (next->simplified == NULL);
-              if (next->reachable && next->mark == 0)
+              if (next->reachable && next->epoch != epoch)
                 {
                   /* search upwards only if write has been synthesized and 
                    * assignments to the indices are unequal
@@ -6623,10 +7412,9 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
                   if (BTOR_REAL_ADDR_EXP (next->e[1])->sat_both_phases &&
                       compare_assignments (next->e[1], index) != 0)
                     {
-                      next->mark = 1;
+                      next->epoch = epoch;
                       next->parent = cur;
                       BTOR_ENQUEUE (mm, queue, next);
-                      BTOR_PUSH_STACK (mm, unmark_stack, next);
                     }
                 }
             }
@@ -6634,19 +7422,7 @@ bfs (Btor * btor, BtorExp * acc, BtorExp * array)
     }
   while (!BTOR_EMPTY_QUEUE (queue));
   assert (found);
-  BTOR_RELEASE_QUEUE (mm, queue);
-  /* reset mark flags */
-  assert (!BTOR_EMPTY_STACK (unmark_stack));
-  do
-    {
-      cur = BTOR_POP_STACK (unmark_stack);
-      assert (BTOR_IS_REGULAR_EXP (cur));
-      assert (BTOR_IS_ARRAY_EXP (cur) || BTOR_IS_ARRAY_EQ_EXP (cur)
-              || BTOR_IS_ARRAY_COND_EXP (cur));
-      cur->mark = 0;
-    }
-  while (!BTOR_EMPTY_STACK (unmark_stack));
-  BTOR_RELEASE_STACK (mm, unmark_stack);
+  release_trv_queue (btor, &queue);
 }
 
 static int
@@ -6699,6 +7475,7 @@ add_lemma (Btor * btor, BtorExp * array, BtorExp * acc1, BtorExp * acc2)
   assert (BTOR_IS_ACC_EXP (acc1));
   assert (BTOR_IS_ACC_EXP (acc2));
 
+  BTOR_TRACE_BEGIN ("lemma");
   mm = btor->mm;
   amgr = btor_get_aig_mgr_aigvec_mgr (btor->avmgr);
 
@@ -6774,10 +7551,9 @@ add_lemma (Btor * btor, BtorExp * array, BtorExp * acc1, BtorExp * acc2)
         }
     }
 
-  encode_lemma (btor, writes, aeqs, aconds_sel1, aconds_sel2,
-                BTOR_GET_INDEX_ACC_EXP (acc1),
-                BTOR_GET_INDEX_ACC_EXP (acc2),
-                BTOR_GET_VALUE_ACC_EXP (acc1), BTOR_GET_VALUE_ACC_EXP (acc2));
+  encode_lemma (btor, writes, aeqs, aconds_sel1, aconds_sel2, acc1, acc2);
+  BTOR_TRACE_END ("lemma", "size", writes->count + aeqs->count
+                  + aconds_sel1->count + aconds_sel2->count + 2, NULL, 0);
   btor_delete_ptr_hash_table (writes);
   btor_delete_ptr_hash_table (aeqs);
   btor_delete_ptr_hash_table (aconds_sel1);
@@ -6965,7 +7741,7 @@ process_working_stack (Btor * btor, BtorExpPtrStack * stack,
   BtorPartialParentIterator it;
   BtorExp *acc, *index, *value, *array, *hashed_acc, *hashed_value;
   BtorExp *cur_aeq, *cond, *next;
-  BtorPtrHashBucket *bucket;
+  BtorOAPtrHashEntry *entry;
   BtorMemMgr *mm;
   BtorAIGMgr *amgr;
   int assignment, indices_equal, has_array_equalities;
@@ -6999,17 +7775,17 @@ process_working_stack (Btor * btor, BtorExpPtrStack * stack,
       if (array->rho == NULL)
         {
           array->rho =
-            btor_new_ptr_hash_table (mm, (BtorHashPtr) hash_assignment,
-                                     (BtorCmpPtr) compare_assignments);
+            btor_new_oa_ptr_hash_table (mm, (BtorHashPtr) hash_assignment,
+                                        (BtorCmpPtr) compare_assignments);
           BTOR_PUSH_STACK (mm, *cleanup_stack, array);
         }
       else
         {
           /* check array axiom 1 */
-          bucket = btor_find_in_ptr_hash_table (array->rho, index);
-          if (bucket != NULL)
+          entry = btor_find_in_oa_ptr_hash_table (array->rho, index);
+          if (entry != NULL)
             {
-              hashed_acc = (BtorExp *) bucket->data.asPtr;
+              hashed_acc = (BtorExp *) entry->data.asPtr;
               assert (BTOR_IS_REGULAR_EXP (hashed_acc));
               assert (BTOR_IS_ACC_EXP (hashed_acc));
               hashed_value = BTOR_GET_VALUE_ACC_EXP (hashed_acc);
@@ -7083,7 +7859,7 @@ process_working_stack (Btor * btor, BtorExpPtrStack * stack,
         }
       assert (array->rho != NULL);
       /* insert into hash table */
-      btor_insert_in_ptr_hash_table (array->rho, index)->data.asPtr = acc;
+      btor_insert_in_oa_ptr_hash_table (array->rho, index)->data.asPtr = acc;
       if (has_array_equalities)
         {
           /* propagate pairs wich are reachable via array equality */
@@ -7182,16 +7958,17 @@ search_top_arrays (Btor * btor, BtorExpPtrStack * top_arrays)
 {
   BtorPartialParentIterator it;
   BtorExp *cur_array, *cur_parent;
-  BtorExpPtrStack stack, unmark_stack;
+  BtorExpPtrStack stack;
   BtorPtrHashBucket *bucket;
   BtorMemMgr *mm;
   int found_top;
+  long long epoch;
   assert (btor != NULL);
   assert (top_arrays != NULL);
   assert (BTOR_COUNT_STACK (*top_arrays) == 0);
   mm = btor->mm;
-  BTOR_INIT_STACK (stack);
-  BTOR_INIT_STACK (unmark_stack);
+  init_trv_stack (btor, &stack);
+  epoch = new_trv_epoch (btor);
   for (bucket = btor->array_vars->first; bucket; bucket = bucket->next)
     {
       cur_array = (BtorExp *) bucket->key;
@@ -7207,11 +7984,9 @@ search_top_arrays (Btor * btor, BtorExpPtrStack * top_arrays)
       assert (BTOR_IS_ARRAY_EXP (cur_array));
       assert (cur_array->reachable);
       assert (cur_array->simplified == NULL);
-      assert (cur_array->array_mark == 0 || cur_array->array_mark == 1);
-      if (cur_array->array_mark == 0)
+      if (cur_array->epoch != epoch)
         {
-          cur_array->array_mark = 1;
-          BTOR_PUSH_STACK (mm, unmark_stack, cur_array);
+          cur_array->epoch = epoch;
           found_top = 1;
           /* ATTENTION: There can be write and array conditional parents 
            * although they are not reachable from root. 
@@ -7230,7 +8005,7 @@ search_top_arrays (Btor * btor, BtorExpPtrStack * top_arrays)
               if (cur_parent->reachable)
                 {
                   found_top = 0;
-                  assert (cur_parent->array_mark == 0);
+                  assert (cur_parent->epoch != epoch);
                   BTOR_PUSH_STACK (mm, stack, cur_parent);
                 }
             }
@@ -7251,20 +8026,10 @@ search_top_arrays (Btor * btor, BtorExpPtrStack * top_arrays)
             BTOR_PUSH_STACK (mm, *top_arrays, cur_array);
         }
     }
-  BTOR_RELEASE_STACK (mm, stack);
-
-  /* reset array marks of arrays */
-  while (!BTOR_EMPTY_STACK (unmark_stack))
-    {
-      cur_array = BTOR_POP_STACK (unmark_stack);
-      assert (BTOR_IS_REGULAR_EXP (cur_array));
-      assert (BTOR_IS_ARRAY_EXP (cur_array));
-      assert (cur_array->array_mark == 1);
-      cur_array->array_mark = 0;
-    }
-  BTOR_RELEASE_STACK (mm, unmark_stack);
+  release_trv_stack (btor, &stack);
 }
 
+
 static int
 check_and_resolve_conflicts (Btor * btor, BtorExpPtrStack * top_arrays)
 {
@@ -7282,10 +8047,10 @@ check_and_resolve_conflicts (Btor * btor, BtorExpPtrStack * top_arrays)
 BTOR_READ_WRITE_ARRAY_CONFLICT_CHECK:
   assert (!found_conflict);
   changed_assignments = 0;
-  BTOR_INIT_STACK (unmark_stack);
-  BTOR_INIT_STACK (working_stack);
-  BTOR_INIT_STACK (cleanup_stack);
-  BTOR_INIT_STACK (array_stack);
+  init_trv_stack (btor, &unmark_stack);
+  init_trv_stack (btor, &working_stack);
+  init_trv_stack (btor, &cleanup_stack);
+  init_trv_stack (btor, &array_stack);
 
   /* push all top arrays on the stack */
   top = top_arrays->top;
@@ -7362,7 +8127,7 @@ BTOR_READ_WRITE_ARRAY_CONFLICT_CLEANUP:
 
       if (found_conflict || changed_assignments)
         {
-          btor_delete_ptr_hash_table (cur_array->rho);
+          btor_delete_oa_ptr_hash_table (cur_array->rho);
           cur_array->rho = NULL;
         }
       else
@@ -7372,10 +8137,10 @@ BTOR_READ_WRITE_ARRAY_CONFLICT_CLEANUP:
         }
 
     }
-  BTOR_RELEASE_STACK (mm, cleanup_stack);
+  release_trv_stack (btor, &cleanup_stack);
 
-  BTOR_RELEASE_STACK (mm, working_stack);
-  BTOR_RELEASE_STACK (mm, array_stack);
+  release_trv_stack (btor, &working_stack);
+  release_trv_stack (btor, &array_stack);
 
   /* reset array marks of arrays */
   while (!BTOR_EMPTY_STACK (unmark_stack))
@@ -7386,7 +8151,7 @@ BTOR_READ_WRITE_ARRAY_CONFLICT_CLEANUP:
       assert (cur_array->array_mark == 1);
       cur_array->array_mark = 0;
     }
-  BTOR_RELEASE_STACK (mm, unmark_stack);
+  release_trv_stack (btor, &unmark_stack);
 
   /* restart? (assignments changed during lazy synthesis and encoding) */
   if (changed_assignments)
@@ -7424,7 +8189,7 @@ btor_reset_array_models (Btor * btor)
       assert (!BTOR_IS_INVERTED_EXP (cur));
       assert (BTOR_IS_ARRAY_EXP (cur));
       assert (cur->rho != NULL);
-      btor_delete_ptr_hash_table (cur->rho);
+      btor_delete_oa_ptr_hash_table (cur->rho);
       cur->rho = NULL;
     }
   BTOR_RESET_STACK (btor->arrays_with_model);
@@ -7440,13 +8205,137 @@ btor_reset_incremental_usage (Btor * btor)
   btor->valid_assignments = 0;
 }
 
+/* Deletes all pairs of a table of expression pairs and starts over
+ * with an empty table. */
+static void
+reset_exp_pair_table (Btor * btor, BtorOAPtrHashTable ** table)
+{
+  int i;
+  assert (btor != NULL);
+  assert (table != NULL);
+  for (i = 0; i < (*table)->count; i++)
+    delete_exp_pair (btor, (BtorExpPair *) (*table)->entries[i].key);
+  btor_delete_oa_ptr_hash_table (*table);
+  *table = btor_new_oa_ptr_hash_table (btor->mm, (BtorHashPtr) hash_exp_pair,
+                                       (BtorCmpPtr) compare_exp_pair);
+}
+
+/* Releases the AIG vector of 'exp' and resets the flags set by synthesis.
+ * The virtual reads of array equalities are pushed on 'vreads' together
+ * with their references, as releasing them could change the unique table.
+ */
+static void
+unsynthesize_exp (Btor * btor, BtorExp * exp, BtorExpPtrStack * vreads)
+{
+  assert (btor != NULL);
+  assert (exp != NULL);
+  assert (BTOR_IS_REGULAR_EXP (exp));
+  assert (vreads != NULL);
+  exp->reachable = 0;
+  exp->sat_both_phases = 0;
+  /* arrays share the AIG vector field with their model */
+  if (BTOR_IS_ARRAY_EXP (exp))
+    return;
+  if (exp->kind == BTOR_AEQ_EXP && exp->vreads)
+    {
+      BTOR_PUSH_STACK (btor->mm, *vreads, exp->vreads->exp1);
+      BTOR_PUSH_STACK (btor->mm, *vreads, exp->vreads->exp2);
+      BTOR_DELETE (btor->mm, exp->vreads);
+      exp->vreads = 0;
+    }
+  if (exp->av)
+    {
+      btor_release_delete_aigvec (btor->avmgr, exp->av);
+      exp->av = 0;
+    }
+}
+
+void
+btor_restart_sat_btor (Btor * btor)
+{
+  BtorPtrHashTable *synthesized_constraints;
+  BtorExpPtrStack vreads;
+  BtorPtrHashBucket *b;
+  BtorAIGMgr *amgr;
+  BtorSATMgr *smgr;
+  BtorMemMgr *mm;
+  BtorExp *cur;
+  int i, ands;
+
+  assert (btor != NULL);
+  /* abstractions and their refinements live in the SAT solver only */
+  assert (!btor->ua.enabled);
+  assert (!btor->la.enabled);
+
+  mm = btor->mm;
+  amgr = btor_get_aig_mgr_aigvec_mgr (btor->avmgr);
+  smgr = btor_get_sat_mgr_aig_mgr (amgr);
+  ands = btor_num_ands_aig_mgr (amgr);
+
+  if (btor->valid_assignments)
+    btor_reset_incremental_usage (btor);
+  else
+    btor_reset_array_models (btor);
+
+  /* CNF ids of lemmas and top level assignments become invalid */
+  reset_exp_pair_table (btor, &btor->exp_pair_cnf_diff_id_table);
+  reset_exp_pair_table (btor, &btor->exp_pair_cnf_eq_id_table);
+  reset_exp_pair_table (btor, &btor->exp_pair_ass_unequal_table);
+  reset_exp_pair_table (btor, &btor->lemma_lit_table);
+
+  /* constraints are synthesized and encoded again by the next SAT call */
+  synthesized_constraints = btor->synthesized_constraints;
+  for (b = synthesized_constraints->first; b != NULL; b = b->next)
+    {
+      cur = (BtorExp *) b->key;
+      if (btor_find_in_ptr_hash_table (btor->unsynthesized_constraints, cur))
+        btor_release_exp (btor, cur);
+      else
+        (void) btor_insert_in_ptr_hash_table (btor->unsynthesized_constraints,
+                                              cur);
+    }
+  btor_delete_ptr_hash_table (synthesized_constraints);
+  btor->synthesized_constraints =
+    btor_new_ptr_hash_table (mm, (BtorHashPtr) btor_hash_exp_by_id,
+                             (BtorCmpPtr) btor_compare_exp_by_id);
+
+  while (btor->table.old_chains != NULL)
+    rehash_exp_unique_table (btor, (unsigned int) btor->table.old_pos);
+
+  BTOR_INIT_STACK (vreads);
+  for (i = 0; i < btor->table.size; i++)
+    for (cur = btor->table.chains[i]; cur != NULL; cur = cur->next)
+      unsynthesize_exp (btor, cur, &vreads);
+  for (b = btor->bv_vars->first; b != NULL; b = b->next)
+    unsynthesize_exp (btor, (BtorExp *) b->key, &vreads);
+  for (b = btor->array_vars->first; b != NULL; b = b->next)
+    unsynthesize_exp (btor, (BtorExp *) b->key, &vreads);
+  while (!BTOR_EMPTY_STACK (vreads))
+    btor_release_exp (btor, BTOR_POP_STACK (vreads));
+  BTOR_RELEASE_STACK (mm, vreads);
+
+  /* drops all clauses, the next SAT call starts with CNF id 1 again */
+  if (btor_is_initialized_sat (smgr))
+    btor_reset_sat (smgr);
+  (void) btor_restart_ids_aig_mgr (amgr);
+
+  btor->valid_assignments = 0;
+  btor->stats.sat_restarts++;
+
+  if (btor->verbosity > 0)
+    btor_msg_exp ("SAT restart: released %d AIG ands, %d left",
+                  ands - btor_num_ands_aig_mgr (amgr),
+                  btor_num_ands_aig_mgr (amgr));
+}
+
 /* check if left does not occur on the right side */
 static int
 occurrence_check (Btor * btor, BtorExp * left, BtorExp * right)
 {
   BtorExp *cur, *real_left;
-  BtorExpPtrStack stack, unmark_stack;
+  BtorExpPtrStack stack;
   int is_cyclic, i;
+  long long epoch;
   BtorMemMgr *mm;
   assert (btor != NULL);
   assert (left != NULL);
@@ -7455,8 +8344,8 @@ occurrence_check (Btor * btor, BtorExp * left, BtorExp * right)
   is_cyclic = 0;
   mm = btor->mm;
   real_left = BTOR_REAL_ADDR_EXP (left);
-  BTOR_INIT_STACK (stack);
-  BTOR_INIT_STACK (unmark_stack);
+  init_trv_stack (btor, &stack);
+  epoch = new_trv_epoch (btor);
 
   cur = BTOR_REAL_ADDR_EXP (right);
   goto OCCURRENCE_CHECK_ENTER_WITHOUT_POP;
@@ -7465,11 +8354,9 @@ occurrence_check (Btor * btor, BtorExp * left, BtorExp * right)
     {
       cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
 OCCURRENCE_CHECK_ENTER_WITHOUT_POP:
-      assert (cur->aux_mark == 0 || cur->aux_mark == 1);
-      if (cur->aux_mark == 0)
+      if (cur->epoch != epoch)
         {
-          cur->aux_mark = 1;
-          BTOR_PUSH_STACK (mm, unmark_stack, cur);
+          cur->epoch = epoch;
           if (cur == real_left)
             {
               is_cyclic = 1;
@@ -7480,16 +8367,7 @@ OCCURRENCE_CHECK_ENTER_WITHOUT_POP:
         }
     }
   while (!BTOR_EMPTY_STACK (stack));
-  BTOR_RELEASE_STACK (mm, stack);
-
-  while (!BTOR_EMPTY_STACK (unmark_stack))
-    {
-      cur = BTOR_POP_STACK (unmark_stack);
-      assert (BTOR_IS_REGULAR_EXP (cur));
-      assert (cur->aux_mark == 1);
-      cur->aux_mark = 0;
-    }
-  BTOR_RELEASE_STACK (mm, unmark_stack);
+  release_trv_stack (btor, &stack);
 
   return is_cyclic;
 }
@@ -7731,7 +8609,6 @@ lambda_var_exp (Btor * btor, int len)
   return result;
 }
 
-#if 0
 static BtorExp *
 lambda_array_exp (Btor * btor, int elem_len, int index_len)
 {
@@ -7754,7 +8631,6 @@ lambda_array_exp (Btor * btor, int elem_len, int index_len)
   BTOR_DELETEN (mm, name, string_len);
   return result;
 }
-#endif
 
 enum BtorSubstCompKind
 {
@@ -8144,6 +9020,7 @@ add_constraint (Btor * btor, BtorExp * exp)
   BtorExp *cur, *child;
   BtorExpPtrStack stack;
   BtorMemMgr *mm;
+  long long epoch;
 
   assert (btor != NULL);
   assert (exp != NULL);
@@ -8157,7 +9034,8 @@ add_constraint (Btor * btor, BtorExp * exp)
 
   if (!BTOR_IS_INVERTED_EXP (exp) && exp->kind == BTOR_AND_EXP)
     {
-      BTOR_INIT_STACK (stack);
+      init_trv_stack (btor, &stack);
+      epoch = new_trv_epoch (btor);
       cur = exp;
       goto ADD_CONSTRAINT_ENTER_LOOP_WITHOUT_POP;
 
@@ -8167,10 +9045,9 @@ add_constraint (Btor * btor, BtorExp * exp)
 ADD_CONSTRAINT_ENTER_LOOP_WITHOUT_POP:
           assert (!BTOR_IS_INVERTED_EXP (cur));
           assert (cur->kind == BTOR_AND_EXP);
-          assert (cur->mark == 0 || cur->mark == 1);
-          if (!cur->mark)
+          if (cur->epoch != epoch)
             {
-              cur->mark = 1;
+              cur->epoch = epoch;
               child = cur->e[1];
               if (!BTOR_IS_INVERTED_EXP (child) && child->kind == BTOR_AND_EXP)
                 BTOR_PUSH_STACK (mm, stack, child);
@@ -8184,8 +9061,7 @@ ADD_CONSTRAINT_ENTER_LOOP_WITHOUT_POP:
             }
         }
       while (!BTOR_EMPTY_STACK (stack));
-      BTOR_RELEASE_STACK (mm, stack);
-      btor_mark_exp (btor, exp, 0);
+      release_trv_stack (btor, &stack);
     }
   else
     insert_new_constraint (btor, exp);
@@ -8240,6 +9116,7 @@ btor_add_assumption_exp (Btor * btor, BtorExp * exp)
   BtorExp *cur, *child;
   BtorExpPtrStack stack;
   BtorMemMgr *mm;
+  long long epoch;
 
   assert (btor != NULL);
   assert (btor->inc_enabled);
@@ -8254,7 +9131,8 @@ btor_add_assumption_exp (Btor * btor, BtorExp * exp)
 
   if (!BTOR_IS_INVERTED_EXP (exp) && exp->kind == BTOR_AND_EXP)
     {
-      BTOR_INIT_STACK (stack);
+      init_trv_stack (btor, &stack);
+      epoch = new_trv_epoch (btor);
       cur = exp;
       goto BTOR_ADD_ASSUMPTION_EXP_ENTER_WITHOUT_POP;
 
@@ -8264,10 +9142,9 @@ btor_add_assumption_exp (Btor * btor, BtorExp * exp)
 BTOR_ADD_ASSUMPTION_EXP_ENTER_WITHOUT_POP:
           assert (!BTOR_IS_INVERTED_EXP (cur));
           assert (cur->kind == BTOR_AND_EXP);
-          assert (cur->mark == 0 || cur->mark == 1);
-          if (!cur->mark)
+          if (cur->epoch != epoch)
             {
-              cur->mark = 1;
+              cur->epoch = epoch;
               child = cur->e[1];
               if (!BTOR_IS_INVERTED_EXP (child) && child->kind == BTOR_AND_EXP)
                 BTOR_PUSH_STACK (mm, stack, child);
@@ -8291,8 +9168,7 @@ BTOR_ADD_ASSUMPTION_EXP_ENTER_WITHOUT_POP:
             }
         }
       while (!BTOR_EMPTY_STACK (stack));
-      BTOR_RELEASE_STACK (mm, stack);
-      btor_mark_exp (btor, exp, 0);
+      release_trv_stack (btor, &stack);
     }
   else
     {
@@ -8303,7 +9179,8 @@ BTOR_ADD_ASSUMPTION_EXP_ENTER_WITHOUT_POP:
 }
 
 /* synthesizes unsynthesized constraints and updates constraints tables.
- * returns 0 if a constraint has been synthesized into AIG_FALSE */
+ * returns 0 if a constraint has been synthesized into AIG_FALSE.
+ * stops early if the memory limit is exceeded */
 static int
 process_unsynthesized_constraints (Btor * btor)
 {
@@ -8318,7 +9195,8 @@ process_unsynthesized_constraints (Btor * btor)
   synthesized_constraints = btor->synthesized_constraints;
   amgr = btor_get_aig_mgr_aigvec_mgr (btor->avmgr);
   smgr = btor_get_sat_mgr_aig_mgr (amgr);
-  while (unsynthesized_constraints->count > 0)
+  while (unsynthesized_constraints->count > 0
+         && !btor_is_limit_exceeded_mem_mgr (btor->mm))
     {
       bucket = unsynthesized_constraints->first;
       assert (bucket != NULL);
@@ -8369,127 +9247,250 @@ update_assumptions (Btor * btor)
     }
 }
 
-/* we perform all variable substitutions in one pass and rebuild the formula
- * cyclic substitutions must have been deleted before! */
+/* The rebuild worklist is a binary heap of expressions ordered by id.
+ * As expressions are always created after their children, children are
+ * rebuilt before their parents.  Expressions in the worklist have their
+ * 'aux_mark' set and are referenced by the worklist.
+ */
 static void
-substitute_vars_and_rebuild_exps (Btor * btor, BtorPtrHashTable * substs)
+enqueue_rebuild_exp (Btor * btor, BtorExpPtrStack * heap, BtorExp * exp)
 {
-  BtorExpPtrStack stack, root_stack;
-  BtorPtrHashBucket *b;
-  BtorExp *cur, *cur_parent, *rebuilt_exp, **temp, **top, *rhs, *simplified;
-  BtorMemMgr *mm;
-  BtorFullParentIterator it;
-  int pushed, i;
+  BtorExp *parent;
+  int pos, up;
+
   assert (btor != NULL);
-  assert (substs != NULL);
+  assert (heap != NULL);
+  assert (exp != NULL);
+  assert (BTOR_IS_REGULAR_EXP (exp));
 
-  if (substs->count == 0u)
+  if (exp->aux_mark)
     return;
 
-  mm = btor->mm;
+  exp->aux_mark = 1;
+  BTOR_PUSH_STACK (btor->mm, *heap, btor_copy_exp (btor, exp));
 
-  BTOR_INIT_STACK (stack);
-  BTOR_INIT_STACK (root_stack);
-  /* search upwards for all reachable roots */
-  /* we push all left sides on the search stack */
-  for (b = substs->first; b != NULL; b = b->next)
+  pos = BTOR_COUNT_STACK (*heap) - 1;
+  while (pos > 0)
     {
-      cur = (BtorExp *) b->key;
-      assert (BTOR_IS_REGULAR_EXP (cur));
-      assert (BTOR_IS_BV_VAR_EXP (cur) || BTOR_IS_ARRAY_VAR_EXP (cur));
-      BTOR_PUSH_STACK (mm, stack, cur);
+      up = (pos - 1) / 2;
+      parent = heap->start[up];
+      if (parent->id <= exp->id)
+        break;
+      heap->start[pos] = parent;
+      pos = up;
     }
-  do
+  heap->start[pos] = exp;
+}
+
+static BtorExp *
+dequeue_rebuild_exp (BtorExpPtrStack * heap)
+{
+  BtorExp *res, *last, *child;
+  int pos, down, count;
+
+  assert (heap != NULL);
+  assert (!BTOR_EMPTY_STACK (*heap));
+
+  res = heap->start[0];
+  last = BTOR_POP_STACK (*heap);
+  count = BTOR_COUNT_STACK (*heap);
+
+  if (count > 0)
     {
-      cur = BTOR_POP_STACK (stack);
-      assert (BTOR_IS_REGULAR_EXP (cur));
-      if (cur->aux_mark == 0)
+      pos = 0;
+      for (;;)
         {
-          cur->aux_mark = 1;
-          init_full_parent_iterator (&it, cur);
-          /* are we at a root ? */
-          pushed = 0;
-          while (has_next_parent_full_parent_iterator (&it))
-            {
-              cur_parent = next_parent_full_parent_iterator (&it);
-              assert (BTOR_IS_REGULAR_EXP (cur_parent));
-              pushed = 1;
-              BTOR_PUSH_STACK (mm, stack, cur_parent);
-            }
-          if (!pushed)
-            BTOR_PUSH_STACK (mm, root_stack, btor_copy_exp (btor, cur));
+          down = 2 * pos + 1;
+          if (down >= count)
+            break;
+          if (down + 1 < count &&
+              heap->start[down + 1]->id < heap->start[down]->id)
+            down++;
+          child = heap->start[down];
+          if (last->id <= child->id)
+            break;
+          heap->start[pos] = child;
+          pos = down;
         }
+      heap->start[pos] = last;
     }
-  while (!BTOR_EMPTY_STACK (stack));
 
-  /* copy roots on substitution stack */
-  top = root_stack.top;
-  for (temp = root_stack.start; temp != top; temp++)
-    BTOR_PUSH_STACK (mm, stack, *temp);
+  assert (res->aux_mark == 1);
+  res->aux_mark = 0;
+  return res;
+}
+
+static void
+enqueue_parents_rebuild_exp (Btor * btor, BtorExpPtrStack * heap,
+                             BtorExp * exp)
+{
+  BtorFullParentIterator it;
+  BtorExp *parent;
 
-  /* substitute */
-  while (!BTOR_EMPTY_STACK (stack))
+  assert (btor != NULL);
+  assert (heap != NULL);
+  assert (exp != NULL);
+  assert (BTOR_IS_REGULAR_EXP (exp));
+
+  init_full_parent_iterator (&it, exp);
+  while (has_next_parent_full_parent_iterator (&it))
     {
-      cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
+      parent = next_parent_full_parent_iterator (&it);
+      assert (BTOR_IS_REGULAR_EXP (parent));
+      enqueue_rebuild_exp (btor, heap, parent);
+    }
+}
 
-      if (cur->aux_mark == 0)
-        continue;
+/* Rebuilds the expressions in the worklist.  Only parents of expressions
+ * which actually changed are rebuilt, thus the work is proportional
+ * to the part of the formula which changes.  Variables contained in
+ * 'substs' are replaced by their right hand sides.
+ */
+static void
+rebuild_worklist_exps (Btor * btor, BtorExpPtrStack * heap,
+                       BtorPtrHashTable * substs)
+{
+  BtorExp *cur, *rebuilt_exp, *simplified;
+  BtorPtrHashBucket *b;
+  int rebuilt, changed;
+
+  assert (btor != NULL);
+  assert (heap != NULL);
+
+  rebuilt = changed = 0;
 
+  while (!BTOR_EMPTY_STACK (*heap))
+    {
+      cur = dequeue_rebuild_exp (heap);
+      assert (BTOR_IS_REGULAR_EXP (cur));
       assert (!BTOR_IS_BV_CONST_EXP (cur));
 
-      if (cur->aux_mark == 1)
+      if (cur->kind == BTOR_PROXY_EXP)
         {
-          BTOR_PUSH_STACK (mm, stack, cur);
-          cur->aux_mark = 2;
-          if (BTOR_IS_BV_VAR_EXP (cur) || BTOR_IS_ARRAY_VAR_EXP (cur))
-            {
-              b = btor_find_in_ptr_hash_table (substs, cur);
-              assert (b != NULL);
-              assert (cur == (BtorExp *) b->key);
-              rhs = (BtorExp *) b->data.asPtr;
-              assert (rhs != NULL);
-              BTOR_PUSH_STACK (mm, stack, rhs);
-            }
-          else
-            {
-              for (i = cur->arity - 1; i >= 0; i--)
-                BTOR_PUSH_STACK (mm, stack, cur->e[i]);
-            }
+          enqueue_parents_rebuild_exp (btor, heap, cur);
+          btor_release_exp (btor, cur);
+          continue;
         }
-      else
+
+      if (substs != NULL &&
+          (BTOR_IS_BV_VAR_EXP (cur) || BTOR_IS_ARRAY_VAR_EXP (cur)))
         {
-          assert (cur->aux_mark == 2);
-          cur->aux_mark = 0;
-          if (BTOR_IS_BV_VAR_EXP (cur) || BTOR_IS_ARRAY_VAR_EXP (cur))
-            {
-              b = btor_find_in_ptr_hash_table (substs, cur);
-              assert (b != NULL);
-              assert (cur == (BtorExp *) b->key);
-              rhs = (BtorExp *) b->data.asPtr;
-              assert (rhs != NULL);
-              rebuilt_exp = btor_copy_exp (btor, rhs);
-              if (BTOR_IS_BV_VAR_EXP (cur))
-                btor->stats.var_substitutions++;
-              else
-                btor->stats.array_substitutions++;
-            }
+          b = btor_find_in_ptr_hash_table (substs, cur);
+          assert (b != NULL);
+          assert (b->data.asPtr != NULL);
+          rebuilt_exp = btor_copy_exp (btor, (BtorExp *) b->data.asPtr);
+          if (BTOR_IS_BV_VAR_EXP (cur))
+            btor->stats.var_substitutions++;
           else
-            rebuilt_exp = rebuild_exp (btor, cur);
-          assert (rebuilt_exp != NULL);
-          assert (rebuilt_exp != cur);
+            btor->stats.array_substitutions++;
+        }
+      else
+        rebuilt_exp = rebuild_exp (btor, cur);
 
+      assert (rebuilt_exp != NULL);
+      rebuilt++;
+
+      /* base case: rebuilt_exp == cur */
+      if (rebuilt_exp != cur)
+        {
           simplified = btor_pointer_chase_simplified_exp (btor, rebuilt_exp);
           set_simplified_exp (btor, cur, simplified, 1);
-          btor_release_exp (btor, rebuilt_exp);
+          enqueue_parents_rebuild_exp (btor, heap, cur);
+          changed++;
         }
+
+      btor_release_exp (btor, rebuilt_exp);
+      btor_release_exp (btor, cur);
     }
 
-  BTOR_RELEASE_STACK (mm, stack);
+  BTOR_RELEASE_STACK (btor->mm, *heap);
+
+  btor->stats.rebuild_rounds++;
+  btor->stats.rebuilds += rebuilt;
+
+  if (btor->verbosity > 2)
+    btor_msg_exp ("rebuild round %d: rebuilt %d expressions, %d changed",
+                  btor->stats.rebuild_rounds, rebuilt, changed);
+}
+
+/* we perform all variable substitutions in one pass and rebuild the formula
+ * cyclic substitutions must have been deleted before! */
+static void
+substitute_vars_and_rebuild_exps (Btor * btor, BtorPtrHashTable * substs)
+{
+  BtorExpPtrStack heap;
+  BtorPtrHashBucket *b;
+  BtorExp *cur;
+  assert (btor != NULL);
+  assert (substs != NULL);
+
+  if (substs->count == 0u)
+    return;
+
+  BTOR_INIT_STACK (heap);
+  for (b = substs->first; b != NULL; b = b->next)
+    {
+      cur = (BtorExp *) b->key;
+      assert (BTOR_IS_REGULAR_EXP (cur));
+      assert (BTOR_IS_BV_VAR_EXP (cur) || BTOR_IS_ARRAY_VAR_EXP (cur));
+      enqueue_rebuild_exp (btor, &heap, cur);
+    }
+  rebuild_worklist_exps (btor, &heap, substs);
+}
+
+/* Moves the first variable substitution constraint into 'substs'.
+ * Constraints added during the last rebuild round may refer to variables
+ * substituted later in the same round, or their right hand sides may
+ * have been rebuilt since.  Right hand sides are updated, and if the
+ * variable is substituted already, occurs on the right hand side now,
+ * or is in 'substs' already, the substitution becomes an equality
+ * constraint instead.
+ */
+static void
+move_varsubst_constraint (Btor * btor, BtorPtrHashTable * substs)
+{
+  BtorExp *left, *right, *simplified, *eq;
+  BtorPtrHashTable *varsubst_constraints;
+  BtorPtrHashBucket *b;
 
-  top = root_stack.top;
-  for (temp = root_stack.start; temp != top; temp++)
-    btor_release_exp (btor, *temp);
-  BTOR_RELEASE_STACK (mm, root_stack);
+  assert (btor != NULL);
+  assert (substs != NULL);
+
+  varsubst_constraints = btor->varsubst_constraints;
+  assert (varsubst_constraints->count > 0u);
+  b = varsubst_constraints->first;
+  left = (BtorExp *) b->key;
+  right = (BtorExp *) b->data.asPtr;
+  assert (BTOR_IS_REGULAR_EXP (left));
+  btor_remove_from_ptr_hash_table (varsubst_constraints, left, NULL, NULL);
+
+  simplified = btor_pointer_chase_simplified_exp (btor, right);
+  if (left->kind == BTOR_PROXY_EXP
+      || btor_find_in_ptr_hash_table (substs, left)
+      || (simplified != right && occurrence_check (btor, left, simplified)))
+    {
+      eq = btor_eq_exp (btor, left, simplified);
+      /* as in 'insert_varsubst_constraint', otherwise it would be
+       * normalized to the same substitution again */
+      if (left->kind != BTOR_PROXY_EXP
+          && btor_find_in_ptr_hash_table (substs, left))
+        insert_unsynthesized_constraint (btor, eq);
+      else
+        add_constraint (btor, eq);
+      btor_release_exp (btor, eq);
+      btor_release_exp (btor, left);
+      btor_release_exp (btor, right);
+      return;
+    }
+
+  assert (BTOR_IS_BV_VAR_EXP (left) || BTOR_IS_ARRAY_VAR_EXP (left));
+  if (simplified != right)
+    {
+      simplified = btor_copy_exp (btor, simplified);
+      btor_release_exp (btor, right);
+      right = simplified;
+    }
+  btor_insert_in_ptr_hash_table (substs, left)->data.asPtr = right;
 }
 
 static void
@@ -8521,16 +9522,7 @@ substitute_var_exps (Btor * btor, int check_cyclic)
 					    (BtorCmpPtr) btor_compare_exp_by_id);
           assert (varsubst_constraints->count > 0u);
 	  do
-	    {
-	      b = varsubst_constraints->first;
-	      cur = (BtorExp *) b->key;
-	      assert (BTOR_IS_REGULAR_EXP (cur));
-	      assert (BTOR_IS_BV_VAR_EXP (cur) || BTOR_IS_ARRAY_VAR_EXP (cur));
-	      btor_insert_in_ptr_hash_table (substs, cur)->data.asPtr =
-		b->data.asPtr;
-	      btor_remove_from_ptr_hash_table (varsubst_constraints, cur, NULL,
-					       NULL);
-	    }
+	    move_varsubst_constraint (btor, substs);
 	  while (varsubst_constraints->count > 0u);
 	  assert (varsubst_constraints->count == 0u);
           /* we rebuild and substiute variables in one pass */
@@ -8568,16 +9560,7 @@ substitute_var_exps (Btor * btor, int check_cyclic)
       /* we copy the current substitution constraints into a local hash table,
        * and empty the global substitution table */
       while (varsubst_constraints->count > 0u)
-        {
-          b = varsubst_constraints->first;
-          cur = (BtorExp *) b->key;
-          assert (BTOR_IS_REGULAR_EXP (cur));
-          assert (BTOR_IS_BV_VAR_EXP (cur) || BTOR_IS_ARRAY_VAR_EXP (cur));
-          btor_insert_in_ptr_hash_table (substs, cur)->data.asPtr =
-            b->data.asPtr;
-          btor_remove_from_ptr_hash_table (varsubst_constraints, cur, NULL,
-                                           NULL);
-        }
+        move_varsubst_constraint (btor, substs);
       assert (varsubst_constraints->count == 0u);
 
       /* we search for cyclic substitution dependencies 
@@ -8768,17 +9751,16 @@ substitute_var_exps (Btor * btor, int check_cyclic)
   BTOR_RELEASE_STACK (mm, stack);
 }
 
-/* Simple substitution by following simplified pointer. 
+/* Simple substitution by following simplified pointer.  The expressions
+ * in 'subst' and all of their parents are rebuilt, further up only
+ * parents of changed expressions are rebuilt.
  */
 static void
 substitute_and_rebuild (Btor * btor, BtorPtrHashTable *subst)
 {
-  BtorExpPtrStack stack, root_stack;
+  BtorExpPtrStack heap;
   BtorPtrHashBucket *b;
-  BtorExp *cur, *cur_parent, *rebuilt_exp, **temp, **top, *simplified;
-  BtorMemMgr *mm;
-  BtorFullParentIterator it;
-  int pushed, i;
+  BtorExp *cur;
 
   assert (btor != NULL);
   assert (subst != NULL);
@@ -8786,86 +9768,54 @@ substitute_and_rebuild (Btor * btor, BtorPtrHashTable *subst)
   if (subst->count == 0u)
     return;
 
-  mm = btor->mm;
-
-  BTOR_INIT_STACK (stack);
-  BTOR_INIT_STACK (root_stack);
-
-/* we push all expressions on the search stack */
+  BTOR_INIT_STACK (heap);
   for (b = subst->first; b != NULL; b = b->next)
     {
-      cur = (BtorExp *) b->key;
-      BTOR_PUSH_STACK (mm, stack, BTOR_REAL_ADDR_EXP (cur));
-    }
-  while (!BTOR_EMPTY_STACK (stack))
-    {
-      /* search upwards for all reachable roots */
-      cur = BTOR_POP_STACK (stack);
-      assert (BTOR_IS_REGULAR_EXP (cur));
-      if (cur->aux_mark == 0)
-        {
-          cur->aux_mark = 1;
-          init_full_parent_iterator (&it, cur);
-          /* are we at a root ? */
-          pushed = 0;
-          while (has_next_parent_full_parent_iterator (&it))
-            {
-              cur_parent = next_parent_full_parent_iterator (&it);
-              assert (BTOR_IS_REGULAR_EXP (cur_parent));
-              pushed = 1;
-              BTOR_PUSH_STACK (mm, stack, cur_parent);
-            }
-          if (!pushed)
-            BTOR_PUSH_STACK (mm, root_stack, btor_copy_exp (btor, cur));
-        }
+      cur = BTOR_REAL_ADDR_EXP ((BtorExp *) b->key);
+      enqueue_rebuild_exp (btor, &heap, cur);
+      enqueue_parents_rebuild_exp (btor, &heap, cur);
     }
+  rebuild_worklist_exps (btor, &heap, 0);
+}
 
-/* copy roots on substitution stack */
-  top = root_stack.top;
-  for (temp = root_stack.start; temp != top; temp++)
-    BTOR_PUSH_STACK (mm, stack, *temp);
+/* Expressions outside of the constraints, e.g. right hand sides of
+ * substituted variables, may still refer to expressions of 'exps' which
+ * have been substituted, i.e. turned into proxies.  Their parents are
+ * rebuilt.
+ */
+static void
+rebuild_parents_of_proxies (Btor * btor, BtorExp ** exps, int num)
+{
+  BtorFullParentIterator it;
+  BtorPtrHashTable *parents;
+  BtorExp *cur, *cur_parent;
+  int i;
 
-/* substitute */
-  while (!BTOR_EMPTY_STACK (stack))
-    {
-      cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
+  assert (btor != NULL);
+  assert (exps != NULL || num == 0);
+  assert (num >= 0);
 
-      if (cur->aux_mark == 0)
+  parents = btor_new_ptr_hash_table (btor->mm,
+                                     (BtorHashPtr) btor_hash_exp_by_id,
+                                     (BtorCmpPtr) btor_compare_exp_by_id);
+  for (i = 0; i < num; i++)
+    {
+      cur = exps[i];
+      assert (BTOR_IS_REGULAR_EXP (cur));
+      if (cur->kind != BTOR_PROXY_EXP)
         continue;
-
-      if (cur->aux_mark == 1)
-        {
-          cur->aux_mark = 2;
-          BTOR_PUSH_STACK (mm, stack, cur);
-
-          for (i = cur->arity - 1; i >= 0; i--)
-            BTOR_PUSH_STACK (mm, stack, cur->e[i]);
-        }
-      else
+      init_full_parent_iterator (&it, cur);
+      while (has_next_parent_full_parent_iterator (&it))
         {
-          assert (cur->aux_mark == 2);
-          cur->aux_mark = 0;
-
-          rebuilt_exp = rebuild_exp (btor, cur);
-          assert (rebuilt_exp != NULL);
-          /* base case: rebuilt_exp == cur */
-          if (rebuilt_exp != cur)
-            {
-              simplified =
-                btor_pointer_chase_simplified_exp (btor, rebuilt_exp);
-              set_simplified_exp (btor, cur, simplified, 1);
-            }
-
-          btor_release_exp (btor, rebuilt_exp);
+          cur_parent = next_parent_full_parent_iterator (&it);
+          assert (BTOR_IS_REGULAR_EXP (cur_parent));
+          if (cur_parent->kind != BTOR_PROXY_EXP &&
+              !btor_find_in_ptr_hash_table (parents, cur_parent))
+            btor_insert_in_ptr_hash_table (parents, cur_parent);
         }
     }
-
-  BTOR_RELEASE_STACK (mm, stack);
-
-  top = root_stack.top;
-  for (temp = root_stack.start; temp != top; temp++)
-    btor_release_exp (btor, *temp);
-  BTOR_RELEASE_STACK (mm, root_stack);
+  substitute_and_rebuild (btor, parents);
+  btor_delete_ptr_hash_table (parents);
 }
 
 static void 
@@ -8913,7 +9863,7 @@ process_embedded_constraints (Btor * btor)
 }
 
 static void
-run_rewrite_engine (Btor * btor, int full)
+run_rewrite_engine_aux (Btor * btor, int full)
 {
   int rewrite_level, inc_enabled, model_gen, check_cyclic;
 
@@ -8961,6 +9911,10 @@ run_rewrite_engine (Btor * btor, int full)
 
 	      if (rewrite_level > 2 && !inc_enabled)
 	        {
+		  eliminate_linear_equations (btor);
+		  if (btor->inconsistent)
+		    return;
+
 		  /* needs recursive rewrite bound > 0 */
 		  eliminate_slices_on_bv_vars (btor);
 		  if (btor->inconsistent)
@@ -8972,7 +9926,27 @@ run_rewrite_engine (Btor * btor, int full)
 	 while (btor->varsubst_constraints->count > 0u ||
 		btor->embedded_constraints->count > 0u);
 
-	 if (rewrite_level > 2 && !inc_enabled && !model_gen)
+	 if (rewrite_level > 2 && !inc_enabled)
+	   {
+	     reduce_bit_widths (btor);
+	     if (btor->inconsistent)
+	       return;
+	     check_cyclic = 1;
+	   }
+
+	 if (rewrite_level > 2 && !inc_enabled && !btor->ua.enabled &&
+	     btor->varsubst_constraints->count == 0u &&
+	     btor->embedded_constraints->count == 0u)
+	   {
+	     eliminate_unconstrained_exps (btor);
+	     if (btor->inconsistent)
+	       return;
+	     check_cyclic = 1;
+	   }
+
+	 if (rewrite_level > 2 && !inc_enabled && !model_gen &&
+	     btor->varsubst_constraints->count == 0u &&
+	     btor->embedded_constraints->count == 0u)
 	   {
 	     abstract_domain_bv_variables (btor);
 	     if (btor->inconsistent)
@@ -8986,6 +9960,16 @@ run_rewrite_engine (Btor * btor, int full)
    }
 }
 
+static void
+run_rewrite_engine (Btor * btor, int full)
+{
+  double start;
+  assert (btor != NULL);
+  start = btor_monotonic_time_stamp ();
+  run_rewrite_engine_aux (btor, full);
+  btor->time.rewrite += btor_monotonic_time_stamp () - start;
+}
+
 static int
 max_len_global_under_approx_vars (Btor * btor)
 {
@@ -9806,407 +10790,3236 @@ PROBE_EXPS_ENTER_WITHOUT_POP:
 #endif
 
 
-static void
-eliminate_slices_on_bv_vars (Btor * btor)
+/* Returns the number of leading bits of 'exp' which are known to be zero
+ * according to its three-valued bits.
+ */
+static int
+num_leading_zeros_3vl (BtorExp * exp)
 {
-  BtorExpPtrStack vars;
-  BtorFullParentIterator it;
-  BtorPtrHashBucket *b_var, *b1, *b2;
-  BtorExp *var, *cur, *result, *lambda_var, *temp;
-  Slice *s1, *s2, *new_s1, *new_s2, *new_s3, **sorted_slices;
-  BtorPtrHashTable *slices;
-  BtorMemMgr *mm;
-  int i, min, max;
-  int vals[4];
+  BtorExp *real_exp;
+  char zero;
+  int i;
 
-  assert (btor != NULL);
+  assert (exp != NULL);
+  real_exp = BTOR_REAL_ADDR_EXP (exp);
+  if (real_exp->bits == NULL)
+    return 0;
+  zero = BTOR_IS_INVERTED_EXP (exp) ? '1' : '0';
+  for (i = 0; i < real_exp->len && real_exp->bits[i] == zero; i++)
+    ;
+  return i;
+}
 
-  mm = btor->mm;
-  BTOR_INIT_STACK (vars);
-  for (b_var = btor->bv_vars->first; b_var != NULL; b_var = b_var->next)
-    {
-      var = (BtorExp *) b_var->key;
-      BTOR_PUSH_STACK (mm, vars, var);
-    }
+/* Returns the number of leading bits which are known to be equal
+ * in 'e0' and 'e1' according to their three-valued bits.
+ */
+static int
+num_common_leading_bits_3vl (BtorExp * e0, BtorExp * e1)
+{
+  BtorExp *real_e0, *real_e1;
+  char b0, b1;
+  int i;
 
-  while (!BTOR_EMPTY_STACK (vars))
-    {
-      slices = btor_new_ptr_hash_table (mm, (BtorHashPtr) hash_slice, 
-				            (BtorCmpPtr) compare_slices);
-      var = BTOR_POP_STACK (vars);
+  assert (e0 != NULL);
+  assert (e1 != NULL);
+  real_e0 = BTOR_REAL_ADDR_EXP (e0);
+  real_e1 = BTOR_REAL_ADDR_EXP (e1);
+  assert (real_e0->len == real_e1->len);
+  if (real_e0->bits == NULL || real_e1->bits == NULL)
+    return 0;
+  for (i = 0; i < real_e0->len; i++)
+    {
+      b0 = real_e0->bits[i];
+      b1 = real_e1->bits[i];
+      if (b0 == 'x' || b1 == 'x')
+        break;
+      if (BTOR_IS_INVERTED_EXP (e0))
+        b0 = b0 == '0' ? '1' : '0';
+      if (BTOR_IS_INVERTED_EXP (e1))
+        b1 = b1 == '0' ? '1' : '0';
+      if (b0 != b1)
+        break;
+    }
+  return i;
+}
+
+/* Computes an equivalent expression of smaller bit-width for additions,
+ * multiplications and comparisons whose operands have known leading bits.
+ * Returns NULL if no reduction is possible.
+ */
+static BtorExp *
+reduce_bit_width_exp (Btor * btor, BtorExp * exp)
+{
+  BtorExp *e0, *e1, *s0, *s1, *op, *zero, *result;
+  int len, width, w0, w1;
+
+  assert (btor != NULL);
+  assert (exp != NULL);
+  assert (BTOR_IS_REGULAR_EXP (exp));
+
+  if (exp->kind != BTOR_ADD_EXP && exp->kind != BTOR_MUL_EXP &&
+      exp->kind != BTOR_ULT_EXP && exp->kind != BTOR_BEQ_EXP)
+    return NULL;
+
+  e0 = btor_pointer_chase_simplified_exp (btor, exp->e[0]);
+  e1 = btor_pointer_chase_simplified_exp (btor, exp->e[1]);
+  len = BTOR_REAL_ADDR_EXP (e0)->len;
+  if (len == 1)
+    return NULL;
+
+  switch (exp->kind)
+    {
+    case BTOR_ADD_EXP:
+      /* the sum fits into one bit more than the wider operand */
+      width = len - BTOR_MIN_UTIL (num_leading_zeros_3vl (e0),
+                                   num_leading_zeros_3vl (e1)) + 1;
+      break;
+    case BTOR_MUL_EXP:
+      /* the product fits into the sum of the operand widths */
+      w0 = len - num_leading_zeros_3vl (e0);
+      w1 = len - num_leading_zeros_3vl (e1);
+      if (w0 == 0 || w1 == 0)
+        return NULL;
+      width = w0 + w1;
+      break;
+    default:
+      /* common leading bits do not influence the comparison */
+      assert (exp->kind == BTOR_ULT_EXP || exp->kind == BTOR_BEQ_EXP);
+      width = len - num_common_leading_bits_3vl (e0, e1);
+      if (width == 0)
+        return NULL;
+      break;
+    }
+
+  if (width >= len)
+    return NULL;
+
+  assert (width > 0);
+  s0 = btor_slice_exp (btor, e0, width - 1, 0);
+  s1 = btor_slice_exp (btor, e1, width - 1, 0);
+  switch (exp->kind)
+    {
+    case BTOR_ADD_EXP:
+      op = btor_add_exp (btor, s0, s1);
+      break;
+    case BTOR_MUL_EXP:
+      op = btor_mul_exp (btor, s0, s1);
+      break;
+    case BTOR_ULT_EXP:
+      op = btor_ult_exp (btor, s0, s1);
+      break;
+    default:
+      assert (exp->kind == BTOR_BEQ_EXP);
+      op = btor_eq_exp (btor, s0, s1);
+      break;
+    }
+  btor_release_exp (btor, s0);
+  btor_release_exp (btor, s1);
+
+  if (exp->kind == BTOR_ADD_EXP || exp->kind == BTOR_MUL_EXP)
+    {
+      zero = btor_zero_exp (btor, len - width);
+      result = btor_concat_exp (btor, zero, op);
+      btor_release_exp (btor, zero);
+      btor_release_exp (btor, op);
+    }
+  else
+    result = op;
+
+  return result;
+}
+
+/* Returns the lower 'width' bits of 'exp'. If a narrowed version of 'exp'
+ * with at least 'width' bits exists, then it is sliced instead of 'exp'.
+ */
+static BtorExp *
+narrow_operand_exp (Btor * btor, BtorPtrHashTable * narrowed,
+                    BtorExp * exp, int width)
+{
+  BtorPtrHashBucket *b;
+  BtorExp *narrow;
+
+  assert (btor != NULL);
+  assert (narrowed != NULL);
+  assert (exp != NULL);
+  assert (width > 0);
+
+  exp = btor_pointer_chase_simplified_exp (btor, exp);
+  b = btor_find_in_ptr_hash_table (narrowed, BTOR_REAL_ADDR_EXP (exp));
+  if (b != NULL)
+    {
+      narrow = (BtorExp *) b->data.asPtr;
+      if (BTOR_REAL_ADDR_EXP (narrow)->len >= width)
+        return btor_slice_exp (btor, BTOR_COND_INVERT_EXP (exp, narrow),
+                               width - 1, 0);
+    }
+  return btor_slice_exp (btor, exp, width - 1, 0);
+}
+
+/* Computes the lower 'width' bits of 'exp' from narrowed operands.
+ * Returns NULL if 'exp' cannot be narrowed.
+ */
+static BtorExp *
+narrow_exp (Btor * btor, BtorPtrHashTable * narrowed, BtorExp * exp,
+            int width)
+{
+  BtorExp *e0, *e1, *cond, *result;
+  int len1;
+
+  assert (btor != NULL);
+  assert (narrowed != NULL);
+  assert (exp != NULL);
+  assert (BTOR_IS_REGULAR_EXP (exp));
+  assert (width > 0);
+  assert (width < exp->len);
+
+  switch (exp->kind)
+    {
+    case BTOR_AND_EXP:
+    case BTOR_ADD_EXP:
+    case BTOR_MUL_EXP:
+      e0 = narrow_operand_exp (btor, narrowed, exp->e[0], width);
+      e1 = narrow_operand_exp (btor, narrowed, exp->e[1], width);
+      if (exp->kind == BTOR_AND_EXP)
+        result = btor_and_exp (btor, e0, e1);
+      else if (exp->kind == BTOR_ADD_EXP)
+        result = btor_add_exp (btor, e0, e1);
+      else
+        result = btor_mul_exp (btor, e0, e1);
+      break;
+    case BTOR_CONCAT_EXP:
+      len1 = BTOR_REAL_ADDR_EXP (exp->e[1])->len;
+      if (width <= len1)
+        return narrow_operand_exp (btor, narrowed, exp->e[1], width);
+      e0 = narrow_operand_exp (btor, narrowed, exp->e[0], width - len1);
+      e1 = btor_copy_exp (btor, exp->e[1]);
+      result = btor_concat_exp (btor, e0, e1);
+      break;
+    case BTOR_BCOND_EXP:
+      cond = exp->e[0];
+      e0 = narrow_operand_exp (btor, narrowed, exp->e[1], width);
+      e1 = narrow_operand_exp (btor, narrowed, exp->e[2], width);
+      result = btor_cond_exp (btor, cond, e0, e1);
+      break;
+    default:
+      return NULL;
+    }
+  btor_release_exp (btor, e0);
+  btor_release_exp (btor, e1);
+  return result;
+}
+
+/* Updates the number of demanded lower bits of 'exp' */
+static void
+demand_bits (BtorPtrHashTable * demanded, BtorExp * exp, int width)
+{
+  BtorPtrHashBucket *b;
+
+  assert (demanded != NULL);
+  assert (exp != NULL);
+  assert (width > 0);
+
+  exp = BTOR_REAL_ADDR_EXP (exp);
+  assert (width <= exp->len);
+  b = btor_find_in_ptr_hash_table (demanded, exp);
+  if (b == NULL)
+    btor_insert_in_ptr_hash_table (demanded, exp)->data.asInt = width;
+  else if (b->data.asInt < width)
+    b->data.asInt = width;
+}
+
+/* Word-level bit-width reduction.
+ * First, we determine top-down how many lower bits of each expression are
+ * demanded by the constraints.  Then, we rebuild the formula bottom-up.
+ * Additions, multiplications and comparisons with known leading bits are
+ * replaced by equivalent narrower expressions.  Expressions of which only
+ * the lower bits are demanded are computed on narrowed operands, and slices
+ * on them are redirected to the narrowed versions.  Only equivalent
+ * expressions are substituted, hence models can be obtained as usual by
+ * following simplified pointers.
+ */
+static void
+reduce_bit_widths (Btor * btor)
+{
+  BtorPtrHashTable *demanded, *narrowed;
+  BtorPtrHashBucket *b;
+  BtorExpPtrStack stack, order;
+  BtorExp *cur, *rep, *real_rep, *result, *narrow, *child, *simplified;
+  BtorMemMgr *mm;
+  int i, j, width, len1, changed;
+
+  assert (btor != NULL);
+  assert (btor->rewrite_level > 2);
+  assert (!btor->inc_enabled);
+  assert (btor->varsubst_constraints->count == 0u);
+  assert (btor->embedded_constraints->count == 0u);
+
+  if (btor->unsynthesized_constraints->count == 0u)
+    return;
+
+  mm = btor->mm;
+  BTOR_INIT_STACK (stack);
+  BTOR_INIT_STACK (order);
+
+  /* compute topological order of all expressions in the constraints */
+  for (b = btor->unsynthesized_constraints->first; b != NULL; b = b->next)
+    BTOR_PUSH_STACK (mm, stack, BTOR_REAL_ADDR_EXP ((BtorExp *) b->key));
+  while (!BTOR_EMPTY_STACK (stack))
+    {
+      cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
+      if (cur->aux_mark == 2)
+        continue;
+      if (cur->aux_mark == 0)
+        {
+          cur->aux_mark = 1;
+          BTOR_PUSH_STACK (mm, stack, cur);
+          for (i = cur->arity - 1; i >= 0; i--)
+            BTOR_PUSH_STACK (mm, stack, cur->e[i]);
+        }
+      else if (cur->aux_mark == 1)
+        {
+          cur->aux_mark = 2;
+          /* expressions may become proxies during rebuild */
+          BTOR_PUSH_STACK (mm, order, btor_copy_exp (btor, cur));
+        }
+    }
+  for (i = 0; i < BTOR_COUNT_STACK (order); i++)
+    order.start[i]->aux_mark = 0;
+
+  /* propagate demanded bits top-down */
+  demanded = btor_new_ptr_hash_table (mm,
+                                      (BtorHashPtr) btor_hash_exp_by_id,
+                                      (BtorCmpPtr) btor_compare_exp_by_id);
+  for (i = BTOR_COUNT_STACK (order) - 1; i >= 0; i--)
+    {
+      cur = order.start[i];
+      if (BTOR_IS_ARRAY_EXP (cur))
+        width = 0;
+      else
+        {
+          b = btor_find_in_ptr_hash_table (demanded, cur);
+          /* roots are fully demanded */
+          width = b == NULL ? cur->len : b->data.asInt;
+        }
+      switch (cur->kind)
+        {
+        case BTOR_SLICE_EXP:
+          demand_bits (demanded, cur->e[0], cur->lower + width);
+          break;
+        case BTOR_AND_EXP:
+        case BTOR_ADD_EXP:
+        case BTOR_MUL_EXP:
+          demand_bits (demanded, cur->e[0], width);
+          demand_bits (demanded, cur->e[1], width);
+          break;
+        case BTOR_CONCAT_EXP:
+          len1 = BTOR_REAL_ADDR_EXP (cur->e[1])->len;
+          demand_bits (demanded, cur->e[0],
+                       BTOR_MAX_UTIL (width - len1, 1));
+          demand_bits (demanded, cur->e[1], BTOR_MIN_UTIL (width, len1));
+          break;
+        case BTOR_BCOND_EXP:
+          demand_bits (demanded, cur->e[0], 1);
+          demand_bits (demanded, cur->e[1], width);
+          demand_bits (demanded, cur->e[2], width);
+          break;
+        default:
+          for (j = 0; j < cur->arity; j++)
+            {
+              child = BTOR_REAL_ADDR_EXP (cur->e[j]);
+              if (!BTOR_IS_ARRAY_EXP (child))
+                demand_bits (demanded, child, child->len);
+            }
+          break;
+        }
+    }
+
+  /* rebuild bottom-up */
+  narrowed = btor_new_ptr_hash_table (mm,
+                                      (BtorHashPtr) btor_hash_exp_by_id,
+                                      (BtorCmpPtr) btor_compare_exp_by_id);
+  for (i = 0; i < BTOR_COUNT_STACK (order); i++)
+    {
+      cur = order.start[i];
+      if (cur->kind == BTOR_PROXY_EXP || cur->arity == 0)
+        continue;
+
+      result = reduce_bit_width_exp (btor, cur);
+      if (result != NULL)
+        btor->stats.bw_reductions++;
+      else if (cur->kind == BTOR_SLICE_EXP)
+        {
+          child = btor_pointer_chase_simplified_exp (btor, cur->e[0]);
+          b = btor_find_in_ptr_hash_table (narrowed,
+                                           BTOR_REAL_ADDR_EXP (child));
+          if (b != NULL && cur->upper <
+              BTOR_REAL_ADDR_EXP ((BtorExp *) b->data.asPtr)->len)
+            {
+              narrow = (BtorExp *) b->data.asPtr;
+              result = btor_slice_exp (btor,
+                                       BTOR_COND_INVERT_EXP (child, narrow),
+                                       cur->upper, cur->lower);
+            }
+        }
+      if (result == NULL)
+        {
+          changed = 0;
+          for (j = 0; j < cur->arity; j++)
+            if (BTOR_REAL_ADDR_EXP (cur->e[j])->simplified != NULL)
+              changed = 1;
+          if (changed)
+            result = rebuild_exp (btor, cur);
+        }
+      if (result != NULL)
+        {
+          if (result != cur)
+            {
+              simplified = btor_pointer_chase_simplified_exp (btor, result);
+              set_simplified_exp (btor, cur, simplified, 1);
+            }
+          btor_release_exp (btor, result);
+        }
+
+      if (BTOR_IS_ARRAY_EXP (cur))
+        continue;
+      b = btor_find_in_ptr_hash_table (demanded, cur);
+      width = b == NULL ? cur->len : b->data.asInt;
+      if (width >= cur->len)
+        continue;
+
+      /* only the lower bits are demanded */
+      rep = btor_pointer_chase_simplified_exp (btor, cur);
+      real_rep = BTOR_REAL_ADDR_EXP (rep);
+      b = btor_find_in_ptr_hash_table (narrowed, real_rep);
+      if (b != NULL &&
+          BTOR_REAL_ADDR_EXP ((BtorExp *) b->data.asPtr)->len >= width)
+        continue;
+      narrow = narrow_exp (btor, narrowed, real_rep, width);
+      if (narrow == NULL)
+        continue;
+      if (b == NULL)
+        {
+          b = btor_insert_in_ptr_hash_table (narrowed,
+                                             btor_copy_exp (btor, real_rep));
+        }
+      else
+        btor_release_exp (btor, (BtorExp *) b->data.asPtr);
+      b->data.asPtr = narrow;
+      btor->stats.bw_reductions++;
+    }
+
+  rebuild_parents_of_proxies (btor, order.start, BTOR_COUNT_STACK (order));
+
+  /* cleanup */
+  for (b = narrowed->first; b != NULL; b = b->next)
+    {
+      btor_release_exp (btor, (BtorExp *) b->key);
+      btor_release_exp (btor, (BtorExp *) b->data.asPtr);
+    }
+  btor_delete_ptr_hash_table (narrowed);
+  btor_delete_ptr_hash_table (demanded);
+  for (i = 0; i < BTOR_COUNT_STACK (order); i++)
+    btor_release_exp (btor, order.start[i]);
+  BTOR_RELEASE_STACK (mm, order);
+  BTOR_RELEASE_STACK (mm, stack);
+}
+
+
+/*------------------------------------------------------------------------*/
+/* Gaussian elimination of linear equations                               */
+/*------------------------------------------------------------------------*/
+
+/* Equality constraints which are linear in bit-vector variables, either
+ * modulo 2^n or bit-wise over GF(2), i.e. built from exclusive or, are
+ * grouped into systems with the same kind and width.  Every system is
+ * solved jointly by Gauss-Jordan elimination on a dense matrix.  Rows of
+ * modular systems are words, thus the width is limited to 64, and only
+ * odd coefficients are used as pivots.  Rows of GF(2) systems are
+ * packed bit sets.  Every variable solved this way becomes a variable
+ * substitution constraint and its original equation is removed.
+ */
+
+/* maximum number of expressions visited per equation */
+#define BTOR_GE_TERM_LIMIT 1000
+/* maximum number of matrix words per system */
+#define BTOR_GE_MATRIX_LIMIT (1 << 20)
+
+#define BTOR_GE_WORD_BITS ((int) (8 * sizeof (unsigned long long)))
+
+enum BtorGEKind
+{
+  BTOR_GE_ARITH = 0,
+  BTOR_GE_XOR = 1
+};
+
+typedef enum BtorGEKind BtorGEKind;
+
+typedef struct BtorGETerm BtorGETerm;
+
+struct BtorGETerm
+{
+  BtorExp *exp;                 /* regular, not a constant */
+  unsigned long long coeff;
+};
+
+BTOR_DECLARE_STACK (GETerm, BtorGETerm);
+
+typedef struct BtorGEEquation BtorGEEquation;
+
+struct BtorGEEquation
+{
+  BtorExp *exp;                 /* original equality constraint */
+  BtorGEKind kind;
+  int len;
+  int num_terms;
+  BtorGETerm *terms;            /* sum of terms plus constant is zero */
+  unsigned long long val;       /* constant of modular equations */
+  char *bits;                   /* constant of GF(2) equations */
+};
+
+static unsigned long long
+mask_ge (int len)
+{
+  assert (len > 0);
+  assert (len <= BTOR_GE_WORD_BITS);
+  return len == BTOR_GE_WORD_BITS ? ~0ull : (1ull << len) - 1;
+}
+
+static unsigned long long
+const_to_word_ge (BtorExp * exp)
+{
+  unsigned long long res;
+  BtorExp *real_exp;
+  int i;
+
+  real_exp = BTOR_REAL_ADDR_EXP (exp);
+  assert (BTOR_IS_BV_CONST_EXP (real_exp));
+  assert (real_exp->len <= BTOR_GE_WORD_BITS);
+
+  res = 0;
+  for (i = 0; i < real_exp->len; i++)
+    res = 2 * res + (real_exp->bits[i] == '1');
+  if (BTOR_IS_INVERTED_EXP (exp))
+    res = ~res;
+  return res & mask_ge (real_exp->len);
+}
+
+static BtorExp *
+word_to_exp_ge (Btor * btor, unsigned long long val, int len)
+{
+  BtorExp *result;
+  char *bits;
+  int i;
+
+  BTOR_NEWN (btor->mm, bits, len + 1);
+  for (i = 0; i < len; i++)
+    bits[len - 1 - i] = (val >> i) & 1 ? '1' : '0';
+  bits[len] = '\0';
+  result = btor_const_exp (btor, bits);
+  BTOR_DELETEN (btor->mm, bits, len + 1);
+  return result;
+}
+
+/* Inverse of an odd number modulo 2^64 by Newton iteration, every
+ * step doubles the number of correct low bits. */
+static unsigned long long
+inverse_word_ge (unsigned long long a)
+{
+  unsigned long long res;
+  int i;
+
+  assert (a & 1);
+  res = a;
+  for (i = 0; i < 5; i++)
+    res *= 2 - a * res;
+  assert (a * res == 1);
+  return res;
+}
+
+/* Is 'exp' an exclusive or as built by 'btor_xor_exp', i.e.
+ * '~(~a & ~b) & ~(a & b)' in any order? */
+static int
+is_xor_exp_ge (BtorExp * exp, BtorExp ** a, BtorExp ** b)
+{
+  BtorExp *e0, *e1;
+
+  if (BTOR_IS_INVERTED_EXP (exp) || exp->kind != BTOR_AND_EXP)
+    return 0;
+  if (!BTOR_IS_INVERTED_EXP (exp->e[0]) || !BTOR_IS_INVERTED_EXP (exp->e[1]))
+    return 0;
+  e0 = BTOR_REAL_ADDR_EXP (exp->e[0]);
+  e1 = BTOR_REAL_ADDR_EXP (exp->e[1]);
+  if (e0->kind != BTOR_AND_EXP || e1->kind != BTOR_AND_EXP)
+    return 0;
+  if ((e0->e[0] != BTOR_INVERT_EXP (e1->e[0])
+       || e0->e[1] != BTOR_INVERT_EXP (e1->e[1]))
+      && (e0->e[0] != BTOR_INVERT_EXP (e1->e[1])
+          || e0->e[1] != BTOR_INVERT_EXP (e1->e[0])))
+    return 0;
+  *a = e0->e[0];
+  *b = e0->e[1];
+  return 1;
+}
+
+/* Adds 'coeff * term' to a modular equation.  Expressions which are not
+ * linear, and all expressions beyond the bound, are kept as terms. */
+static void
+collect_arith_terms_ge (Btor * btor, BtorGETermStack * terms,
+                        unsigned long long *val, BtorExp * term,
+                        unsigned long long coeff, int *bound_ptr)
+{
+  BtorExp *real_term, *other;
+  BtorGETerm t;
+  int len;
+
+  real_term = BTOR_REAL_ADDR_EXP (term);
+  len = real_term->len;
+  coeff &= mask_ge (len);
+  if (coeff == 0)
+    return;
+
+  if (BTOR_IS_BV_CONST_EXP (real_term))
+    {
+      *val += coeff * const_to_word_ge (term);
+      return;
+    }
+
+  if (*bound_ptr > 0)
+    {
+      *bound_ptr -= 1;
+
+      if (BTOR_IS_INVERTED_EXP (term))
+        {
+          /* coeff * ~t = coeff * (-1 - t) = -coeff - coeff * t */
+          *val -= coeff;
+          collect_arith_terms_ge (btor, terms, val, real_term, -coeff,
+                                  bound_ptr);
+          return;
+        }
+
+      if (term->kind == BTOR_ADD_EXP)
+        {
+          collect_arith_terms_ge (btor, terms, val, term->e[0], coeff,
+                                  bound_ptr);
+          collect_arith_terms_ge (btor, terms, val, term->e[1], coeff,
+                                  bound_ptr);
+          return;
+        }
+
+      if (term->kind == BTOR_MUL_EXP
+          && (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (term->e[0]))
+              || BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (term->e[1]))))
+        {
+          if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (term->e[0])))
+            {
+              coeff *= const_to_word_ge (term->e[0]);
+              other = term->e[1];
+            }
+          else
+            {
+              coeff *= const_to_word_ge (term->e[1]);
+              other = term->e[0];
+            }
+          collect_arith_terms_ge (btor, terms, val, other, coeff, bound_ptr);
+          return;
+        }
+
+      if (term->kind == BTOR_SLL_EXP
+          && BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (term->e[1])))
+        {
+          /* shift width is log2 of 'len', thus shifts are smaller */
+          coeff <<= const_to_word_ge (term->e[1]);
+          collect_arith_terms_ge (btor, terms, val, term->e[0], coeff,
+                                  bound_ptr);
+          return;
+        }
+    }
+
+  if (BTOR_IS_INVERTED_EXP (term))
+    {
+      *val -= coeff;
+      coeff = -coeff;
+    }
+  t.exp = real_term;
+  t.coeff = coeff;
+  BTOR_PUSH_STACK (btor->mm, *terms, t);
+}
+
+/* Adds 'term' to a GF(2) equation with constant 'bits'. */
+static void
+collect_xor_terms_ge (Btor * btor, BtorGETermStack * terms, char *bits,
+                      BtorExp * term, int *bound_ptr)
+{
+  BtorExp *real_term, *a, *b;
+  BtorGETerm t;
+  int i;
+
+  real_term = BTOR_REAL_ADDR_EXP (term);
+
+  /* ~t = t ^ 1...1 */
+  if (BTOR_IS_INVERTED_EXP (term))
+    btor_invert_const (btor->mm, bits);
+
+  if (BTOR_IS_BV_CONST_EXP (real_term))
+    {
+      for (i = 0; i < real_term->len; i++)
+        if (real_term->bits[i] == '1')
+          bits[i] = bits[i] == '1' ? '0' : '1';
+      return;
+    }
+
+  if (*bound_ptr > 0 && is_xor_exp_ge (real_term, &a, &b))
+    {
+      *bound_ptr -= 1;
+      collect_xor_terms_ge (btor, terms, bits, a, bound_ptr);
+      collect_xor_terms_ge (btor, terms, bits, b, bound_ptr);
+      return;
+    }
+
+  t.exp = real_term;
+  t.coeff = 1;
+  BTOR_PUSH_STACK (btor->mm, *terms, t);
+}
+
+static int
+count_var_terms_ge (BtorGETermStack * terms)
+{
+  int i, res;
+
+  res = 0;
+  for (i = 0; i < BTOR_COUNT_STACK (*terms); i++)
+    res += BTOR_IS_BV_VAR_EXP (terms->start[i].exp);
+  return res;
+}
+
+/* Translates equality constraint 'exp' into a modular or GF(2) equation,
+ * whichever has more variable terms.  Returns zero if there are none. */
+static int
+linear_equation_ge (Btor * btor, BtorExp * exp, BtorGEEquation * eq)
+{
+  BtorGETermStack arith, xor;
+  unsigned long long val;
+  int bound, len, num_arith, num_xor;
+  BtorMemMgr *mm;
+  char *bits;
+
+  assert (BTOR_IS_REGULAR_EXP (exp));
+  assert (exp->kind == BTOR_BEQ_EXP);
+
+  mm = btor->mm;
+  len = BTOR_REAL_ADDR_EXP (exp->e[0])->len;
+  BTOR_INIT_STACK (arith);
+  BTOR_INIT_STACK (xor);
+
+  num_arith = 0;
+  val = 0;
+  if (len <= BTOR_GE_WORD_BITS)
+    {
+      bound = BTOR_GE_TERM_LIMIT;
+      collect_arith_terms_ge (btor, &arith, &val, exp->e[0], 1, &bound);
+      collect_arith_terms_ge (btor, &arith, &val, exp->e[1], -1ull, &bound);
+      num_arith = count_var_terms_ge (&arith);
+    }
+
+  bits = btor_zero_const (mm, len);
+  bound = BTOR_GE_TERM_LIMIT;
+  collect_xor_terms_ge (btor, &xor, bits, exp->e[0], &bound);
+  collect_xor_terms_ge (btor, &xor, bits, exp->e[1], &bound);
+  num_xor = count_var_terms_ge (&xor);
+
+  if (num_arith == 0 && num_xor == 0)
+    {
+      btor_delete_const (mm, bits);
+      BTOR_RELEASE_STACK (mm, arith);
+      BTOR_RELEASE_STACK (mm, xor);
+      return 0;
+    }
+
+  eq->exp = exp;
+  eq->len = len;
+  if (num_arith >= num_xor)
+    {
+      eq->kind = BTOR_GE_ARITH;
+      eq->num_terms = BTOR_COUNT_STACK (arith);
+      BTOR_NEWN (mm, eq->terms, eq->num_terms);
+      memcpy (eq->terms, arith.start, eq->num_terms * sizeof (BtorGETerm));
+      eq->val = val & mask_ge (len);
+      eq->bits = NULL;
+      btor_delete_const (mm, bits);
+    }
+  else
+    {
+      eq->kind = BTOR_GE_XOR;
+      eq->num_terms = BTOR_COUNT_STACK (xor);
+      BTOR_NEWN (mm, eq->terms, eq->num_terms);
+      memcpy (eq->terms, xor.start, eq->num_terms * sizeof (BtorGETerm));
+      eq->val = 0;
+      eq->bits = bits;
+    }
+
+  BTOR_RELEASE_STACK (mm, arith);
+  BTOR_RELEASE_STACK (mm, xor);
+  return 1;
+}
+
+static int
+compare_ge_equations (const void *p, const void *q)
+{
+  const BtorGEEquation *a, *b;
+
+  a = (const BtorGEEquation *) p;
+  b = (const BtorGEEquation *) q;
+  if (a->kind != b->kind)
+    return a->kind - b->kind;
+  if (a->len != b->len)
+    return a->len - b->len;
+  return a->exp->id - b->exp->id;
+}
+
+/* Marks variables which occur below non-linear terms of the equations,
+ * as their right hand sides could contain them. */
+static void
+mark_vars_below_terms_ge (Btor * btor, BtorGEEquation * eqs, int num_eqs,
+                          BtorPtrHashTable * blocked)
+{
+  BtorExpPtrStack stack;
+  BtorExp *cur;
+  BtorMemMgr *mm;
+  int i, j, k;
+  long long epoch;
+
+  mm = btor->mm;
+  init_trv_stack (btor, &stack);
+  epoch = new_trv_epoch (btor);
+
+  for (i = 0; i < num_eqs; i++)
+    for (j = 0; j < eqs[i].num_terms; j++)
+      {
+        cur = eqs[i].terms[j].exp;
+        if (BTOR_IS_BV_VAR_EXP (cur))
+          continue;
+        BTOR_PUSH_STACK (mm, stack, cur);
+        while (!BTOR_EMPTY_STACK (stack))
+          {
+            cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
+            if (cur->epoch == epoch)
+              continue;
+            cur->epoch = epoch;
+            if (BTOR_IS_BV_VAR_EXP (cur))
+              {
+                if (!btor_find_in_ptr_hash_table (blocked, cur))
+                  btor_insert_in_ptr_hash_table (blocked, cur);
+              }
+            else
+              for (k = 0; k < cur->arity; k++)
+                BTOR_PUSH_STACK (mm, stack, cur->e[k]);
+          }
+      }
+
+  release_trv_stack (btor, &stack);
+}
+
+/* Solves the equations 'eqs[0..num_eqs-1]' of the same kind and width.
+ * Pivot rows are flagged in 'solved'.  Returns the number of variable
+ * substitutions. */
+static int
+solve_linear_system_ge (Btor * btor, BtorGEEquation * eqs, int num_eqs,
+                        BtorPtrHashTable * blocked, char *solved)
+{
+  unsigned long long *matrix, *row, *other, mask, inv, f, *vals;
+  int i, j, k, r, len, num_cols, num_words, pivot, result, words, *pivots;
+  BtorExp *var, *rhs, *tmp, *term, *c;
+  BtorPtrHashTable *cols;
+  BtorExpPtrStack col_exps;
+  BtorPtrHashBucket *b;
+  BtorGEKind kind;
+  BtorMemMgr *mm;
+  char **bits;
+
+  assert (num_eqs > 0);
+
+  mm = btor->mm;
+  kind = eqs[0].kind;
+  len = eqs[0].len;
+  result = 0;
+
+  /* columns in order of their first occurrence */
+  cols = btor_new_ptr_hash_table (mm,
+                                  (BtorHashPtr) btor_hash_exp_by_id,
+                                  (BtorCmpPtr) btor_compare_exp_by_id);
+  BTOR_INIT_STACK (col_exps);
+  for (i = 0; i < num_eqs; i++)
+    for (j = 0; j < eqs[i].num_terms; j++)
+      if (!btor_find_in_ptr_hash_table (cols, eqs[i].terms[j].exp))
+        {
+          btor_insert_in_ptr_hash_table (cols, eqs[i].terms[j].exp)->
+            data.asInt = BTOR_COUNT_STACK (col_exps);
+          BTOR_PUSH_STACK (mm, col_exps, eqs[i].terms[j].exp);
+        }
+  num_cols = BTOR_COUNT_STACK (col_exps);
+
+  if (kind == BTOR_GE_ARITH)
+    words = num_cols;
+  else
+    words = (num_cols + BTOR_GE_WORD_BITS - 1) / BTOR_GE_WORD_BITS;
+
+  if ((long long) words * num_eqs > BTOR_GE_MATRIX_LIMIT)
+    {
+      BTOR_RELEASE_STACK (mm, col_exps);
+      btor_delete_ptr_hash_table (cols);
+      return 0;
+    }
+
+  num_words = words * num_eqs;
+  BTOR_CNEWN (mm, matrix, num_words);
+  BTOR_CNEWN (mm, vals, num_eqs);
+  BTOR_CNEWN (mm, bits, num_eqs);
+  BTOR_NEWN (mm, pivots, num_eqs);
+  mask = kind == BTOR_GE_ARITH ? mask_ge (len) : 1;
+
+  for (i = 0; i < num_eqs; i++)
+    {
+      row = matrix + i * words;
+      for (j = 0; j < eqs[i].num_terms; j++)
+        {
+          b = btor_find_in_ptr_hash_table (cols, eqs[i].terms[j].exp);
+          k = b->data.asInt;
+          if (kind == BTOR_GE_ARITH)
+            row[k] = (row[k] + eqs[i].terms[j].coeff) & mask;
+          else
+            row[k / BTOR_GE_WORD_BITS] ^= 1ull << (k % BTOR_GE_WORD_BITS);
+        }
+      vals[i] = eqs[i].val;
+      if (kind == BTOR_GE_XOR)
+        bits[i] = btor_copy_const (mm, eqs[i].bits);
+    }
+
+  /* Gauss-Jordan elimination, pivot columns are removed from all other
+   * rows, thus right hand sides do not contain pivot variables */
+  for (r = 0; r < num_eqs; r++)
+    {
+      pivots[r] = -1;
+      row = matrix + r * words;
+      for (pivot = 0; pivot < num_cols; pivot++)
+        {
+          var = col_exps.start[pivot];
+          if (!BTOR_IS_BV_VAR_EXP (var)
+              || btor_find_in_ptr_hash_table (blocked, var))
+            continue;
+          if (kind == BTOR_GE_ARITH ? (row[pivot] & 1) :
+              (row[pivot / BTOR_GE_WORD_BITS] >>
+               (pivot % BTOR_GE_WORD_BITS)) & 1)
+            break;
+        }
+      if (pivot == num_cols)
+        continue;
+
+      pivots[r] = pivot;
+      if (kind == BTOR_GE_ARITH)
+        {
+          inv = inverse_word_ge (row[pivot]);
+          for (j = 0; j < num_cols; j++)
+            row[j] = (row[j] * inv) & mask;
+          vals[r] = (vals[r] * inv) & mask;
+          for (i = 0; i < num_eqs; i++)
+            {
+              other = matrix + i * words;
+              if (i == r || !(f = other[pivot]))
+                continue;
+              for (j = 0; j < num_cols; j++)
+                other[j] = (other[j] - f * row[j]) & mask;
+              vals[i] = (vals[i] - f * vals[r]) & mask;
+            }
+        }
+      else
+        {
+          for (i = 0; i < num_eqs; i++)
+            {
+              other = matrix + i * words;
+              if (i == r || !((other[pivot / BTOR_GE_WORD_BITS] >>
+                               (pivot % BTOR_GE_WORD_BITS)) & 1))
+                continue;
+              for (j = 0; j < words; j++)
+                other[j] ^= row[j];
+              for (j = 0; j < len; j++)
+                if (bits[r][j] == '1')
+                  bits[i][j] = bits[i][j] == '1' ? '0' : '1';
+            }
+        }
+    }
+
+  /* pivot row 'x + sum (a * t) + c = 0' gives 'x = sum (-a * t) - c',
+   * and 'x ^ t ^ ... ^ c = 0' gives 'x = t ^ ... ^ c' */
+  for (r = 0; r < num_eqs; r++)
+    {
+      if (pivots[r] < 0)
+        continue;
+      row = matrix + r * words;
+      var = col_exps.start[pivots[r]];
+      if (kind == BTOR_GE_ARITH)
+        rhs = word_to_exp_ge (btor, -vals[r] & mask, len);
+      else
+        rhs = btor_const_exp (btor, bits[r]);
+      for (j = 0; j < num_cols; j++)
+        {
+          if (j == pivots[r])
+            continue;
+          term = col_exps.start[j];
+          if (kind == BTOR_GE_ARITH)
+            {
+              f = -row[j] & mask;
+              if (f == 0)
+                continue;
+              if (f == 1)
+                term = btor_copy_exp (btor, term);
+              else if (f == mask)
+                term = btor_neg_exp (btor, term);
+              else
+                {
+                  c = word_to_exp_ge (btor, f, len);
+                  term = btor_mul_exp (btor, c, term);
+                  btor_release_exp (btor, c);
+                }
+              tmp = btor_add_exp (btor, rhs, term);
+            }
+          else
+            {
+              if (!((row[j / BTOR_GE_WORD_BITS] >> (j % BTOR_GE_WORD_BITS))
+                    & 1))
+                continue;
+              term = btor_copy_exp (btor, term);
+              tmp = btor_xor_exp (btor, rhs, term);
+            }
+          btor_release_exp (btor, term);
+          btor_release_exp (btor, rhs);
+          rhs = tmp;
+        }
+      assert (!occurrence_check (btor, var, rhs));
+      insert_varsubst_constraint (btor, var, rhs);
+      btor_release_exp (btor, rhs);
+      /* later systems must not substitute it again */
+      btor_insert_in_ptr_hash_table (blocked, var);
+      solved[r] = 1;
+      result++;
+    }
+
+  BTOR_DELETEN (mm, matrix, num_words);
+  BTOR_DELETEN (mm, vals, num_eqs);
+  BTOR_DELETEN (mm, pivots, num_eqs);
+  for (i = 0; i < num_eqs; i++)
+    if (bits[i] != NULL)
+      btor_delete_const (mm, bits[i]);
+  BTOR_DELETEN (mm, bits, num_eqs);
+  BTOR_RELEASE_STACK (mm, col_exps);
+  btor_delete_ptr_hash_table (cols);
+  return result;
+}
+
+static void
+eliminate_linear_equations (Btor * btor)
+{
+  BtorPtrHashTable *blocked;
+  BtorGEEquation *eqs;
+  BtorPtrHashBucket *b;
+  int i, j, num_eqs, size, substs;
+  BtorExp *cur;
+  BtorMemMgr *mm;
+  double start;
+  char *solved;
+
+  assert (btor != NULL);
+  assert (btor->rewrite_level > 2);
+  assert (!btor->inc_enabled);
+
+  if (btor->unsynthesized_constraints->count == 0u)
+    return;
+
+  start = btor_time_stamp ();
+  mm = btor->mm;
+  num_eqs = 0;
+  size = btor->unsynthesized_constraints->count;
+  BTOR_NEWN (mm, eqs, size);
+  for (b = btor->unsynthesized_constraints->first; b != NULL; b = b->next)
+    {
+      cur = (BtorExp *) b->key;
+      if (BTOR_IS_INVERTED_EXP (cur) || cur->kind != BTOR_BEQ_EXP)
+        continue;
+      /* the negation would lose its constraint flag on removal */
+      if (btor_find_in_ptr_hash_table (btor->unsynthesized_constraints,
+                                       BTOR_INVERT_EXP (cur)))
+        continue;
+      if (linear_equation_ge (btor, cur, eqs + num_eqs))
+        num_eqs++;
+    }
+
+  if (num_eqs == 0)
+    {
+      BTOR_DELETEN (mm, eqs, size);
+      return;
+    }
+
+  /* the constraints are not changed before the equations are deleted */
+  qsort (eqs, num_eqs, sizeof (BtorGEEquation), compare_ge_equations);
+  blocked = btor_new_ptr_hash_table (mm,
+                                     (BtorHashPtr) btor_hash_exp_by_id,
+                                     (BtorCmpPtr) btor_compare_exp_by_id);
+  mark_vars_below_terms_ge (btor, eqs, num_eqs, blocked);
+  for (i = 0; i < num_eqs; i++)
+    btor_copy_exp (btor, eqs[i].exp);
+
+  substs = 0;
+  BTOR_CNEWN (mm, solved, num_eqs);
+  for (i = 0; i < num_eqs; i = j)
+    {
+      for (j = i + 1; j < num_eqs; j++)
+        if (eqs[j].kind != eqs[i].kind || eqs[j].len != eqs[i].len)
+          break;
+      substs += solve_linear_system_ge (btor, eqs + i, j - i, blocked,
+                                        solved + i);
+    }
+
+  /* substitutions imply the equations of their pivot rows, rows without
+   * pivot are only reduced by pivot rows and thus stay equivalent */
+  for (i = 0; i < num_eqs; i++)
+    {
+      cur = eqs[i].exp;
+      if (solved[i]
+          && btor_find_in_ptr_hash_table (btor->unsynthesized_constraints,
+                                          cur))
+        {
+          btor_remove_from_ptr_hash_table (btor->unsynthesized_constraints,
+                                           cur, NULL, NULL);
+          cur->constraint = 0;
+          btor_release_exp (btor, cur);
+        }
+      btor_release_exp (btor, cur);
+      BTOR_DELETEN (mm, eqs[i].terms, eqs[i].num_terms);
+      if (eqs[i].bits != NULL)
+        btor_delete_const (mm, eqs[i].bits);
+    }
+
+  btor->stats.gauss_equations += num_eqs;
+  btor->stats.gauss_substs += substs;
+  if (btor->verbosity > 1)
+    btor_msg_exp ("gaussian elimination: %d equations, %d substitutions, "
+                  "%.2f seconds", num_eqs, substs, btor_time_stamp () - start);
+
+  BTOR_DELETEN (mm, solved, num_eqs);
+  btor_delete_ptr_hash_table (blocked);
+  BTOR_DELETEN (mm, eqs, size);
+}
+
+/*------------------------------------------------------------------------*/
+/* Unconstrained expressions                                              */
+/*------------------------------------------------------------------------*/
+
+/* An expression is unconstrained if it can take every value independent
+ * of the rest of the formula.  Variables are unconstrained, and so are
+ * additions, equalities and exclusive ors with an unconstrained operand,
+ * multiplications of an unconstrained operand by an odd constant, slices
+ * of an unconstrained operand, and comparisons and concatenations of two
+ * unconstrained operands.  An operand is only unconstrained for its
+ * parent if it does not occur anywhere else.  Unconstrained expressions
+ * are determined bottom-up, and every maximal one is replaced by a fresh
+ * variable.  If models are generated, the values of the eliminated
+ * variables are given top-down by expressions over the fresh variables,
+ * otherwise also reads and writes on unconstrained arrays are replaced.
+ */
+
+static int
+num_parents_uc (BtorExp * exp, int limit)
+{
+  BtorFullParentIterator it;
+  int result;
+
+  assert (BTOR_IS_REGULAR_EXP (exp));
+
+  result = 0;
+  init_full_parent_iterator (&it, exp);
+  while (result <= limit && has_next_parent_full_parent_iterator (&it))
+    {
+      (void) next_parent_full_parent_iterator (&it);
+      result++;
+    }
+  return result;
+}
+
+/* Is 'child' unconstrained and its only occurrence in its parent? */
+static int
+is_uc_child_exp (BtorPtrHashTable * uc, BtorExp * child)
+{
+  BtorExp *real_child;
+
+  real_child = BTOR_REAL_ADDR_EXP (child);
+  return btor_find_in_ptr_hash_table (uc, real_child) != NULL
+    && !real_child->constraint && num_parents_uc (real_child, 1) == 1;
+}
+
+/* Is 'leaf' of the exclusive or 'exp' unconstrained and only used by
+ * 'exp'?  Both of its occurrences are in the inner conjunctions. */
+static int
+is_uc_xor_leaf_exp (BtorPtrHashTable * uc, BtorExp * exp, BtorExp * leaf)
+{
+  BtorExp *real_leaf, *e0, *e1;
+
+  real_leaf = BTOR_REAL_ADDR_EXP (leaf);
+  e0 = BTOR_REAL_ADDR_EXP (exp->e[0]);
+  e1 = BTOR_REAL_ADDR_EXP (exp->e[1]);
+  return btor_find_in_ptr_hash_table (uc, real_leaf) != NULL
+    && !real_leaf->constraint && num_parents_uc (real_leaf, 2) == 2
+    && !btor_find_in_ptr_hash_table (uc, e0) && !e0->constraint
+    && num_parents_uc (e0, 1) == 1
+    && !btor_find_in_ptr_hash_table (uc, e1) && !e1->constraint
+    && num_parents_uc (e1, 1) == 1;
+}
+
+static int
+is_odd_const_exp (BtorExp * exp)
+{
+  BtorExp *real_exp;
+  int bit;
+
+  real_exp = BTOR_REAL_ADDR_EXP (exp);
+  if (!BTOR_IS_BV_CONST_EXP (real_exp))
+    return 0;
+  bit = real_exp->bits[real_exp->len - 1] == '1';
+  return BTOR_IS_INVERTED_EXP (exp) ? !bit : bit;
+}
+
+/* Estimated number of clauses of the Tseitin encoding of the AIGs */
+static long long
+clauses_uc (BtorExp * exp)
+{
+  BtorExp *e0, *e1;
+  long long ands;
+  int i, ones;
+
+  assert (BTOR_IS_REGULAR_EXP (exp));
+
+  switch (exp->kind)
+    {
+    case BTOR_ADD_EXP:
+      ands = 7ll * exp->len;
+      break;
+    case BTOR_MUL_EXP:
+      e0 = BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (exp->e[0])) ?
+        exp->e[0] : exp->e[1];
+      ones = 0;
+      for (i = 0; i < exp->len; i++)
+        if ((BTOR_REAL_ADDR_EXP (e0)->bits[i] == '1')
+            != BTOR_IS_INVERTED_EXP (e0))
+          ones++;
+      ands = 7ll * exp->len * (ones - 1);
+      break;
+    case BTOR_BEQ_EXP:
+    case BTOR_ULT_EXP:
+      e1 = BTOR_REAL_ADDR_EXP (exp->e[1]);
+      ands = 4ll * e1->len;
+      break;
+    case BTOR_AND_EXP:
+      ands = 3ll * exp->len;
+      break;
+    default:
+      ands = 0;
+      break;
+    }
+  return 3 * ands;
+}
+
+static void
+insert_uc_model (BtorPtrHashTable * models, BtorExp * child, BtorExp * value)
+{
+  BtorExp *real_child;
+
+  real_child = BTOR_REAL_ADDR_EXP (child);
+  assert (!btor_find_in_ptr_hash_table (models, real_child));
+  btor_insert_in_ptr_hash_table (models, real_child)->data.asPtr =
+    BTOR_COND_INVERT_EXP (child, value);
+}
+
+/* Expresses the absorbed operands of 'exp' by its value 'model' */
+static void
+propagate_uc_model (Btor * btor, BtorPtrHashTable * absorbed,
+                    BtorPtrHashTable * models, BtorExp * exp,
+                    BtorExp * model)
+{
+  BtorExp *child, *other, *value, *zero, *ones, *tmp, *a, *b;
+  char *bits, *inverse;
+  int k, len;
+  BtorMemMgr *mm;
+
+  assert (BTOR_IS_REGULAR_EXP (exp));
+
+  mm = btor->mm;
+  k = btor_find_in_ptr_hash_table (absorbed,
+                                   BTOR_REAL_ADDR_EXP (exp->e[0])) ? 0 : 1;
+  switch (exp->kind)
+    {
+    case BTOR_ADD_EXP:
+      child = exp->e[k];
+      other = exp->e[1 - k];
+      insert_uc_model (models, child,
+                       btor_sub_exp (btor, model, other));
+      break;
+    case BTOR_MUL_EXP:
+      child = exp->e[k];
+      other = exp->e[1 - k];
+      bits = BTOR_IS_INVERTED_EXP (other) ?
+        btor_not_const (mm, BTOR_REAL_ADDR_EXP (other)->bits) :
+        btor_copy_const (mm, BTOR_REAL_ADDR_EXP (other)->bits);
+      inverse = btor_inverse_const (mm, bits);
+      tmp = btor_const_exp (btor, inverse);
+      insert_uc_model (models, child, btor_mul_exp (btor, model, tmp));
+      btor_release_exp (btor, tmp);
+      btor_delete_const (mm, inverse);
+      btor_delete_const (mm, bits);
+      break;
+    case BTOR_BEQ_EXP:
+      child = exp->e[k];
+      other = exp->e[1 - k];
+      insert_uc_model (models, child,
+                       btor_cond_exp (btor, model, other,
+                                      BTOR_INVERT_EXP (other)));
+      break;
+    case BTOR_ULT_EXP:
+      len = BTOR_REAL_ADDR_EXP (exp->e[0])->len;
+      zero = btor_zero_exp (btor, len);
+      ones = btor_ones_exp (btor, len);
+      insert_uc_model (models, exp->e[0],
+                       btor_cond_exp (btor, model, zero, ones));
+      insert_uc_model (models, exp->e[1],
+                       btor_cond_exp (btor, model, ones, zero));
+      btor_release_exp (btor, ones);
+      btor_release_exp (btor, zero);
+      break;
+    case BTOR_CONCAT_EXP:
+      len = BTOR_REAL_ADDR_EXP (exp->e[1])->len;
+      insert_uc_model (models, exp->e[0],
+                       btor_slice_exp (btor, model, exp->len - 1, len));
+      insert_uc_model (models, exp->e[1],
+                       btor_slice_exp (btor, model, len - 1, 0));
+      break;
+    case BTOR_SLICE_EXP:
+      child = exp->e[0];
+      len = BTOR_REAL_ADDR_EXP (child)->len;
+      value = btor_copy_exp (btor, model);
+      if (exp->lower > 0)
+        {
+          zero = btor_zero_exp (btor, exp->lower);
+          tmp = btor_concat_exp (btor, value, zero);
+          btor_release_exp (btor, zero);
+          btor_release_exp (btor, value);
+          value = tmp;
+        }
+      if (exp->upper < len - 1)
+        {
+          zero = btor_zero_exp (btor, len - 1 - exp->upper);
+          tmp = btor_concat_exp (btor, zero, value);
+          btor_release_exp (btor, zero);
+          btor_release_exp (btor, value);
+          value = tmp;
+        }
+      insert_uc_model (models, child, value);
+      break;
+    default:
+      assert (exp->kind == BTOR_AND_EXP);
+      is_xor_exp_ge (exp, &a, &b);
+      if (btor_find_in_ptr_hash_table (absorbed, BTOR_REAL_ADDR_EXP (a)))
+        {
+          child = a;
+          other = b;
+        }
+      else
+        {
+          child = b;
+          other = a;
+        }
+      insert_uc_model (models, child,
+                       btor_xor_exp (btor, model, other));
+      break;
+    }
+}
+
+static void
+eliminate_unconstrained_exps (Btor * btor)
+{
+  BtorPtrHashTable *uc, *absorbed, *models;
+  BtorExpPtrStack stack, order, maximal;
+  BtorPtrHashBucket *b;
+  BtorExp *cur, *e0, *e1, *a, *b0, *fresh, *model;
+  BtorMemMgr *mm;
+  int i, model_gen, is_uc, eliminated, arrays;
+  long long clauses;
+
+  assert (btor != NULL);
+  assert (btor->rewrite_level > 2);
+  assert (!btor->inc_enabled);
+  assert (!btor->ua.enabled);
+  assert (btor->varsubst_constraints->count == 0u);
+  assert (btor->embedded_constraints->count == 0u);
+
+  if (btor->unsynthesized_constraints->count == 0u)
+    return;
+
+  mm = btor->mm;
+  model_gen = btor->model_gen;
+  BTOR_INIT_STACK (stack);
+  BTOR_INIT_STACK (order);
+  BTOR_INIT_STACK (maximal);
+
+  /* compute topological order of all expressions in the constraints */
+  for (b = btor->unsynthesized_constraints->first; b != NULL; b = b->next)
+    BTOR_PUSH_STACK (mm, stack, BTOR_REAL_ADDR_EXP ((BtorExp *) b->key));
+  while (!BTOR_EMPTY_STACK (stack))
+    {
+      cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
+      if (cur->aux_mark == 2)
+        continue;
+      if (cur->aux_mark == 0)
+        {
+          cur->aux_mark = 1;
+          BTOR_PUSH_STACK (mm, stack, cur);
+          for (i = cur->arity - 1; i >= 0; i--)
+            BTOR_PUSH_STACK (mm, stack, cur->e[i]);
+        }
+      else if (cur->aux_mark == 1)
+        {
+          cur->aux_mark = 2;
+          BTOR_PUSH_STACK (mm, order, btor_copy_exp (btor, cur));
+        }
+    }
+  for (i = 0; i < BTOR_COUNT_STACK (order); i++)
+    order.start[i]->aux_mark = 0;
+
+  /* determine unconstrained expressions bottom-up */
+  uc = btor_new_ptr_hash_table (mm,
+                                (BtorHashPtr) btor_hash_exp_by_id,
+                                (BtorCmpPtr) btor_compare_exp_by_id);
+  absorbed = btor_new_ptr_hash_table (mm,
+                                      (BtorHashPtr) btor_hash_exp_by_id,
+                                      (BtorCmpPtr) btor_compare_exp_by_id);
+  for (i = 0; i < BTOR_COUNT_STACK (order); i++)
+    {
+      cur = order.start[i];
+      is_uc = 0;
+      e0 = cur->arity > 0 ? cur->e[0] : NULL;
+      e1 = cur->arity > 1 ? cur->e[1] : NULL;
+      switch (cur->kind)
+        {
+        case BTOR_BV_VAR_EXP:
+          is_uc = !cur->constraint;
+          break;
+        case BTOR_ARRAY_VAR_EXP:
+          is_uc = !model_gen;
+          break;
+        case BTOR_ADD_EXP:
+        case BTOR_BEQ_EXP:
+          if (is_uc_child_exp (uc, e0))
+            is_uc = 1;
+          else if (is_uc_child_exp (uc, e1))
+            {
+              is_uc = 1;
+              e0 = e1;
+            }
+          if (is_uc)
+            btor_insert_in_ptr_hash_table (absorbed, BTOR_REAL_ADDR_EXP (e0));
+          break;
+        case BTOR_MUL_EXP:
+          if (is_odd_const_exp (e1) && is_uc_child_exp (uc, e0))
+            is_uc = 1;
+          else if (is_odd_const_exp (e0) && is_uc_child_exp (uc, e1))
+            {
+              is_uc = 1;
+              e0 = e1;
+            }
+          if (is_uc)
+            btor_insert_in_ptr_hash_table (absorbed, BTOR_REAL_ADDR_EXP (e0));
+          break;
+        case BTOR_ULT_EXP:
+        case BTOR_CONCAT_EXP:
+          if (BTOR_REAL_ADDR_EXP (e0) != BTOR_REAL_ADDR_EXP (e1)
+              && is_uc_child_exp (uc, e0) && is_uc_child_exp (uc, e1))
+            {
+              is_uc = 1;
+              btor_insert_in_ptr_hash_table (absorbed,
+                                             BTOR_REAL_ADDR_EXP (e0));
+              btor_insert_in_ptr_hash_table (absorbed,
+                                             BTOR_REAL_ADDR_EXP (e1));
+            }
+          break;
+        case BTOR_SLICE_EXP:
+          if (is_uc_child_exp (uc, e0))
+            {
+              is_uc = 1;
+              btor_insert_in_ptr_hash_table (absorbed,
+                                             BTOR_REAL_ADDR_EXP (e0));
+            }
+          break;
+        case BTOR_AND_EXP:
+          if (!is_xor_exp_ge (cur, &a, &b0)
+              || BTOR_REAL_ADDR_EXP (a) == BTOR_REAL_ADDR_EXP (b0))
+            break;
+          if (is_uc_xor_leaf_exp (uc, cur, a))
+            is_uc = 1;
+          else if (is_uc_xor_leaf_exp (uc, cur, b0))
+            {
+              is_uc = 1;
+              a = b0;
+            }
+          if (is_uc)
+            {
+              btor_insert_in_ptr_hash_table (absorbed,
+                                             BTOR_REAL_ADDR_EXP (e0));
+              btor_insert_in_ptr_hash_table (absorbed,
+                                             BTOR_REAL_ADDR_EXP (e1));
+              btor_insert_in_ptr_hash_table (absorbed,
+                                             BTOR_REAL_ADDR_EXP (a));
+            }
+          break;
+        case BTOR_READ_EXP:
+          if (!model_gen && is_uc_child_exp (uc, e0))
+            {
+              is_uc = 1;
+              btor_insert_in_ptr_hash_table (absorbed, e0);
+            }
+          break;
+        case BTOR_WRITE_EXP:
+          if (!model_gen && is_uc_child_exp (uc, e0)
+              && is_uc_child_exp (uc, cur->e[2]))
+            {
+              is_uc = 1;
+              btor_insert_in_ptr_hash_table (absorbed, e0);
+              btor_insert_in_ptr_hash_table (absorbed,
+                                             BTOR_REAL_ADDR_EXP (cur->e[2]));
+            }
+          break;
+        default:
+          break;
+        }
+      if (is_uc)
+        btor_insert_in_ptr_hash_table (uc, cur);
+    }
+
+  /* introduce fresh variables for maximal unconstrained expressions and
+   * express the absorbed operands top-down by them */
+  models = btor_new_ptr_hash_table (mm,
+                                    (BtorHashPtr) btor_hash_exp_by_id,
+                                    (BtorCmpPtr) btor_compare_exp_by_id);
+  eliminated = arrays = 0;
+  clauses = 0;
+  for (i = BTOR_COUNT_STACK (order) - 1; i >= 0; i--)
+    {
+      cur = order.start[i];
+      if (!btor_find_in_ptr_hash_table (uc, cur) ||
+          BTOR_IS_BV_VAR_EXP (cur) || BTOR_IS_ARRAY_VAR_EXP (cur))
+        continue;
+
+      if (BTOR_IS_ARRAY_EXP (cur))
+        arrays++;
+      else
+        eliminated++;
+      clauses += clauses_uc (cur);
+
+      if (!btor_find_in_ptr_hash_table (absorbed, cur))
+        {
+          if (BTOR_IS_ARRAY_EXP (cur))
+            fresh = lambda_array_exp (btor, cur->len, cur->index_len);
+          else
+            fresh = lambda_var_exp (btor, cur->len);
+          BTOR_PUSH_STACK (mm, maximal, cur);
+          btor_insert_in_ptr_hash_table (models, cur)->data.asPtr = fresh;
+        }
+
+      if (model_gen)
+        {
+          b = btor_find_in_ptr_hash_table (models, cur);
+          assert (b != NULL);
+          propagate_uc_model (btor, absorbed, models, cur,
+                              (BtorExp *) b->data.asPtr);
+        }
+    }
+
+  /* eliminated variables are substituted by their models */
+  for (b = models->first; b != NULL; b = b->next)
+    {
+      cur = (BtorExp *) b->key;
+      if (!BTOR_IS_BV_VAR_EXP (cur))
+        continue;
+      assert (model_gen);
+      model = btor_pointer_chase_simplified_exp (btor,
+                                                 (BtorExp *) b->data.asPtr);
+      set_simplified_exp (btor, cur, model, 1);
+      if (!btor_find_in_ptr_hash_table (btor->var_rhs, cur))
+        {
+          btor_insert_in_ptr_hash_table (btor->var_rhs, cur);
+          inc_exp_ref_counter (btor, cur);
+        }
+    }
+
+  for (i = 0; i < BTOR_COUNT_STACK (maximal); i++)
+    {
+      cur = maximal.start[i];
+      b = btor_find_in_ptr_hash_table (models, cur);
+      assert (b != NULL);
+      set_simplified_exp (btor, cur, (BtorExp *) b->data.asPtr, 1);
+    }
+
+  rebuild_parents_of_proxies (btor, order.start, BTOR_COUNT_STACK (order));
+
+  btor->stats.bv_uc_props += eliminated;
+  btor->stats.array_uc_props += arrays;
+  btor->stats.uc_clauses += clauses;
+  if (btor->verbosity > 1 && (eliminated > 0 || arrays > 0))
+    btor_msg_exp ("unconstrained: %d expressions, %d arrays eliminated, "
+                  "%lld clauses saved (estimated)", eliminated, arrays,
+                  clauses);
+
+  /* cleanup */
+  for (b = models->first; b != NULL; b = b->next)
+    btor_release_exp (btor, (BtorExp *) b->data.asPtr);
+  btor_delete_ptr_hash_table (models);
+  btor_delete_ptr_hash_table (absorbed);
+  btor_delete_ptr_hash_table (uc);
+  for (i = 0; i < BTOR_COUNT_STACK (order); i++)
+    btor_release_exp (btor, order.start[i]);
+  BTOR_RELEASE_STACK (mm, maximal);
+  BTOR_RELEASE_STACK (mm, order);
+  BTOR_RELEASE_STACK (mm, stack);
+}
+
+
+static void
+eliminate_slices_on_bv_vars (Btor * btor)
+{
+  BtorExpPtrStack vars;
+  BtorFullParentIterator it;
+  BtorPtrHashBucket *b_var, *b1, *b2;
+  BtorExp *var, *cur, *result, *lambda_var, *temp;
+  Slice *s1, *s2, *new_s1, *new_s2, *new_s3, **sorted_slices;
+  BtorPtrHashTable *slices;
+  BtorMemMgr *mm;
+  int i, min, max;
+  int vals[4];
+
+  assert (btor != NULL);
+
+  mm = btor->mm;
+  BTOR_INIT_STACK (vars);
+  for (b_var = btor->bv_vars->first; b_var != NULL; b_var = b_var->next)
+    {
+      var = (BtorExp *) b_var->key;
+      BTOR_PUSH_STACK (mm, vars, var);
+    }
+
+  while (!BTOR_EMPTY_STACK (vars))
+    {
+      slices = btor_new_ptr_hash_table (mm, (BtorHashPtr) hash_slice, 
+				            (BtorCmpPtr) compare_slices);
+      var = BTOR_POP_STACK (vars);
       assert (BTOR_IS_REGULAR_EXP (var));
       assert (BTOR_IS_BV_VAR_EXP (var));
       init_full_parent_iterator (&it, var);
       /* find all slices on variable */
       while (has_next_parent_full_parent_iterator (&it))
         {
-	  cur = next_parent_full_parent_iterator (&it);
-	  assert (BTOR_IS_REGULAR_EXP (cur));
-	  if (cur->kind == BTOR_SLICE_EXP)
+	  cur = next_parent_full_parent_iterator (&it);
+	  assert (BTOR_IS_REGULAR_EXP (cur));
+	  if (cur->kind == BTOR_SLICE_EXP)
+	    {
+	      s1 = new_slice (btor, cur->upper, cur->lower);
+	      assert (!btor_find_in_ptr_hash_table (slices, s1));
+	      btor_insert_in_ptr_hash_table (slices, s1);
+	    }
+	}
+
+      /* no splitting necessary? */
+      if (slices->count == 0u)
+        {
+	  btor_delete_ptr_hash_table (slices);
+	  continue;
+	}
+
+      /* add full slice */
+      s1 = new_slice (btor, var->len - 1, 0);
+      assert (!btor_find_in_ptr_hash_table (slices, s1));
+      btor_insert_in_ptr_hash_table (slices, s1);
+
+
+BTOR_SPLIT_SLICES_RESTART:
+      for (b1 = slices->last; b1 != NULL; b1 = b1->prev)
+	{
+	  s1 = (Slice *) b1->key;
+	  for (b2 = b1->prev; b2 != NULL; b2 = b2->prev)
+	    {
+	      s2 = (Slice *) b2->key;
+
+	      assert (compare_slices (s1, s2));
+
+	      /* not overlapping? */
+	      if ((s1->lower > s2->upper) || (s1->upper < s2->lower) ||
+		  (s2->lower > s1->upper) || (s2->upper < s1->lower))
+		  continue;
+
+	      if (s1->upper == s2->upper)
+		{
+		  assert (s1->lower != s2->lower);
+		  max = BTOR_MAX_UTIL (s1->lower, s2->lower);
+		  min = BTOR_MIN_UTIL (s1->lower, s2->lower);
+		  new_s1 = new_slice (btor, max - 1, min);
+		  if (!btor_find_in_ptr_hash_table (slices, new_s1))
+		    btor_insert_in_ptr_hash_table (slices, new_s1);
+		  else
+		    delete_slice (btor, new_s1);
+
+		  if (min == s1->lower)
+		    {
+		      btor_remove_from_ptr_hash_table (slices, s1, NULL, NULL);
+		      delete_slice (btor, s1);
+		    }
+		  else
+		    {
+		      btor_remove_from_ptr_hash_table (slices, s2, NULL, NULL);
+		      delete_slice (btor, s2);
+		    }
+		  goto BTOR_SPLIT_SLICES_RESTART;
+		}
+
+	      if (s1->lower == s2->lower)
+		{
+		  assert (s1->upper != s2->upper);
+		  max = BTOR_MAX_UTIL (s1->upper, s2->upper);
+		  min = BTOR_MIN_UTIL (s1->upper, s2->upper);
+		  new_s1 = new_slice (btor, max, min + 1);
+		  if (!btor_find_in_ptr_hash_table (slices, new_s1))
+		    btor_insert_in_ptr_hash_table (slices, new_s1);
+		  else
+		    delete_slice (btor, new_s1);
+		  if (max == s1->upper)
+		    {
+		      btor_remove_from_ptr_hash_table (slices, s1, NULL, NULL);
+		      delete_slice (btor, s1);
+		    }
+		  else
+		    {
+		      btor_remove_from_ptr_hash_table (slices, s2, NULL, NULL);
+		      delete_slice (btor, s2);
+		    }
+		  goto BTOR_SPLIT_SLICES_RESTART;
+		}
+
+	      /* regular overlapping case (overlapping at both ends) */
+	      vals[0] = s1->upper;
+	      vals[1] = s1->lower;
+	      vals[2] = s2->upper;
+	      vals[3] = s2->lower;
+	      qsort (vals, 4, sizeof(int), compare_int_ptr);
+	      new_s1 = new_slice (btor, vals[3], vals[2] + 1);
+	      new_s2 = new_slice (btor, vals[2], vals[1]);
+	      new_s3 = new_slice (btor, vals[1] - 1, vals[0]);
+	      btor_remove_from_ptr_hash_table (slices, s1, NULL, NULL);
+	      btor_remove_from_ptr_hash_table (slices, s2, NULL, NULL);
+	      delete_slice (btor, s1);
+	      delete_slice (btor, s2);
+	      if (!btor_find_in_ptr_hash_table (slices, new_s1))
+		btor_insert_in_ptr_hash_table (slices, new_s1);
+	      else
+		delete_slice (btor, new_s1);
+	      if (!btor_find_in_ptr_hash_table (slices, new_s2))
+		btor_insert_in_ptr_hash_table (slices, new_s2);
+	      else
+		delete_slice (btor, new_s2);
+	      if (!btor_find_in_ptr_hash_table (slices, new_s3))
+		btor_insert_in_ptr_hash_table (slices, new_s3);
+	      else
+		delete_slice (btor, new_s3);
+	      goto BTOR_SPLIT_SLICES_RESTART;
+	    }
+	}
+
+      /* copy slices to sort them */
+      assert (slices->count > 1u);
+      BTOR_NEWN (mm, sorted_slices, slices->count);
+      i = 0;
+      for (b1 = slices->first; b1 != NULL; b1 = b1->next)
+        {
+	  s1 = (Slice *) b1->key;
+	  sorted_slices[i++] = s1;
+	}
+      qsort (sorted_slices, slices->count, 
+	     sizeof(Slice *), compare_slices_qsort);
+
+      s1 = sorted_slices[(int) slices->count - 1];
+      /* printf ("[%d:%d]\n", s1->upper, s1->lower); */
+      result = lambda_var_exp (btor, s1->upper - s1->lower + 1); 
+      delete_slice (btor, s1);
+      for (i = (int) slices->count - 2; i >= 0; i--)
+        {
+	  s1 = sorted_slices[i];
+	  lambda_var = lambda_var_exp (btor, s1->upper - s1->lower + 1);
+	  temp = btor_concat_exp (btor, result, lambda_var);
+	  btor_release_exp (btor, result);
+	  result = temp; 
+	  btor_release_exp (btor, lambda_var);
+	  /* printf ("[%d:%d]\n", s1->upper, s1->lower); */
+	  delete_slice (btor, s1);
+	}
+      BTOR_DELETEN (mm, sorted_slices, slices->count);
+      btor_delete_ptr_hash_table (slices);
+      /* printf ("\n"); */
+
+      insert_varsubst_constraint (btor, var, result);
+      btor_release_exp (btor, result);
+    }
+
+  BTOR_RELEASE_STACK (mm, vars);
+}
+
+static int 
+restrict_domain_of_eq_class (Btor * btor, BtorPtrHashTable *eq)
+{
+  BtorPtrHashBucket *b;
+  BtorExp *cur, *lambda_var;
+  int min_len;
+
+  assert (btor != NULL);
+  assert (eq != NULL);
+  assert (btor->rewrite_level > 2);
+  assert (!btor->inc_enabled);
+  assert (!btor->model_gen);
+
+  if (eq->count <= 1u)
+    return 0;
+
+  min_len = btor_log_2_util (btor_next_power_of_2_util ((int) eq->count));
+  cur = BTOR_REAL_ADDR_EXP ((BtorExp *) eq->first->key);
+  if (min_len >= cur->len)
+    return 0;
+
+  /* perform uniform domain abstraction */
+  for (b = eq->first; b != NULL; b = b->next)
+    {
+      cur = (BtorExp *) b->key;
+      assert (BTOR_REAL_ADDR_EXP (cur)->len > 1);
+      if (!btor_find_in_ptr_hash_table (btor->varsubst_constraints, 
+	                                BTOR_REAL_ADDR_EXP (cur)))
+        {
+          lambda_var = lambda_var_exp (btor, min_len);
+          insert_varsubst_constraint (btor, BTOR_REAL_ADDR_EXP (cur), 
+	                              lambda_var);
+          btor_release_exp (btor, lambda_var);
+	  btor->stats.domain_abst++;
+	}
+    }
+  return 1;
+}
+
+static void 
+abstract_domain_bv_variables (Btor * btor)
+{
+  BtorFullParentIterator it;
+  BtorMemMgr *mm;
+  BtorExpPtrStack stack, vars;
+  BtorPtrHashBucket *b;
+  BtorPtrHashTable *eq, *marked;
+  BtorExp *cur, *cur_parent, *next;
+  int i;
+
+  assert (btor != NULL);
+  assert (btor->rewrite_level > 2);
+  assert (!btor->inc_enabled);
+  assert (!btor->model_gen);
+  assert (btor->assumptions->count == 0u);
+  assert (btor->varsubst_constraints->count == 0u);
+  assert (btor->embedded_constraints->count == 0u);
+  assert (btor->synthesized_constraints->count == 0u);
+
+  mm = btor->mm;
+  BTOR_INIT_STACK (vars);
+  BTOR_INIT_STACK (stack);
+
+  for (b = btor->bv_vars->first; b != NULL; b = b->next)
+    {
+      cur = (BtorExp *) b->key;
+      assert (BTOR_IS_REGULAR_EXP (cur));
+      assert (BTOR_IS_BV_VAR_EXP (cur));
+      BTOR_PUSH_STACK (mm, vars, cur);
+    }
+
+  marked = btor_new_ptr_hash_table (mm, (BtorHashPtr) btor_hash_exp_by_id,
+                                        (BtorCmpPtr) btor_compare_exp_by_id);
+
+  for (i = 0; i < BTOR_COUNT_STACK (vars); i++)
+    {
+      cur = vars.start[i];
+
+      /* boolean variables cannot be abstracted further */
+      if (cur->len == 1)
+	continue;
+
+      if (btor_find_in_ptr_hash_table (marked, cur))
+	continue;
+
+      assert (BTOR_EMPTY_STACK (stack));
+      eq = btor_new_ptr_hash_table (mm, (BtorHashPtr) btor_hash_exp_by_id,
+                                        (BtorCmpPtr) btor_compare_exp_by_id);
+      btor_insert_in_ptr_hash_table (eq, cur);
+      goto BTOR_ABSTRACT_DOMAIN_BV_VARS_ENTER_WITHOUT_POP;
+
+      while (!BTOR_EMPTY_STACK (stack))
+        {
+	  cur = BTOR_POP_STACK (stack);
+	  assert (BTOR_IS_BV_VAR_EXP (BTOR_REAL_ADDR_EXP (cur)));
+
+	  if (btor_find_in_ptr_hash_table (marked, cur))
+	    goto BTOR_ABSTRACT_DOMAIN_BV_VARS_CLEANUP;
+
+BTOR_ABSTRACT_DOMAIN_BV_VARS_ENTER_WITHOUT_POP:
+	  assert (btor_find_in_ptr_hash_table (eq, cur));
+	  init_full_parent_iterator (&it, cur);
+	  while (has_next_parent_full_parent_iterator (&it))
 	    {
-	      s1 = new_slice (btor, cur->upper, cur->lower);
-	      assert (!btor_find_in_ptr_hash_table (slices, s1));
-	      btor_insert_in_ptr_hash_table (slices, s1);
+	      cur_parent = next_parent_full_parent_iterator (&it);
+	      assert (BTOR_IS_REGULAR_EXP (cur_parent));
+	      if (BTOR_IS_BV_EQ_EXP (cur_parent))
+	        {
+		  /* we assume that rewriting rules have already simplified
+		   * x = x, and x = ~x
+		   */
+		  if (BTOR_REAL_ADDR_EXP (cur_parent->e[0]) == 
+		      BTOR_REAL_ADDR_EXP (cur))
+		    {
+		      next = cur_parent->e[1];
+		    }
+		  else
+		    {
+		      assert (BTOR_REAL_ADDR_EXP (cur_parent->e[1]) == 
+			      BTOR_REAL_ADDR_EXP (cur));
+		      next = cur_parent->e[0];
+		    }
+
+		  if (BTOR_IS_BV_VAR_EXP (BTOR_REAL_ADDR_EXP (next)))
+		    {
+		      if (!btor_find_in_ptr_hash_table (eq, next))
+		        { 
+		          btor_insert_in_ptr_hash_table (eq, next);
+		          BTOR_PUSH_STACK (mm, stack, next);
+			}
+		    }
+		  else
+		    goto BTOR_ABSTRACT_DOMAIN_BV_VARS_CLEANUP;
+		}
+	      else
+		goto BTOR_ABSTRACT_DOMAIN_BV_VARS_CLEANUP;
 	    }
 	}
 
-      /* no splitting necessary? */
-      if (slices->count == 0u)
-        {
-	  btor_delete_ptr_hash_table (slices);
-	  continue;
+      restrict_domain_of_eq_class (btor, eq);
+
+BTOR_ABSTRACT_DOMAIN_BV_VARS_CLEANUP:
+      BTOR_RESET_STACK (stack);
+
+      for (b = eq->first; b != NULL; b = b->next)
+	{
+	  cur = (BtorExp *) b->key;
+	  if (!btor_find_in_ptr_hash_table (marked, cur))
+	    btor_insert_in_ptr_hash_table (marked, cur);
 	}
+      btor_delete_ptr_hash_table (eq);
+    }
 
-      /* add full slice */
-      s1 = new_slice (btor, var->len - 1, 0);
-      assert (!btor_find_in_ptr_hash_table (slices, s1));
-      btor_insert_in_ptr_hash_table (slices, s1);
+  /* cleanup */
+  btor_delete_ptr_hash_table (marked);
+  BTOR_RELEASE_STACK (mm, vars);
+  BTOR_RELEASE_STACK (mm, stack);
+}
+
+
+/* Equality saturation of arithmetic (ES).  Bit-vector expressions of the
+ * constraints are copied into an e-graph, in which equivalence classes
+ * of expressions are represented by union-find.  Rewrite rules for
+ * add, mul, shift by constants, and, and not are applied without
+ * destroying the original expressions until the e-graph is saturated or
+ * the node or time budget is exhausted.  Then the cheapest expression of
+ * every class with respect to the estimated AIG size is extracted and
+ * replaces the original expression if it is cheaper.  All other
+ * expressions are leafs of the e-graph.
+ */
+
+#define BTOR_ES_NODE_LIMIT 50000
+#define BTOR_ES_ITERATION_LIMIT 8
+#define BTOR_ES_TIME_LIMIT 1.0
+
+/* Rules which add new expressions are banned for a while after they
+ * matched more often than their limit in one iteration, and their limit
+ * is doubled.  Thus they can not exhaust the node budget on their own.
+ */
+#define BTOR_ES_MATCH_LIMIT 500
+#define BTOR_ES_BAN_LENGTH 2
+
+enum BtorESRule
+{
+  BTOR_ES_ASSOC_RULE = 0,
+  BTOR_ES_DISTRIB_RULE = 1,
+  BTOR_ES_FACTOR_RULE = 2,
+  BTOR_ES_NOT_RULE = 3,
+  BTOR_ES_NUM_RULES = 4
+};
+
+typedef enum BtorESRule BtorESRule;
+
+enum BtorESOp
+{
+  BTOR_ES_CONST = 0,
+  BTOR_ES_LEAF = 1,
+  BTOR_ES_NOT = 2,
+  BTOR_ES_AND = 3,
+  BTOR_ES_ADD = 4,
+  BTOR_ES_MUL = 5,
+  BTOR_ES_SLL = 6
+};
+
+typedef enum BtorESOp BtorESOp;
+
+typedef struct BtorESNode BtorESNode;
+
+struct BtorESNode
+{
+  BtorESOp op;
+  int len;
+  int e[2];                     /* children classes */
+  int shift;                    /* shift width of SLL */
+  int cls;                      /* class, not necessarily representative */
+  char *bits;                   /* value of CONST */
+  BtorExp *exp;                 /* regular expression of LEAF */
+  BtorESNode *next;             /* next node in the same class */
+};
+
+BTOR_DECLARE_STACK (ESNodePtr, BtorESNode *);
+
+typedef struct BtorESGraph BtorESGraph;
+
+struct BtorESGraph
+{
+  Btor *btor;
+  BtorMemMgr *mm;
+  BtorESNodePtrStack nodes;
+  BtorPtrHashTable *memo;       /* hash consing of nodes */
+  BtorIntStack merges;          /* pairs of classes to be merged */
+  int merged;                   /* number of merged classes */
+  int size;                     /* maximum number of nodes and classes */
+  int classes;
+  int *uf;
+  BtorESNode **first;           /* members of classes */
+  BtorESNode **last;
+  char **val;                   /* constant value of classes */
+  double *cost;                 /* extraction, negative if unknown */
+  BtorESNode **best;
+  BtorExp **built;
+  struct
+  {
+    int matches;
+    int limit;
+    int banned;                 /* remaining iterations */
+    int bans;
+  } rules[BTOR_ES_NUM_RULES];
+};
+
+static int
+is_commutative_es_op (BtorESOp op)
+{
+  return op == BTOR_ES_AND || op == BTOR_ES_ADD || op == BTOR_ES_MUL;
+}
+
+static unsigned
+hash_es_node (BtorESNode * n)
+{
+  unsigned h;
+  h = (unsigned) n->op;
+  h = h * 7333u + (unsigned) n->len;
+  h = h * 7333u + (unsigned) n->e[0];
+  h = h * 7333u + (unsigned) n->e[1];
+  h = h * 7333u + (unsigned) n->shift;
+  if (n->bits != NULL)
+    h = h * 7333u + btor_hashstr (n->bits);
+  if (n->exp != NULL)
+    h = h * 7333u + (unsigned) n->exp->id;
+  return h;
+}
+
+static int
+compare_es_nodes (BtorESNode * n0, BtorESNode * n1)
+{
+  if (n0->op != n1->op || n0->len != n1->len || n0->e[0] != n1->e[0] ||
+      n0->e[1] != n1->e[1] || n0->shift != n1->shift || n0->exp != n1->exp)
+    return 1;
+  if (n0->bits != NULL && n1->bits != NULL)
+    return strcmp (n0->bits, n1->bits);
+  return n0->bits != n1->bits;
+}
+
+static int
+find_es_class (BtorESGraph * eg, int c)
+{
+  assert (c >= 0);
+  assert (c < eg->classes);
+  while (eg->uf[c] != c)
+    {
+      eg->uf[c] = eg->uf[eg->uf[c]];
+      c = eg->uf[c];
+    }
+  return c;
+}
+
+static void
+canonicalize_es_node (BtorESGraph * eg, BtorESNode * n)
+{
+  int tmp;
+  if (n->op == BTOR_ES_CONST || n->op == BTOR_ES_LEAF)
+    return;
+  n->e[0] = find_es_class (eg, n->e[0]);
+  if (n->op == BTOR_ES_NOT || n->op == BTOR_ES_SLL)
+    return;
+  n->e[1] = find_es_class (eg, n->e[1]);
+  if (is_commutative_es_op (n->op) && n->e[0] > n->e[1])
+    {
+      tmp = n->e[0];
+      n->e[0] = n->e[1];
+      n->e[1] = tmp;
+    }
+}
+
+static char *
+shift_width_es_node (BtorESGraph * eg, BtorESNode * n)
+{
+  assert (n->op == BTOR_ES_SLL);
+  return btor_unsigned_to_const (eg->mm, (unsigned) n->shift,
+                                 btor_log_2_util (n->len));
+}
+
+/* Computes constant value of node if the values of its children are
+ * known, otherwise the result is NULL.
+ */
+static char *
+fold_es_node (BtorESGraph * eg, BtorESNode * n)
+{
+  char *v0, *v1, *shift, *result;
+
+  if (n->op == BTOR_ES_CONST)
+    return btor_copy_const (eg->mm, n->bits);
+  if (n->op == BTOR_ES_LEAF)
+    return NULL;
+
+  v0 = eg->val[find_es_class (eg, n->e[0])];
+  if (v0 == NULL)
+    return NULL;
+  if (n->op == BTOR_ES_NOT)
+    return btor_not_const (eg->mm, v0);
+  if (n->op == BTOR_ES_SLL)
+    {
+      shift = shift_width_es_node (eg, n);
+      result = btor_sll_const (eg->mm, v0, shift);
+      btor_delete_const (eg->mm, shift);
+      return result;
+    }
+
+  v1 = eg->val[find_es_class (eg, n->e[1])];
+  if (v1 == NULL)
+    return NULL;
+  if (n->op == BTOR_ES_AND)
+    return btor_and_const (eg->mm, v0, v1);
+  if (n->op == BTOR_ES_ADD)
+    return btor_add_const (eg->mm, v0, v1);
+  assert (n->op == BTOR_ES_MUL);
+  return btor_mul_const (eg->mm, v0, v1);
+}
+
+static void
+merge_es_classes (BtorESGraph * eg, int c0, BtorESNode * n)
+{
+  if (n == NULL)
+    return;
+  BTOR_PUSH_STACK (eg->mm, eg->merges, c0);
+  BTOR_PUSH_STACK (eg->mm, eg->merges, n->cls);
+}
+
+/* Finds or adds node.  Returns NULL if the node budget is exhausted. */
+static BtorESNode *
+es_node (BtorESGraph * eg, BtorESOp op, int len, int e0, int e1, int shift,
+         const char *bits, BtorExp * exp)
+{
+  BtorPtrHashBucket *b;
+  BtorESNode tmp, *result;
+  int c;
+
+  tmp.op = op;
+  tmp.len = len;
+  tmp.e[0] = e0;
+  tmp.e[1] = e1;
+  tmp.shift = shift;
+  tmp.bits = (char *) bits;
+  tmp.exp = exp;
+  canonicalize_es_node (eg, &tmp);
+
+  b = btor_find_in_ptr_hash_table (eg->memo, &tmp);
+  if (b != NULL)
+    return (BtorESNode *) b->key;
+
+  if (BTOR_COUNT_STACK (eg->nodes) >= eg->size)
+    return NULL;
+
+  BTOR_NEW (eg->mm, result);
+  *result = tmp;
+  if (bits != NULL)
+    result->bits = btor_copy_const (eg->mm, bits);
+  result->next = NULL;
+  BTOR_PUSH_STACK (eg->mm, eg->nodes, result);
+  btor_insert_in_ptr_hash_table (eg->memo, result);
+
+  c = eg->classes++;
+  eg->uf[c] = c;
+  eg->first[c] = eg->last[c] = result;
+  eg->val[c] = fold_es_node (eg, result);
+  result->cls = c;
+
+  /* classes with known value contain a constant */
+  if (op != BTOR_ES_CONST && eg->val[c] != NULL)
+    merge_es_classes (eg, c, es_node (eg, BTOR_ES_CONST, len, 0, 0, 0,
+                                      eg->val[c], NULL));
+  return result;
+}
+
+static BtorESNode *
+es_binary_node (BtorESGraph * eg, BtorESOp op, int e0, BtorESNode * n1)
+{
+  if (n1 == NULL)
+    return NULL;
+  return es_node (eg, op, n1->len, e0, find_es_class (eg, n1->cls), 0,
+                  NULL, NULL);
+}
+
+static BtorESNode *
+es_int_node (BtorESGraph * eg, int len, int x)
+{
+  BtorESNode *result;
+  char *bits;
+  bits = btor_int_to_const (eg->mm, x, len);
+  result = es_node (eg, BTOR_ES_CONST, len, 0, 0, 0, bits, NULL);
+  btor_delete_const (eg->mm, bits);
+  return result;
+}
+
+static BtorESNode *
+es_power_of_2_node (BtorESGraph * eg, int len, int k)
+{
+  BtorESNode *result;
+  char *bits;
+  assert (k >= 0);
+  assert (k < len);
+  bits = btor_zero_const (eg->mm, len);
+  bits[len - 1 - k] = '1';
+  result = es_node (eg, BTOR_ES_CONST, len, 0, 0, 0, bits, NULL);
+  btor_delete_const (eg->mm, bits);
+  return result;
+}
+
+/* Returns 'k' if 'bits' is 2^k and -1 otherwise. */
+static int
+log_2_es_const (const char *bits)
+{
+  int i, len, result;
+  len = (int) strlen (bits);
+  result = -1;
+  for (i = 0; i < len; i++)
+    if (bits[i] == '1')
+      {
+        if (result >= 0)
+          return -1;
+        result = len - 1 - i;
+      }
+  return result;
+}
+
+static int
+use_es_rule (BtorESGraph * eg, BtorESRule rule)
+{
+  if (eg->rules[rule].banned > 0)
+    return 0;
+  if (eg->rules[rule].matches++ < eg->rules[rule].limit)
+    return 1;
+  eg->rules[rule].banned = BTOR_ES_BAN_LENGTH << eg->rules[rule].bans++;
+  eg->rules[rule].limit *= 2;
+  return 0;
+}
+
+/* Merges pending classes and restores congruence and constant values. */
+static void
+rebuild_es_graph (BtorESGraph * eg)
+{
+  BtorPtrHashBucket *b;
+  BtorESNode *n, *m;
+  int i, c0, c1, tmp;
+  char *v;
+
+  while (!BTOR_EMPTY_STACK (eg->merges))
+    {
+      while (!BTOR_EMPTY_STACK (eg->merges))
+        {
+          c1 = find_es_class (eg, BTOR_POP_STACK (eg->merges));
+          c0 = find_es_class (eg, BTOR_POP_STACK (eg->merges));
+          if (c0 == c1)
+            continue;
+          if (c1 < c0)
+            {
+              tmp = c0;
+              c0 = c1;
+              c1 = tmp;
+            }
+          eg->uf[c1] = c0;
+          eg->last[c0]->next = eg->first[c1];
+          eg->last[c0] = eg->last[c1];
+          if (eg->val[c0] == NULL)
+            eg->val[c0] = eg->val[c1];
+          else if (eg->val[c1] != NULL)
+            {
+              assert (!strcmp (eg->val[c0], eg->val[c1]));
+              btor_delete_const (eg->mm, eg->val[c1]);
+            }
+          eg->val[c1] = NULL;
+          eg->merged++;
+        }
+
+      /* children may have been merged, thus we hash cons again */
+      btor_delete_ptr_hash_table (eg->memo);
+      eg->memo = btor_new_ptr_hash_table (eg->mm,
+                                          (BtorHashPtr) hash_es_node,
+                                          (BtorCmpPtr) compare_es_nodes);
+      for (i = 0; i < BTOR_COUNT_STACK (eg->nodes); i++)
+        {
+          n = eg->nodes.start[i];
+          canonicalize_es_node (eg, n);
+          b = btor_find_in_ptr_hash_table (eg->memo, n);
+          if (b == NULL)
+            btor_insert_in_ptr_hash_table (eg->memo, n);
+          else
+            {
+              m = (BtorESNode *) b->key;
+              if (find_es_class (eg, m->cls) != find_es_class (eg, n->cls))
+                merge_es_classes (eg, m->cls, n);
+            }
+          c0 = find_es_class (eg, n->cls);
+          if (eg->val[c0] != NULL || (v = fold_es_node (eg, n)) == NULL)
+            continue;
+          eg->val[c0] = v;
+          if (n->op != BTOR_ES_CONST)
+            merge_es_classes (eg, c0, es_node (eg, BTOR_ES_CONST, n->len,
+                                               0, 0, 0, v, NULL));
+        }
+    }
+}
+
+/* Applies all rules to all nodes once.  New nodes are added to new
+ * classes and all merges are delayed, thus members of classes do not
+ * change while matching.
+ */
+static void
+apply_es_rules (BtorESGraph * eg)
+{
+  int i, j, k, side, num, c, x, y, len;
+  BtorESNode *n, *m, *m1, *t;
+  char *vx;
+
+  for (i = 0; i < BTOR_ES_NUM_RULES; i++)
+    {
+      if (eg->rules[i].banned > 0)
+        eg->rules[i].banned--;
+      eg->rules[i].matches = 0;
+    }
+
+  num = BTOR_COUNT_STACK (eg->nodes);
+  for (i = 0; i < num && BTOR_COUNT_STACK (eg->nodes) < eg->size; i++)
+    {
+      n = eg->nodes.start[i];
+      c = find_es_class (eg, n->cls);
+      len = n->len;
+
+      switch (n->op)
+        {
+        case BTOR_ES_CONST:
+        case BTOR_ES_LEAF:
+          break;
+
+        case BTOR_ES_NOT:
+          x = find_es_class (eg, n->e[0]);
+          /* ~~x = x */
+          for (m = eg->first[x]; m != NULL; m = m->next)
+            if (m->op == BTOR_ES_NOT)
+              merge_es_classes (eg, c, eg->first[find_es_class (eg,
+                                                                m->e[0])]);
+          /* ~x = x * -1 + -1 */
+          if (len > 1 && eg->val[x] == NULL &&
+              use_es_rule (eg, BTOR_ES_NOT_RULE))
+            {
+              t = es_int_node (eg, len, -1);
+              if (t != NULL)
+                merge_es_classes (eg, c,
+                  es_binary_node (eg, BTOR_ES_ADD, find_es_class (eg, t->cls),
+                                  es_binary_node (eg, BTOR_ES_MUL, x, t)));
+            }
+          break;
+
+        case BTOR_ES_SLL:
+          /* x << k = x * 2^k */
+          merge_es_classes (eg, c,
+            es_binary_node (eg, BTOR_ES_MUL, find_es_class (eg, n->e[0]),
+                            es_power_of_2_node (eg, len, n->shift)));
+          break;
+
+        default:
+          assert (is_commutative_es_op (n->op));
+          if (find_es_class (eg, n->e[0]) == find_es_class (eg, n->e[1]))
+            {
+              x = find_es_class (eg, n->e[0]);
+              /* x & x = x, x + x = x * 2 */
+              if (n->op == BTOR_ES_AND)
+                merge_es_classes (eg, c, eg->first[x]);
+              else if (n->op == BTOR_ES_ADD)
+                merge_es_classes (eg, c,
+                  es_binary_node (eg, BTOR_ES_MUL, x, es_int_node (eg, len,
+                                                                   2)));
+            }
+
+          for (side = 0; side < 2; side++)
+            {
+              x = find_es_class (eg, n->e[side]);
+              y = find_es_class (eg, n->e[1 - side]);
+              vx = eg->val[x];
+
+              if (vx != NULL)
+                {
+                  if (btor_is_zero_const (vx))
+                    {
+                      /* x + 0 = x, x & 0 = 0, x * 0 = 0 */
+                      if (n->op == BTOR_ES_ADD)
+                        merge_es_classes (eg, c, eg->first[y]);
+                      else
+                        merge_es_classes (eg, c, eg->first[x]);
+                    }
+                  else if (n->op == BTOR_ES_AND && btor_is_ones_const (vx))
+                    merge_es_classes (eg, c, eg->first[y]);
+                  else if (n->op == BTOR_ES_MUL)
+                    {
+                      /* x * 2^k = x << k */
+                      k = log_2_es_const (vx);
+                      if (k == 0)
+                        merge_es_classes (eg, c, eg->first[y]);
+                      else if (k > 0 && len > 1 &&
+                               btor_is_power_of_2_util (len))
+                        merge_es_classes (eg, c,
+                          es_node (eg, BTOR_ES_SLL, len, y, 0, k, NULL,
+                                   NULL));
+                      /* c * (a + b) = c * a + c * b */
+                      for (m = eg->first[y]; m != NULL; m = m->next)
+                        if (m->op == BTOR_ES_ADD &&
+                            use_es_rule (eg, BTOR_ES_DISTRIB_RULE))
+                          {
+                            t = es_node (eg, BTOR_ES_MUL, len, x, m->e[0], 0,
+                                         NULL, NULL);
+                            if (t == NULL)
+                              break;
+                            merge_es_classes (eg, c,
+                              es_binary_node (eg, BTOR_ES_ADD,
+                                find_es_class (eg, t->cls),
+                                es_node (eg, BTOR_ES_MUL, len, x, m->e[1],
+                                         0, NULL, NULL)));
+                          }
+                    }
+                }
+
+              /* x & ~x = 0, x + ~x = -1 */
+              if (n->op != BTOR_ES_MUL)
+                for (m = eg->first[y]; m != NULL; m = m->next)
+                  if (m->op == BTOR_ES_NOT &&
+                      find_es_class (eg, m->e[0]) == x)
+                    {
+                      merge_es_classes (eg, c, es_int_node (eg, len,
+                        n->op == BTOR_ES_AND ? 0 : -1));
+                      break;
+                    }
+
+              /* (a o b) o y = a o (b o y) = b o (a o y) */
+              for (m = eg->first[x]; m != NULL; m = m->next)
+                if (m->op == n->op && use_es_rule (eg, BTOR_ES_ASSOC_RULE))
+                  for (j = 0; j < 2; j++)
+                    merge_es_classes (eg, c,
+                      es_binary_node (eg, n->op, m->e[j],
+                                      es_node (eg, n->op, len, m->e[1 - j],
+                                               y, 0, NULL, NULL)));
+
+              if (n->op != BTOR_ES_ADD)
+                continue;
+
+              /* x + x * a = x * (a + 1) */
+              for (m = eg->first[y]; m != NULL; m = m->next)
+                if (m->op == BTOR_ES_MUL)
+                  for (j = 0; j < 2; j++)
+                    if (find_es_class (eg, m->e[j]) == x &&
+                        use_es_rule (eg, BTOR_ES_FACTOR_RULE))
+                      {
+                        t = es_int_node (eg, len, 1);
+                        if (t == NULL)
+                          break;
+                        merge_es_classes (eg, c,
+                          es_binary_node (eg, BTOR_ES_MUL, x,
+                            es_node (eg, BTOR_ES_ADD, len, m->e[1 - j],
+                                     find_es_class (eg, t->cls), 0, NULL,
+                                     NULL)));
+                      }
+
+              /* x * a + x * b = x * (a + b), both sides match anyway */
+              if (side)
+                continue;
+              for (m = eg->first[x]; m != NULL; m = m->next)
+                {
+                  if (m->op != BTOR_ES_MUL)
+                    continue;
+                  for (m1 = eg->first[y]; m1 != NULL; m1 = m1->next)
+                    {
+                      if (m1->op != BTOR_ES_MUL)
+                        continue;
+                      for (j = 0; j < 4; j++)
+                        if (find_es_class (eg, m->e[j >> 1]) ==
+                            find_es_class (eg, m1->e[j & 1]) &&
+                            use_es_rule (eg, BTOR_ES_FACTOR_RULE))
+                          merge_es_classes (eg, c,
+                            es_binary_node (eg, BTOR_ES_MUL,
+                              find_es_class (eg, m->e[j >> 1]),
+                              es_node (eg, BTOR_ES_ADD, len,
+                                       m->e[1 - (j >> 1)],
+                                       m1->e[1 - (j & 1)], 0, NULL,
+                                       NULL)));
+                    }
+                }
+            }
+          break;
+        }
+    }
+}
 
+/* Estimated number of AIG nodes of the operator of the node. */
+static double
+cost_es_node (BtorESGraph * eg, BtorESNode * n)
+{
+  char *v;
+  int i, ones;
 
-BTOR_SPLIT_SLICES_RESTART:
-      for (b1 = slices->last; b1 != NULL; b1 = b1->prev)
-	{
-	  s1 = (Slice *) b1->key;
-	  for (b2 = b1->prev; b2 != NULL; b2 = b2->prev)
-	    {
-	      s2 = (Slice *) b2->key;
+  switch (n->op)
+    {
+    case BTOR_ES_CONST:
+    case BTOR_ES_LEAF:
+      return 0;
+    case BTOR_ES_NOT:
+    case BTOR_ES_SLL:
+      return 1;
+    case BTOR_ES_AND:
+      return n->len;
+    case BTOR_ES_ADD:
+      return 7.0 * n->len;
+    default:
+      assert (n->op == BTOR_ES_MUL);
+      v = eg->val[find_es_class (eg, n->e[0])];
+      if (v == NULL)
+        v = eg->val[find_es_class (eg, n->e[1])];
+      if (v == NULL)
+        return 7.0 * n->len * n->len;
+      /* one adder per bit set in the constant */
+      ones = 0;
+      for (i = 0; v[i]; i++)
+        ones += v[i] == '1';
+      return 1 + 7.0 * n->len * ones;
+    }
+}
 
-	      assert (compare_slices (s1, s2));
+/* Computes cheapest node of every class by fixed point iteration. */
+static void
+extract_es_graph (BtorESGraph * eg)
+{
+  double cost, child_cost;
+  BtorESNode *n;
+  int i, j, c, changed, arity;
 
-	      /* not overlapping? */
-	      if ((s1->lower > s2->upper) || (s1->upper < s2->lower) ||
-		  (s2->lower > s1->upper) || (s2->upper < s1->lower))
-		  continue;
+  for (i = 0; i < eg->classes; i++)
+    eg->cost[i] = -1;
 
-	      if (s1->upper == s2->upper)
-		{
-		  assert (s1->lower != s2->lower);
-		  max = BTOR_MAX_UTIL (s1->lower, s2->lower);
-		  min = BTOR_MIN_UTIL (s1->lower, s2->lower);
-		  new_s1 = new_slice (btor, max - 1, min);
-		  if (!btor_find_in_ptr_hash_table (slices, new_s1))
-		    btor_insert_in_ptr_hash_table (slices, new_s1);
-		  else
-		    delete_slice (btor, new_s1);
+  do
+    {
+      changed = 0;
+      for (i = 0; i < BTOR_COUNT_STACK (eg->nodes); i++)
+        {
+          n = eg->nodes.start[i];
+          cost = cost_es_node (eg, n);
+          if (n->op == BTOR_ES_CONST || n->op == BTOR_ES_LEAF)
+            arity = 0;
+          else if (n->op == BTOR_ES_NOT || n->op == BTOR_ES_SLL)
+            arity = 1;
+          else
+            arity = 2;
+          for (j = 0; j < arity; j++)
+            {
+              child_cost = eg->cost[find_es_class (eg, n->e[j])];
+              if (child_cost < 0)
+                break;
+              cost += child_cost;
+            }
+          if (j < arity)
+            continue;
+          c = find_es_class (eg, n->cls);
+          /* strict improvements only, thus 'best' is acyclic */
+          if (eg->cost[c] < 0 || cost < eg->cost[c])
+            {
+              eg->cost[c] = cost;
+              eg->best[c] = n;
+              changed = 1;
+            }
+        }
+    }
+  while (changed);
+}
 
-		  if (min == s1->lower)
-		    {
-		      btor_remove_from_ptr_hash_table (slices, s1, NULL, NULL);
-		      delete_slice (btor, s1);
-		    }
-		  else
-		    {
-		      btor_remove_from_ptr_hash_table (slices, s2, NULL, NULL);
-		      delete_slice (btor, s2);
-		    }
-		  goto BTOR_SPLIT_SLICES_RESTART;
-		}
+/* Builds expression of the cheapest node of a class. */
+static BtorExp *
+build_es_class (BtorESGraph * eg, int c)
+{
+  BtorExp *e0, *e1, *shift;
+  BtorIntStack stack;
+  BtorESNode *n;
+  Btor *btor;
+  int cur, c0, c1;
+  char *bits;
 
-	      if (s1->lower == s2->lower)
-		{
-		  assert (s1->upper != s2->upper);
-		  max = BTOR_MAX_UTIL (s1->upper, s2->upper);
-		  min = BTOR_MIN_UTIL (s1->upper, s2->upper);
-		  new_s1 = new_slice (btor, max, min + 1);
-		  if (!btor_find_in_ptr_hash_table (slices, new_s1))
-		    btor_insert_in_ptr_hash_table (slices, new_s1);
-		  else
-		    delete_slice (btor, new_s1);
-		  if (max == s1->upper)
-		    {
-		      btor_remove_from_ptr_hash_table (slices, s1, NULL, NULL);
-		      delete_slice (btor, s1);
-		    }
-		  else
-		    {
-		      btor_remove_from_ptr_hash_table (slices, s2, NULL, NULL);
-		      delete_slice (btor, s2);
-		    }
-		  goto BTOR_SPLIT_SLICES_RESTART;
-		}
+  btor = eg->btor;
+  BTOR_INIT_STACK (stack);
+  BTOR_PUSH_STACK (eg->mm, stack, find_es_class (eg, c));
+  while (!BTOR_EMPTY_STACK (stack))
+    {
+      cur = BTOR_POP_STACK (stack);
+      if (eg->built[cur] != NULL)
+        continue;
+      n = eg->best[cur];
+      assert (n != NULL);
+      c0 = c1 = -1;
+      if (n->op != BTOR_ES_CONST && n->op != BTOR_ES_LEAF)
+        {
+          c0 = find_es_class (eg, n->e[0]);
+          if (n->op != BTOR_ES_NOT && n->op != BTOR_ES_SLL)
+            c1 = find_es_class (eg, n->e[1]);
+          if (eg->built[c0] == NULL || (c1 >= 0 && eg->built[c1] == NULL))
+            {
+              BTOR_PUSH_STACK (eg->mm, stack, cur);
+              BTOR_PUSH_STACK (eg->mm, stack, c0);
+              if (c1 >= 0)
+                BTOR_PUSH_STACK (eg->mm, stack, c1);
+              continue;
+            }
+        }
 
-	      /* regular overlapping case (overlapping at both ends) */
-	      vals[0] = s1->upper;
-	      vals[1] = s1->lower;
-	      vals[2] = s2->upper;
-	      vals[3] = s2->lower;
-	      qsort (vals, 4, sizeof(int), compare_int_ptr);
-	      new_s1 = new_slice (btor, vals[3], vals[2] + 1);
-	      new_s2 = new_slice (btor, vals[2], vals[1]);
-	      new_s3 = new_slice (btor, vals[1] - 1, vals[0]);
-	      btor_remove_from_ptr_hash_table (slices, s1, NULL, NULL);
-	      btor_remove_from_ptr_hash_table (slices, s2, NULL, NULL);
-	      delete_slice (btor, s1);
-	      delete_slice (btor, s2);
-	      if (!btor_find_in_ptr_hash_table (slices, new_s1))
-		btor_insert_in_ptr_hash_table (slices, new_s1);
-	      else
-		delete_slice (btor, new_s1);
-	      if (!btor_find_in_ptr_hash_table (slices, new_s2))
-		btor_insert_in_ptr_hash_table (slices, new_s2);
-	      else
-		delete_slice (btor, new_s2);
-	      if (!btor_find_in_ptr_hash_table (slices, new_s3))
-		btor_insert_in_ptr_hash_table (slices, new_s3);
-	      else
-		delete_slice (btor, new_s3);
-	      goto BTOR_SPLIT_SLICES_RESTART;
-	    }
-	}
+      e0 = c0 >= 0 ? eg->built[c0] : NULL;
+      e1 = c1 >= 0 ? eg->built[c1] : NULL;
 
-      /* copy slices to sort them */
-      assert (slices->count > 1u);
-      BTOR_NEWN (mm, sorted_slices, slices->count);
-      i = 0;
-      for (b1 = slices->first; b1 != NULL; b1 = b1->next)
+      switch (n->op)
         {
-	  s1 = (Slice *) b1->key;
-	  sorted_slices[i++] = s1;
-	}
-      qsort (sorted_slices, slices->count, 
-	     sizeof(Slice *), compare_slices_qsort);
+        case BTOR_ES_CONST:
+          eg->built[cur] = btor_const_exp (btor, n->bits);
+          break;
+        case BTOR_ES_LEAF:
+          eg->built[cur] = btor_copy_exp (btor, n->exp);
+          break;
+        case BTOR_ES_NOT:
+          eg->built[cur] = btor_not_exp (btor, e0);
+          break;
+        case BTOR_ES_SLL:
+          bits = shift_width_es_node (eg, n);
+          shift = btor_const_exp (btor, bits);
+          btor_delete_const (eg->mm, bits);
+          eg->built[cur] = btor_sll_exp (btor, e0, shift);
+          btor_release_exp (btor, shift);
+          break;
+        case BTOR_ES_AND:
+          eg->built[cur] = btor_and_exp (btor, e0, e1);
+          break;
+        case BTOR_ES_ADD:
+          eg->built[cur] = btor_add_exp (btor, e0, e1);
+          break;
+        default:
+          assert (n->op == BTOR_ES_MUL);
+          eg->built[cur] = btor_mul_exp (btor, e0, e1);
+          break;
+        }
+    }
+  BTOR_RELEASE_STACK (eg->mm, stack);
+  return eg->built[find_es_class (eg, c)];
+}
 
-      s1 = sorted_slices[(int) slices->count - 1];
-      /* printf ("[%d:%d]\n", s1->upper, s1->lower); */
-      result = lambda_var_exp (btor, s1->upper - s1->lower + 1); 
-      delete_slice (btor, s1);
-      for (i = (int) slices->count - 2; i >= 0; i--)
+/* Maximum id of the expressions older than 'old_id' which are reached
+ * from 'exp' through new expressions only.
+ */
+static int
+max_old_id_exp (Btor * btor, BtorExp * exp, int old_id)
+{
+  BtorExpPtrStack stack, visited;
+  BtorExp *cur;
+  int i, result;
+
+  BTOR_INIT_STACK (stack);
+  BTOR_INIT_STACK (visited);
+  BTOR_PUSH_STACK (btor->mm, stack, exp);
+  result = 0;
+  while (!BTOR_EMPTY_STACK (stack))
+    {
+      cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
+      if (cur->id < old_id)
         {
-	  s1 = sorted_slices[i];
-	  lambda_var = lambda_var_exp (btor, s1->upper - s1->lower + 1);
-	  temp = btor_concat_exp (btor, result, lambda_var);
-	  btor_release_exp (btor, result);
-	  result = temp; 
-	  btor_release_exp (btor, lambda_var);
-	  /* printf ("[%d:%d]\n", s1->upper, s1->lower); */
-	  delete_slice (btor, s1);
-	}
-      BTOR_DELETEN (mm, sorted_slices, slices->count);
-      btor_delete_ptr_hash_table (slices);
-      /* printf ("\n"); */
+          if (cur->id > result)
+            result = cur->id;
+          continue;
+        }
+      if (cur->aux_mark)
+        continue;
+      cur->aux_mark = 1;
+      BTOR_PUSH_STACK (btor->mm, visited, cur);
+      for (i = 0; i < cur->arity; i++)
+        BTOR_PUSH_STACK (btor->mm, stack, cur->e[i]);
+    }
+  while (!BTOR_EMPTY_STACK (visited))
+    BTOR_POP_STACK (visited)->aux_mark = 0;
+  BTOR_RELEASE_STACK (btor->mm, visited);
+  BTOR_RELEASE_STACK (btor->mm, stack);
+  return result;
+}
 
-      insert_varsubst_constraint (btor, var, result);
-      btor_release_exp (btor, result);
-    }
+static int
+is_es_op_exp (BtorExp * exp)
+{
+  assert (BTOR_IS_REGULAR_EXP (exp));
+  return exp->kind == BTOR_AND_EXP || exp->kind == BTOR_ADD_EXP ||
+         exp->kind == BTOR_MUL_EXP ||
+         (exp->kind == BTOR_SLL_EXP &&
+          BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (exp->e[1])));
+}
 
-  BTOR_RELEASE_STACK (mm, vars);
+
+/* Class of a child expression, inverted children are negated. */
+static int
+es_child_class (BtorESGraph * eg, BtorPtrHashTable * index,
+                BtorESNode ** nodes, BtorExp * e)
+{
+  BtorPtrHashBucket *b;
+  BtorESNode *n;
+  int c;
+
+  b = btor_find_in_ptr_hash_table (index, BTOR_REAL_ADDR_EXP (e));
+  assert (b != NULL);
+  c = nodes[b->data.asInt]->cls;
+  if (!BTOR_IS_INVERTED_EXP (e))
+    return c;
+  n = es_node (eg, BTOR_ES_NOT, BTOR_REAL_ADDR_EXP (e)->len, c, 0, 0, NULL,
+               NULL);
+  assert (n != NULL);
+  return n->cls;
 }
 
-static int 
-restrict_domain_of_eq_class (Btor * btor, BtorPtrHashTable *eq)
+static void
+saturate_exps (Btor * btor)
 {
+  int i, j, iterations, num_nodes, merged, rewrites, num, c, shift, old_id;
+  BtorExp *cur, *result, *e1, **results;
+  BtorESNode *n, **nodes;
+  BtorPtrHashTable *index;
+  BtorExpPtrStack stack, order;
   BtorPtrHashBucket *b;
-  BtorExp *cur, *lambda_var;
-  int min_len;
+  double start, *orig;
+  BtorESGraph eg;
+  BtorMemMgr *mm;
+  char *bits;
 
   assert (btor != NULL);
-  assert (eq != NULL);
-  assert (btor->rewrite_level > 2);
+  assert (btor->rewrite_level > 1);
   assert (!btor->inc_enabled);
-  assert (!btor->model_gen);
 
-  if (eq->count <= 1u)
-    return 0;
+  if (btor->unsynthesized_constraints->count == 0u)
+    return;
 
-  min_len = btor_log_2_util (btor_next_power_of_2_util ((int) eq->count));
-  cur = BTOR_REAL_ADDR_EXP ((BtorExp *) eq->first->key);
-  if (min_len >= cur->len)
-    return 0;
+  start = btor_time_stamp ();
+  old_id = btor->id;
+  mm = btor->mm;
+  BTOR_INIT_STACK (stack);
+  BTOR_INIT_STACK (order);
 
-  /* perform uniform domain abstraction */
-  for (b = eq->first; b != NULL; b = b->next)
+  /* compute topological order of all bit-vector expressions */
+  for (b = btor->unsynthesized_constraints->first; b != NULL; b = b->next)
+    BTOR_PUSH_STACK (mm, stack, BTOR_REAL_ADDR_EXP ((BtorExp *) b->key));
+  while (!BTOR_EMPTY_STACK (stack))
     {
-      cur = (BtorExp *) b->key;
-      assert (BTOR_REAL_ADDR_EXP (cur)->len > 1);
-      if (!btor_find_in_ptr_hash_table (btor->varsubst_constraints, 
-	                                BTOR_REAL_ADDR_EXP (cur)))
+      cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
+      if (cur->aux_mark == 2)
+        continue;
+      if (cur->aux_mark == 0)
         {
-          lambda_var = lambda_var_exp (btor, min_len);
-          insert_varsubst_constraint (btor, BTOR_REAL_ADDR_EXP (cur), 
-	                              lambda_var);
-          btor_release_exp (btor, lambda_var);
-	  btor->stats.domain_abst++;
-	}
+          cur->aux_mark = 1;
+          BTOR_PUSH_STACK (mm, stack, cur);
+          for (i = cur->arity - 1; i >= 0; i--)
+            BTOR_PUSH_STACK (mm, stack, cur->e[i]);
+        }
+      else if (cur->aux_mark == 1)
+        {
+          cur->aux_mark = 2;
+          /* expressions may become proxies during rebuild */
+          BTOR_PUSH_STACK (mm, order, btor_copy_exp (btor, cur));
+        }
+    }
+  for (i = 0; i < BTOR_COUNT_STACK (order); i++)
+    order.start[i]->aux_mark = 0;
+  num = BTOR_COUNT_STACK (order);
+
+  BTOR_CLR (&eg);
+  eg.btor = btor;
+  eg.mm = mm;
+  eg.size = 2 * num + BTOR_ES_NODE_LIMIT;
+  eg.memo = btor_new_ptr_hash_table (mm, (BtorHashPtr) hash_es_node,
+                                     (BtorCmpPtr) compare_es_nodes);
+  BTOR_NEWN (mm, eg.uf, eg.size);
+  BTOR_NEWN (mm, eg.first, eg.size);
+  BTOR_NEWN (mm, eg.last, eg.size);
+  BTOR_CNEWN (mm, eg.val, eg.size);
+  for (i = 0; i < BTOR_ES_NUM_RULES; i++)
+    eg.rules[i].limit = BTOR_ES_MATCH_LIMIT;
+
+  /* copy expressions into the e-graph, arrays are left out */
+  index = btor_new_ptr_hash_table (mm,
+                                   (BtorHashPtr) btor_hash_exp_by_id,
+                                   (BtorCmpPtr) btor_compare_exp_by_id);
+  BTOR_CNEWN (mm, nodes, num);
+  for (i = 0; i < num; i++)
+    {
+      cur = order.start[i];
+      if (BTOR_IS_ARRAY_EXP (cur))
+        continue;
+      if (BTOR_IS_BV_CONST_EXP (cur))
+        n = es_node (&eg, BTOR_ES_CONST, cur->len, 0, 0, 0, cur->bits, NULL);
+      else if (!is_es_op_exp (cur))
+        n = es_node (&eg, BTOR_ES_LEAF, cur->len, 0, 0, 0, NULL, cur);
+      else if (cur->kind == BTOR_SLL_EXP)
+        {
+          e1 = cur->e[1];
+          bits = btor_copy_const (mm, BTOR_REAL_ADDR_EXP (e1)->bits);
+          if (BTOR_IS_INVERTED_EXP (e1))
+            btor_invert_const (mm, bits);
+          shift = 0;
+          for (j = 0; bits[j]; j++)
+            shift = 2 * shift + (bits[j] == '1');
+          btor_delete_const (mm, bits);
+          n = es_node (&eg, BTOR_ES_SLL, cur->len,
+                       es_child_class (&eg, index, nodes, cur->e[0]), 0,
+                       shift, NULL, NULL);
+        }
+      else
+        n = es_node (&eg, cur->kind == BTOR_AND_EXP ? BTOR_ES_AND :
+                     cur->kind == BTOR_ADD_EXP ? BTOR_ES_ADD : BTOR_ES_MUL,
+                     cur->len, es_child_class (&eg, index, nodes, cur->e[0]),
+                     es_child_class (&eg, index, nodes, cur->e[1]), 0, NULL,
+                     NULL);
+      assert (n != NULL);
+      nodes[i] = n;
+      btor_insert_in_ptr_hash_table (index, cur)->data.asInt = i;
+    }
+  rebuild_es_graph (&eg);
+
+  /* estimated costs of the original expressions as trees */
+  BTOR_NEWN (mm, orig, num);
+  for (i = 0; i < num; i++)
+    {
+      orig[i] = 0;
+      cur = order.start[i];
+      if (nodes[i] == NULL || !is_es_op_exp (cur))
+        continue;
+      orig[i] = cost_es_node (&eg, nodes[i]);
+      for (j = 0; j < cur->arity; j++)
+        {
+          b = btor_find_in_ptr_hash_table (index,
+                                           BTOR_REAL_ADDR_EXP (cur->e[j]));
+          orig[i] += orig[b->data.asInt] + BTOR_IS_INVERTED_EXP (cur->e[j]);
+        }
     }
-  return 1;
-}
 
-static void 
-abstract_domain_bv_variables (Btor * btor)
-{
-  BtorFullParentIterator it;
-  BtorMemMgr *mm;
-  BtorExpPtrStack stack, vars;
-  BtorPtrHashBucket *b;
-  BtorPtrHashTable *eq, *marked;
-  BtorExp *cur, *cur_parent, *next;
-  int i;
+  /* saturate */
+  iterations = 0;
+  while (iterations < BTOR_ES_ITERATION_LIMIT &&
+         BTOR_COUNT_STACK (eg.nodes) < eg.size &&
+         btor_time_stamp () - start < BTOR_ES_TIME_LIMIT)
+    {
+      iterations++;
+      num_nodes = BTOR_COUNT_STACK (eg.nodes);
+      merged = eg.merged;
+      apply_es_rules (&eg);
+      rebuild_es_graph (&eg);
+      if (num_nodes != BTOR_COUNT_STACK (eg.nodes) || merged != eg.merged)
+        continue;
+      for (i = 0; i < BTOR_ES_NUM_RULES; i++)
+        if (eg.rules[i].banned > 0)
+          break;
+      if (i == BTOR_ES_NUM_RULES)
+        break;
+    }
+
+  /* extract and replace expressions by cheaper ones */
+  BTOR_NEWN (mm, eg.cost, eg.classes);
+  BTOR_NEWN (mm, eg.best, eg.classes);
+  BTOR_CNEWN (mm, eg.built, eg.classes);
+  extract_es_graph (&eg);
+  BTOR_CNEWN (mm, results, num);
+  for (i = 0; i < num; i++)
+    {
+      cur = order.start[i];
+      if (nodes[i] == NULL || !is_es_op_exp (cur))
+        continue;
+      c = find_es_class (&eg, nodes[i]->cls);
+      if (eg.cost[c] >= orig[i])
+        continue;
+      result = build_es_class (&eg, c);
+      if (BTOR_REAL_ADDR_EXP (result) == cur)
+        continue;
+      /* Old expressions with smaller ids can not contain 'cur'.  Along
+       * chains of substitutions these ids decrease, thus no cycles. */
+      if (max_old_id_exp (btor, result, old_id) >= cur->id)
+        continue;
+      results[i] = btor_copy_exp (btor, result);
+    }
+
+  /* all expressions are built before the first one is substituted */
+  rewrites = 0;
+  for (i = 0; i < num; i++)
+    {
+      if (results[i] == NULL)
+        continue;
+      result = btor_pointer_chase_simplified_exp (btor, results[i]);
+      set_simplified_exp (btor, order.start[i], result, 1);
+      btor_release_exp (btor, results[i]);
+      rewrites++;
+    }
+  BTOR_DELETEN (mm, results, num);
+
+  rebuild_parents_of_proxies (btor, order.start, num);
 
-  assert (btor != NULL);
-  assert (btor->rewrite_level > 2);
-  assert (!btor->inc_enabled);
-  assert (!btor->model_gen);
-  assert (btor->assumptions->count == 0u);
-  assert (btor->varsubst_constraints->count == 0u);
-  assert (btor->embedded_constraints->count == 0u);
-  assert (btor->synthesized_constraints->count == 0u);
+  btor->stats.es_nodes += BTOR_COUNT_STACK (eg.nodes);
+  btor->stats.es_rewrites += rewrites;
+  btor->stats.es_time += btor_time_stamp () - start;
+  if (btor->verbosity > 1)
+    btor_msg_exp ("equality saturation: %d nodes, %d classes, "
+                  "%d iterations, %d rewrites, %.2f seconds",
+                  BTOR_COUNT_STACK (eg.nodes), eg.classes - eg.merged,
+                  iterations, rewrites, btor_time_stamp () - start);
 
-  mm = btor->mm;
-  BTOR_INIT_STACK (vars);
-  BTOR_INIT_STACK (stack);
+  /* cleanup */
+  for (i = 0; i < eg.classes; i++)
+    {
+      if (eg.built[i] != NULL)
+        btor_release_exp (btor, eg.built[i]);
+      if (eg.val[i] != NULL)
+        btor_delete_const (mm, eg.val[i]);
+    }
+  for (i = 0; i < BTOR_COUNT_STACK (eg.nodes); i++)
+    {
+      n = eg.nodes.start[i];
+      if (n->bits != NULL)
+        btor_delete_const (mm, n->bits);
+      BTOR_DELETE (mm, n);
+    }
+  BTOR_RELEASE_STACK (mm, eg.nodes);
+  BTOR_RELEASE_STACK (mm, eg.merges);
+  btor_delete_ptr_hash_table (eg.memo);
+  BTOR_DELETEN (mm, eg.built, eg.classes);
+  BTOR_DELETEN (mm, eg.best, eg.classes);
+  BTOR_DELETEN (mm, eg.cost, eg.classes);
+  BTOR_DELETEN (mm, eg.val, eg.size);
+  BTOR_DELETEN (mm, eg.last, eg.size);
+  BTOR_DELETEN (mm, eg.first, eg.size);
+  BTOR_DELETEN (mm, eg.uf, eg.size);
+  BTOR_DELETEN (mm, orig, num);
+  BTOR_DELETEN (mm, nodes, num);
+  btor_delete_ptr_hash_table (index);
+  for (i = 0; i < num; i++)
+    btor_release_exp (btor, order.start[i]);
+  BTOR_RELEASE_STACK (mm, order);
+  BTOR_RELEASE_STACK (mm, stack);
+}
 
-  for (b = btor->bv_vars->first; b != NULL; b = b->next)
+/* maximum number of components solved one after the other,
+ * all remaining components are solved together in the last step */
+#define BTOR_MAX_COMPONENTS 16
+
+/* Finds representative of variable with path compression. */
+static BtorExp *
+find_component_var (BtorPtrHashTable * uf, BtorExp * var)
+{
+  BtorPtrHashBucket *b;
+  BtorExp *root, *next;
+  assert (uf != NULL);
+  assert (var != NULL);
+  root = var;
+  while ((next = (BtorExp *) btor_find_in_ptr_hash_table (uf, root)->data.
+          asPtr) != root)
+    root = next;
+  while (var != root)
     {
-      cur = (BtorExp *) b->key;
-      assert (BTOR_IS_REGULAR_EXP (cur));
-      assert (BTOR_IS_BV_VAR_EXP (cur));
-      BTOR_PUSH_STACK (mm, vars, cur);
+      b = btor_find_in_ptr_hash_table (uf, var);
+      next = (BtorExp *) b->data.asPtr;
+      b->data.asPtr = root;
+      var = next;
     }
+  return root;
+}
 
-  marked = btor_new_ptr_hash_table (mm, (BtorHashPtr) btor_hash_exp_by_id,
-                                        (BtorCmpPtr) btor_compare_exp_by_id);
+static void
+union_component_vars (BtorPtrHashTable * uf, BtorExp * var0, BtorExp * var1)
+{
+  var0 = find_component_var (uf, var0);
+  var1 = find_component_var (uf, var1);
+  if (var0 != var1)
+    btor_find_in_ptr_hash_table (uf, var0)->data.asPtr = var1;
+}
 
-  for (i = 0; i < BTOR_COUNT_STACK (vars); i++)
-    {
-      cur = vars.start[i];
+static int
+compare_component_size (const void *p, const void *q)
+{
+  const BtorExpPtrStack *a = *(BtorExpPtrStack * const *) p;
+  const BtorExpPtrStack *b = *(BtorExpPtrStack * const *) q;
+  return BTOR_COUNT_STACK (*a) - BTOR_COUNT_STACK (*b);
+}
 
-      /* boolean variables cannot be abstracted further */
-      if (cur->len == 1)
-	continue;
+/* Partitions the unsynthesized constraints into components which do not
+ * share variables (union-find over the variables in their cones).  The
+ * smallest component is kept in 'unsynthesized_constraints', all others
+ * are moved to 'pending' in the order in which they should be solved.
+ * Every component on 'pending' is terminated by NULL, the component to
+ * be solved next is on top.  Returns the number of components.
+ */
+static int
+partition_constraints (Btor * btor, BtorExpPtrStack * pending)
+{
+  BtorPtrHashTable *uf, *reps, *index;
+  BtorExpPtrStack stack, **comps;
+  BtorPtrHashBucket *b, *c;
+  BtorExp *cur, *rep, *child_rep;
+  int i, num, count, size;
+  BtorMemMgr *mm;
 
-      if (btor_find_in_ptr_hash_table (marked, cur))
-	continue;
+  assert (btor != NULL);
+  assert (pending != NULL);
+  assert (BTOR_EMPTY_STACK (*pending));
 
-      assert (BTOR_EMPTY_STACK (stack));
-      eq = btor_new_ptr_hash_table (mm, (BtorHashPtr) btor_hash_exp_by_id,
-                                        (BtorCmpPtr) btor_compare_exp_by_id);
-      btor_insert_in_ptr_hash_table (eq, cur);
-      goto BTOR_ABSTRACT_DOMAIN_BV_VARS_ENTER_WITHOUT_POP;
+  if (btor->unsynthesized_constraints->count < 2u)
+    return 1;
+
+  mm = btor->mm;
+  uf = btor_new_ptr_hash_table (mm, (BtorHashPtr) btor_hash_exp_by_id,
+                                (BtorCmpPtr) btor_compare_exp_by_id);
+  reps = btor_new_ptr_hash_table (mm, (BtorHashPtr) btor_hash_exp_by_id,
+                                  (BtorCmpPtr) btor_compare_exp_by_id);
+  BTOR_INIT_STACK (stack);
 
+  /* every expression is mapped to one variable in its cone (or NULL) */
+  for (b = btor->unsynthesized_constraints->first; b != NULL; b = b->next)
+    {
+      BTOR_PUSH_STACK (mm, stack, BTOR_REAL_ADDR_EXP ((BtorExp *) b->key));
       while (!BTOR_EMPTY_STACK (stack))
         {
-	  cur = BTOR_POP_STACK (stack);
-	  assert (BTOR_IS_BV_VAR_EXP (BTOR_REAL_ADDR_EXP (cur)));
+          cur = BTOR_REAL_ADDR_EXP (BTOR_POP_STACK (stack));
+          if (btor_find_in_ptr_hash_table (reps, cur))
+            continue;
 
-	  if (btor_find_in_ptr_hash_table (marked, cur))
-	    goto BTOR_ABSTRACT_DOMAIN_BV_VARS_CLEANUP;
+          if (BTOR_IS_BV_VAR_EXP (cur) || BTOR_IS_ARRAY_VAR_EXP (cur))
+            {
+              btor_insert_in_ptr_hash_table (uf, cur)->data.asPtr = cur;
+              btor_insert_in_ptr_hash_table (reps, cur)->data.asPtr = cur;
+            }
+          else if (cur->mark == 0)
+            {
+              cur->mark = 1;
+              BTOR_PUSH_STACK (mm, stack, cur);
+              for (i = cur->arity - 1; i >= 0; i--)
+                BTOR_PUSH_STACK (mm, stack, cur->e[i]);
+            }
+          else
+            {
+              assert (cur->mark == 1);
+              cur->mark = 0;
+              rep = NULL;
+              for (i = 0; i < cur->arity; i++)
+                {
+                  c = btor_find_in_ptr_hash_table (reps,
+                                                   BTOR_REAL_ADDR_EXP (cur->
+                                                                       e[i]));
+                  assert (c != NULL);
+                  child_rep = (BtorExp *) c->data.asPtr;
+                  if (child_rep == NULL)
+                    continue;
+                  if (rep == NULL)
+                    rep = child_rep;
+                  else
+                    union_component_vars (uf, rep, child_rep);
+                }
+              btor_insert_in_ptr_hash_table (reps, cur)->data.asPtr = rep;
+            }
+        }
+    }
 
-BTOR_ABSTRACT_DOMAIN_BV_VARS_ENTER_WITHOUT_POP:
-	  assert (btor_find_in_ptr_hash_table (eq, cur));
-	  init_full_parent_iterator (&it, cur);
-	  while (has_next_parent_full_parent_iterator (&it))
-	    {
-	      cur_parent = next_parent_full_parent_iterator (&it);
-	      assert (BTOR_IS_REGULAR_EXP (cur_parent));
-	      if (BTOR_IS_BV_EQ_EXP (cur_parent))
-	        {
-		  /* we assume that rewriting rules have already simplified
-		   * x = x, and x = ~x
-		   */
-		  if (BTOR_REAL_ADDR_EXP (cur_parent->e[0]) == 
-		      BTOR_REAL_ADDR_EXP (cur))
-		    {
-		      next = cur_parent->e[1];
-		    }
-		  else
-		    {
-		      assert (BTOR_REAL_ADDR_EXP (cur_parent->e[1]) == 
-			      BTOR_REAL_ADDR_EXP (cur));
-		      next = cur_parent->e[0];
-		    }
+  /* collect constraints per component, constraints without
+   * variables are put into the first component */
+  index = btor_new_ptr_hash_table (mm, (BtorHashPtr) btor_hash_exp_by_id,
+                                   (BtorCmpPtr) btor_compare_exp_by_id);
+  size = (int) btor->unsynthesized_constraints->count + 1;
+  BTOR_CNEWN (mm, comps, size);
+  num = 1;
+  for (b = btor->unsynthesized_constraints->first; b != NULL; b = b->next)
+    {
+      cur = (BtorExp *) b->key;
+      rep = (BtorExp *)
+        btor_find_in_ptr_hash_table (reps, BTOR_REAL_ADDR_EXP (cur))->data.
+        asPtr;
+      if (rep == NULL)
+        i = 0;
+      else
+        {
+          rep = find_component_var (uf, rep);
+          c = btor_find_in_ptr_hash_table (index, rep);
+          if (c == NULL)
+            {
+              c = btor_insert_in_ptr_hash_table (index, rep);
+              c->data.asInt = num++;
+            }
+          i = c->data.asInt;
+        }
+      if (comps[i] == NULL)
+        {
+          BTOR_NEW (mm, comps[i]);
+          BTOR_INIT_STACK (*comps[i]);
+        }
+      BTOR_PUSH_STACK (mm, *comps[i], cur);
+    }
 
-		  if (BTOR_IS_BV_VAR_EXP (BTOR_REAL_ADDR_EXP (next)))
-		    {
-		      if (!btor_find_in_ptr_hash_table (eq, next))
-		        { 
-		          btor_insert_in_ptr_hash_table (eq, next);
-		          BTOR_PUSH_STACK (mm, stack, next);
-			}
-		    }
-		  else
-		    goto BTOR_ABSTRACT_DOMAIN_BV_VARS_CLEANUP;
-		}
-	      else
-		goto BTOR_ABSTRACT_DOMAIN_BV_VARS_CLEANUP;
-	    }
-	}
+  /* drop empty slot of variable free constraints */
+  count = 0;
+  for (i = 0; i < num; i++)
+    if (comps[i] != NULL)
+      comps[count++] = comps[i];
 
-      restrict_domain_of_eq_class (btor, eq);
+  /* small components first, they are cheap and may be unsatisfiable */
+  qsort (comps, count, sizeof *comps, compare_component_size);
 
-BTOR_ABSTRACT_DOMAIN_BV_VARS_CLEANUP:
-      BTOR_RESET_STACK (stack);
+  if (count > 1)
+    {
+      for (i = count - 1; i > 0; i--)
+        {
+          if (i >= BTOR_MAX_COMPONENTS - 1 && i < count - 1)
+            {
+              /* merged into last component */
+              while (!BTOR_EMPTY_STACK (*comps[i]))
+                BTOR_PUSH_STACK (mm, *pending, BTOR_POP_STACK (*comps[i]));
+              continue;
+            }
+          BTOR_PUSH_STACK (mm, *pending, NULL);
+          while (!BTOR_EMPTY_STACK (*comps[i]))
+            BTOR_PUSH_STACK (mm, *pending, BTOR_POP_STACK (*comps[i]));
+        }
 
-      for (b = eq->first; b != NULL; b = b->next)
-	{
-	  cur = (BtorExp *) b->key;
-	  if (!btor_find_in_ptr_hash_table (marked, cur))
-	    btor_insert_in_ptr_hash_table (marked, cur);
-	}
-      btor_delete_ptr_hash_table (eq);
+      /* the constraints keep their reference */
+      for (i = 0; i < BTOR_COUNT_STACK (*pending); i++)
+        if ((cur = pending->start[i]) != NULL)
+          btor_remove_from_ptr_hash_table (btor->unsynthesized_constraints,
+                                           cur, NULL, NULL);
     }
 
-  /* cleanup */
-  btor_delete_ptr_hash_table (marked);
-  BTOR_RELEASE_STACK (mm, vars);
+  for (i = 0; i < count; i++)
+    {
+      BTOR_RELEASE_STACK (mm, *comps[i]);
+      BTOR_DELETE (mm, comps[i]);
+    }
+  BTOR_DELETEN (mm, comps, size);
   BTOR_RELEASE_STACK (mm, stack);
+  btor_delete_ptr_hash_table (index);
+  btor_delete_ptr_hash_table (reps);
+  btor_delete_ptr_hash_table (uf);
+
+  return count < BTOR_MAX_COMPONENTS ? count : BTOR_MAX_COMPONENTS;
 }
 
+/* Moves the next pending component back to the unsynthesized constraints. */
+static void
+add_next_component (Btor * btor, BtorExpPtrStack * pending)
+{
+  BtorExp *cur;
+  assert (btor != NULL);
+  assert (pending != NULL);
+  assert (!BTOR_EMPTY_STACK (*pending));
+  while ((cur = BTOR_POP_STACK (*pending)) != NULL)
+    {
+      assert (!btor_find_in_ptr_hash_table (btor->unsynthesized_constraints,
+                                            cur));
+      (void) btor_insert_in_ptr_hash_table (btor->unsynthesized_constraints,
+                                            cur);
+    }
+}
 
-int
-btor_sat_btor (Btor * btor)
+/* Synthesizes the unsynthesized constraints and runs the lemmas on demand
+ * loop on all synthesized constraints. */
+static int
+solve_constraints_btor (Btor * btor)
 {
   int sat_result, found_conflict, found_constraint_false, verbosity;
   int ua_refinements, lod_refinements, found_assumption_false;
   int under_approx_finished, ua;
   BtorExpPtrStack top_arrays;
+  double start;
   BtorAIGMgr *amgr;
   BtorSATMgr *smgr;
   BtorMemMgr *mm;
 
   assert (btor != NULL);
-  assert (btor->btor_sat_btor_called >= 0);
-  assert (btor->inc_enabled || btor->btor_sat_btor_called == 0);
-  btor->btor_sat_btor_called++;
 
   verbosity = btor->verbosity;
   ua = btor->ua.enabled;
   under_approx_finished = 0;
-
-  if (btor->inconsistent)
-    return BTOR_UNSAT;
-
-  if (verbosity > 0)
-    btor_msg_exp ("calling SAT");
-
-  run_rewrite_engine (btor, 1);
-
-  if (btor->inconsistent)
-    return BTOR_UNSAT;
-
   mm = btor->mm;
   ua_refinements = btor->stats.ua_refinements;
   lod_refinements = btor->stats.lod_refinements;
 
   amgr = btor_get_aig_mgr_aigvec_mgr (btor->avmgr);
   smgr = btor_get_sat_mgr_aig_mgr (amgr);
-  if (!btor_is_initialized_sat (smgr))
-    btor_init_sat (smgr);
 
-  if (btor->valid_assignments == 1)
-    btor_reset_incremental_usage (btor);
-  btor->valid_assignments = 1;
+  if (btor->eqsat && btor->rewrite_level > 1 && !btor->inc_enabled)
+    {
+      saturate_exps (btor);
+      if (btor->inconsistent)
+        return BTOR_UNSAT;
+    }
 
+  start = btor_monotonic_time_stamp ();
   assert (check_all_hash_tables_proxy_free_dbg (btor));
   found_constraint_false = process_unsynthesized_constraints (btor);
   assert (check_all_hash_tables_proxy_free_dbg (btor));
 
   if (found_constraint_false)
-    return BTOR_UNSAT;
+    {
+      btor->time.synthesis += btor_monotonic_time_stamp () - start;
+      return BTOR_UNSAT;
+    }
 
   if (btor->model_gen)
     synthesize_all_var_rhs (btor);
+  btor->time.synthesis += btor_monotonic_time_stamp () - start;
 
-  assert (btor->unsynthesized_constraints->count == 0u);
+  /* synthesis stopped at the memory limit */
+  if (btor->unsynthesized_constraints->count > 0u)
+    return BTOR_UNKNOWN;
 
 #if BTOR_ENABLE_PROBING_OPT
   if (!ua && !btor->inc_enabled && btor->rewrite_level > 2)
@@ -10221,6 +14034,8 @@ btor_sat_btor (Btor * btor)
           assert (check_all_hash_tables_proxy_free_dbg (btor));
 	  if (found_constraint_false)
 	    return BTOR_UNSAT;
+          if (btor->unsynthesized_constraints->count > 0u)
+            return BTOR_UNKNOWN;
 	}
     }
 #endif
@@ -10240,8 +14055,14 @@ btor_sat_btor (Btor * btor)
       under_approx_finished = !encode_under_approx (btor);
     }
 
-  sat_result = btor_sat_sat (smgr, -1);
-  assert (sat_result != BTOR_UNKNOWN);
+  if (btor->la.enabled)
+    (void) encode_lazy_arith_ops (btor);
+
+  start = btor_monotonic_time_stamp ();
+  sat_result = btor_mem_limited_sat (smgr, -1);
+  btor->stats.sat_calls++;
+  btor->time.sat += btor_monotonic_time_stamp () - start;
+  assert (sat_result != BTOR_UNKNOWN || btor_is_limit_exceeded_mem_mgr (mm));
 
   BTOR_INIT_STACK (top_arrays);
   search_top_arrays (btor, &top_arrays);
@@ -10251,12 +14072,27 @@ btor_sat_btor (Btor * btor)
     {
       if (sat_result == BTOR_SAT)
         {
-          found_conflict = check_and_resolve_conflicts (btor, &top_arrays);
+          /* abstracted arithmetic is refined before arrays */
+          if (!btor->la.enabled || !refine_lazy_arith (btor))
+            {
+              start = btor_monotonic_time_stamp ();
+              found_conflict =
+                check_and_resolve_conflicts (btor, &top_arrays);
+              btor->time.lemmas += btor_monotonic_time_stamp () - start;
 
-          if (!found_conflict)
-            break;
+              if (found_conflict && btor_is_limit_exceeded_mem_mgr (mm))
+                {
+                  sat_result = BTOR_UNKNOWN;
+                  break;
+                }
+
+              if (found_conflict)
+                lod_refinements++;
+              /* lemma generation may have synthesized new operations */
+              else if (!btor->la.enabled || !refine_lazy_arith (btor))
+                break;
+            }
 
-          lod_refinements++;
           found_assumption_false = readd_assumptions (btor);
           assert (!found_assumption_false);
 
@@ -10295,19 +14131,118 @@ btor_sat_btor (Btor * btor)
               fflush (stdout);
             }
         }
-      sat_result = btor_sat_sat (smgr, -1);
-      assert (sat_result != BTOR_UNKNOWN);
+      start = btor_monotonic_time_stamp ();
+      sat_result = btor_mem_limited_sat (smgr, -1);
+      btor->stats.sat_calls++;
+      btor->time.sat += btor_monotonic_time_stamp () - start;
+      assert (sat_result != BTOR_UNKNOWN
+              || btor_is_limit_exceeded_mem_mgr (mm));
     }
 
   btor->stats.ua_refinements = ua_refinements;
   btor->stats.lod_refinements = lod_refinements;
 
   BTOR_RELEASE_STACK (mm, top_arrays);
-  BTOR_ABORT_EXP (sat_result != BTOR_SAT && sat_result != BTOR_UNSAT,
+  BTOR_ABORT_EXP (sat_result == BTOR_UNKNOWN && !mm->limited,
                   "result must be sat or unsat");
   return sat_result;
 }
 
+static int
+sat_btor_aux (Btor * btor)
+{
+  int sat_result, verbosity, components, count;
+  BtorExpPtrStack pending;
+  BtorAIGMgr *amgr;
+  BtorSATMgr *smgr;
+  double start, delta;
+
+  assert (btor != NULL);
+  assert (btor->btor_sat_btor_called >= 0);
+  assert (btor->inc_enabled || btor->btor_sat_btor_called == 0);
+  btor->btor_sat_btor_called++;
+
+  verbosity = btor->verbosity;
+
+  if (btor->inconsistent)
+    return BTOR_UNSAT;
+
+  if (verbosity > 0)
+    btor_msg_exp ("calling SAT");
+
+  run_rewrite_engine (btor, 1);
+
+  /* do not keep cached rewrite results alive during synthesis */
+  btor_flush_rw_cache (btor);
+
+  if (btor->inconsistent)
+    return BTOR_UNSAT;
+
+  amgr = btor_get_aig_mgr_aigvec_mgr (btor->avmgr);
+  smgr = btor_get_sat_mgr_aig_mgr (amgr);
+  if (!btor_is_initialized_sat (smgr))
+    btor_init_sat (smgr);
+
+  if (btor->valid_assignments == 1)
+    btor_reset_incremental_usage (btor);
+  btor->valid_assignments = 1;
+
+  /* variable disjoint components are solved one after the other */
+  BTOR_INIT_STACK (pending);
+  if (!btor->ua.enabled && !btor->la.enabled)
+    components = partition_constraints (btor, &pending);
+  else
+    components = 1;
+  btor->stats.components = components;
+  btor->stats.components_solved = 0;
+
+  for (;;)
+    {
+      count = (int) btor->unsynthesized_constraints->count;
+      start = btor_time_stamp ();
+      sat_result = solve_constraints_btor (btor);
+      delta = btor_time_stamp () - start;
+
+      btor->stats.components_solved++;
+      if (delta > btor->stats.component_time_max)
+        btor->stats.component_time_max = delta;
+
+      if (verbosity > 1 && components > 1)
+        btor_msg_exp ("component %d/%d: %d constraints, %s, %.2f seconds",
+                      btor->stats.components_solved, components, count,
+                      sat_result == BTOR_SAT ? "sat"
+                      : sat_result == BTOR_UNSAT ? "unsat" : "unknown",
+                      delta);
+
+      /* an unsatisfiable component makes the whole formula unsatisfiable */
+      if (sat_result != BTOR_SAT || BTOR_EMPTY_STACK (pending))
+        break;
+
+      /* conflict checking starts from scratch for the next component */
+      btor_reset_array_models (btor);
+      add_next_component (btor, &pending);
+    }
+
+  /* constraints of unsolved components are kept for incremental usage */
+  while (!BTOR_EMPTY_STACK (pending))
+    add_next_component (btor, &pending);
+  BTOR_RELEASE_STACK (btor->mm, pending);
+
+  return sat_result;
+}
+
+int
+btor_sat_btor (Btor * btor)
+{
+  int sat_result;
+  double start;
+  assert (btor != NULL);
+  start = btor_monotonic_time_stamp ();
+  sat_result = sat_btor_aux (btor);
+  btor->time.solve += btor_monotonic_time_stamp () - start;
+  return sat_result;
+}
+
 char *
 btor_bv_assignment_exp (Btor * btor, BtorExp * exp)
 {
@@ -10358,7 +14293,6 @@ void
 btor_array_assignment_exp (Btor * btor, BtorExp * exp, char ***indices,
                            char ***values, int *size)
 {
-  BtorPtrHashBucket *b;
   BtorExp *index, *value;
   int i;
 
@@ -10371,8 +14305,6 @@ btor_array_assignment_exp (Btor * btor, BtorExp * exp, char ***indices,
   assert (values != NULL);
   assert (size != NULL);
 
-  i = 0;
-
   if (exp->rho == NULL)
     {
       *size = 0;
@@ -10385,13 +14317,13 @@ btor_array_assignment_exp (Btor * btor, BtorExp * exp, char ***indices,
       BTOR_NEWN (btor->mm, *indices, *size);
       BTOR_NEWN (btor->mm, *values, *size);
 
-      for (b = exp->rho->first; b != NULL; b = b->next)
+      for (i = 0; i < *size; i++)
         {
-          index = (BtorExp *) b->key;
-          value = BTOR_GET_VALUE_ACC_EXP ((BtorExp *) b->data.asPtr);
+          index = (BtorExp *) exp->rho->entries[i].key;
+          value =
+            BTOR_GET_VALUE_ACC_EXP ((BtorExp *) exp->rho->entries[i].data.asPtr);
           (*indices)[i] = btor_bv_assignment_exp (btor, index);
           (*values)[i] = btor_bv_assignment_exp (btor, value);
-          i++;
         }
     }
 }
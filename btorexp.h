@@ -25,6 +25,11 @@
 #include "btoraigvec.h"
 #include "btorqueue.h"
 #include "btorhash.h"
+#include "btoroahash.h"
+
+#ifdef BTOR_THREADS
+#include <pthread.h>
+#endif
 
 /*------------------------------------------------------------------------*/
 /* PRIVATE INTERFACE                                                      */
@@ -92,13 +97,23 @@ typedef enum BtorExpKind BtorExpKind;
 
 typedef struct BtorExpPair BtorExpPair;
 
+/* maximum width of cached zero, one and ones constants */
+#define BTOR_CONST_CACHE_LEN 64
+
+/* number of traversal stacks and queues kept for reuse */
+#define BTOR_TRV_POOL_SIZE 8
+
+/* The fields used by hashing, rewriting and DAG traversals are kept at
+ * the front of each node, which makes them fit into one 64 byte cache
+ * line on 64 bit machines.  Fields only used when nodes are connected,
+ * synthesized or printed follow behind.
+ */
 #define BTOR_BV_VAR_EXP_STRUCT \
   struct { \
     BtorExpKind kind:5;            /* kind of expression */ \
     unsigned int mark:3;           /* for DAG traversal */ \
     unsigned int array_mark:2;     /* for bottom up array traversal */ \
     unsigned int aux_mark:2;       /* auxiallary mark flag */ \
-    unsigned int synth_mark:2;     /* mark for synthesize_exp */ \
     unsigned int reachable:1;      /* flag determines if expression  \
 				      is reachable from root */ \
     unsigned int sat_both_phases:1;/* flag determines if expression has been \
@@ -114,24 +129,15 @@ typedef struct BtorExpPair BtorExpPair;
     unsigned int unique:1;	   /* in unique table? */ \
     unsigned int bytes:8;          /* allocated bytes */ \
     unsigned int arity:2;          /* arity of operator */ \
-    char *bits;                    /* three valued bits */ \
     int id;                        /* unique expression id */ \
     int len;                       /* number of bits */ \
     int refs;                      /* reference counter */ \
     union { \
       BtorAIGVec *av;              /* synthesized AIG vector */ \
-      BtorPtrHashTable *rho;       /* used for finding array conflicts */ \
+      BtorOAPtrHashTable *rho;     /* used for finding array conflicts */ \
     }; \
     struct BtorExp *next;          /* next element in unique table */ \
-    struct BtorExp *parent;        /* parent pointer for BFS */ \
     struct BtorExp *simplified;    /* equivalent simplified expression */ \
-    Btor *btor;                    /* boolector */ \
-    struct BtorExp *first_parent;  /* head of parent list */ \
-    struct BtorExp *last_parent;   /* tail of parent list */ \
-}
-
-#define BTOR_BV_ADDITIONAL_EXP_STRUCT \
-  struct { \
     union \
     { \
       struct \
@@ -144,8 +150,22 @@ typedef struct BtorExpPair BtorExpPair;
 	  BtorExpPair *vreads;     /* virtual reads for array equalites */ \
 	}; \
       }; \
+      struct \
+      { \
+	unsigned long long value;  /* first 64 bits of constants */ \
+	unsigned int key;          /* hash of all bits of constants */ \
+      }; \
       struct BtorExp *e[3];        /* three expression children */ \
     }; \
+    long long epoch;               /* last visit, see 'btor->trv.epoch' */ \
+    char *bits;                    /* three valued bits */ \
+    Btor *btor;                    /* boolector */ \
+    struct BtorExp *first_parent;  /* head of parent list */ \
+    struct BtorExp *last_parent;   /* tail of parent list */ \
+}
+
+#define BTOR_BV_ADDITIONAL_EXP_STRUCT \
+  struct { \
     struct BtorExp *prev_parent[3];/* prev exp in parent list of child i */ \
     struct BtorExp *next_parent[3];/* next exp in parent list of child i */ \
 }
@@ -153,6 +173,7 @@ typedef struct BtorExpPair BtorExpPair;
 #define BTOR_ARRAY_VAR_EXP_STRUCT \
   struct { \
     int index_len;                            /* length of the index */ \
+    struct BtorExp *parent;                   /* parent pointer for BFS */ \
     struct BtorExp *first_aeq_acond_parent;   /* first array equality or array \
                                                  conditional in parent list */ \
     struct BtorExp *last_aeq_acond_parent;    /* last array equality or array \
@@ -172,7 +193,6 @@ typedef struct BtorExpPair BtorExpPair;
 struct BtorBVVarExp
 {
   BTOR_BV_VAR_EXP_STRUCT;
-  char *symbol;
 };
 
 typedef struct BtorBVVarExp BtorBVVarExp;
@@ -215,6 +235,11 @@ struct BtorExpUniqueTable
   int size;
   int num_elements;
   struct BtorExp **chains;
+  /* chains of the previous table are rehashed incrementally,
+   * all chains below 'old_pos' have been moved already */
+  int old_size;
+  int old_pos;
+  struct BtorExp **old_chains;
 };
 
 typedef struct BtorExpUniqueTable BtorExpUniqueTable;
@@ -257,6 +282,12 @@ enum BtorUAEnc
 typedef enum BtorUAEnc BtorUAEnc;
 
 
+typedef struct BtorLazyArithOp BtorLazyArithOp;
+
+typedef struct BtorRWCacheEntry BtorRWCacheEntry;
+
+BTOR_DECLARE_STACK (LazyArithOpPtr, BtorLazyArithOp *);
+
 struct Btor
 {
   BtorMemMgr *mm;
@@ -277,6 +308,7 @@ struct Btor
   int model_gen;                    /* model generation enabled */
   int external_refs;                /* external references (library mode) */
   int inc_enabled;                  /* incremental usage enabled ? */
+  int eqsat;                        /* equality saturation enabled */
   int btor_sat_btor_called;         /* how often is btor_sat_btor been called */
   struct                            /* Under-approximation UA */
   {                       
@@ -291,9 +323,45 @@ struct Btor
     BtorPtrHashTable *vars_reads;   /* bv variables and reads */
     BtorPtrHashTable *writes_aconds;/* array writes and array conds */
   } ua;
-  BtorPtrHashTable *exp_pair_cnf_diff_id_table; /* hash table for CNF ids */
-  BtorPtrHashTable *exp_pair_cnf_eq_id_table;   /* hash table for CNF ids */
-  BtorPtrHashTable *exp_pair_ass_unequal_table; /* assignment unequal */
+  struct                            /* lazy arithmetic LA */
+  {
+    int enabled;                    /* LA enabled */
+    int min_width;                  /* min. bit-width of abstracted ops */
+    BtorLazyArithOpPtrStack ops;    /* abstracted ops not refined yet */
+  } la;
+  struct                            /* rewrite cache RWC */
+  {
+    BtorRWCacheEntry *entries;      /* allocated on first use */
+    int epoch;                      /* incremented on simplification */
+  } rwc;
+  struct                            /* constant cache CC */
+  {
+    /* zero, one and ones constants indexed by width, the cache does not
+     * hold references, entries are cleared when constants are erased */
+    BtorExp *zero[BTOR_CONST_CACHE_LEN + 1];
+    BtorExp *one[BTOR_CONST_CACHE_LEN + 1];
+    BtorExp *ones[BTOR_CONST_CACHE_LEN + 1];
+  } cc;
+  struct                            /* traversals TRV */
+  {
+    BtorExpPtrStack stacks[BTOR_TRV_POOL_SIZE]; /* empty, for reuse */
+    int num_stacks;
+    BtorExpPtrQueue queues[BTOR_TRV_POOL_SIZE]; /* empty, for reuse */
+    int num_queues;
+    /* A traversal starts a new epoch and visits expressions by setting
+     * their 'epoch' to it, which requires no reset afterwards. */
+    long long epoch;
+  } trv;
+  struct                            /* read over write index ROW */
+  {
+    int read_prop_limit;            /* max. propagations of a read */
+    int write_chain_bound;          /* max. depth of write chain rewriting */
+    BtorPtrHashTable *writes;       /* allocated on first use */
+  } row;
+  BtorOAPtrHashTable *exp_pair_cnf_diff_id_table; /* hash table for CNF ids */
+  BtorOAPtrHashTable *exp_pair_cnf_eq_id_table;   /* hash table for CNF ids */
+  BtorOAPtrHashTable *exp_pair_ass_unequal_table; /* assignment unequal */
+  BtorOAPtrHashTable *lemma_lit_table;            /* lemma literals */
   BtorPtrHashTable *varsubst_constraints;
   BtorPtrHashTable *embedded_constraints;
   BtorPtrHashTable *unsynthesized_constraints;
@@ -302,6 +370,11 @@ struct Btor
   BtorPtrHashTable *var_rhs; /* only for model generation */
   BtorExpPtrStack arrays_with_model;
   BtorExpPtrStack replay_constraints;
+  struct BtorApiTrace *apitrace;	/* log of public interface calls */
+#ifdef BTOR_THREADS
+  pthread_mutex_t *mutex;         /* thread safe usage enabled ? */
+  pthread_rwlock_t *rwlock;       /* API calls, see 'boolector.c' */
+#endif
   /* statistics */
   int ops[BTOR_NUM_OPS_EXP];
   struct
@@ -310,8 +383,16 @@ struct Btor
     int max_rec_rw_calls;
     /* number of under-approximation refinements */
     int ua_refinements;
+    /* number of abstracted multiplications and divisions (LA) */
+    int la_abstractions;
+    /* number of LA refinements */
+    int la_refinements;
     /* number of lemmas on demand refinements */
     int lod_refinements;
+    /* number of SAT solver calls during lemmas on demand */
+    int sat_calls;
+    /* number of SAT restarts by 'btor_restart_sat_btor' */
+    int sat_restarts;
     /* number of restarts as a result of lazy synthesis */
     int synthesis_assignment_inconsistencies;
     /* number of array axiom 1 conflicts: 
@@ -320,22 +401,44 @@ struct Btor
     /* number of array axiom 2 conflicts:
      * i = j => read(write(a, i, e), j) = e */
     int array_axiom_2_conflicts;
+    /* number of lemmas reusing the lemma literal of an access pair */
+    int lemma_cache_hits;
     /* number of variables that have been substituted */
     int var_substitutions;
     /* number of array variables that have been substituted */
     int array_substitutions;
     /* embedded constraint substitutions */
     int ec_substitutions;
+    /* number of variable disjoint constraint components in the last
+     * SAT call, how many of them have been solved, and the maximum
+     * time needed to solve one of them */
+    int components;
+    int components_solved;
+    double component_time_max;
+    /* number of global rebuild rounds and of rebuilt expressions */
+    int rebuild_rounds;
+    long long rebuilds;
     /* number of virtual reads */
     int vreads;
     /* number of linear equations */
     int linear_equations;
+    /* equations in linear systems and variables solved by Gaussian
+     * elimination */
+    int gauss_equations;
+    int gauss_substs;
     /* number of add chains normalizations */
     int adds_normalized;
     /* number of mul chains normalizations */
     int muls_normalized;
     /* domain abstractions */
     int domain_abst;
+    /* bit-width reductions */
+    int bw_reductions;
+    /* nodes of e-graphs, expressions replaced by cheaper equivalent ones,
+     * and time spent in equality saturation */
+    long long es_nodes;
+    int es_rewrites;
+    double es_time;
 #if BTOR_ENABLE_PROBING_OPT
     /* how many equalities have been successfully probed */
     int probed_equalities;
@@ -344,12 +447,28 @@ struct Btor
     int bv_uc_props;
     /* unconstrained array propagations */
     int array_uc_props;
+    /* estimated number of clauses saved by unconstrained propagations */
+    long long uc_clauses;
     /*  how often have we pushed a read over write during construction */
     int read_props_construct;
+    /* how often have we skipped writes by the read over write index */
+    int read_props_index;
+    /* rewrite calls, cache hits, applied rewrites and rewrite time per
+     * operator (indexed by BTOR_BEQ_EXP for equalities and by
+     * BTOR_BCOND_EXP for conditionals) */
+    struct
+    {
+      long long calls;
+      long long cached;
+      long long rewritten;
+      double time;
+    } rw[BTOR_NUM_OPS_EXP];
     /* sum of the size of all added lemmas */
     long long int lemmas_size_sum;
     /* sum of the size of all linking clauses */
     long long int lclause_size_sum;
+    /* number of premisses dropped as they are false at the top level */
+    long long int lemma_premisses_dropped;
     /* constraint statistics */
     ConstraintStats constraints;
     struct
@@ -358,6 +477,18 @@ struct Btor
     } old;
     long long expressions;
   } stats;
+
+  /* wall clock seconds spent in the phases of 'btor_sat_btor', lemmas
+   * include lazy synthesis and SAT calls during conflict resolution,
+   * solve is the total over all calls of 'btor_sat_btor' */
+  struct
+  {
+    double solve;
+    double rewrite;
+    double synthesis;
+    double sat;
+    double lemmas;
+  } time;
 };
 
 
@@ -425,6 +556,36 @@ struct Btor
 #define BTOR_ACC_TARGET_EXP(exp) (BTOR_IS_READ_EXP(exp) ? (exp)->e[0] : (exp))
 #define BTOR_IS_SYNTH_EXP(exp) ((exp)->av != NULL)
 
+/* With thread safe usage several threads build expressions concurrently.
+ * The unique table, parent lists, reference counts, caches and
+ * statistics are only changed while holding the lock of the instance.
+ * Rewriting and the argument checks of the API run without it, thus
+ * reference counts are additionally changed and read atomically.
+ */
+#ifdef BTOR_THREADS
+#define BTOR_LOCK_EXP(btor) \
+  do { \
+    if ((btor)->mutex != NULL) \
+      pthread_mutex_lock ((btor)->mutex); \
+  } while (0)
+#define BTOR_UNLOCK_EXP(btor) \
+  do { \
+    if ((btor)->mutex != NULL) \
+      pthread_mutex_unlock ((btor)->mutex); \
+  } while (0)
+#define BTOR_INC_REFS_EXP(exp) \
+  ((void) __atomic_add_fetch (&(exp)->refs, 1, __ATOMIC_RELAXED))
+#define BTOR_DEC_REFS_EXP(exp) \
+  ((void) __atomic_sub_fetch (&(exp)->refs, 1, __ATOMIC_RELAXED))
+#define BTOR_REFS_EXP(exp) __atomic_load_n (&(exp)->refs, __ATOMIC_RELAXED)
+#else
+#define BTOR_LOCK_EXP(btor) do { } while (0)
+#define BTOR_UNLOCK_EXP(btor) do { } while (0)
+#define BTOR_INC_REFS_EXP(exp) ((void) (exp)->refs++)
+#define BTOR_DEC_REFS_EXP(exp) ((void) (exp)->refs--)
+#define BTOR_REFS_EXP(exp) ((exp)->refs)
+#endif
+
 /*------------------------------------------------------------------------*/
 /* Btor                                                                   */
 /*------------------------------------------------------------------------*/
@@ -460,6 +621,30 @@ void btor_set_under_approx_ref (Btor * btor, BtorUARef ua_ref);
 
 void btor_set_under_approx_enc (Btor * btor, BtorUAEnc ua_bw_enc);
 
+/* Enables lazy bit-blasting of multiplications and divisions (LA).
+ * They are abstracted by fresh variables and refined on demand.
+ */
+void btor_enable_lazy_arith (Btor * btor);
+
+/* Enables equality saturation of arithmetic expressions before
+ * bit-blasting (ES).  Needs rewrite level 2 or higher.
+ */
+void btor_enable_eqsat (Btor * btor);
+
+/* Sets minimum bit-width of operations which are abstracted by LA. */
+void btor_set_lazy_arith_min_width (Btor * btor, int min_width);
+
+/* Sets maximum number of writes a read is propagated over during
+ * construction.  Runs of writes with constant indices are skipped at once
+ * by a read with constant index and count as one propagation.
+ */
+void btor_set_read_over_write_limit (Btor * btor, int limit);
+
+/* Sets maximum depth up to which write chains are searched for an
+ * earlier write to the same index, which is then skipped.
+ */
+void btor_set_write_chain_bound (Btor * btor, int bound);
+
 /* Turns replay on or off. */
 void btor_set_replay_btor (Btor * btor, int replay);
 
@@ -890,6 +1075,15 @@ void btor_add_assumption_exp (Btor * btor, BtorExp * exp);
  */ 
 int btor_sat_btor (Btor * btor);
 
+/* Restarts synthesis and SAT solving: releases the AIGs of all
+ * expressions and resets the SAT solver, which drops all clauses, lemmas
+ * and CNF ids.  PicoSAT can only be reset as a whole.  Constraints are
+ * synthesized and encoded again by the next call of 'btor_sat_btor'.
+ * Assignments are not available until then.  Neither under-approximation
+ * nor lazy arithmetic may be enabled.
+ */
+void btor_restart_sat_btor (Btor * btor);
+
 /* Builds current assignment string of expression (in the SAT case) 
  * and returns it.
  * Do not call before calling btor_sat_exp.
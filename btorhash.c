@@ -36,6 +36,7 @@ btor_new_ptr_hash_table (BtorMemMgr * mem, BtorHashPtr hash, BtorCmpPtr cmp)
 {
   BtorPtrHashTable * res;
 
+  mem = BTOR_VIEW_MEM_MGR (mem, BTOR_MEM_HASH);
   BTOR_NEW (mem, res);
   BTOR_CLR (res);
 
@@ -58,38 +59,75 @@ btor_delete_ptr_hash_table (BtorPtrHashTable * p2iht)
     }
 
   BTOR_DELETEN (p2iht->mem, p2iht->table, p2iht->size);
+  BTOR_DELETEN (p2iht->mem, p2iht->old_table, p2iht->old_size);
   BTOR_DELETE (p2iht->mem, p2iht);
 }
 
+/* number of old buckets moved per table access while enlarging */
+#define BTOR_PTR_HASH_TABLE_REHASH_STEPS 4
+
 static void
-btor_enlarge_ptr_hash_table (BtorPtrHashTable * p2iht)
+btor_rehash_chain_ptr_hash_table (BtorPtrHashTable * p2iht, unsigned pos)
+{
+  BtorPtrHashBucket * p, * chain;
+  unsigned h;
+
+  assert (p2iht->old_table);
+  assert (pos < p2iht->old_size);
+
+  for (p = p2iht->old_table[pos]; p; p = chain)
+    {
+      chain = p->chain;
+      h = p2iht->hash (p->key);
+      h &= p2iht->size - 1;
+      p->chain = p2iht->table[h];
+      p2iht->table[h] = p;
+    }
+
+  p2iht->old_table[pos] = 0;
+}
+
+/* Moves the next few buckets of the old table and deletes it
+ * as soon as all buckets have been moved.
+ */
+static void
+btor_rehash_step_ptr_hash_table (BtorPtrHashTable * p2iht, unsigned steps)
 {
-  BtorPtrHashBucket * p, * chain, ** old_table, ** new_table;
-  unsigned old_size, new_size, i, h;
-  BtorHashPtr hash;
+  assert (p2iht->old_table);
 
-  old_size = p2iht->size;
-  old_table = p2iht->table;
+  while (steps-- && p2iht->old_pos < p2iht->old_size)
+    btor_rehash_chain_ptr_hash_table (p2iht, p2iht->old_pos++);
 
-  new_size = old_size ? 2 * old_size : 1;
-  BTOR_CNEWN (p2iht->mem, new_table, new_size);
+  if (p2iht->old_pos == p2iht->old_size)
+    {
+      BTOR_DELETEN (p2iht->mem, p2iht->old_table, p2iht->old_size);
+      p2iht->old_table = 0;
+      p2iht->old_size = 0;
+      p2iht->old_pos = 0;
+    }
+}
+
+static void
+btor_enlarge_ptr_hash_table (BtorPtrHashTable * p2iht)
+{
+  unsigned new_size;
 
-  hash = p2iht->hash;
+  /* the previous enlargement has to be finished first */
+  if (p2iht->old_table)
+    btor_rehash_step_ptr_hash_table (p2iht, p2iht->old_size);
 
-  for (i = 0; i < old_size; i++)
-    for (p = old_table[i]; p; p = chain)
-      {
-	chain = p->chain;
-	h = hash (p->key);
-	h &= new_size - 1;
-	p->chain = new_table[h];
-	new_table[h] = p;
-      }
+  assert (!p2iht->old_table);
 
-  BTOR_DELETEN (p2iht->mem, old_table, old_size);
+  p2iht->old_size = p2iht->size;
+  p2iht->old_pos = 0;
+  p2iht->old_table = p2iht->table;
 
+  new_size = p2iht->size ? 2 * p2iht->size : 1;
+  BTOR_CNEWN (p2iht->mem, p2iht->table, new_size);
   p2iht->size = new_size;
-  p2iht->table = new_table;
+
+  if (!p2iht->old_size)
+    p2iht->old_table = 0;
 }
 
 static BtorPtrHashBucket **
@@ -97,7 +135,7 @@ btor_findpos_in_ptr_hash_table_pos (BtorPtrHashTable * p2iht,
     				           void * key)
 {
   BtorPtrHashBucket ** p, * b;
-  unsigned h;
+  unsigned h, pos;
 
   if (p2iht->count == p2iht->size)
     btor_enlarge_ptr_hash_table (p2iht);
@@ -105,6 +143,17 @@ btor_findpos_in_ptr_hash_table_pos (BtorPtrHashTable * p2iht,
   assert (p2iht->size > 0);
 
   h = p2iht->hash (key);
+
+  if (p2iht->old_table)
+    {
+      /* make sure the bucket of the key has been moved */
+      pos = h & (p2iht->old_size - 1);
+      if (pos >= p2iht->old_pos)
+        btor_rehash_chain_ptr_hash_table (p2iht, pos);
+      btor_rehash_step_ptr_hash_table (p2iht,
+                                       BTOR_PTR_HASH_TABLE_REHASH_STEPS);
+    }
+
   h &= p2iht->size - 1;
 
   for (p = p2iht->table + h;
@@ -64,6 +64,14 @@ struct BtorPtrHashTable
   unsigned count;
   BtorPtrHashBucket **table;
 
+  /* While enlarging, buckets of the previous table are moved
+   * incrementally. All buckets of 'old_table' below 'old_pos'
+   * are moved already.
+   */
+  unsigned old_size;
+  unsigned old_pos;
+  BtorPtrHashBucket **old_table;
+
   BtorHashPtr hash;
   BtorCmpPtr cmp;
 
@@ -138,6 +138,11 @@ struct BtorMainApp
   BtorUAMode ua_mode;
   BtorUARef ua_ref;
   BtorUAEnc ua_enc;
+  int la;
+  int la_min_width;
+  int es;
+  int row_limit;
+  int write_chain_bound;
   int bmcmaxk;
   int bmcadc;
   BtorCNFEnc cnf_enc;
@@ -174,6 +179,8 @@ static const char *g_usage =
   "  -rwl<n>|--rewrite-level<n>       set rewrite level [0,3] (default 3)\n"
   "  -tcnf|--tseitin-cnf              use Tseitin CNF encoding\n"
   "  -pgcnf|--plaisted-greenbaum-cnf  use Plaisted-Greenbaum CNF encoding (default)\n"
+  "  -rowl=<n>                        set limit of read over write propagations (default n=1024)\n"
+  "  -wcb=<n>                         set bound of write chain rewriting (default n=20)\n"
  
   "\n"
   "Under-approximation options:\n"
@@ -192,6 +199,13 @@ static const char *g_usage =
   "  -uac                             UA encoding by equivalence classes\n"
   "  -uas                             UA encoding by sign-extension (default)\n"
   "\n"
+  "Lazy arithmetic options:\n"
+  "  -la                              enable lazy bit-blasting of mul/div (LA)\n"
+  "  -law=<n>                         set min. bit-width of abstracted ops (default n=16)\n"
+  "\n"
+  "Equality saturation options:\n"
+  "  -es                              enable equality saturation of arithmetic (ES)\n"
+  "\n"
   "\n"
   "BMC options:\n"
   "  -bmc-maxk=<k>                    sets maximum bound for model checking\n"
@@ -711,6 +725,41 @@ parse_commandline_arguments (BtorMainApp * app)
 	  app->ua_enc = BTOR_UA_ENC_SIGN_EXTEND;
 	  app->ua = 1;
 	}
+      else if (!strcmp (app->argv[app->argpos], "-la"))
+	app->la = 1;
+      else if (!strcmp (app->argv[app->argpos], "-es"))
+	app->es = 1;
+      else if (strstr (app->argv[app->argpos], "-law=") == app->argv[app->argpos]
+             && strlen (app->argv[app->argpos]) > strlen ("-law="))
+        {
+	  app->la_min_width = atoi (app->argv[app->argpos] + 5);
+	  app->la = 1;
+	  if (app->la_min_width < 1)
+	    {
+	      print_err (app, "LA min. width must be greater than zero\n");
+	      app->err = 1;
+	    }
+	}
+      else if (strstr (app->argv[app->argpos], "-rowl=") == app->argv[app->argpos]
+             && strlen (app->argv[app->argpos]) > strlen ("-rowl="))
+        {
+	  app->row_limit = atoi (app->argv[app->argpos] + 6);
+	  if (app->row_limit < 1)
+	    {
+	      print_err (app, "read over write limit must be greater than zero\n");
+	      app->err = 1;
+	    }
+	}
+      else if (strstr (app->argv[app->argpos], "-wcb=") == app->argv[app->argpos]
+             && strlen (app->argv[app->argpos]) > strlen ("-wcb="))
+        {
+	  app->write_chain_bound = atoi (app->argv[app->argpos] + 5);
+	  if (app->write_chain_bound < 0)
+	    {
+	      print_err (app, "write chain bound must not be negative\n");
+	      app->err = 1;
+	    }
+	}
       else if (!strcmp (app->argv[app->argpos], "-tcnf")
                || !strcmp (app->argv[app->argpos], "--tseitin-cnf"))
         app->cnf_enc = BTOR_TSEITIN_CNF_ENC;
@@ -977,6 +1026,11 @@ boolector_main (int argc, char **argv)
   app.ua_mode = BTOR_UA_GLOBAL_MODE;
   app.ua_ref = BTOR_UA_REF_BY_DOUBLING;
   app.ua_enc = BTOR_UA_ENC_SIGN_EXTEND;
+  app.la = 0;
+  app.la_min_width = 0;         /* 0 means it has not been set by the user */
+  app.es = 0;
+  app.row_limit = 0;            /* 0 means it has not been set by the user */
+  app.write_chain_bound = -1;   /* -1 means it has not been set by the user */
   app.bmcmaxk = -1;             /* -1 means it has not been set by the user */
   app.bmcadc = 1;
   app.cnf_enc = BTOR_PLAISTED_GREENBAUM_CNF_ENC;
@@ -1016,6 +1070,18 @@ boolector_main (int argc, char **argv)
           btor_set_under_approx_ref (btor, app.ua_ref);
           btor_set_under_approx_enc (btor, app.ua_enc);
 	}
+      if (app.la)
+        {
+          btor_enable_lazy_arith (btor);
+          if (app.la_min_width > 0)
+            btor_set_lazy_arith_min_width (btor, app.la_min_width);
+        }
+      if (app.es)
+        btor_enable_eqsat (btor);
+      if (app.row_limit > 0)
+        btor_set_read_over_write_limit (btor, app.row_limit);
+      if (app.write_chain_bound >= 0)
+        btor_set_write_chain_bound (btor, app.write_chain_bound);
       btor_set_verbosity_btor (btor, app.verbosity);
       btor_set_replay_btor (btor,
 	                    app.replay_mode != BTOR_APP_REPLAY_MODE_NONE);
@@ -1594,7 +1660,7 @@ boolector_main (int argc, char **argv)
                                            nconstraints);
 
               sat_result = btor_sat_btor (btor);
-	      assert (sat_result != BTOR_UNKNOWN);
+	      assert (sat_result != BTOR_UNKNOWN || btor->mm->limited);
               print_sat_result (&app, sat_result);
 
               /* check if status is equal to benchmark status */
@@ -36,49 +36,132 @@
   } while (0)
 
 
-#define ADJUST() \
-  do { \
-    if (mm->maxallocated < mm->allocated) \
-      mm->maxallocated = mm->allocated; \
-  } while (0)
+#ifdef BTOR_THREADS
 
-#define LIMIT(inc) \
-  do { \
-    BTOR_ABORT_MEM (inc > 0 && \
-		    mm->limited &&  \
-		    mm->allocated + (inc) >= mm->limitallocated, \
-		    "memory limit reached"); \
-  } while (0)
+/* Threads building expressions of a thread safe instance allocate
+ * concurrently, thus the statistics are updated atomically.
+ */
+static void
+update_max_mem_mgr (size_t * max, size_t cur)
+{
+  size_t old = __atomic_load_n (max, __ATOMIC_RELAXED);
+  while (old < cur &&
+         !__atomic_compare_exchange_n (max, &old, cur, 1,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+static void
+inc_mem_mgr (BtorMemMgr * mm, size_t bytes)
+{
+  BtorMemMgr *root = mm->root;
+  update_max_mem_mgr (&root->maxallocated,
+                      __atomic_add_fetch (&root->allocated, bytes,
+                                          __ATOMIC_RELAXED));
+  update_max_mem_mgr (root->kind_maxallocated + mm->kind,
+                      __atomic_add_fetch (root->kind_allocated + mm->kind,
+                                          bytes, __ATOMIC_RELAXED));
+}
+
+static void
+dec_mem_mgr (BtorMemMgr * mm, size_t bytes)
+{
+  BtorMemMgr *root = mm->root;
+  __atomic_sub_fetch (&root->allocated, bytes, __ATOMIC_RELAXED);
+  __atomic_sub_fetch (root->kind_allocated + mm->kind, bytes,
+                      __ATOMIC_RELAXED);
+}
+
+#else
+
+static void
+inc_mem_mgr (BtorMemMgr * mm, size_t bytes)
+{
+  BtorMemMgr *root = mm->root;
+  root->allocated += bytes;
+  if (root->maxallocated < root->allocated)
+    root->maxallocated = root->allocated;
+  root->kind_allocated[mm->kind] += bytes;
+  if (root->kind_maxallocated[mm->kind] < root->kind_allocated[mm->kind])
+    root->kind_maxallocated[mm->kind] = root->kind_allocated[mm->kind];
+}
+
+static void
+dec_mem_mgr (BtorMemMgr * mm, size_t bytes)
+{
+  BtorMemMgr *root = mm->root;
+  assert (root->allocated >= bytes);
+  assert (root->kind_allocated[mm->kind] >= bytes);
+  root->allocated -= bytes;
+  root->kind_allocated[mm->kind] -= bytes;
+}
+
+#endif
+
+static BtorMemMgr *
+new_view_mem_mgr (BtorMemMgr * root, BtorMemKind kind)
+{
+  BtorMemMgr *res = (BtorMemMgr *) calloc (1, sizeof (BtorMemMgr));
+  BTOR_ABORT_MEM (res == NULL, "out of memory in 'btor_new_mem_mgr'");
+  res->kind = kind;
+  res->root = root;
+  return res;
+}
 
 BtorMemMgr *
 btor_new_mem_mgr (void)
 {
   const char * limit_str_in_mb;
-  BtorMemMgr *mm = (BtorMemMgr *) malloc (sizeof (BtorMemMgr));
+  int kind;
+  BtorMemMgr *mm = (BtorMemMgr *) calloc (1, sizeof (BtorMemMgr));
   BTOR_ABORT_MEM (mm == NULL, "out of memory in 'btor_new_mem_mgr'");
-  mm->allocated = 0;
-  mm->maxallocated = 0;
+  mm->kind = BTOR_MEM_EXP;
+  mm->root = mm;
+  mm->views[BTOR_MEM_EXP] = mm;
+  for (kind = BTOR_MEM_EXP + 1; kind < BTOR_NUM_MEM_KINDS; kind++)
+    mm->views[kind] = new_view_mem_mgr (mm, (BtorMemKind) kind);
   if ((limit_str_in_mb = getenv ("BTORMEMLIMIT")))
-    {
-      mm->limited = 1;
-      mm->limitallocated = ((size_t)atoi (limit_str_in_mb)) << 20;
-    }
-  else
-    mm->limited = 0;
+    btor_set_limit_mem_mgr (mm, ((size_t)atoi (limit_str_in_mb)) << 20);
 
   return mm;
 }
 
+void
+btor_set_limit_mem_mgr (BtorMemMgr * mm, size_t limit)
+{
+  assert (mm != NULL);
+  mm = mm->root;
+  mm->limited = limit > 0;
+  mm->limitallocated = limit;
+}
+
+int
+btor_is_limit_exceeded_mem_mgr (BtorMemMgr * mm)
+{
+  assert (mm != NULL);
+  mm = mm->root;
+  return mm->limited && mm->allocated >= mm->limitallocated;
+}
+
+const char *
+btor_name_mem_kind (BtorMemKind kind)
+{
+  static const char *const names[BTOR_NUM_MEM_KINDS] = {
+    "expressions", "constants", "AIGs", "hash tables", "SAT solver", "parser"
+  };
+  assert (kind >= BTOR_MEM_EXP);
+  assert (kind < BTOR_NUM_MEM_KINDS);
+  return names[kind];
+}
+
 void *
 btor_malloc (BtorMemMgr * mm, size_t size)
 {
   void *result;
   assert (mm != NULL);
-  LIMIT(size);
   result = malloc (size);
   BTOR_ABORT_MEM (result == NULL, "out of memory in 'btor_malloc'");
-  mm->allocated += size;
-  ADJUST ();
+  inc_mem_mgr (mm, size);
   return result;
 }
 
@@ -88,13 +171,10 @@ btor_realloc (BtorMemMgr * mm, void *p, size_t old_size, size_t new_size)
   void *result;
   assert (mm != NULL);
   assert (!p == !old_size);
-  assert (mm->allocated >= old_size);
-  LIMIT(new_size - old_size);
   result = realloc (p, new_size);
   BTOR_ABORT_MEM (result == NULL, "out of memory in 'btor_realloc'");
-  mm->allocated -= old_size;
-  mm->allocated += new_size;
-  ADJUST ();
+  dec_mem_mgr (mm, old_size);
+  inc_mem_mgr (mm, new_size);
   return result;
 }
 
@@ -104,11 +184,9 @@ btor_calloc (BtorMemMgr * mm, size_t nobj, size_t size)
   size_t bytes = nobj * size;
   void *result;
   assert (mm != NULL);
-  LIMIT (bytes);
   result = calloc (nobj, size);
   BTOR_ABORT_MEM (result == NULL, "out of memory in 'btor_calloc'");
-  mm->allocated += bytes;
-  ADJUST ();
+  inc_mem_mgr (mm, bytes);
   return result;
 }
 
@@ -117,8 +195,7 @@ btor_free (BtorMemMgr * mm, void *p, size_t freed)
 {
   assert (mm != NULL);
   assert (!p == !freed);
-  assert (mm->allocated >= freed);
-  mm->allocated -= freed;
+  dec_mem_mgr (mm, freed);
   free (p);
 }
 
@@ -130,7 +207,6 @@ btor_strdup (BtorMemMgr * mm, const char *str)
   if (str)
     {
       res = btor_malloc (mm, strlen (str) + 1);
-      ADJUST ();
       strcpy (res, str);
     }
   else
@@ -149,8 +225,12 @@ btor_freestr (BtorMemMgr * mm, char *str)
 void
 btor_delete_mem_mgr (BtorMemMgr * mm)
 {
+  int kind;
   assert (mm != NULL);
+  assert (mm->root == mm);
   assert (getenv ("BTORLEAKMEM") || mm->allocated == 0);
+  for (kind = BTOR_MEM_EXP + 1; kind < BTOR_NUM_MEM_KINDS; kind++)
+    free (mm->views[kind]);
   free (mm);
 }
 
@@ -57,18 +57,60 @@
     (n) = internaln; \
   } while (0)
 
+/* Allocations are accounted per kind.  A memory manager has a view for
+ * each kind, which allocates from the same manager but accounts the bytes
+ * to its kind.  Memory has to be released through a manager of the same
+ * kind as it has been allocated from.  Allocations through the manager
+ * itself are accounted to 'BTOR_MEM_EXP'.
+ */
+enum BtorMemKind
+{
+  BTOR_MEM_EXP = 0,             /* expressions and everything else */
+  BTOR_MEM_CONST = 1,           /* bits of constant expressions */
+  BTOR_MEM_AIG = 2,             /* AIG nodes and the AIG unique table */
+  BTOR_MEM_HASH = 3,            /* pointer hash tables */
+  BTOR_MEM_SAT = 4,             /* SAT solver */
+  BTOR_MEM_PARSER = 5,
+  BTOR_NUM_MEM_KINDS = 6
+};
+
+typedef enum BtorMemKind BtorMemKind;
+
+typedef struct BtorMemMgr BtorMemMgr;
+
 struct BtorMemMgr
 {
-  size_t allocated;
+  size_t allocated;             /* of all kinds */
   size_t maxallocated;
   size_t limitallocated;
   int limited;
+  BtorMemKind kind;
+  BtorMemMgr *root;             /* the manager itself if it is not a view */
+  BtorMemMgr *views[BTOR_NUM_MEM_KINDS];
+  size_t kind_allocated[BTOR_NUM_MEM_KINDS];
+  size_t kind_maxallocated[BTOR_NUM_MEM_KINDS];
 };
 
-typedef struct BtorMemMgr BtorMemMgr;
+/* Statistics and the limit are only maintained by the root manager. */
+#define BTOR_ROOT_MEM_MGR(mm) ((mm)->root)
+
+/* View of the root manager of 'mm' accounting to 'kind'. */
+#define BTOR_VIEW_MEM_MGR(mm,kind) ((mm)->root->views[kind])
 
+/* The limit is initialized from the environment variable 'BTORMEMLIMIT'
+ * in MB.  Allocations do not fail if the limit is reached.  Instead
+ * clients check 'btor_is_limit_exceeded_mem_mgr' at points at which they
+ * can give up gracefully.
+ */
 BtorMemMgr *btor_new_mem_mgr (void);
 
+/* Zero removes the limit. */
+void btor_set_limit_mem_mgr (BtorMemMgr * mm, size_t limit);
+
+int btor_is_limit_exceeded_mem_mgr (BtorMemMgr * mm);
+
+const char *btor_name_mem_kind (BtorMemKind kind);
+
 void *btor_malloc (BtorMemMgr * mm, size_t size);
 
 void *btor_realloc (BtorMemMgr * mm, void *, size_t oldsz, size_t newsz);
@@ -0,0 +1,284 @@
+/*  Boolector: Satisfiablity Modulo Theories (SMT) solver.
+ *  Copyright (C) 2010  Robert Daniel Brummayer, Armin Biere
+ *
+ *  This file is part of Boolector.
+ *
+ *  Boolector is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Boolector is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "btoroahash.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define BTOR_OA_GROUP_SIZE 16u
+#define BTOR_OA_EMPTY ((unsigned char) 0x80)
+
+/* The control byte of a full slot holds the upper 7 bits of the hash
+ * value, the lower bits select the group.  Empty slots have the most
+ * significant bit set.  The first 'BTOR_OA_GROUP_SIZE - 1' control bytes
+ * are mirrored behind the last one, such that every group can be loaded
+ * at once without wrapping around.
+ */
+#define BTOR_OA_H2(hash) ((unsigned char) ((hash) >> 25))
+
+static unsigned
+btor_hash_ptr_oa (const void * p)
+{
+  return 1183477 * (unsigned)(unsigned long) p;
+}
+
+static int
+btor_cmp_ptr_oa (const void * p, const void * q)
+{
+  return ((long)p) - ((long)q);
+}
+
+/* Hash functions in Boolector often only use few bits or are simple
+ * multiples of ids, thus we need to mix all bits into the upper ones.
+ */
+static unsigned
+btor_mix_hash_oa (unsigned h)
+{
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+/* Bit 'i' of the result is set iff control byte 'i' of the group
+ * starting at 'ctrl' is 'byte'.
+ */
+static unsigned
+btor_match_group_oa (const unsigned char * ctrl, unsigned char byte)
+{
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128 ((const __m128i *) ctrl);
+  return (unsigned) _mm_movemask_epi8 (
+           _mm_cmpeq_epi8 (group, _mm_set1_epi8 ((char) byte)));
+#else
+  unsigned i, res = 0;
+  for (i = 0; i < BTOR_OA_GROUP_SIZE; i++)
+    if (ctrl[i] == byte)
+      res |= 1u << i;
+  return res;
+#endif
+}
+
+static unsigned
+btor_match_empty_oa (const unsigned char * ctrl)
+{
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128 ((const __m128i *) ctrl);
+  return (unsigned) _mm_movemask_epi8 (group);
+#else
+  return btor_match_group_oa (ctrl, BTOR_OA_EMPTY);
+#endif
+}
+
+static unsigned
+btor_lowest_bit_oa (unsigned bits)
+{
+  assert (bits);
+#ifdef __GNUC__
+  return (unsigned) __builtin_ctz (bits);
+#else
+  {
+    unsigned res = 0;
+    while (!(bits & 1u))
+      bits >>= 1, res++;
+    return res;
+  }
+#endif
+}
+
+static void
+btor_set_ctrl_oa (BtorOAPtrHashTable * table, unsigned pos, unsigned char c)
+{
+  table->ctrl[pos] = c;
+  if (pos < BTOR_OA_GROUP_SIZE - 1)
+    table->ctrl[table->size + pos] = c;
+}
+
+/* Finds the first empty slot on the probe sequence of 'hash'. */
+static unsigned
+btor_find_empty_oa (BtorOAPtrHashTable * table, unsigned hash)
+{
+  unsigned pos, step, mask, bits;
+
+  mask = table->size - 1;
+  pos = hash & mask;
+  step = 0;
+
+  while (!(bits = btor_match_empty_oa (table->ctrl + pos)))
+    {
+      step += BTOR_OA_GROUP_SIZE;
+      assert (step <= table->size);
+      pos = (pos + step) & mask;
+    }
+
+  return (pos + btor_lowest_bit_oa (bits)) & mask;
+}
+
+/* Finds the slot of 'key'.  If it is not contained, the result is
+ * the first empty slot on the probe sequence of 'hash'.
+ */
+static unsigned
+btor_findpos_oa (BtorOAPtrHashTable * table, void * key, unsigned hash,
+                 int * found)
+{
+  unsigned pos, step, mask, bits, i;
+  unsigned char h2;
+  BtorOAPtrHashEntry *e;
+
+  assert (table->size >= BTOR_OA_GROUP_SIZE);
+
+  mask = table->size - 1;
+  h2 = BTOR_OA_H2 (hash);
+  pos = hash & mask;
+  step = 0;
+
+  for (;;)
+    {
+      bits = btor_match_group_oa (table->ctrl + pos, h2);
+      while (bits)
+        {
+          i = (pos + btor_lowest_bit_oa (bits)) & mask;
+          e = table->entries + table->slots[i];
+          if (e->hash == hash && !table->cmp (e->key, key))
+            {
+              *found = 1;
+              return i;
+            }
+          bits &= bits - 1;
+        }
+
+      bits = btor_match_empty_oa (table->ctrl + pos);
+      if (bits)
+        {
+          *found = 0;
+          return (pos + btor_lowest_bit_oa (bits)) & mask;
+        }
+
+      /* triangular probing visits every group exactly once */
+      step += BTOR_OA_GROUP_SIZE;
+      assert (step <= table->size);
+      pos = (pos + step) & mask;
+    }
+}
+
+static void
+btor_enlarge_oa_ptr_hash_table (BtorOAPtrHashTable * table)
+{
+  unsigned new_size, i, pos;
+
+  if (table->size)
+    {
+      BTOR_DELETEN (table->mem, table->ctrl,
+                    table->size + BTOR_OA_GROUP_SIZE - 1);
+      BTOR_DELETEN (table->mem, table->slots, table->size);
+    }
+
+  new_size = table->size ? 2 * table->size : BTOR_OA_GROUP_SIZE;
+  BTOR_NEWN (table->mem, table->ctrl, new_size + BTOR_OA_GROUP_SIZE - 1);
+  memset (table->ctrl, BTOR_OA_EMPTY, new_size + BTOR_OA_GROUP_SIZE - 1);
+  BTOR_NEWN (table->mem, table->slots, new_size);
+  table->size = new_size;
+
+  /* hash values are cached in the entries, keys are all different */
+  for (i = 0; i < table->count; i++)
+    {
+      pos = btor_find_empty_oa (table, table->entries[i].hash);
+      btor_set_ctrl_oa (table, pos, BTOR_OA_H2 (table->entries[i].hash));
+      table->slots[pos] = (int) i;
+    }
+}
+
+BtorOAPtrHashTable *
+btor_new_oa_ptr_hash_table (BtorMemMgr * mem, BtorHashPtr hash,
+                            BtorCmpPtr cmp)
+{
+  BtorOAPtrHashTable * res;
+
+  mem = BTOR_VIEW_MEM_MGR (mem, BTOR_MEM_HASH);
+  BTOR_NEW (mem, res);
+  BTOR_CLR (res);
+
+  res->mem = mem;
+  res->hash = hash ? hash : btor_hash_ptr_oa;
+  res->cmp = cmp ? cmp : btor_cmp_ptr_oa;
+
+  return res;
+}
+
+void
+btor_delete_oa_ptr_hash_table (BtorOAPtrHashTable * table)
+{
+  if (table->size)
+    {
+      BTOR_DELETEN (table->mem, table->ctrl,
+                    table->size + BTOR_OA_GROUP_SIZE - 1);
+      BTOR_DELETEN (table->mem, table->slots, table->size);
+    }
+  BTOR_DELETEN (table->mem, table->entries, table->entries_size);
+  BTOR_DELETE (table->mem, table);
+}
+
+BtorOAPtrHashEntry *
+btor_find_in_oa_ptr_hash_table (BtorOAPtrHashTable * table, void * key)
+{
+  unsigned pos;
+  int found;
+
+  if (!table->count)
+    return 0;
+
+  pos = btor_findpos_oa (table, key,
+                         btor_mix_hash_oa (table->hash (key)), &found);
+
+  return found ? table->entries + table->slots[pos] : 0;
+}
+
+BtorOAPtrHashEntry *
+btor_insert_in_oa_ptr_hash_table (BtorOAPtrHashTable * table, void * key)
+{
+  BtorOAPtrHashEntry * res;
+  unsigned hash, pos;
+  int found;
+
+  /* keep the load factor below 7/8 */
+  if (8 * (table->count + 1) > 7 * table->size)
+    btor_enlarge_oa_ptr_hash_table (table);
+
+  if (table->count == table->entries_size)
+    BTOR_ENLARGE (table->mem, table->entries, table->entries_size,
+                  table->entries_size);
+
+  hash = btor_mix_hash_oa (table->hash (key));
+  pos = btor_findpos_oa (table, key, hash, &found);
+  assert (!found);
+
+  res = table->entries + table->count;
+  res->key = key;
+  res->data.asPtr = 0;
+  res->hash = hash;
+
+  btor_set_ctrl_oa (table, pos, BTOR_OA_H2 (hash));
+  table->slots[pos] = (int) table->count++;
+
+  return res;
+}
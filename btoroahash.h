@@ -0,0 +1,89 @@
+/*  Boolector: Satisfiablity Modulo Theories (SMT) solver.
+ *  Copyright (C) 2010  Robert Daniel Brummayer, Armin Biere
+ *
+ *  This file is part of Boolector.
+ *
+ *  Boolector is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Boolector is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BTOROAHASH_H_INCLUDED
+#define BTOROAHASH_H_INCLUDED
+
+#include "btorhash.h"
+#include "btormem.h"
+
+/*------------------------------------------------------------------------*/
+/* PRIVATE INTERFACE                                                      */
+/*------------------------------------------------------------------------*/
+
+/* Open addressing variant of 'BtorPtrHashTable'. Slots are probed in
+ * groups of 16 using one control byte per slot (7 bits of the hash value
+ * or empty), which are compared with SSE2 if available. The entries
+ * themselves are stored in a dense array in insertion order, thus
+ * chronological iteration is a simple loop:
+ *
+ *   for (i = 0; i < table->count; i++)
+ *     ... table->entries[i].key ... table->entries[i].data ...
+ *
+ * Entries can not be removed. Pointers to entries are invalidated by
+ * the next insertion.  Hash values are cached in the entries, thus
+ * growing the table does not call the hash function again.
+ */
+typedef struct BtorOAPtrHashTable BtorOAPtrHashTable;
+typedef struct BtorOAPtrHashEntry BtorOAPtrHashEntry;
+
+struct BtorOAPtrHashEntry
+{
+  /* public:
+   */
+  void *key;
+
+  BtorPtrHashData data;
+
+  /* private:
+   */
+  unsigned hash;
+};
+
+struct BtorOAPtrHashTable
+{
+  BtorMemMgr *mem;
+
+  unsigned count;
+  BtorOAPtrHashEntry *entries;	/* chronologically */
+
+  /* private:
+   */
+  unsigned size;		/* number of slots */
+  unsigned char *ctrl;		/* control bytes */
+  int *slots;			/* slot to entry index */
+  unsigned entries_size;
+
+  BtorHashPtr hash;
+  BtorCmpPtr cmp;
+};
+
+BtorOAPtrHashTable *btor_new_oa_ptr_hash_table (BtorMemMgr *,
+                                                BtorHashPtr, BtorCmpPtr);
+
+void btor_delete_oa_ptr_hash_table (BtorOAPtrHashTable *);
+
+BtorOAPtrHashEntry *btor_find_in_oa_ptr_hash_table (BtorOAPtrHashTable *,
+                                                    void *key);
+
+/* The key must not be an element of the hash table yet. */
+BtorOAPtrHashEntry *btor_insert_in_oa_ptr_hash_table (BtorOAPtrHashTable *,
+                                                      void *key);
+
+#endif
@@ -18,3 +18,338 @@
  */
 
 #include "btorrand.h"
+#include "btorconst.h"
+#include "btormem.h"
+#include "btorstack.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+/*------------------------------------------------------------------------*/
+/* BEGIN OF DECLARATIONS                                                  */
+/*------------------------------------------------------------------------*/
+
+struct BtorRand
+{
+  unsigned state;
+};
+
+/*------------------------------------------------------------------------*/
+/* END OF DECLARATIONS                                                    */
+/*------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------*/
+/* BEGIN OF IMPLEMENTATION                                                */
+/*------------------------------------------------------------------------*/
+
+BtorRand *
+btor_new_rand (BtorMemMgr * mm, unsigned seed)
+{
+  BtorRand *result;
+  assert (mm != NULL);
+  BTOR_NEW (mm, result);
+  result->state = seed;
+  return result;
+}
+
+void
+btor_delete_rand (BtorMemMgr * mm, BtorRand * rand)
+{
+  assert (mm != NULL);
+  assert (rand != NULL);
+  BTOR_DELETE (mm, rand);
+}
+
+static unsigned
+next_rand (BtorRand * rand)
+{
+  assert (rand != NULL);
+  rand->state = rand->state * 1664525u + 1013904223u;
+  return rand->state >> 8;
+}
+
+static unsigned
+pick_rand (BtorRand * rand, unsigned n)
+{
+  assert (n > 0);
+  return next_rand (rand) % n;
+}
+
+static BtorExp *
+pick_exp (BtorRand * rand, BtorExpPtrStack * stack)
+{
+  assert (!BTOR_EMPTY_STACK (*stack));
+  return stack->start[pick_rand (rand, BTOR_COUNT_STACK (*stack))];
+}
+
+/* picks an expression different from 'other' if there is one */
+static BtorExp *
+pick_other_exp (BtorRand * rand, BtorExpPtrStack * stack, BtorExp * other)
+{
+  BtorExp *result;
+  int i;
+  for (i = 0; i < 8; i++)
+    if ((result = pick_exp (rand, stack)) != other)
+      return result;
+  return result;
+}
+
+static BtorExp *
+rand_const_exp (Btor * btor, BtorRand * rand, int width)
+{
+  BtorExp *result;
+  char *bits;
+  int i;
+  assert (width > 0);
+  BTOR_NEWN (btor->mm, bits, width + 1);
+  for (i = 0; i < width; i++)
+    bits[i] = (next_rand (rand) & 1) ? '1' : '0';
+  bits[width] = '\0';
+  result = btor_const_exp (btor, bits);
+  BTOR_DELETEN (btor->mm, bits, width + 1);
+  return result;
+}
+
+/* adjusts the bit width of 'exp' to 'width' by slicing or zero extension */
+static BtorExp *
+resize_exp (Btor * btor, BtorExp * exp, int width)
+{
+  int len;
+  len = BTOR_REAL_ADDR_EXP (exp)->len;
+  if (len > width)
+    return btor_slice_exp (btor, exp, width - 1, 0);
+  if (len < width)
+    return btor_uext_exp (btor, exp, width - len);
+  return btor_copy_exp (btor, exp);
+}
+
+static BtorExp *
+rand_pred_exp (Btor * btor, BtorRand * rand, BtorRandExpParams * params,
+               BtorExpPtrStack * data, BtorExpPtrStack * arrays)
+{
+  BtorExp *e0, *e1;
+
+  if (BTOR_COUNT_STACK (*arrays) > 1 && !pick_rand (rand, 8))
+    {
+      e0 = pick_exp (rand, arrays);
+      e1 = pick_other_exp (rand, arrays, e0);
+      return btor_eq_exp (btor, e0, e1);
+    }
+
+  e0 = pick_exp (rand, data);
+  e1 = pick_other_exp (rand, data, e0);
+  if (params->equations)
+    return btor_eq_exp (btor, e0, e1);
+
+  switch (pick_rand (rand, 5))
+    {
+    case 0:
+      return btor_eq_exp (btor, e0, e1);
+    case 1:
+      return btor_ne_exp (btor, e0, e1);
+    case 2:
+      return btor_ult_exp (btor, e0, e1);
+    case 3:
+      return btor_slt_exp (btor, e0, e1);
+    default:
+      return btor_ulte_exp (btor, e0, e1);
+    }
+}
+
+static BtorExp *
+rand_term_exp (Btor * btor, BtorRand * rand, BtorRandExpParams * params,
+               BtorExpPtrStack * data, BtorExpPtrStack * arrays)
+{
+  BtorExp *e0, *e1, *cond, *index, *result;
+  int width;
+
+  width = (int) params->width.data;
+  e0 = pick_exp (rand, data);
+  e1 = pick_other_exp (rand, data, e0);
+
+  if (!BTOR_EMPTY_STACK (*arrays) && !pick_rand (rand, 4))
+    {
+      index = resize_exp (btor, e1, (int) params->width.address);
+      result = btor_read_exp (btor, pick_exp (rand, arrays), index);
+      btor_release_exp (btor, index);
+      return result;
+    }
+
+  if (!pick_rand (rand, 8))
+    {
+      cond = rand_pred_exp (btor, rand, params, data, arrays);
+      result = btor_cond_exp (btor, cond, e0, e1);
+      btor_release_exp (btor, cond);
+      return result;
+    }
+
+  if (params->linear)
+    {
+      switch (pick_rand (rand, 4))
+        {
+        case 0:
+          return btor_add_exp (btor, e0, e1);
+        case 1:
+          return btor_sub_exp (btor, e0, e1);
+        case 2:
+          return btor_neg_exp (btor, e0);
+        default:
+          e1 = rand_const_exp (btor, rand, width);
+          result = btor_mul_exp (btor, e0, e1);
+          btor_release_exp (btor, e1);
+          return result;
+        }
+    }
+
+  switch (pick_rand (rand, 11))
+    {
+    case 0:
+      return btor_add_exp (btor, e0, e1);
+    case 1:
+      return btor_sub_exp (btor, e0, e1);
+    case 2:
+      return btor_and_exp (btor, e0, e1);
+    case 3:
+      return btor_or_exp (btor, e0, e1);
+    case 4:
+      return btor_xor_exp (btor, e0, e1);
+    case 5:
+    case 6:
+      return btor_mul_exp (btor, e0, e1);
+    case 7:
+      return btor_udiv_exp (btor, e0, e1);
+    case 8:
+      return btor_urem_exp (btor, e0, e1);
+    case 9:
+      return btor_sdiv_exp (btor, e0, e1);
+    default:
+      return btor_srem_exp (btor, e0, e1);
+    }
+}
+
+/* Generates a random formula.  Terms are combined from previous terms,
+ * variables and constants.  With 'write' set, writes are stacked on the
+ * most recent array, which results in long write chains.  The formula is
+ * the conjunction of 'formulas' random boolean combinations of predicates
+ * (or of all predicates if 'formulas' is zero).
+ */
+BtorExp *
+btor_new_rand_exp (Btor * btor, BtorRand * rand, BtorRandExpParams * params)
+{
+  BtorExpPtrStack data, arrays, preds, formulas;
+  BtorExp *exp, *e0, *e1, *index, *result;
+  BtorMemMgr *mm;
+  char name[32];
+  unsigned i;
+
+  assert (btor != NULL);
+  assert (rand != NULL);
+  assert (params != NULL);
+  assert (params->width.data > 0);
+  assert (params->arrays == 0 || params->width.address > 0);
+
+  mm = btor->mm;
+  BTOR_INIT_STACK (data);
+  BTOR_INIT_STACK (arrays);
+  BTOR_INIT_STACK (preds);
+  BTOR_INIT_STACK (formulas);
+
+  for (i = 0; i < params->constants; i++)
+    BTOR_PUSH_STACK (mm, data,
+                     rand_const_exp (btor, rand, (int) params->width.data));
+
+  for (i = 0; i < params->variables || BTOR_EMPTY_STACK (data); i++)
+    {
+      sprintf (name, "v%u", i);
+      BTOR_PUSH_STACK (mm, data,
+                       btor_var_exp (btor, (int) params->width.data, name));
+    }
+
+  for (i = 0; i < params->arrays; i++)
+    {
+      sprintf (name, "a%u", i);
+      BTOR_PUSH_STACK (mm, arrays,
+                       btor_array_exp (btor, (int) params->width.data,
+                                       (int) params->width.address, name));
+    }
+
+  for (i = 0; i < params->terms; i++)
+    {
+      if (params->write && !BTOR_EMPTY_STACK (arrays) && !pick_rand (rand, 4))
+        {
+          index = resize_exp (btor, pick_exp (rand, &data),
+                              (int) params->width.address);
+          exp = btor_write_exp (btor, arrays.top[-1], index,
+                                pick_exp (rand, &data));
+          btor_release_exp (btor, index);
+          BTOR_PUSH_STACK (mm, arrays, exp);
+        }
+      else
+        {
+          exp = rand_term_exp (btor, rand, params, &data, &arrays);
+          BTOR_PUSH_STACK (mm, data, exp);
+        }
+    }
+
+  for (i = 0; i < params->predicates || BTOR_EMPTY_STACK (preds); i++)
+    {
+      exp = rand_pred_exp (btor, rand, params, &data, &arrays);
+      BTOR_PUSH_STACK (mm, preds, exp);
+    }
+
+  for (i = 0; i < params->formulas; i++)
+    {
+      e0 = pick_exp (rand, &preds);
+      e1 = pick_other_exp (rand, &preds, e0);
+      if (next_rand (rand) & 1)
+        e0 = BTOR_INVERT_EXP (e0);
+      /* disjunctions keep conjunctions of many formulas satisfiable */
+      switch (pick_rand (rand, 6))
+        {
+        case 0:
+          exp = btor_and_exp (btor, e0, e1);
+          break;
+        case 1:
+          exp = btor_xor_exp (btor, e0, e1);
+          break;
+        case 2:
+        case 3:
+          exp = btor_or_exp (btor, e0, e1);
+          break;
+        default:
+          exp = btor_implies_exp (btor, e0, e1);
+          break;
+        }
+      BTOR_PUSH_STACK (mm, preds, exp);
+      BTOR_PUSH_STACK (mm, formulas, exp);
+    }
+
+  if (BTOR_EMPTY_STACK (formulas))
+    for (i = 0; i < (unsigned) BTOR_COUNT_STACK (preds); i++)
+      BTOR_PUSH_STACK (mm, formulas, preds.start[i]);
+
+  result = btor_copy_exp (btor, formulas.start[0]);
+  for (i = 1; i < (unsigned) BTOR_COUNT_STACK (formulas); i++)
+    {
+      exp = btor_and_exp (btor, result, formulas.start[i]);
+      btor_release_exp (btor, result);
+      result = exp;
+    }
+
+  while (!BTOR_EMPTY_STACK (data))
+    btor_release_exp (btor, BTOR_POP_STACK (data));
+  while (!BTOR_EMPTY_STACK (arrays))
+    btor_release_exp (btor, BTOR_POP_STACK (arrays));
+  while (!BTOR_EMPTY_STACK (preds))
+    btor_release_exp (btor, BTOR_POP_STACK (preds));
+  BTOR_RELEASE_STACK (mm, data);
+  BTOR_RELEASE_STACK (mm, arrays);
+  BTOR_RELEASE_STACK (mm, preds);
+  BTOR_RELEASE_STACK (mm, formulas);
+
+  return result;
+}
+
+/*------------------------------------------------------------------------*/
+/* END OF IMPLEMENTATION                                                  */
+/*------------------------------------------------------------------------*/
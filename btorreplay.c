@@ -0,0 +1,547 @@
+/*  Boolector: Satisfiablity Modulo Theories (SMT) solver.
+ *  Copyright (C) 2010  Robert Daniel Brummayer, Armin Biere
+ *
+ *  This file is part of Boolector.
+ *
+ *  Boolector is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Boolector is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Re-executes a log of public interface calls written by
+ * 'boolector_set_api_trace' (or with 'BTORAPITRACE' set) and reports the
+ * time spent per function.  Expressions of the log are mapped to the
+ * expressions returned during the replay.  Since expression construction
+ * is deterministic the replayed expressions get the same ids and the
+ * replayed results should be the same as the logged ones.  Differences
+ * are counted as diverging results.
+ */
+
+#include "boolector.h"
+#include "btorapitrace.h"
+#include "btorexp.h"
+#include "btormem.h"
+#include "btorutil.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+typedef BtorExp *(*BtorUnaryFun) (Btor *, BtorExp *);
+typedef BtorExp *(*BtorBinaryFun) (Btor *, BtorExp *, BtorExp *);
+
+typedef struct BtorReplay BtorReplay;
+
+struct BtorReplay
+{
+  BtorMemMgr *mm;
+  Btor *btor;
+  BtorExp **exps;               /* replayed expressions by logged id */
+  int size;
+  FILE *sink;                   /* output of dumps */
+  int calls;
+  int diverged;
+  int verbose;
+  struct
+  {
+    int calls;
+    double time;
+    double max;
+  } ops[BTOR_API_NUM_OPS];
+};
+
+static const char *g_usage =
+  "usage: btorreplay [<option> ...] <trace>\n"
+  "\n"
+  "  -h|--help       print this message and exit\n"
+  "  -v              print every call with its time\n";
+
+static void
+die (const char *fmt, ...)
+{
+  va_list ap;
+  fputs ("*** btorreplay: ", stdout);
+  va_start (ap, fmt);
+  vfprintf (stdout, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stdout);
+  exit (1);
+}
+
+static void
+msg (const char *fmt, ...)
+{
+  va_list ap;
+  fputs ("[btorreplay] ", stdout);
+  va_start (ap, fmt);
+  vfprintf (stdout, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stdout);
+  fflush (stdout);
+}
+
+static BtorExp *
+exp_arg (BtorReplay * replay, unsigned code)
+{
+  BtorExp *exp;
+  int id;
+  id = (int) (code >> 1);
+  if (id >= replay->size || replay->exps[id] == NULL)
+    die ("call %d uses unknown expression %d", replay->calls, id);
+  exp = replay->exps[id];
+  return (code & 1u) ? BTOR_INVERT_EXP (exp) : exp;
+}
+
+/* Maps the logged result to the replayed one. */
+static void
+map_exp_result (BtorReplay * replay, unsigned code, BtorExp * exp)
+{
+  int id, new_size;
+  id = (int) (code >> 1);
+  if (id >= replay->size)
+    {
+      new_size = replay->size ? replay->size : 1024;
+      while (new_size <= id)
+        new_size *= 2;
+      BTOR_REALLOC (replay->mm, replay->exps, replay->size, new_size);
+      memset (replay->exps + replay->size, 0,
+              (new_size - replay->size) * sizeof *replay->exps);
+      replay->size = new_size;
+    }
+  replay->exps[id] = (code & 1u) ? BTOR_INVERT_EXP (exp) : exp;
+  if (BTOR_REAL_ADDR_EXP (exp)->id != id
+      || BTOR_IS_INVERTED_EXP (exp) != (int) (code & 1u))
+    replay->diverged++;
+}
+
+static BtorUnaryFun
+unary_fun (BtorApiOp op)
+{
+  switch (op)
+    {
+    case BTOR_API_NOT:
+      return boolector_not;
+    case BTOR_API_NEG:
+      return boolector_neg;
+    case BTOR_API_REDOR:
+      return boolector_redor;
+    case BTOR_API_REDXOR:
+      return boolector_redxor;
+    case BTOR_API_REDAND:
+      return boolector_redand;
+    case BTOR_API_INC:
+      return boolector_inc;
+    case BTOR_API_DEC:
+      return boolector_dec;
+    case BTOR_API_COPY:
+      return boolector_copy;
+    default:
+      return NULL;
+    }
+}
+
+static BtorBinaryFun
+binary_fun (BtorApiOp op)
+{
+  switch (op)
+    {
+    case BTOR_API_IMPLIES:
+      return boolector_implies;
+    case BTOR_API_IFF:
+      return boolector_iff;
+    case BTOR_API_XOR:
+      return boolector_xor;
+    case BTOR_API_XNOR:
+      return boolector_xnor;
+    case BTOR_API_AND:
+      return boolector_and;
+    case BTOR_API_NAND:
+      return boolector_nand;
+    case BTOR_API_OR:
+      return boolector_or;
+    case BTOR_API_NOR:
+      return boolector_nor;
+    case BTOR_API_EQ:
+      return boolector_eq;
+    case BTOR_API_NE:
+      return boolector_ne;
+    case BTOR_API_ADD:
+      return boolector_add;
+    case BTOR_API_UADDO:
+      return boolector_uaddo;
+    case BTOR_API_SADDO:
+      return boolector_saddo;
+    case BTOR_API_MUL:
+      return boolector_mul;
+    case BTOR_API_UMULO:
+      return boolector_umulo;
+    case BTOR_API_SMULO:
+      return boolector_smulo;
+    case BTOR_API_ULT:
+      return boolector_ult;
+    case BTOR_API_SLT:
+      return boolector_slt;
+    case BTOR_API_ULTE:
+      return boolector_ulte;
+    case BTOR_API_SLTE:
+      return boolector_slte;
+    case BTOR_API_UGT:
+      return boolector_ugt;
+    case BTOR_API_SGT:
+      return boolector_sgt;
+    case BTOR_API_UGTE:
+      return boolector_ugte;
+    case BTOR_API_SGTE:
+      return boolector_sgte;
+    case BTOR_API_SLL:
+      return boolector_sll;
+    case BTOR_API_SRL:
+      return boolector_srl;
+    case BTOR_API_SRA:
+      return boolector_sra;
+    case BTOR_API_ROL:
+      return boolector_rol;
+    case BTOR_API_ROR:
+      return boolector_ror;
+    case BTOR_API_SUB:
+      return boolector_sub;
+    case BTOR_API_USUBO:
+      return boolector_usubo;
+    case BTOR_API_SSUBO:
+      return boolector_ssubo;
+    case BTOR_API_UDIV:
+      return boolector_udiv;
+    case BTOR_API_SDIV:
+      return boolector_sdiv;
+    case BTOR_API_SDIVO:
+      return boolector_sdivo;
+    case BTOR_API_UREM:
+      return boolector_urem;
+    case BTOR_API_SREM:
+      return boolector_srem;
+    case BTOR_API_SMOD:
+      return boolector_smod;
+    case BTOR_API_CONCAT:
+      return boolector_concat;
+    case BTOR_API_READ:
+      return boolector_read;
+    default:
+      return NULL;
+    }
+}
+
+static void
+free_array_assignment (Btor * btor, char **indices, char **values, int size)
+{
+  int i;
+  if (size == 0)
+    return;
+  for (i = 0; i < size; i++)
+    {
+      boolector_free_bv_assignment (btor, indices[i]);
+      boolector_free_bv_assignment (btor, values[i]);
+    }
+  BTOR_DELETEN (btor->mm, indices, size);
+  BTOR_DELETEN (btor->mm, values, size);
+}
+
+/* Executes one call and returns its result, which is either an expression
+ * or an integer depending on the signature of the operation.
+ */
+static BtorApiArg
+execute_call (BtorReplay * replay, BtorApiCall * call, BtorExp ** res)
+{
+  char **indices, **values, *assignment;
+  BtorApiArg *args, result;
+  BtorUnaryFun unary;
+  BtorBinaryFun binary;
+  Btor *btor;
+  int size;
+
+  btor = replay->btor;
+  args = call->args;
+  result.i = 0;
+  *res = NULL;
+
+  if ((unary = unary_fun (call->op)))
+    {
+      *res = unary (btor, exp_arg (replay, args[0].exp));
+      return result;
+    }
+
+  if ((binary = binary_fun (call->op)))
+    {
+      *res = binary (btor, exp_arg (replay, args[0].exp),
+                     exp_arg (replay, args[1].exp));
+      return result;
+    }
+
+  switch (call->op)
+    {
+    case BTOR_API_ENABLE_MODEL_GEN:
+      boolector_enable_model_gen (btor);
+      break;
+    case BTOR_API_ENABLE_INC_USAGE:
+      boolector_enable_inc_usage (btor);
+      break;
+    case BTOR_API_SET_REWRITE_LEVEL:
+      boolector_set_rewrite_level (btor, args[0].i);
+      break;
+    case BTOR_API_SET_READ_OVER_WRITE_LIMIT:
+      boolector_set_read_over_write_limit (btor, args[0].i);
+      break;
+    case BTOR_API_SET_WRITE_CHAIN_BOUND:
+      boolector_set_write_chain_bound (btor, args[0].i);
+      break;
+    case BTOR_API_SET_MEMORY_LIMIT:
+      boolector_set_memory_limit (btor, args[0].i);
+      break;
+    case BTOR_API_ENABLE_THREAD_SAFETY:
+      /* calls are replayed in the logged order by a single thread */
+      break;
+    case BTOR_API_GET_REFS:
+      result.i = boolector_get_refs (btor);
+      break;
+    case BTOR_API_DELETE:
+      boolector_delete (btor);
+      replay->btor = NULL;
+      break;
+    case BTOR_API_CONST:
+      *res = boolector_const (btor, args[0].str);
+      break;
+    case BTOR_API_ZERO:
+      *res = boolector_zero (btor, args[0].i);
+      break;
+    case BTOR_API_FALSE:
+      *res = boolector_false (btor);
+      break;
+    case BTOR_API_ONES:
+      *res = boolector_ones (btor, args[0].i);
+      break;
+    case BTOR_API_TRUE:
+      *res = boolector_true (btor);
+      break;
+    case BTOR_API_ONE:
+      *res = boolector_one (btor, args[0].i);
+      break;
+    case BTOR_API_UNSIGNED_INT:
+      *res = boolector_unsigned_int (btor, args[0].u, args[1].i);
+      break;
+    case BTOR_API_INT:
+      *res = boolector_int (btor, args[0].i, args[1].i);
+      break;
+    case BTOR_API_VAR:
+      *res = boolector_var (btor, args[0].i, args[1].str);
+      break;
+    case BTOR_API_ARRAY:
+      *res = boolector_array (btor, args[0].i, args[1].i, args[2].str);
+      break;
+    case BTOR_API_SLICE:
+      *res = boolector_slice (btor, exp_arg (replay, args[0].exp),
+                              args[1].i, args[2].i);
+      break;
+    case BTOR_API_UEXT:
+      *res = boolector_uext (btor, exp_arg (replay, args[0].exp), args[1].i);
+      break;
+    case BTOR_API_SEXT:
+      *res = boolector_sext (btor, exp_arg (replay, args[0].exp), args[1].i);
+      break;
+    case BTOR_API_WRITE:
+      *res = boolector_write (btor, exp_arg (replay, args[0].exp),
+                              exp_arg (replay, args[1].exp),
+                              exp_arg (replay, args[2].exp));
+      break;
+    case BTOR_API_COND:
+      *res = boolector_cond (btor, exp_arg (replay, args[0].exp),
+                             exp_arg (replay, args[1].exp),
+                             exp_arg (replay, args[2].exp));
+      break;
+    case BTOR_API_GET_WIDTH:
+      result.i = boolector_get_width (btor, exp_arg (replay, args[0].exp));
+      break;
+    case BTOR_API_IS_ARRAY:
+      result.i = boolector_is_array (btor, exp_arg (replay, args[0].exp));
+      break;
+    case BTOR_API_GET_INDEX_WIDTH:
+      /* 'boolector_get_index_width' is not exported under this name */
+      result.i = btor_get_index_exp_len (btor,
+                                         btor_pointer_chase_simplified_exp
+                                         (btor,
+                                          exp_arg (replay, args[0].exp)));
+      break;
+    case BTOR_API_GET_SYMBOL_OF_VAR:
+      (void) boolector_get_symbol_of_var (btor,
+                                          exp_arg (replay, args[0].exp));
+      break;
+    case BTOR_API_RELEASE:
+      boolector_release (btor, exp_arg (replay, args[0].exp));
+      break;
+    case BTOR_API_DUMP_BTOR:
+      boolector_dump_btor (btor, replay->sink, exp_arg (replay, args[0].exp));
+      break;
+    case BTOR_API_DUMP_SMT:
+      boolector_dump_smt (btor, replay->sink, exp_arg (replay, args[0].exp));
+      break;
+    case BTOR_API_ASSERT:
+      boolector_assert (btor, exp_arg (replay, args[0].exp));
+      break;
+    case BTOR_API_ASSUME:
+      boolector_assume (btor, exp_arg (replay, args[0].exp));
+      break;
+    case BTOR_API_SAT:
+      result.i = boolector_sat (btor);
+      break;
+    case BTOR_API_RESTART_SAT:
+      boolector_restart_sat (btor);
+      break;
+    case BTOR_API_GET_STATS:
+      (void) boolector_get_stats (btor);
+      break;
+    case BTOR_API_BV_ASSIGNMENT:
+      assignment =
+        boolector_bv_assignment (btor, exp_arg (replay, args[0].exp));
+      boolector_free_bv_assignment (btor, assignment);
+      break;
+    default:
+      assert (call->op == BTOR_API_ARRAY_ASSIGNMENT);
+      boolector_array_assignment (btor, exp_arg (replay, args[0].exp),
+                                  &indices, &values, &size);
+      free_array_assignment (btor, indices, values, size);
+      break;
+    }
+  return result;
+}
+
+static BtorReplay *g_replay;
+
+static int
+cmp_ops (const void *p, const void *q)
+{
+  int a = *(const int *) p, b = *(const int *) q;
+  if (g_replay->ops[a].time > g_replay->ops[b].time)
+    return -1;
+  if (g_replay->ops[a].time < g_replay->ops[b].time)
+    return 1;
+  return a - b;
+}
+
+/* Prints calls, total and maximum time per function, slowest first. */
+static void
+report (BtorReplay * replay, double total)
+{
+  int order[BTOR_API_NUM_OPS], i, n;
+  n = 0;
+  for (i = BTOR_API_INVALID + 1; i < BTOR_API_NUM_OPS; i++)
+    if (replay->ops[i].calls)
+      order[n++] = i;
+  g_replay = replay;
+  qsort (order, n, sizeof *order, cmp_ops);
+  msg ("replayed %d calls in %.3f seconds", replay->calls, total);
+  msg ("diverging results: %d", replay->diverged);
+  msg ("%9s %10s %10s  %s", "calls", "seconds", "max", "function");
+  for (i = 0; i < n; i++)
+    msg ("%9d %10.3f %10.6f  %s", replay->ops[order[i]].calls,
+         replay->ops[order[i]].time, replay->ops[order[i]].max,
+         btor_name_api_op ((BtorApiOp) order[i]));
+}
+
+int
+main (int argc, char **argv)
+{
+  double start, delta, total;
+  const char *name;
+  BtorApiReader *reader;
+  BtorReplay replay;
+  BtorApiArg result, logged;
+  BtorApiCall call;
+  BtorExp *exp;
+  FILE *file;
+  int i, res;
+
+  memset (&replay, 0, sizeof replay);
+  name = NULL;
+  for (i = 1; i < argc; i++)
+    {
+      if (!strcmp (argv[i], "-h") || !strcmp (argv[i], "--help"))
+        {
+          fputs (g_usage, stdout);
+          exit (0);
+        }
+      else if (!strcmp (argv[i], "-v"))
+        replay.verbose = 1;
+      else if (argv[i][0] == '-')
+        die ("invalid option '%s' (try '-h')", argv[i]);
+      else if (name)
+        die ("multiple traces '%s' and '%s'", name, argv[i]);
+      else
+        name = argv[i];
+    }
+  if (!name)
+    die ("no trace specified (try '-h')");
+  if (!(file = fopen (name, "rb")))
+    die ("can not read '%s'", name);
+
+  replay.mm = btor_new_mem_mgr ();
+  if (!(reader = btor_new_api_reader (replay.mm, file)))
+    die ("'%s' is not an API trace", name);
+  if (!(replay.sink = fopen ("/dev/null", "w")))
+    die ("can not open '/dev/null'");
+
+  replay.btor = boolector_new ();
+  total = 0;
+  while ((res = btor_read_api_call (reader, &call)) > 0)
+    {
+      if (!replay.btor)
+        die ("call %d after 'delete'", replay.calls + 1);
+      replay.calls++;
+      start = btor_monotonic_time_stamp ();
+      result = execute_call (&replay, &call, &exp);
+      delta = btor_monotonic_time_stamp () - start;
+      total += delta;
+      replay.ops[call.op].calls++;
+      replay.ops[call.op].time += delta;
+      if (delta > replay.ops[call.op].max)
+        replay.ops[call.op].max = delta;
+      if (replay.verbose)
+        msg ("%d %s %.6f", replay.calls, btor_name_api_op (call.op), delta);
+      if (!strchr (btor_signature_api_op (call.op), ':'))
+        continue;
+      if (!btor_read_api_result (reader, &logged))
+        {
+          msg ("call %d (%s) did not return in the traced run",
+               replay.calls, btor_name_api_op (call.op));
+          break;
+        }
+      if (exp)
+        map_exp_result (&replay, logged.exp, exp);
+      else if (result.i != logged.i)
+        {
+          msg ("call %d (%s) returned %d instead of %d", replay.calls,
+               btor_name_api_op (call.op), result.i, logged.i);
+          replay.diverged++;
+        }
+    }
+  if (res < 0)
+    die ("corrupted trace after call %d", replay.calls);
+
+  report (&replay, total);
+
+  /* an instance which has not been deleted in the traced run is kept */
+  fclose (replay.sink);
+  fclose (file);
+  btor_delete_api_reader (reader);
+  BTOR_DELETEN (replay.mm, replay.exps, replay.size);
+  btor_delete_mem_mgr (replay.mm);
+  return 0;
+}
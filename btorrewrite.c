@@ -27,31 +27,58 @@
 /* recursive rewriting bound */
 #define BTOR_REC_RW_BOUND 4096
 
-/* iterative rewriting bounds */
-#define BTOR_WRITE_CHAIN_EXP_RW_BOUND 20
-#define BTOR_READ_OVER_WRITE_DOWN_PROPAGATION_LIMIT 1024
-
 /* other rewriting bounds */
 #define BTOR_FIND_AND_EXP_CONTRADICTION_LIMIT 8
 
+/* number of entries of the direct mapped rewrite cache */
+#define BTOR_RW_CACHE_SIZE (1 << 14)
+
+/* Rewrite results are cached by operator, signed ids of the children and
+ * slice bounds. Ids are never reused, thus the children do not have to be
+ * referenced, but the result is. Entries of older epochs are stale, since
+ * simplifications have happened in between.
+ */
+struct BtorRWCacheEntry
+{
+  BtorExp *result;              /* NULL if unused */
+  BtorExpKind kind;
+  int ids[3];
+  int upper;
+  int lower;
+  int epoch;
+};
+
+#ifdef BTOR_THREADS
+/* Threads sharing an instance rewrite concurrently, hence the recursion
+ * depth of the rewriter is tracked per thread.
+ */
+static __thread int btor_rec_rw_calls;
+#define BTOR_REC_RW_CALLS(btor) btor_rec_rw_calls
+#else
+#define BTOR_REC_RW_CALLS(btor) ((btor)->rec_rw_calls)
+#endif
+
 #define BTOR_INC_REC_RW_CALL(btor) \
   do { \
-    (btor)->rec_rw_calls++; \
-    if ((btor)->rec_rw_calls > (btor)->stats.max_rec_rw_calls) \
-      (btor)->stats.max_rec_rw_calls = (btor)->rec_rw_calls; \
+    BTOR_REC_RW_CALLS (btor)++; \
+    BTOR_LOCK_EXP (btor); \
+    if (BTOR_REC_RW_CALLS (btor) > (btor)->stats.max_rec_rw_calls) \
+      (btor)->stats.max_rec_rw_calls = BTOR_REC_RW_CALLS (btor); \
+    BTOR_UNLOCK_EXP (btor); \
   } while (0)
 
 
 #define BTOR_DEC_REC_RW_CALL(btor) \
   do { \
-    assert ((btor)->rec_rw_calls > 0); \
-    (btor)->rec_rw_calls--; \
+    assert (BTOR_REC_RW_CALLS (btor) > 0); \
+    BTOR_REC_RW_CALLS (btor)--; \
   } while (0)
 
 static int
 is_const_one_exp (Btor * btor, BtorExp * exp)
 {
   int result;
+  char *bits;
   BtorExp *real_exp;
 
   assert (btor != NULL);
@@ -63,10 +90,14 @@ is_const_one_exp (Btor * btor, BtorExp * exp)
 
   real_exp = BTOR_REAL_ADDR_EXP (exp);
   if (BTOR_IS_INVERTED_EXP (exp))
-    btor_invert_const (btor->mm, real_exp->bits);
-  result = btor_is_special_const (real_exp->bits) == BTOR_SPECIAL_CONST_ONE;
-  if (BTOR_IS_INVERTED_EXP (exp))
-    btor_invert_const (btor->mm, real_exp->bits);
+    {
+      /* do not invert the shared constant in place */
+      bits = btor_not_const (btor->mm, real_exp->bits);
+      result = btor_is_special_const (bits) == BTOR_SPECIAL_CONST_ONE;
+      btor_delete_const (btor->mm, bits);
+    }
+  else
+    result = btor_is_special_const (real_exp->bits) == BTOR_SPECIAL_CONST_ONE;
 
   return result;
 }
@@ -75,6 +106,7 @@ static int
 is_const_zero_exp (Btor * btor, BtorExp * exp)
 {
   int result;
+  char *bits;
   BtorExp *real_exp;
 
   assert (btor != NULL);
@@ -86,10 +118,14 @@ is_const_zero_exp (Btor * btor, BtorExp * exp)
 
   real_exp = BTOR_REAL_ADDR_EXP (exp);
   if (BTOR_IS_INVERTED_EXP (exp))
-    btor_invert_const (btor->mm, real_exp->bits);
-  result = btor_is_special_const (real_exp->bits) == BTOR_SPECIAL_CONST_ZERO;
-  if (BTOR_IS_INVERTED_EXP (exp))
-    btor_invert_const (btor->mm, real_exp->bits);
+    {
+      /* do not invert the shared constant in place */
+      bits = btor_not_const (btor->mm, real_exp->bits);
+      result = btor_is_special_const (bits) == BTOR_SPECIAL_CONST_ZERO;
+      btor_delete_const (btor->mm, bits);
+    }
+  else
+    result = btor_is_special_const (real_exp->bits) == BTOR_SPECIAL_CONST_ZERO;
 
   return result;
 }
@@ -185,13 +221,13 @@ compute_slice_3vl (Btor * btor, BtorExp * e0, int upper, int lower)
   if (BTOR_IS_INVERTED_EXP (e0))
     {
       invert_e0 = 1;
-      btor_invert_const_3vl (mm, b0);
+      b0 = btor_not_const_3vl (mm, b0);
     }
 
   result = btor_slice_const_3vl (mm, b0, upper, lower);
 
   if (invert_e0)
-    btor_invert_const_3vl (mm, b0);
+    btor_delete_const (mm, b0);
 
   return result;
 
@@ -224,6 +260,8 @@ slice_exp_node_3vl (Btor * btor, BtorExp * exp, int upper, int lower)
     }
 #endif
 
+  /* other threads only see the node together with its 3vl bits */
+  BTOR_LOCK_EXP (btor);
   result = btor_slice_exp_node (btor, exp, upper, lower);
   assert (result != NULL);
 
@@ -243,12 +281,13 @@ slice_exp_node_3vl (Btor * btor, BtorExp * exp, int upper, int lower)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
 
-BtorExp *
-btor_rewrite_slice_exp (Btor * btor, BtorExp * exp, int upper, int lower)
+static BtorExp *
+rewrite_slice_exp (Btor * btor, BtorExp * exp, int upper, int lower)
 {
   char *bits = NULL;
   int len;
@@ -289,7 +328,7 @@ btor_rewrite_slice_exp (Btor * btor, BtorExp * exp, int upper, int lower)
     }
   else if (real_exp->kind == BTOR_SLICE_EXP)
     { 
-      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	goto BTOR_REWRITE_SLICE_EXP_NO_REWRITE;
       BTOR_INC_REC_RW_CALL (btor);
       result = btor_rewrite_slice_exp (btor, 
@@ -329,7 +368,7 @@ btor_rewrite_slice_exp (Btor * btor, BtorExp * exp, int upper, int lower)
 	  len = BTOR_REAL_ADDR_EXP (real_exp->e[1])->len;
           if (lower >= len)
             {
-	      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		goto BTOR_REWRITE_SLICE_EXP_NO_REWRITE;
 	      BTOR_INC_REC_RW_CALL (btor);
 	      result = btor_rewrite_slice_exp (btor, 
@@ -340,7 +379,7 @@ btor_rewrite_slice_exp (Btor * btor, BtorExp * exp, int upper, int lower)
             }
 	  else if (upper < len)
 	    {
-	      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		goto BTOR_REWRITE_SLICE_EXP_NO_REWRITE;
 	      BTOR_INC_REC_RW_CALL (btor);
 	      result = btor_rewrite_slice_exp (btor, 
@@ -352,7 +391,7 @@ btor_rewrite_slice_exp (Btor * btor, BtorExp * exp, int upper, int lower)
 	  else if (lower == 0)
 	    {
 	      assert (upper >= len);
-	      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		goto BTOR_REWRITE_SLICE_EXP_NO_REWRITE;
 	      BTOR_INC_REC_RW_CALL (btor);
 	      tmp = btor_rewrite_slice_exp (btor, BTOR_COND_INVERT_EXP (exp,
@@ -426,13 +465,13 @@ compute_binary_3vl (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
       if (BTOR_IS_INVERTED_EXP (e0))
         {
           invert_e0 = 1;
-          btor_invert_const_3vl (mm, b0);
+          b0 = btor_not_const_3vl (mm, b0);
         }
 
       if (BTOR_IS_INVERTED_EXP (e1))
         {
           invert_e1 = 1;
-          btor_invert_const_3vl (mm, b1);
+          b1 = btor_not_const_3vl (mm, b1);
         }
 
     }
@@ -480,9 +519,9 @@ compute_binary_3vl (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
   else
     {
       if (invert_e0)
-        btor_invert_const_3vl (mm, b0);
+        btor_delete_const (mm, b0);
       if (invert_e1)
-        btor_invert_const_3vl (mm, b1);
+        btor_delete_const (mm, b1);
     }
 
   return result;
@@ -532,11 +571,11 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
           invert_b0 = BTOR_IS_INVERTED_EXP (e0);
           b0 = real_e0->bits;
           if (invert_b0)
-            btor_invert_const (mm, b0);
+            b0 = btor_not_const (mm, b0);
           invert_b1 = BTOR_IS_INVERTED_EXP (e1);
           b1 = real_e1->bits;
           if (invert_b1)
-            btor_invert_const (mm, b1);
+            b1 = btor_not_const (mm, b1);
         }
       switch (kind)
         {
@@ -579,11 +618,11 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
         }
       else
         {
-          /* invert back if necessary */
+          /* release inverted copies if necessary */
           if (invert_b0)
-            btor_invert_const (mm, b0);
+            btor_delete_const (mm, b0);
           if (invert_b1)
-            btor_invert_const (mm, b1);
+            btor_delete_const (mm, b1);
         }
       result = btor_const_exp (btor, bresult);
       btor_delete_const (mm, bresult);
@@ -593,11 +632,11 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
       invert_b0 = BTOR_IS_INVERTED_EXP (e0);
       b0 = real_e0->bits;
       if (invert_b0)
-        btor_invert_const (mm, b0);
+        b0 = btor_not_const (mm, b0);
       sc = btor_is_special_const (b0);
-      /* invert back if necessary */
+      /* release inverted copy if necessary */
       if (invert_b0)
-        btor_invert_const (mm, b0);
+        btor_delete_const (mm, b0);
       switch (sc)
         {
         case BTOR_SPECIAL_CONST_ZERO:
@@ -608,7 +647,7 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
 		  result = btor_not_exp (btor, e1);
 		else if (is_xor_exp (btor, e1))  /* 0 == (a ^ b)  -->  a = b */
 		  {
-		    if (btor->rec_rw_calls < BTOR_REC_RW_BOUND)
+		    if (BTOR_REC_RW_CALLS (btor) < BTOR_REC_RW_BOUND)
 		      {
 			BTOR_INC_REC_RW_CALL (btor);
 			result = btor_rewrite_eq_exp (btor, 
@@ -622,7 +661,7 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
 		else if (BTOR_IS_INVERTED_EXP (e1) && 
 		         real_e1->kind == BTOR_AND_EXP)
 		  {      /* 0 == a | b  -->  a == 0 && b == 0 */
-		    if (btor->rec_rw_calls < BTOR_REC_RW_BOUND)
+		    if (BTOR_REC_RW_CALLS (btor) < BTOR_REC_RW_BOUND)
 		      {
 			BTOR_INC_REC_RW_CALL (btor);
 			left = btor_rewrite_eq_exp (btor, 
@@ -681,7 +720,7 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
 	    {
               if (is_xnor_exp (btor, e1))    /* 1+ == (a XNOR b)  -->  a = b */
 	        {
-		  if (btor->rec_rw_calls < BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) < BTOR_REC_RW_BOUND)
 		    {
 		      BTOR_INC_REC_RW_CALL (btor);
 		      result = btor_rewrite_eq_exp (btor, 
@@ -694,7 +733,7 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
 		}
 	      else if (!BTOR_IS_INVERTED_EXP (e1) && e1->kind == BTOR_AND_EXP)
 	        { /* 1+ == a & b  -->  a == 1+ && b == 1+ */
-		  if (btor->rec_rw_calls < BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) < BTOR_REC_RW_BOUND)
 		    {
 		      BTOR_INC_REC_RW_CALL (btor);
 		      left = btor_rewrite_eq_exp (btor, e1->e[0], e0);
@@ -714,7 +753,7 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
         default:
           assert (sc == BTOR_SPECIAL_CONST_NONE);
 	  if (kind == BTOR_BEQ_EXP && real_e1->kind == BTOR_AND_EXP &&
-	      btor->rec_rw_calls < BTOR_REC_RW_BOUND)
+	      BTOR_REC_RW_CALLS (btor) < BTOR_REC_RW_BOUND)
 	    {
 	      BTOR_INC_REC_RW_CALL (btor);
 	      BTOR_INIT_STACK (stack);
@@ -816,11 +855,11 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
       invert_b1 = BTOR_IS_INVERTED_EXP (e1);
       b1 = real_e1->bits;
       if (invert_b1)
-        btor_invert_const (mm, b1);
+        b1 = btor_not_const (mm, b1);
       sc = btor_is_special_const (b1);
-      /* invert back if necessary */
+      /* release inverted copy if necessary */
       if (invert_b1)
-        btor_invert_const (mm, b1);
+        btor_delete_const (mm, b1);
       switch (sc)
         {
         case BTOR_SPECIAL_CONST_ZERO:
@@ -831,7 +870,7 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
 		  result = btor_not_exp (btor, e0);
 		else if (is_xor_exp (btor, e0))   /* (a ^ b) == 0 -->  a = b */
 		  {
-		    if (btor->rec_rw_calls < BTOR_REC_RW_BOUND)
+		    if (BTOR_REC_RW_CALLS (btor) < BTOR_REC_RW_BOUND)
 		      {
 			BTOR_INC_REC_RW_CALL (btor);
 			result = btor_rewrite_eq_exp (btor, 
@@ -845,7 +884,7 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
 		else if (BTOR_IS_INVERTED_EXP (e0) && 
 			 real_e0->kind == BTOR_AND_EXP)
 		  {      /*  a | b == 0  -->  a == 0 && b == 0 */
-		    if (btor->rec_rw_calls < BTOR_REC_RW_BOUND)
+		    if (BTOR_REC_RW_CALLS (btor) < BTOR_REC_RW_BOUND)
 		      {
 			BTOR_INC_REC_RW_CALL (btor);
 			left = btor_rewrite_eq_exp (btor, 
@@ -904,7 +943,7 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
 	    {
 	      if (is_xnor_exp (btor, e0))    /* (a XNOR b) == 1 -->  a = b */
 	        {
-		  if (btor->rec_rw_calls < BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) < BTOR_REC_RW_BOUND)
 		    {
 		      BTOR_INC_REC_RW_CALL (btor);
 		      result = btor_rewrite_eq_exp (btor, 
@@ -917,7 +956,7 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
 		}
 	      else if (!BTOR_IS_INVERTED_EXP (e0) && e0->kind == BTOR_AND_EXP)
 	        { /* a & b == 1+ -->  a == 1+ && b == 1+ */
-		  if (btor->rec_rw_calls < BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) < BTOR_REC_RW_BOUND)
 		    {
 		      BTOR_INC_REC_RW_CALL (btor);
 		      left = btor_rewrite_eq_exp (btor, e0->e[0], e1);
@@ -937,7 +976,7 @@ rewrite_binary_exp (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1)
         default:
           assert (sc == BTOR_SPECIAL_CONST_NONE);
 	  if (kind == BTOR_BEQ_EXP && real_e0->kind == BTOR_AND_EXP &&
-	      btor->rec_rw_calls < BTOR_REC_RW_BOUND)
+	      BTOR_REC_RW_CALLS (btor) < BTOR_REC_RW_BOUND)
 	    {
 	      BTOR_INC_REC_RW_CALL (btor);
 	      BTOR_INIT_STACK (stack);
@@ -1356,6 +1395,7 @@ normalize_binary_comm_ass_exp (Btor * btor, BtorExp * e0, BtorExp * e1,
       return;
     }
 
+  BTOR_LOCK_EXP (btor);
   if (kind == BTOR_ADD_EXP)
     btor->stats.adds_normalized++;
   else
@@ -1363,6 +1403,7 @@ normalize_binary_comm_ass_exp (Btor * btor, BtorExp * e0, BtorExp * e1,
       assert (kind == BTOR_MUL_EXP);
       btor->stats.muls_normalized++;
     }
+  BTOR_UNLOCK_EXP (btor);
 
   assert (comm->count >= 2u);
   b = comm->first;
@@ -1482,6 +1523,7 @@ and_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
     }
 #endif
 
+  BTOR_LOCK_EXP (btor);
   result = btor_and_exp_node (btor, e0, e1);
 
 #ifndef BTOR_NO_3VL
@@ -1493,6 +1535,7 @@ and_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
@@ -1526,8 +1569,8 @@ find_and_contradiction_exp (Btor * btor, BtorExp *exp, BtorExp *e0, BtorExp *e1,
   return 0;
 }
 
-BtorExp *
-btor_rewrite_and_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+static BtorExp *
+rewrite_and_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *real_e0, *real_e1, *result, *e0_norm, *e1_norm, *temp;
   char *bits_3vl = NULL;
@@ -1669,7 +1712,7 @@ BTOR_EXP_TWO_LEVEL_OPT_TRY_AGAIN:
                || (real_e0->e[0] == BTOR_INVERT_EXP (real_e1->e[1])
                    && real_e0->e[1] == BTOR_INVERT_EXP (real_e1->e[0]))))
 	    {
-	      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		goto BTOR_REWRITE_AND_EXP_NO_REWRITE;
 	      BTOR_INC_REC_RW_CALL (btor);
               result = btor_rewrite_eq_exp (btor, BTOR_REAL_ADDR_EXP (real_e0->e[0]),
@@ -1744,7 +1787,7 @@ BTOR_EXP_TWO_LEVEL_OPT_TRY_AGAIN:
               if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[0])))
                 {
                   assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[1])));
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_AND_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   temp = btor_rewrite_and_exp (btor, e1, e0->e[0]);
@@ -1757,7 +1800,7 @@ BTOR_EXP_TWO_LEVEL_OPT_TRY_AGAIN:
               if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[1])))
                 {
                   assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[0])));
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_AND_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   temp = btor_rewrite_and_exp (btor, e1, e0->e[1]);
@@ -1820,7 +1863,7 @@ BTOR_EXP_TWO_LEVEL_OPT_TRY_AGAIN:
               if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[0])))
                 {
                   assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[1])));
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_AND_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   temp = btor_rewrite_and_exp (btor, e0, e1->e[0]);
@@ -1833,7 +1876,7 @@ BTOR_EXP_TWO_LEVEL_OPT_TRY_AGAIN:
               if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[1])))
                 {
                   assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[0])));
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_AND_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   temp = btor_rewrite_and_exp (btor, e0, e1->e[1]);
@@ -1860,7 +1903,7 @@ BTOR_EXP_TWO_LEVEL_OPT_TRY_AGAIN:
       if (BTOR_IS_INVERTED_EXP (e0) && BTOR_IS_INVERTED_EXP (e1)
           && real_e0->e[0] == real_e1->e[1] && real_e0->e[1] == real_e1->e[0])
         {
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_AND_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
 	  result = btor_rewrite_eq_exp (btor, real_e0->e[0], real_e0->e[1]);
@@ -1942,6 +1985,7 @@ eq_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
     }
 #endif
 
+  BTOR_LOCK_EXP (btor);
   result = btor_eq_exp_node (btor, e0, e1);
 
 #ifndef BTOR_NO_3VL
@@ -1953,6 +1997,7 @@ eq_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 
@@ -2011,8 +2056,8 @@ try_rewrite_add_mul_distrib (Btor * btor, BtorExp * e0, BtorExp * e1)
 }
 
 
-BtorExp *
-btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+static BtorExp *
+rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *tmp1, *tmp2, *result;
   BtorExp *tmp3, *tmp4;
@@ -2100,7 +2145,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
             {
               if (e0->e[0] == e1)
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
                   tmp1 = btor_zero_exp (btor, e0->len);
 		  BTOR_INC_REC_RW_CALL (btor);
@@ -2112,7 +2157,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
               if (e0->e[1] == e1)
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
                   tmp1 = btor_zero_exp (btor, e0->len);
 		  BTOR_INC_REC_RW_CALL (btor);
@@ -2130,7 +2175,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
               if (is_always_unequal (btor, e0->e[1], e1))
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   tmp1 = btor_rewrite_eq_exp (btor, e0->e[2], e1);
@@ -2142,7 +2187,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
               if (is_always_unequal (btor, e0->e[2], e1))
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   tmp1 = btor_rewrite_eq_exp (btor, e0->e[1], e1);
@@ -2165,7 +2210,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
             {
               if (e1->e[0] == e0)
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
                   tmp1 = btor_zero_exp (btor, e1->len);
 		  BTOR_INC_REC_RW_CALL (btor);
@@ -2177,7 +2222,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
               if (e1->e[1] == e0)
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
                   tmp1 = btor_zero_exp (btor, e1->len);
 		  BTOR_INC_REC_RW_CALL (btor);
@@ -2195,7 +2240,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
               if (is_always_unequal (btor, e1->e[1], e0))
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   tmp1 = btor_rewrite_eq_exp (btor, e1->e[2], e0);
@@ -2207,7 +2252,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
               if (is_always_unequal (btor, e1->e[2], e0))
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   tmp1 = btor_rewrite_eq_exp (btor, e1->e[1], e0);
@@ -2229,7 +2274,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
             {
               if (e0->e[0] == e1->e[0])
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   result = btor_rewrite_eq_exp (btor, e0->e[1], e1->e[1]);
@@ -2239,7 +2284,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
               if (e0->e[0] == e1->e[1])
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   result = btor_rewrite_eq_exp (btor, e0->e[1], e1->e[0]);
@@ -2249,7 +2294,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
               if (e0->e[1] == e1->e[0])
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   result = btor_rewrite_eq_exp (btor, e0->e[0], e1->e[1]);
@@ -2259,7 +2304,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
               if (e0->e[1] == e1->e[1])
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   result = btor_rewrite_eq_exp (btor, e0->e[0], e1->e[0]);
@@ -2284,7 +2329,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 		    {
 		      assert (BTOR_IS_INVERTED_EXP (e1->e[0]) ==
 			      BTOR_IS_INVERTED_EXP (e1->e[1]));
-		      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 			goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		      BTOR_INC_REC_RW_CALL (btor);
 		      result = btor_rewrite_eq_exp (btor, e0->e[0],
@@ -2299,7 +2344,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 		    {
 		      assert (BTOR_IS_INVERTED_EXP (e1->e[0]) !=
 			      BTOR_IS_INVERTED_EXP (e1->e[1]));
-		      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 			goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		      BTOR_INC_REC_RW_CALL (btor);
 		      result 
@@ -2316,7 +2361,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 		  e0->e[1] == BTOR_INVERT_EXP (e1->e[1]))
 	        {
 
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		  tmp1 = btor_zero_exp (btor, e0->len);
 		  BTOR_INC_REC_RW_CALL (btor);
@@ -2331,7 +2376,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 		  e0->e[0] == BTOR_INVERT_EXP (e1->e[0]))
 	        {
 
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 		  tmp1 = btor_zero_exp (btor, e0->len);
 		  BTOR_INC_REC_RW_CALL (btor);
@@ -2353,7 +2398,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
         {
           if (real_e0->e[1] == e1)
             {
-	      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 	      BTOR_INC_REC_RW_CALL (btor);
               if (BTOR_IS_INVERTED_EXP (e0))
@@ -2377,7 +2422,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
           if (real_e0->e[2] == e1)
             {
-	      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 	      BTOR_INC_REC_RW_CALL (btor);
               if (BTOR_IS_INVERTED_EXP (e0))
@@ -2403,7 +2448,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
         {
           if (real_e1->e[1] == e0)
             {
-	      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 	      BTOR_INC_REC_RW_CALL (btor);
               if (BTOR_IS_INVERTED_EXP (e1))
@@ -2427,7 +2472,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 
           if (real_e1->e[2] == e0)
             {
-	      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 	      BTOR_INC_REC_RW_CALL (btor);
               if (BTOR_IS_INVERTED_EXP (e1))
@@ -2511,7 +2556,7 @@ btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
           /* push eq down over concats */
           if ((real_e0->kind == BTOR_CONCAT_EXP || real_e1->kind == BTOR_CONCAT_EXP))
             {
-	      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		goto BTOR_REWRITE_EQ_EXP_NO_REWRITE;
 	      BTOR_INC_REC_RW_CALL (btor);
               upper = real_e0->len - 1;
@@ -2584,6 +2629,7 @@ add_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
     }
 #endif
 
+  BTOR_LOCK_EXP (btor);
   result = btor_add_exp_node (btor, e0, e1);
 
 #ifndef BTOR_NO_3VL
@@ -2595,13 +2641,14 @@ add_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
 
 
-BtorExp *
-btor_rewrite_add_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+static BtorExp *
+rewrite_add_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *result, *e0_norm, *e1_norm, *temp;
   int normalized;
@@ -2634,7 +2681,7 @@ btor_rewrite_add_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
   /* boolean case */
   if (BTOR_REAL_ADDR_EXP (e0)->len == 1)
     {
-      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	goto BTOR_REWRITE_ADD_EXP_NO_REWRITE;
       BTOR_INC_REC_RW_CALL (btor);
       result = btor_xor_exp (btor, e0, e1);
@@ -2660,7 +2707,7 @@ btor_rewrite_add_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
       if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[0])))
         {
           assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[1])));
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_ADD_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           temp = btor_rewrite_add_exp (btor, e0, e1->e[0]);
@@ -2673,7 +2720,7 @@ btor_rewrite_add_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
       if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[1])))
         {
           assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[0])));
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_ADD_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           temp = btor_rewrite_add_exp (btor, e0, e1->e[1]);
@@ -2696,7 +2743,7 @@ btor_rewrite_add_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
       if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[0])))
         {
           assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[1])));
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_ADD_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           temp = btor_rewrite_add_exp (btor, e1, e0->e[0]);
@@ -2709,7 +2756,7 @@ btor_rewrite_add_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
       if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[1])))
         {
           assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[0])));
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_ADD_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           temp = btor_rewrite_add_exp (btor, e1, e0->e[1]);
@@ -2774,6 +2821,7 @@ mul_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
     }
 #endif
 
+  BTOR_LOCK_EXP (btor);
   result = btor_mul_exp_node (btor, e0, e1);
 
 #ifndef BTOR_NO_3VL
@@ -2785,12 +2833,13 @@ mul_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
 
-BtorExp *
-btor_rewrite_mul_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+static BtorExp *
+rewrite_mul_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   char *bits_3vl = NULL;
   BtorExp *result, *left, *right;
@@ -2824,7 +2873,7 @@ btor_rewrite_mul_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
   /* boolean case */
   if (BTOR_REAL_ADDR_EXP (e0)->len == 1)
     {
-      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	goto BTOR_REWRITE_MUL_EXP_NO_REWRITE;
       BTOR_INC_REC_RW_CALL (btor);
       result = btor_rewrite_and_exp (btor, e0, e1);
@@ -2839,7 +2888,7 @@ btor_rewrite_mul_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
       if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[0])))
         {
           assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[1])));
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_MUL_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           left = btor_rewrite_mul_exp (btor, e0, e1->e[0]);
@@ -2852,7 +2901,7 @@ btor_rewrite_mul_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
       if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[1])))
         {
           assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[0])));
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_MUL_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           left = btor_rewrite_mul_exp (btor, e0, e1->e[1]);
@@ -2872,7 +2921,7 @@ btor_rewrite_mul_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
       if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[0])))
         {
           assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[1])));
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_MUL_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           left = btor_rewrite_mul_exp (btor, e1, e0->e[0]);
@@ -2885,7 +2934,7 @@ btor_rewrite_mul_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
       if (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[1])))
         {
           assert (!BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[0])));
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_MUL_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           left = btor_rewrite_mul_exp (btor, e1, e0->e[1]);
@@ -2905,7 +2954,7 @@ btor_rewrite_mul_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
           && (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[0]))
               || BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e1->e[1]))))
         {
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_MUL_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           left = btor_rewrite_mul_exp (btor, e0, e1->e[0]);
@@ -2922,7 +2971,7 @@ btor_rewrite_mul_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
           && (BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[0]))
               || BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e0->e[1]))))
         {
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_MUL_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           left = btor_rewrite_mul_exp (btor, e1, e0->e[0]);
@@ -2987,6 +3036,7 @@ ult_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
     }
 #endif
 
+  BTOR_LOCK_EXP (btor);
   result = btor_ult_exp_node (btor, e0, e1);
 
 #ifndef BTOR_NO_3VL
@@ -2998,13 +3048,14 @@ ult_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
 
 
-BtorExp *
-btor_rewrite_ult_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+static BtorExp *
+rewrite_ult_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *result, *e0_norm, *e1_norm, *temp;
   char *bits_3vl = NULL;
@@ -3044,7 +3095,7 @@ btor_rewrite_ult_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
   /* boolean case */
   if (BTOR_REAL_ADDR_EXP (e0)->len == 1)
     {
-      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	goto BTOR_REWRITE_ULT_EXP_NO_REWRITE;
       BTOR_INC_REC_RW_CALL (btor);
       result = btor_rewrite_and_exp (btor, BTOR_INVERT_EXP (e0), e1);
@@ -3063,7 +3114,7 @@ btor_rewrite_ult_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
                 assert (e1->kind == BTOR_CONCAT_EXP);
                 if (e0->e[0] == e1->e[0])
                   {
-                    if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+                    if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
                       goto BTOR_REWRITE_ULT_EXP_NO_REWRITE;
                     BTOR_INC_REC_RW_CALL (btor);
                     result = btor_rewrite_ult_exp (btor, e0->e[1], e1->e[1]);
@@ -3072,7 +3123,7 @@ btor_rewrite_ult_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
                   }
                 else if (e0->e[1] == e1->e[1])
                   {
-                    if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+                    if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
                       goto BTOR_REWRITE_ULT_EXP_NO_REWRITE;
                     BTOR_INC_REC_RW_CALL (btor);
                     result = btor_rewrite_ult_exp (btor, e0->e[0], e1->e[0]);
@@ -3116,8 +3167,8 @@ BTOR_REWRITE_ULT_EXP_NO_REWRITE:
   return result;
 }
 
-BtorExp *
-btor_rewrite_sll_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+static BtorExp *
+rewrite_sll_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *result;
   char *bits_3vl = NULL;
@@ -3144,6 +3195,7 @@ btor_rewrite_sll_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 #endif
 
   result = rewrite_binary_exp (btor, BTOR_SLL_EXP, e0, e1);
+  BTOR_LOCK_EXP (btor);
   if (result == NULL)
     {
       result = btor_sll_exp_node (btor, e0, e1);
@@ -3158,12 +3210,13 @@ btor_rewrite_sll_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
 
-BtorExp *
-btor_rewrite_srl_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+static BtorExp *
+rewrite_srl_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *result;
   char *bits_3vl = NULL;
@@ -3189,6 +3242,7 @@ btor_rewrite_srl_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 #endif
 
   result = rewrite_binary_exp (btor, BTOR_SRL_EXP, e0, e1);
+  BTOR_LOCK_EXP (btor);
   if (result == NULL)
     {
       result = btor_srl_exp_node (btor, e0, e1);
@@ -3203,6 +3257,7 @@ btor_rewrite_srl_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
@@ -3233,6 +3288,7 @@ udiv_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
     }
 #endif
 
+  BTOR_LOCK_EXP (btor);
   result = btor_udiv_exp_node (btor, e0, e1);
 
 #ifndef BTOR_NO_3VL
@@ -3244,13 +3300,14 @@ udiv_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
 
 
-BtorExp *
-btor_rewrite_udiv_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+static BtorExp *
+rewrite_udiv_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *result, *e0_norm, *e1_norm;
   char *bits_3vl = NULL;
@@ -3285,7 +3342,7 @@ btor_rewrite_udiv_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
   /* boolean case */
   if (BTOR_REAL_ADDR_EXP (e0)->len == 1)
     {
-      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	goto BTOR_REWRITE_UDIV_EXP_NO_REWRITE;
       BTOR_INC_REC_RW_CALL (btor);
       result = BTOR_INVERT_EXP (btor_rewrite_and_exp (btor, BTOR_INVERT_EXP (e0), e1));
@@ -3357,6 +3414,7 @@ urem_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
     }
 #endif
 
+  BTOR_LOCK_EXP (btor);
   result = btor_urem_exp_node (btor, e0, e1);
 
 #ifndef BTOR_NO_3VL
@@ -3368,13 +3426,14 @@ urem_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
 
 
-BtorExp *
-btor_rewrite_urem_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+static BtorExp *
+rewrite_urem_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *result, *e0_norm, *e1_norm;
   char *bits_3vl = NULL;
@@ -3409,7 +3468,7 @@ btor_rewrite_urem_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
   /* boolean case */
   if (BTOR_REAL_ADDR_EXP (e0)->len == 1)
     {
-      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	goto BTOR_REWRITE_UREM_EXP_NO_REWRITE;
       BTOR_INC_REC_RW_CALL (btor);
       result = btor_rewrite_and_exp (btor, e0, BTOR_INVERT_EXP (e1));
@@ -3455,8 +3514,8 @@ BTOR_REWRITE_UREM_EXP_NO_REWRITE:
   return result;
 }
 
-BtorExp *
-btor_rewrite_concat_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+static BtorExp *
+rewrite_concat_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
 {
   BtorExp *result, *temp, *cur;
   BtorExpPtrStack stack, po_stack;
@@ -3475,7 +3534,7 @@ btor_rewrite_concat_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
       && BTOR_REAL_ADDR_EXP (e0)->kind == BTOR_CONCAT_EXP
       && BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (BTOR_REAL_ADDR_EXP (e0)->e[1])))
     {
-      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	goto BTOR_REWRITE_CONCAT_EXP_NO_REWRITE;
       BTOR_INC_REC_RW_CALL (btor);
       if (!BTOR_IS_INVERTED_EXP (e0))
@@ -3505,7 +3564,7 @@ btor_rewrite_concat_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
   if (btor->rewrite_level > 2 &&
       BTOR_REAL_ADDR_EXP (e1)->kind == BTOR_CONCAT_EXP)
     {
-      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	goto BTOR_REWRITE_CONCAT_EXP_NO_REWRITE;
       BTOR_INC_REC_RW_CALL (btor);
 
@@ -3556,8 +3615,11 @@ btor_rewrite_concat_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
   if (result == NULL)
     {
 BTOR_REWRITE_CONCAT_EXP_NO_REWRITE:
+      BTOR_LOCK_EXP (btor);
       result = btor_concat_exp_node (btor, e0, e1);
     }
+  else
+    BTOR_LOCK_EXP (btor);
 
 #ifndef BTOR_NO_3VL
   if (btor->rewrite_level > 1 && result->bits == NULL)
@@ -3569,20 +3631,239 @@ BTOR_REWRITE_CONCAT_EXP_NO_REWRITE:
 	    btor_release_exp (btor, result);
           result = btor_const_exp (btor, bits_3vl);
           btor_delete_const (mm, bits_3vl);
+          BTOR_UNLOCK_EXP (btor);
           return result;
         }
       result->bits = bits_3vl;
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
 
-BtorExp *
-btor_rewrite_read_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index)
+/*------------------------------------------------------------------------*/
+/* Read over write index                                                  */
+/*------------------------------------------------------------------------*/
+
+/* Consecutive writes with constant indices form runs.  For every
+ * constant index of a run its writes are kept ordered by id, which
+ * increases from the bottom to the top of the run.  Hence the most
+ * recent write to a constant index below some write of the run is found
+ * by binary search.  If there is none, a read at this index skips the
+ * whole run, since the next write below has a symbolic index or the
+ * array is not a write at all.  Writes are only appended to the top of a
+ * run, otherwise they start a new run.  The index holds no references.
+ * Writes are removed when they are erased, and the whole run is dropped
+ * if a write below its top becomes a proxy.
+ */
+
+struct BtorRoWRun
+{
+  BtorExp *bottom;              /* first write of the run */
+  BtorExp *top;                 /* last write of the run */
+  int writes;                   /* number of indexed writes */
+  BtorPtrHashTable *indices;    /* constant index -> stack of writes */
+};
+
+typedef struct BtorRoWRun BtorRoWRun;
+
+static int
+is_const_index_write_exp (BtorExp * exp)
+{
+  return BTOR_IS_WRITE_EXP (exp)
+    && BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (exp->e[1]));
+}
+
+static void
+delete_run_row (Btor * btor, BtorRoWRun * run)
+{
+  BtorExpPtrStack *writes;
+  BtorPtrHashBucket *b;
+  BtorExp **w;
+  BtorMemMgr *mm;
+
+  mm = btor->mm;
+  for (b = run->indices->first; b != NULL; b = b->next)
+    {
+      writes = (BtorExpPtrStack *) b->data.asPtr;
+      for (w = writes->start; w < writes->top; w++)
+        btor_remove_from_ptr_hash_table (btor->row.writes, *w, NULL, NULL);
+      BTOR_RELEASE_STACK (mm, *writes);
+      BTOR_DELETE (mm, writes);
+    }
+  btor_delete_ptr_hash_table (run->indices);
+  BTOR_DELETE (mm, run);
+}
+
+static void
+append_write_row (Btor * btor, BtorExp * write)
+{
+  BtorExpPtrStack *writes;
+  BtorPtrHashBucket *b;
+  BtorRoWRun *run;
+  BtorMemMgr *mm;
+
+  assert (is_const_index_write_exp (write));
+  assert (!btor_find_in_ptr_hash_table (btor->row.writes, write));
+
+  mm = btor->mm;
+  b = btor_find_in_ptr_hash_table (btor->row.writes, write->e[0]);
+  if (b != NULL && ((BtorRoWRun *) b->data.asPtr)->top == write->e[0])
+    run = (BtorRoWRun *) b->data.asPtr;
+  else
+    {
+      BTOR_NEW (mm, run);
+      run->bottom = write;
+      run->writes = 0;
+      run->indices = btor_new_ptr_hash_table (mm, 0, 0);
+    }
+
+  b = btor_find_in_ptr_hash_table (run->indices, write->e[1]);
+  if (b == NULL)
+    {
+      BTOR_NEW (mm, writes);
+      BTOR_INIT_STACK (*writes);
+      b = btor_insert_in_ptr_hash_table (run->indices, write->e[1]);
+      b->data.asPtr = writes;
+    }
+  else
+    writes = (BtorExpPtrStack *) b->data.asPtr;
+  assert (BTOR_EMPTY_STACK (*writes) || writes->top[-1]->id < write->id);
+  BTOR_PUSH_STACK (mm, *writes, write);
+
+  run->top = write;
+  run->writes++;
+  btor_insert_in_ptr_hash_table (btor->row.writes, write)->data.asPtr = run;
+}
+
+/* Returns the run of 'write', which is indexed on demand together with
+ * all writes with constant indices below. */
+static BtorRoWRun *
+find_run_row (Btor * btor, BtorExp * write)
+{
+  BtorExpPtrStack stack;
+  BtorPtrHashBucket *b;
+  BtorExp *cur;
+  BtorMemMgr *mm;
+
+  if (!is_const_index_write_exp (write))
+    return NULL;
+
+  mm = btor->mm;
+  if (btor->row.writes == NULL)
+    btor->row.writes = btor_new_ptr_hash_table (mm, 0, 0);
+
+  b = btor_find_in_ptr_hash_table (btor->row.writes, write);
+  if (b != NULL)
+    return (BtorRoWRun *) b->data.asPtr;
+
+  BTOR_INIT_STACK (stack);
+  for (cur = write;
+       is_const_index_write_exp (cur)
+       && !btor_find_in_ptr_hash_table (btor->row.writes, cur);
+       cur = cur->e[0])
+    BTOR_PUSH_STACK (mm, stack, cur);
+  while (!BTOR_EMPTY_STACK (stack))
+    append_write_row (btor, BTOR_POP_STACK (stack));
+  BTOR_RELEASE_STACK (mm, stack);
+
+  b = btor_find_in_ptr_hash_table (btor->row.writes, write);
+  assert (b != NULL);
+  return (BtorRoWRun *) b->data.asPtr;
+}
+
+/* Returns the most recent write to the constant 'index' in the run of
+ * 'write', which is not above 'write', or NULL if there is none. */
+static BtorExp *
+find_write_row (BtorRoWRun * run, BtorExp * write, BtorExp * index)
+{
+  BtorExpPtrStack *writes;
+  BtorPtrHashBucket *b;
+  int l, r, m;
+
+  b = btor_find_in_ptr_hash_table (run->indices, index);
+  if (b == NULL)
+    return NULL;
+  writes = (BtorExpPtrStack *) b->data.asPtr;
+  l = 0;
+  r = BTOR_COUNT_STACK (*writes);
+  while (l < r)
+    {
+      m = l + (r - l) / 2;
+      if (writes->start[m]->id <= write->id)
+        l = m + 1;
+      else
+        r = m;
+    }
+  return l > 0 ? writes->start[l - 1] : NULL;
+}
+
+void
+btor_erase_write_index (Btor * btor, BtorExp * write)
+{
+  BtorExpPtrStack *writes;
+  BtorPtrHashBucket *b;
+  BtorRoWRun *run;
+
+  assert (btor != NULL);
+  assert (BTOR_IS_REGULAR_EXP (write));
+  assert (BTOR_IS_WRITE_EXP (write));
+
+  if (btor->row.writes == NULL)
+    return;
+  b = btor_find_in_ptr_hash_table (btor->row.writes, write);
+  if (b == NULL)
+    return;
+  run = (BtorRoWRun *) b->data.asPtr;
+
+  if (run->top != write)
+    {
+      delete_run_row (btor, run);
+      return;
+    }
+
+  btor_remove_from_ptr_hash_table (btor->row.writes, write, NULL, NULL);
+  b = btor_find_in_ptr_hash_table (run->indices, write->e[1]);
+  assert (b != NULL);
+  writes = (BtorExpPtrStack *) b->data.asPtr;
+  assert (writes->top[-1] == write);
+  (void) BTOR_POP_STACK (*writes);
+  if (BTOR_EMPTY_STACK (*writes))
+    {
+      btor_remove_from_ptr_hash_table (run->indices, write->e[1], NULL, NULL);
+      BTOR_RELEASE_STACK (btor->mm, *writes);
+      BTOR_DELETE (btor->mm, writes);
+    }
+
+  if (--run->writes == 0)
+    {
+      assert (run->bottom == write);
+      delete_run_row (btor, run);
+    }
+  else
+    run->top = write->e[0];
+}
+
+void
+btor_delete_write_index (Btor * btor)
+{
+  assert (btor != NULL);
+  if (btor->row.writes == NULL)
+    return;
+  while (btor->row.writes->count > 0u)
+    delete_run_row (btor,
+                    (BtorRoWRun *) btor->row.writes->first->data.asPtr);
+  btor_delete_ptr_hash_table (btor->row.writes);
+  btor->row.writes = NULL;
+}
+
+static BtorExp *
+rewrite_read_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index)
 {
-  BtorExp *result, *cur_array, *write_index;
-  int propagations;
+  BtorExp *result, *cur_array, *write_index, *write;
+  BtorRoWRun *run;
+  int propagations, const_index, skipped;
   BtorMemMgr *mm;
 
   /* no recurisve rewrite calls here, so we do not need to check bounds */
@@ -3605,6 +3886,7 @@ btor_rewrite_read_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index)
       assert (BTOR_IS_REGULAR_EXP (cur_array));
       assert (BTOR_IS_ARRAY_EXP (cur_array));
       propagations = 0;
+      const_index = BTOR_IS_BV_CONST_EXP (BTOR_REAL_ADDR_EXP (e_index));
 
       do
         {
@@ -3614,25 +3896,56 @@ btor_rewrite_read_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index)
           if (e_index == write_index)
             return btor_copy_exp (btor, cur_array->e[2]);
 
-          if (is_always_unequal (btor, e_index, write_index))
+          /* skip the run of writes with constant indices at once,
+           * the index is shared among threads and updated lazily */
+          skipped = 0;
+          if (const_index)
+            {
+              BTOR_LOCK_EXP (btor);
+              if ((run = find_run_row (btor, cur_array)) != NULL)
+                {
+                  skipped = 1;
+                  btor->stats.read_props_index++;
+                  write = find_write_row (run, cur_array, e_index);
+                  if (write != NULL)
+                    result = btor_copy_exp (btor, write->e[2]);
+                  else
+                    cur_array = run->bottom->e[0];
+                }
+              BTOR_UNLOCK_EXP (btor);
+            }
+
+          if (skipped)
+            {
+              if (write != NULL)
+                return result;
+              assert (BTOR_IS_REGULAR_EXP (cur_array));
+              assert (BTOR_IS_ARRAY_EXP (cur_array));
+              propagations++;
+            }
+          else if (is_always_unequal (btor, e_index, write_index))
             {
               cur_array = cur_array->e[0];
               assert (BTOR_IS_REGULAR_EXP (cur_array));
               assert (BTOR_IS_ARRAY_EXP (cur_array));
               propagations++;
+              BTOR_LOCK_EXP (btor);
               btor->stats.read_props_construct++;
+              BTOR_UNLOCK_EXP (btor);
             }
           else
             break;
 
         }
       while (BTOR_IS_WRITE_EXP (cur_array)
-             && propagations < BTOR_READ_OVER_WRITE_DOWN_PROPAGATION_LIMIT);
-
-      result = btor_read_exp_node (btor, cur_array, e_index);
+             && propagations < btor->row.read_prop_limit);
     }
   else
-    result = btor_read_exp_node (btor, e_array, e_index);
+    cur_array = e_array;
+
+  /* other threads only see the node together with its 3vl bits */
+  BTOR_LOCK_EXP (btor);
+  result = btor_read_exp_node (btor, cur_array, e_index);
   assert (result != NULL);
 
 #ifndef BTOR_NO_3VL
@@ -3640,17 +3953,18 @@ btor_rewrite_read_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index)
   if (result->bits == NULL)
     result->bits = btor_x_const_3vl (mm, e_array->len);
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 }
 
-BtorExp *
-btor_rewrite_write_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index,
-                        BtorExp * e_value)
+static BtorExp *
+rewrite_write_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index,
+                   BtorExp * e_value)
 {
   BtorExp *cur, *cur_write, *temp, *result;
-  BtorExp *chain[BTOR_WRITE_CHAIN_EXP_RW_BOUND];
-  int depth;
+  BtorExpPtrStack chain;
+  BtorMemMgr *mm;
 
   /* no recurisve rewrite calls here, so we do not need to check bounds */
 
@@ -3664,32 +3978,33 @@ btor_rewrite_write_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index,
 
   if (btor->rewrite_level > 2 && BTOR_IS_WRITE_EXP (e_array))
     {
-      depth = 0;
+      mm = btor->mm;
+      BTOR_INIT_STACK (chain);
       cur = e_array;
       assert (BTOR_IS_REGULAR_EXP (cur));
       assert (BTOR_IS_WRITE_EXP (cur));
 
       while (BTOR_IS_WRITE_EXP (cur) && cur->e[1] != e_index
-             && depth < BTOR_WRITE_CHAIN_EXP_RW_BOUND)
+             && BTOR_COUNT_STACK (chain) < btor->row.write_chain_bound)
         {
           assert (BTOR_IS_REGULAR_EXP (cur));
           assert (BTOR_IS_WRITE_EXP (cur));
-          chain[depth++] = cur;
+          BTOR_PUSH_STACK (mm, chain, cur);
           cur = cur->e[0];
           assert (BTOR_IS_REGULAR_EXP (cur));
           assert (BTOR_IS_ARRAY_EXP (cur));
         }
 
-      if (depth < BTOR_WRITE_CHAIN_EXP_RW_BOUND && BTOR_IS_WRITE_EXP (cur))
+      if (BTOR_COUNT_STACK (chain) < btor->row.write_chain_bound
+          && BTOR_IS_WRITE_EXP (cur))
         {
           assert (cur->e[1] == e_index);
           /* we overwrite this position anyhow, so we can skip
            * this intermediate write */
           cur = btor_copy_exp (btor, cur->e[0]);
-          depth--;
-          while (depth >= 0)
+          while (!BTOR_EMPTY_STACK (chain))
             {
-              cur_write = chain[depth--];
+              cur_write = BTOR_POP_STACK (chain);
               assert (BTOR_IS_REGULAR_EXP (cur_write));
               assert (BTOR_IS_WRITE_EXP (cur_write));
               temp =
@@ -3703,6 +4018,7 @@ btor_rewrite_write_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index,
           btor_release_exp (btor, cur);
         }
 
+      BTOR_RELEASE_STACK (mm, chain);
     }
 
   if (result == NULL)
@@ -3770,19 +4086,19 @@ compute_bcond_3vl (Btor * btor, BtorExp * e0, BtorExp * e1, BtorExp * e2)
       if (BTOR_IS_INVERTED_EXP (e0))
         {
           invert_e0 = 1;
-          btor_invert_const_3vl (mm, b0);
+          b0 = btor_not_const_3vl (mm, b0);
         }
 
       if (BTOR_IS_INVERTED_EXP (e1))
         {
           invert_e1 = 1;
-          btor_invert_const_3vl (mm, b1);
+          b1 = btor_not_const_3vl (mm, b1);
         }
 
       if (BTOR_IS_INVERTED_EXP (e2))
         {
           invert_e2 = 1;
-          btor_invert_const_3vl (mm, b2);
+          b2 = btor_not_const_3vl (mm, b2);
         }
     }
 
@@ -3797,11 +4113,11 @@ compute_bcond_3vl (Btor * btor, BtorExp * e0, BtorExp * e1, BtorExp * e2)
   else
     {
       if (invert_e0)
-        btor_invert_const_3vl (mm, b0);
+        btor_delete_const (mm, b0);
       if (invert_e1)
-        btor_invert_const_3vl (mm, b1);
+        btor_delete_const (mm, b1);
       if (invert_e2)
-        btor_invert_const_3vl (mm, b2);
+        btor_delete_const (mm, b2);
     }
 
   return result;
@@ -3837,6 +4153,7 @@ cond_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1, BtorExp * e2)
     }
 #endif
 
+  BTOR_LOCK_EXP (btor);
   result = btor_cond_exp_node (btor, e0, e1, e2);
 
 #ifndef BTOR_NO_3VL
@@ -3848,15 +4165,16 @@ cond_exp_node_3vl (Btor * btor, BtorExp * e0, BtorExp * e1, BtorExp * e2)
         btor_delete_const (mm, bits_3vl);
     }
 #endif
+  BTOR_UNLOCK_EXP (btor);
 
   return result;
 
 }
 
 
-BtorExp *
-btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
-                       BtorExp * e_else)
+static BtorExp *
+rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
+                  BtorExp * e_else)
 {
   BtorExp *result, *tmp1, *tmp2, *tmp3, *tmp4;
   BtorExpKind kind;
@@ -3921,7 +4239,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
     {
       if (BTOR_REAL_ADDR_EXP (e_if)->e[0] == e_cond)
         {
-          if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+          if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
             goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
           BTOR_INC_REC_RW_CALL (btor);
           result = btor_rewrite_cond_exp (btor, e_cond, BTOR_COND_INVERT_EXP (e_if, BTOR_REAL_ADDR_EXP (e_if)->e[1]), e_else);
@@ -3944,7 +4262,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
 
       if (tmp2 == e_else)
         {
-          if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+          if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
             goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
           BTOR_INC_REC_RW_CALL (btor);
           tmp4 = btor_rewrite_and_exp (btor, e_cond, BTOR_INVERT_EXP (tmp1));
@@ -3955,7 +4273,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
         }
       if (tmp3 == e_else)
         {
-          if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+          if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
             goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
           BTOR_INC_REC_RW_CALL (btor);
           tmp4 = btor_rewrite_and_exp (btor, e_cond, tmp1);
@@ -3970,7 +4288,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
     {
       if (BTOR_REAL_ADDR_EXP (e_else)->e[0] == e_cond)
         {
-          if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+          if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
             goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
           BTOR_INC_REC_RW_CALL (btor);
           result = btor_rewrite_cond_exp (btor, e_cond, e_if, BTOR_COND_INVERT_EXP (e_else, BTOR_REAL_ADDR_EXP (e_else)->e[2]));
@@ -3993,7 +4311,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
 
       if (tmp2 == e_if)
         {
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           tmp4 =
@@ -4005,7 +4323,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
         }
       else if (tmp3 == e_if)
         {
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           tmp4 = btor_rewrite_and_exp (btor, BTOR_INVERT_EXP (e_cond), tmp1);
@@ -4020,7 +4338,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
     {
       if (BTOR_REAL_ADDR_EXP (e_if)->len == 1)
         {
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           tmp1 = btor_or_exp (btor, BTOR_INVERT_EXP (e_cond), e_if);
@@ -4034,7 +4352,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
           && ((e_if->e[0] == e_else && is_const_one_exp (btor, e_if->e[1])) ||
               (e_if->e[1] == e_else && is_const_one_exp (btor, e_if->e[0]))))
         {
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           tmp1 = btor_uext_exp (btor, e_cond, BTOR_REAL_ADDR_EXP (e_if)->len - 1);
@@ -4046,7 +4364,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
           && ((e_else->e[0] == e_if && is_const_one_exp (btor, e_else->e[1])) ||
               (e_else->e[1] == e_if && is_const_one_exp (btor, e_else->e[0]))))
         {
-	  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+	  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 	    goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
 	  BTOR_INC_REC_RW_CALL (btor);
           tmp1 =
@@ -4085,7 +4403,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
             {
               if (e_if->e[0] == e_else->e[0])
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   tmp1 = btor_rewrite_cond_exp (btor, e_cond, e_if->e[1], e_else->e[1]);
@@ -4095,7 +4413,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
                 }
 	      else if (e_if->e[1] == e_else->e[1])
                 {
-		  if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		  if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 		    goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
 		  BTOR_INC_REC_RW_CALL (btor);
                   tmp1 = btor_rewrite_cond_exp (btor, e_cond, e_if->e[0], e_else->e[0]);
@@ -4108,7 +4426,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
                   /* works only for commutative operators: */
                   if (e_if->e[0] == e_else->e[1])
                     {
-		      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 			goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
 		      BTOR_INC_REC_RW_CALL (btor);
                       tmp1 = btor_rewrite_cond_exp (btor, e_cond, e_if->e[1], 
@@ -4119,7 +4437,7 @@ btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
                     }
 		  else if (e_if->e[1] == e_else->e[0])
                     {
-		      if (btor->rec_rw_calls >= BTOR_REC_RW_BOUND)
+		      if (BTOR_REC_RW_CALLS (btor) >= BTOR_REC_RW_BOUND)
 			goto BTOR_REWRITE_COND_EXP_NO_REWRITE;
 		      BTOR_INC_REC_RW_CALL (btor);
                       tmp1 = btor_rewrite_cond_exp (btor, e_cond, e_if->e[0], 
@@ -4141,3 +4459,345 @@ BTOR_REWRITE_COND_EXP_NO_REWRITE:
 
   return result;
 }
+
+static unsigned int
+hash_rw_cache (BtorExpKind kind, int id0, int id1, int id2,
+               int upper, int lower)
+{
+  unsigned int hash;
+  hash = (unsigned int) kind;
+  hash = hash * 333444569u + (unsigned int) id0;
+  hash = hash * 76891121u + (unsigned int) id1;
+  hash = hash * 456790003u + (unsigned int) id2;
+  hash = hash * 333444569u + (unsigned int) upper;
+  hash = hash * 76891121u + (unsigned int) lower;
+  return hash & (BTOR_RW_CACHE_SIZE - 1);
+}
+
+static BtorRWCacheEntry *
+find_rw_cache (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1,
+               BtorExp * e2, int upper, int lower)
+{
+  BtorRWCacheEntry *entry;
+  int id0, id1, id2;
+  assert (btor != NULL);
+  assert (e0 != NULL);
+  if (btor->rwc.entries == NULL)
+    BTOR_CNEWN (btor->mm, btor->rwc.entries, BTOR_RW_CACHE_SIZE);
+  id0 = BTOR_GET_ID_EXP (e0);
+  id1 = e1 ? BTOR_GET_ID_EXP (e1) : 0;
+  id2 = e2 ? BTOR_GET_ID_EXP (e2) : 0;
+  entry = btor->rwc.entries + hash_rw_cache (kind, id0, id1, id2,
+                                             upper, lower);
+  if (entry->result != NULL && entry->epoch == btor->rwc.epoch &&
+      entry->kind == kind && entry->ids[0] == id0 &&
+      entry->ids[1] == id1 && entry->ids[2] == id2 &&
+      entry->upper == upper && entry->lower == lower)
+    return entry;
+  return NULL;
+}
+
+static void
+insert_rw_cache (Btor * btor, BtorExpKind kind, BtorExp * e0, BtorExp * e1,
+                 BtorExp * e2, int upper, int lower, BtorExp * result)
+{
+  BtorRWCacheEntry *entry, tmp;
+  assert (btor != NULL);
+  assert (btor->rwc.entries != NULL);
+  assert (e0 != NULL);
+  assert (result != NULL);
+  tmp.result = btor_copy_exp (btor, result);
+  tmp.kind = kind;
+  tmp.ids[0] = BTOR_GET_ID_EXP (e0);
+  tmp.ids[1] = e1 ? BTOR_GET_ID_EXP (e1) : 0;
+  tmp.ids[2] = e2 ? BTOR_GET_ID_EXP (e2) : 0;
+  tmp.upper = upper;
+  tmp.lower = lower;
+  tmp.epoch = btor->rwc.epoch;
+  entry = btor->rwc.entries + hash_rw_cache (kind, tmp.ids[0], tmp.ids[1],
+                                             tmp.ids[2], upper, lower);
+  result = entry->result;
+  *entry = tmp;
+  if (result != NULL)
+    btor_release_exp (btor, result);
+}
+
+void
+btor_flush_rw_cache (Btor * btor)
+{
+  BtorRWCacheEntry *entry;
+  BtorExp *result;
+  int i;
+  assert (btor != NULL);
+  if (btor->rwc.entries == NULL)
+    return;
+  for (i = 0; i < BTOR_RW_CACHE_SIZE; i++)
+    {
+      entry = btor->rwc.entries + i;
+      if (entry->result == NULL)
+        continue;
+      result = entry->result;
+      entry->result = NULL;
+      btor_release_exp (btor, result);
+    }
+}
+
+void
+btor_delete_rw_cache (Btor * btor)
+{
+  assert (btor != NULL);
+  if (btor->rwc.entries == NULL)
+    return;
+  btor_flush_rw_cache (btor);
+  BTOR_DELETEN (btor->mm, btor->rwc.entries, BTOR_RW_CACHE_SIZE);
+  btor->rwc.entries = NULL;
+}
+
+/* Did the rewrite do more than creating the node (kind, e0, e1, e2)? */
+static int
+is_rewritten_exp (BtorExp * result, BtorExpKind kind, BtorExp * e0,
+                  BtorExp * e1, BtorExp * e2)
+{
+  BtorExp *real_result, *child;
+  int i;
+  if (BTOR_IS_INVERTED_EXP (result))
+    return 1;
+  real_result = BTOR_REAL_ADDR_EXP (result);
+  if (real_result->kind != kind)
+    return 1;
+  for (i = 0; i < real_result->arity; i++)
+    {
+      child = real_result->e[i];
+      if (child != e0 && child != e1 && child != e2)
+        return 1;
+    }
+  return 0;
+}
+
+/* Wraps the actual rewriting with the cache and the rewrite statistics.
+ * Statistics are indexed by the (regular) operator kind, the time includes
+ * nested rewrite calls and is only measured at verbosity level 3.
+ */
+static BtorExp *
+cached_rewrite_exp (Btor * btor, BtorExpKind kind, BtorExp * e0,
+                    BtorExp * e1, BtorExp * e2, int upper, int lower)
+{
+  BtorRWCacheEntry *entry;
+  BtorExpKind node_kind;
+  BtorExp *result;
+  double start = 0;
+  int epoch;
+
+  assert (btor != NULL);
+  assert (btor->rewrite_level > 0);
+
+  /* the cache, its epoch and the statistics are shared among threads,
+   * the rewriting itself runs without holding the lock */
+  BTOR_LOCK_EXP (btor);
+  btor->stats.rw[kind].calls++;
+  entry = find_rw_cache (btor, kind, e0, e1, e2, upper, lower);
+  if (entry != NULL)
+    {
+      btor->stats.rw[kind].cached++;
+      result = btor_copy_exp (btor, entry->result);
+      BTOR_UNLOCK_EXP (btor);
+      return result;
+    }
+  epoch = btor->rwc.epoch;
+  BTOR_UNLOCK_EXP (btor);
+
+  if (btor->verbosity > 2)
+    start = btor_time_stamp ();
+
+  node_kind = kind;
+  switch (kind)
+    {
+    case BTOR_SLICE_EXP:
+      result = rewrite_slice_exp (btor, e0, upper, lower);
+      break;
+    case BTOR_AND_EXP:
+      result = rewrite_and_exp (btor, e0, e1);
+      break;
+    case BTOR_BEQ_EXP:
+      if (BTOR_IS_ARRAY_EXP (BTOR_REAL_ADDR_EXP (e0)))
+        node_kind = BTOR_AEQ_EXP;
+      result = rewrite_eq_exp (btor, e0, e1);
+      break;
+    case BTOR_ADD_EXP:
+      result = rewrite_add_exp (btor, e0, e1);
+      break;
+    case BTOR_MUL_EXP:
+      result = rewrite_mul_exp (btor, e0, e1);
+      break;
+    case BTOR_ULT_EXP:
+      result = rewrite_ult_exp (btor, e0, e1);
+      break;
+    case BTOR_SLL_EXP:
+      result = rewrite_sll_exp (btor, e0, e1);
+      break;
+    case BTOR_SRL_EXP:
+      result = rewrite_srl_exp (btor, e0, e1);
+      break;
+    case BTOR_UDIV_EXP:
+      result = rewrite_udiv_exp (btor, e0, e1);
+      break;
+    case BTOR_UREM_EXP:
+      result = rewrite_urem_exp (btor, e0, e1);
+      break;
+    case BTOR_CONCAT_EXP:
+      result = rewrite_concat_exp (btor, e0, e1);
+      break;
+    case BTOR_READ_EXP:
+      result = rewrite_read_exp (btor, e0, e1);
+      break;
+    case BTOR_WRITE_EXP:
+      result = rewrite_write_exp (btor, e0, e1, e2);
+      break;
+    default:
+      assert (kind == BTOR_BCOND_EXP);
+      if (BTOR_IS_ARRAY_EXP (BTOR_REAL_ADDR_EXP (e1)))
+        node_kind = BTOR_ACOND_EXP;
+      result = rewrite_cond_exp (btor, e0, e1, e2);
+      break;
+    }
+
+  BTOR_LOCK_EXP (btor);
+  if (btor->verbosity > 2)
+    btor->stats.rw[kind].time += btor_time_stamp () - start;
+
+  if (kind == BTOR_SLICE_EXP)
+    {
+      if (!BTOR_IS_REGULAR_EXP (result) ||
+          result->kind != BTOR_SLICE_EXP || result->e[0] != e0 ||
+          result->upper != upper || result->lower != lower)
+        btor->stats.rw[kind].rewritten++;
+    }
+  else if (is_rewritten_exp (result, node_kind, e0, e1, e2))
+    btor->stats.rw[kind].rewritten++;
+
+  /* do not cache results computed across simplifications */
+  if (epoch == btor->rwc.epoch)
+    insert_rw_cache (btor, kind, e0, e1, e2, upper, lower, result);
+  BTOR_UNLOCK_EXP (btor);
+
+  return result;
+}
+
+BtorExp *
+btor_rewrite_slice_exp (Btor * btor, BtorExp * exp, int upper, int lower)
+{
+  exp = btor_pointer_chase_simplified_exp (btor, exp);
+  return cached_rewrite_exp (btor, BTOR_SLICE_EXP, exp, NULL, NULL,
+                             upper, lower);
+}
+
+BtorExp *
+btor_rewrite_and_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+{
+  e0 = btor_pointer_chase_simplified_exp (btor, e0);
+  e1 = btor_pointer_chase_simplified_exp (btor, e1);
+  return cached_rewrite_exp (btor, BTOR_AND_EXP, e0, e1, NULL, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_eq_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+{
+  e0 = btor_pointer_chase_simplified_exp (btor, e0);
+  e1 = btor_pointer_chase_simplified_exp (btor, e1);
+  return cached_rewrite_exp (btor, BTOR_BEQ_EXP, e0, e1, NULL, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_add_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+{
+  e0 = btor_pointer_chase_simplified_exp (btor, e0);
+  e1 = btor_pointer_chase_simplified_exp (btor, e1);
+  return cached_rewrite_exp (btor, BTOR_ADD_EXP, e0, e1, NULL, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_mul_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+{
+  e0 = btor_pointer_chase_simplified_exp (btor, e0);
+  e1 = btor_pointer_chase_simplified_exp (btor, e1);
+  return cached_rewrite_exp (btor, BTOR_MUL_EXP, e0, e1, NULL, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_ult_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+{
+  e0 = btor_pointer_chase_simplified_exp (btor, e0);
+  e1 = btor_pointer_chase_simplified_exp (btor, e1);
+  return cached_rewrite_exp (btor, BTOR_ULT_EXP, e0, e1, NULL, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_sll_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+{
+  e0 = btor_pointer_chase_simplified_exp (btor, e0);
+  e1 = btor_pointer_chase_simplified_exp (btor, e1);
+  return cached_rewrite_exp (btor, BTOR_SLL_EXP, e0, e1, NULL, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_srl_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+{
+  e0 = btor_pointer_chase_simplified_exp (btor, e0);
+  e1 = btor_pointer_chase_simplified_exp (btor, e1);
+  return cached_rewrite_exp (btor, BTOR_SRL_EXP, e0, e1, NULL, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_udiv_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+{
+  e0 = btor_pointer_chase_simplified_exp (btor, e0);
+  e1 = btor_pointer_chase_simplified_exp (btor, e1);
+  return cached_rewrite_exp (btor, BTOR_UDIV_EXP, e0, e1, NULL, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_urem_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+{
+  e0 = btor_pointer_chase_simplified_exp (btor, e0);
+  e1 = btor_pointer_chase_simplified_exp (btor, e1);
+  return cached_rewrite_exp (btor, BTOR_UREM_EXP, e0, e1, NULL, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_concat_exp (Btor * btor, BtorExp * e0, BtorExp * e1)
+{
+  e0 = btor_pointer_chase_simplified_exp (btor, e0);
+  e1 = btor_pointer_chase_simplified_exp (btor, e1);
+  return cached_rewrite_exp (btor, BTOR_CONCAT_EXP, e0, e1, NULL, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_read_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index)
+{
+  e_array = btor_pointer_chase_simplified_exp (btor, e_array);
+  e_index = btor_pointer_chase_simplified_exp (btor, e_index);
+  return cached_rewrite_exp (btor, BTOR_READ_EXP, e_array, e_index, NULL,
+                             0, 0);
+}
+
+BtorExp *
+btor_rewrite_write_exp (Btor * btor, BtorExp * e_array, BtorExp * e_index,
+                        BtorExp * e_value)
+{
+  e_array = btor_pointer_chase_simplified_exp (btor, e_array);
+  e_index = btor_pointer_chase_simplified_exp (btor, e_index);
+  e_value = btor_pointer_chase_simplified_exp (btor, e_value);
+  return cached_rewrite_exp (btor, BTOR_WRITE_EXP, e_array, e_index,
+                             e_value, 0, 0);
+}
+
+BtorExp *
+btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if,
+                       BtorExp * e_else)
+{
+  e_cond = btor_pointer_chase_simplified_exp (btor, e_cond);
+  e_if = btor_pointer_chase_simplified_exp (btor, e_if);
+  e_else = btor_pointer_chase_simplified_exp (btor, e_else);
+  return cached_rewrite_exp (btor, BTOR_BCOND_EXP, e_cond, e_if, e_else,
+                             0, 0);
+}
@@ -54,6 +54,22 @@ BtorExp *btor_rewrite_write_exp (Btor * btor, BtorExp * e_array, BtorExp * e_ind
 
 BtorExp *btor_rewrite_cond_exp (Btor * btor, BtorExp * e_cond, BtorExp * e_if, BtorExp *e_else);
 
+/* default bounds of iterative rewriting */
+#define BTOR_WRITE_CHAIN_EXP_RW_BOUND 20
+#define BTOR_READ_OVER_WRITE_DOWN_PROPAGATION_LIMIT 1024
+
+/* Removes 'write' from the read over write index. */
+void btor_erase_write_index (Btor * btor, BtorExp * write);
+
+/* Deletes read over write index. */
+void btor_delete_write_index (Btor * btor);
+
+/* Releases all results in the rewrite cache. */
+void btor_flush_rw_cache (Btor * btor);
+
+/* Deletes rewrite cache. */
+void btor_delete_rw_cache (Btor * btor);
+
 
 #endif
 
@@ -29,6 +29,8 @@
 
 #include "btorsat.h"
 #include "btorexit.h"
+#include "btorstack.h"
+#include "btortrace.h"
 
 #include <stdlib.h>
 #include <assert.h>
@@ -53,6 +55,9 @@
       } \
   } while (0)
 
+/* Decisions per call of the SAT solver if a memory limit is set. */
+#define BTOR_SAT_MEM_LIMIT_DECISIONS 10000
+
 
 struct BtorSATMgr
 {
@@ -60,6 +65,7 @@ struct BtorSATMgr
   BtorMemMgr *mm;
   int initialized;
   int preproc_enabled;
+  BtorIntStack assumptions;     /* since the last call of the solver */
 
   const char * ss_name;
 
@@ -135,12 +141,14 @@ btor_new_sat_mgr (BtorMemMgr * mm)
 
   assert (mm != NULL);
 
+  mm = BTOR_VIEW_MEM_MGR (mm, BTOR_MEM_SAT);
   BTOR_NEW (mm, smgr);
 
   smgr->verbosity = 0;
   smgr->mm = mm;
   smgr->initialized = 0;
   smgr->preproc_enabled = 0;
+  BTOR_INIT_STACK (smgr->assumptions);
 
   smgr->ss_name = "PicoSAT";
 
@@ -209,6 +217,7 @@ btor_delete_sat_mgr (BtorSATMgr * smgr)
    */
   if (smgr->initialized)
     btor_reset_sat (smgr);
+  BTOR_RELEASE_STACK (smgr->mm, smgr->assumptions);
   BTOR_DELETE (smgr->mm, smgr);
 }
 
@@ -304,11 +313,38 @@ btor_assume_sat (BtorSATMgr * smgr, int lit)
   assert (smgr->initialized);
   (void) smgr;
   picosat_assume (lit);
+  BTOR_PUSH_STACK (smgr->mm, smgr->assumptions, lit);
 }
 
-int
-btor_sat_sat (BtorSATMgr * smgr, int limit)
+/* With a memory limit the solver is called repeatedly with a small
+ * decision limit, such that it can be stopped as soon as the memory limit
+ * is exceeded.  Assumptions are only valid for one call and have to be
+ * added again.
+ */
+static int
+sat_mem_limited (BtorSATMgr * smgr, int limit)
+{
+  int res, decisions, *p;
+  for (;;)
+    {
+      decisions = BTOR_SAT_MEM_LIMIT_DECISIONS;
+      if (limit >= 0 && limit < decisions)
+        decisions = limit;
+      res = smgr->ss_sat (decisions);
+      if (res != BTOR_UNKNOWN || decisions == limit
+          || btor_is_limit_exceeded_mem_mgr (smgr->mm))
+        return res;
+      if (limit >= 0)
+        limit -= decisions;
+      for (p = smgr->assumptions.start; p < smgr->assumptions.top; p++)
+        picosat_assume (*p);
+    }
+}
+
+static int
+sat_sat_aux (BtorSATMgr * smgr, int limit, int mem_limited)
 {
+  int res;
   assert (smgr != NULL);
   assert (smgr->initialized);
   (void) smgr;
@@ -319,7 +355,30 @@ btor_sat_sat (BtorSATMgr * smgr, int limit)
       btor_msg_sat ("original clauses: %d\n", smgr->ss_clauses());
     }
 
-  return smgr->ss_sat (limit);
+  BTOR_TRACE_BEGIN ("sat");
+  if (!mem_limited || !BTOR_ROOT_MEM_MGR (smgr->mm)->limited)
+    res = smgr->ss_sat (limit);
+  /* the solver is called anyway to consume the assumptions */
+  else if (btor_is_limit_exceeded_mem_mgr (smgr->mm))
+    res = smgr->ss_sat (0);
+  else
+    res = sat_mem_limited (smgr, limit);
+  BTOR_RESET_STACK (smgr->assumptions);
+  BTOR_TRACE_END ("sat", "clauses", smgr->ss_clauses (),
+                  "vars", smgr->ss_variables ());
+  return res;
+}
+
+int
+btor_sat_sat (BtorSATMgr * smgr, int limit)
+{
+  return sat_sat_aux (smgr, limit, 0);
+}
+
+int
+btor_mem_limited_sat (BtorSATMgr * smgr, int limit)
+{
+  return sat_sat_aux (smgr, limit, 1);
 }
 
 int
@@ -340,6 +399,7 @@ btor_reset_sat (BtorSATMgr * smgr)
   if (smgr->verbosity > 1)
     btor_msg_sat ("resetting %s\n", smgr->ss_name);
   smgr->ss_reset ();
+  BTOR_RESET_STACK (smgr->assumptions);
   smgr->initialized = 0;
 }
 
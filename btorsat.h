@@ -78,6 +78,12 @@ void btor_assume_sat (BtorSATMgr * smgr, int lit);
 /* Solves the SAT instance. */
 int btor_sat_sat (BtorSATMgr * smgr, int limit);
 
+/* Solves the SAT instance, but returns BTOR_UNKNOWN as soon as the memory
+ * limit of the memory manager is exceeded.  If it is already exceeded only
+ * unit propagation is performed.
+ */
+int btor_mem_limited_sat (BtorSATMgr * smgr, int limit);
+
 /* Gets assignment of a literal (in the SAT case).
  * Do not call before calling btor_sat_sat.
  */
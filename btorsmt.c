@@ -21,6 +21,7 @@
 #include "btormem.h"
 #include "btorstack.h"
 #include "btorconst.h"
+#include "btortrace.h"
 
 #include <stdarg.h>
 #include <assert.h>
@@ -512,7 +513,7 @@ insert_symbol (BtorSMTParser * parser, const char * name)
 static BtorSMTParser *
 btor_new_smt_parser (Btor * btor, int verbosity)
 {
-  BtorMemMgr * mem = btor->mm;
+  BtorMemMgr * mem = BTOR_VIEW_MEM_MGR (btor->mm, BTOR_MEM_PARSER);
   BtorSMTSymbol * bind;
   BtorSMTParser * res;
   unsigned char type;
@@ -665,6 +666,9 @@ btor_nextch_smt (BtorSMTParser * parser)
     {
       parser->bytes++;
       res = getc (parser->file);
+      if (res == '\n' && !((parser->lineno + 1) % BTOR_TRACE_PARSE_CHUNK))
+        BTOR_TRACE_INSTANT ("parse chunk", "lines", parser->lineno + 1,
+                            "bytes", (long long) parser->bytes);
     }
 
   if (res == '\n')
@@ -2688,11 +2692,14 @@ NEXT_TOKEN:
       btor_smt_message (parser, 2, "found %u symbols", parser->symbols);
       btor_smt_message (parser, 2, "generated %u nodes", parser->nodes);
 
+      BTOR_TRACE_BEGIN ("translate");
       if (translate_benchmark (parser, top, res))
 	{
 	  assert (parser->error);
+	  BTOR_TRACE_END ("translate", NULL, 0, NULL, 0);
 	  return parser->error;
 	}
+      BTOR_TRACE_END ("translate", "constants", parser->constants, NULL, 0);
 
       btor_smt_message (parser, 2, "found %u constants", parser->constants);
 
@@ -2728,7 +2735,10 @@ btor_parse_smt_parser (BtorSMTParser * parser,
                        FILE * file, const char * name,
 		       BtorParseResult * res)
 {
+  BTOR_TRACE_BEGIN ("parse");
   (void) parse (parser, file, name, res);
+  BTOR_TRACE_END ("parse", "lines", parser->lineno,
+                  "bytes", (long long) parser->bytes);
   btor_release_smt_internals (parser);
   return parser->error;
 }
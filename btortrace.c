@@ -0,0 +1,164 @@
+/*  Boolector: Satisfiablity Modulo Theories (SMT) solver.
+ *  Copyright (C) 2010  Robert Daniel Brummayer, Armin Biere
+ *
+ *  This file is part of Boolector.
+ *
+ *  Boolector is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Boolector is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "btortrace.h"
+#include "btorutil.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+/*------------------------------------------------------------------------*/
+/* BEGIN OF DECLARATIONS                                                  */
+/*------------------------------------------------------------------------*/
+
+static BtorTraceCallback g_trace_fun;
+static void *g_trace_state;
+
+static FILE *g_trace_file;
+static int g_trace_close;       /* trace file opened by 'BTORTRACE' */
+static int g_trace_env_checked;
+static int g_trace_flushed;
+static int g_trace_atexit;
+static long long g_trace_events;
+
+static double g_trace_start = -1;
+
+/*------------------------------------------------------------------------*/
+/* END OF DECLARATIONS                                                    */
+/*------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------*/
+/* BEGIN OF IMPLEMENTATION                                                */
+/*------------------------------------------------------------------------*/
+
+static void
+register_flush_trace (void)
+{
+  if (g_trace_atexit)
+    return;
+  g_trace_atexit = 1;
+  atexit (btor_flush_trace);
+}
+
+void
+btor_set_trace_callback (BtorTraceCallback fun, void *state)
+{
+  g_trace_fun = fun;
+  g_trace_state = state;
+}
+
+void
+btor_set_trace_file (FILE * file)
+{
+  assert (file != NULL);
+  btor_flush_trace ();
+  g_trace_file = file;
+  g_trace_close = 0;
+  g_trace_flushed = 0;
+  g_trace_events = 0;
+  register_flush_trace ();
+}
+
+void
+btor_flush_trace (void)
+{
+  if (g_trace_file == NULL || g_trace_flushed)
+    return;
+  fputs (g_trace_events ? "\n]\n" : "[]\n", g_trace_file);
+  if (g_trace_close)
+    fclose (g_trace_file);
+  else
+    fflush (g_trace_file);
+  g_trace_file = NULL;
+  g_trace_flushed = 1;
+}
+
+static int
+open_env_trace_file (void)
+{
+  const char *name;
+  FILE *file;
+  if (g_trace_env_checked)
+    return 0;
+  g_trace_env_checked = 1;
+  if (!(name = getenv ("BTORTRACE")) || !(file = fopen (name, "w")))
+    return 0;
+  g_trace_file = file;
+  g_trace_close = 1;
+  register_flush_trace ();
+  return 1;
+}
+
+static void
+write_event_trace (const BtorTraceEvent * event)
+{
+  int i;
+  fputs (g_trace_events++ ? ",\n" : "[\n", g_trace_file);
+  fprintf (g_trace_file,
+           "{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f, "
+           "\"pid\": 1, \"tid\": 1",
+           event->name, event->phase, event->usecs);
+  if (event->phase == 'i')
+    fputs (", \"s\": \"g\"", g_trace_file);
+  if (event->arg_names[0] != NULL)
+    {
+      fputs (", \"args\": {", g_trace_file);
+      for (i = 0; i < 2 && event->arg_names[i] != NULL; i++)
+        fprintf (g_trace_file, "%s\"%s\": %lld", i ? ", " : "",
+                 event->arg_names[i], event->args[i]);
+      fputc ('}', g_trace_file);
+    }
+  fputc ('}', g_trace_file);
+}
+
+void
+btor_trace_event (const char *name, char phase,
+                  const char *a0, long long v0, const char *a1, long long v1)
+{
+  BtorTraceEvent event;
+  double now;
+
+  assert (name != NULL);
+  assert (phase == 'B' || phase == 'E' || phase == 'i');
+  assert (a0 != NULL || a1 == NULL);
+
+  if (g_trace_fun == NULL && g_trace_file == NULL && !open_env_trace_file ())
+    return;
+
+  now = 1e6 * btor_monotonic_time_stamp ();
+  if (g_trace_start < 0)
+    g_trace_start = now;
+
+  event.name = name;
+  event.phase = phase;
+  event.usecs = now - g_trace_start;
+  event.arg_names[0] = a0;
+  event.arg_names[1] = a1;
+  event.args[0] = v0;
+  event.args[1] = v1;
+
+  if (g_trace_fun != NULL)
+    g_trace_fun (g_trace_state, &event);
+  else if (g_trace_file != NULL)
+    write_event_trace (&event);
+}
+
+/*------------------------------------------------------------------------*/
+/* END OF IMPLEMENTATION                                                  */
+/*------------------------------------------------------------------------*/
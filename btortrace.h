@@ -0,0 +1,95 @@
+/*  Boolector: Satisfiablity Modulo Theories (SMT) solver.
+ *  Copyright (C) 2010  Robert Daniel Brummayer, Armin Biere
+ *
+ *  This file is part of Boolector.
+ *
+ *  Boolector is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Boolector is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BTORTRACE_H_INCLUDED
+#define BTORTRACE_H_INCLUDED
+
+#include <stdio.h>
+
+/*------------------------------------------------------------------------*/
+/* PRIVATE INTERFACE                                                      */
+/*------------------------------------------------------------------------*/
+
+/* Static probes at events on hot paths, e.g. SAT solver calls, lemmas
+ * and resizes of unique tables.  The probes are compiled out unless
+ * BTOR_TRACE is defined ('configure -trace').  Events are either passed
+ * to a callback or written to a file in the Chrome trace event format,
+ * which can be loaded into 'chrome://tracing'.  If neither is set, the
+ * file named by the environment variable 'BTORTRACE' is opened at the
+ * first event.  Tracing is global to the process.
+ *
+ * Durations are traced by a begin and an end event of the same name,
+ * arguments of the end event are attached to the whole duration.  An
+ * event has up to two integer arguments, unused argument names are NULL.
+ */
+typedef struct BtorTraceEvent BtorTraceEvent;
+
+struct BtorTraceEvent
+{
+  const char *name;
+  char phase;                   /* 'B' begin, 'E' end, 'i' instant */
+  double usecs;                 /* since the first event */
+  const char *arg_names[2];
+  long long args[2];
+};
+
+typedef void (*BtorTraceCallback) (void *state, const BtorTraceEvent * event);
+
+#ifdef BTOR_TRACE
+
+#define BTOR_TRACE_BEGIN(name) \
+  btor_trace_event ((name), 'B', NULL, 0, NULL, 0)
+
+#define BTOR_TRACE_END(name,a0,v0,a1,v1) \
+  btor_trace_event ((name), 'E', (a0), (v0), (a1), (v1))
+
+#define BTOR_TRACE_INSTANT(name,a0,v0,a1,v1) \
+  btor_trace_event ((name), 'i', (a0), (v0), (a1), (v1))
+
+#else
+
+#define BTOR_TRACE_BEGIN(name) do { } while (0)
+#define BTOR_TRACE_END(name,a0,v0,a1,v1) do { } while (0)
+#define BTOR_TRACE_INSTANT(name,a0,v0,a1,v1) do { } while (0)
+
+#endif
+
+/* Lines of input per parser chunk event. */
+#define BTOR_TRACE_PARSE_CHUNK 4096
+
+/* Events are passed to 'fun' instead of being written.  NULL restores
+ * writing events to the trace file.
+ */
+void btor_set_trace_callback (BtorTraceCallback fun, void *state);
+
+/* Writes events to 'file', which is not closed.  The JSON array is
+ * terminated at exit or by 'btor_flush_trace'.
+ */
+void btor_set_trace_file (FILE * file);
+
+/* Terminates the JSON array of the trace file, later events are
+ * ignored.
+ */
+void btor_flush_trace (void);
+
+void btor_trace_event (const char *name, char phase,
+                       const char *a0, long long v0,
+                       const char *a1, long long v1);
+
+#endif
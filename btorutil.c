@@ -21,6 +21,9 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <time.h>
 
 /*------------------------------------------------------------------------*/
 /* BEGIN OF DECLARATIONS                                                  */
@@ -95,6 +98,29 @@ btor_num_digits_util (int x)
   return result;
 }
 
+double
+btor_time_stamp (void)
+{
+  double res = 0;
+  struct rusage u;
+  if (!getrusage (RUSAGE_SELF, &u))
+    {
+      res += u.ru_utime.tv_sec + 1e-6 * u.ru_utime.tv_usec;
+      res += u.ru_stime.tv_sec + 1e-6 * u.ru_stime.tv_usec;
+    }
+  return res;
+}
+
+double
+btor_monotonic_time_stamp (void)
+{
+  double res = 0;
+  struct timespec t;
+  if (!clock_gettime (CLOCK_MONOTONIC, &t))
+    res = t.tv_sec + 1e-9 * t.tv_nsec;
+  return res;
+}
+
 /*------------------------------------------------------------------------*/
 /* END OF IMPLEMENTATION                                                  */
 /*------------------------------------------------------------------------*/
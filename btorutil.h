@@ -40,4 +40,10 @@ int btor_next_power_of_2_util (int x);
 
 int btor_num_digits_util (int x);
 
+/* Process time (user and system) in seconds. */
+double btor_time_stamp (void);
+
+/* Wall clock time in seconds since an arbitrary fixed point. */
+double btor_monotonic_time_stamp (void);
+
 #endif
@@ -22,6 +22,8 @@
 #include "btoraig.h"
 #include "btoraigvec.h"
 #include "btorhash.h"
+#include "btorcaig.h"
+#include "btorutil.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -45,10 +47,176 @@ die (int prefix, const char * fmt, ...)
   exit (1);
 }
 
+#define SYNTHEBTOR_DFS_ROUNDS 10
+
+/* Imports the output AIGs into a compact AIG manager and compares memory
+ * and depth first search time of both representations.  Memory is the
+ * number of bytes accounted to 'BTOR_MEM_AIG', which for the ordinary
+ * manager also covers AIGs that are not reachable from the outputs.
+ */
+static void
+compare_compact_aigs (BtorMemMgr * mem, BtorAIGMgr * amgr,
+                      BtorAIGPtrStack * aigs)
+{
+  size_t aig_bytes, caig_bytes;
+  BtorCAIG lit, * q;
+  BtorPtrHashTable * table;
+  BtorCAIGStack roots, stack;
+  BtorCAIGMgr * cmgr;
+  unsigned char * marks;
+  double start, aig_time, caig_time;
+  int round, num_nodes;
+  unsigned idx;
+  BtorAIG ** p;
+
+  aig_bytes = mem->kind_allocated[BTOR_MEM_AIG];
+
+  start = btor_time_stamp ();
+  for (round = 0; round < SYNTHEBTOR_DFS_ROUNDS; round++)
+    {
+      for (p = aigs->start; p < aigs->top; p++)
+	if (!BTOR_IS_CONST_AIG (*p))
+	  btor_mark_aig (amgr, *p, 1);
+      for (p = aigs->start; p < aigs->top; p++)
+	if (!BTOR_IS_CONST_AIG (*p))
+	  btor_mark_aig (amgr, *p, 0);
+    }
+  aig_time = btor_time_stamp () - start;
+
+  cmgr = btor_new_caig_mgr (mem);
+  table = btor_new_ptr_hash_table (mem, 0, 0);
+  BTOR_INIT_STACK (roots);
+  for (p = aigs->start; p < aigs->top; p++)
+    BTOR_PUSH_STACK (mem, roots, btor_import_aig_caig (cmgr, table, *p));
+  btor_delete_ptr_hash_table (table);
+  caig_bytes = mem->kind_allocated[BTOR_MEM_AIG] - aig_bytes;
+
+  num_nodes = btor_num_nodes_caig_mgr (cmgr);
+  BTOR_NEWN (mem, marks, num_nodes + 1);
+  BTOR_INIT_STACK (stack);
+  start = btor_time_stamp ();
+  for (round = 0; round < SYNTHEBTOR_DFS_ROUNDS; round++)
+    {
+      memset (marks, 0, num_nodes + 1);
+      for (q = roots.start; q < roots.top; q++)
+	{
+	  BTOR_PUSH_STACK (mem, stack, *q);
+	  while (!BTOR_EMPTY_STACK (stack))
+	    {
+	      lit = BTOR_POP_STACK (stack);
+	      if (BTOR_IS_CONST_CAIG (lit))
+		continue;
+	      idx = BTOR_INDEX_CAIG (lit);
+	      if (marks[idx])
+		continue;
+	      marks[idx] = 1;
+	      if (btor_is_var_caig (cmgr, lit))
+		continue;
+	      BTOR_PUSH_STACK (mem, stack, btor_right_child_caig (cmgr, lit));
+	      BTOR_PUSH_STACK (mem, stack, btor_left_child_caig (cmgr, lit));
+	    }
+	}
+    }
+  caig_time = btor_time_stamp () - start;
+  BTOR_RELEASE_STACK (mem, stack);
+  BTOR_DELETEN (mem, marks, num_nodes + 1);
+
+  fprintf (stderr,
+	   "[synthebtor] AIG manager: %lu bytes, %d rounds DFS in %.3f seconds\n",
+	   (unsigned long) aig_bytes, SYNTHEBTOR_DFS_ROUNDS, aig_time);
+  fprintf (stderr,
+	   "[synthebtor] compact AIGs: %d nodes, %lu bytes, "
+	   "%d rounds DFS in %.3f seconds\n",
+	   num_nodes, (unsigned long) caig_bytes,
+	   SYNTHEBTOR_DFS_ROUNDS, caig_time);
+
+  BTOR_RELEASE_STACK (mem, roots);
+  btor_delete_caig_mgr (cmgr);
+}
+
+static int
+same_files (FILE * a, FILE * b)
+{
+  int ch;
+  rewind (a);
+  rewind (b);
+  while ((ch = getc (a)) == getc (b))
+    if (ch == EOF)
+      return 1;
+  return 0;
+}
+
+/* Dumps the model, reads it back into a fresh AIG manager and dumps it
+ * again.  Both dumps have to be identical.
+ */
+static void
+roundtrip_aiger (BtorMemMgr * mem, BtorAIGMgr * amgr, int binary,
+                 BtorAIGPtrStack * aigs,
+		 BtorAIGPtrStack * regs, BtorAIGPtrStack * nexts)
+{
+  BtorAIGPtrStack inputs, latches, latch_nexts, outputs;
+  FILE * first, * second;
+  const char * err;
+  BtorAIGMgr * rmgr;
+  BtorAIG ** p;
+  int same;
+
+  if (!(first = tmpfile ()) || !(second = tmpfile ()))
+    die (1, "can not create temporary file");
+
+  btor_dump_aiger (amgr, binary, first,
+		   BTOR_COUNT_STACK (*aigs), aigs->start,
+		   BTOR_COUNT_STACK (*regs), regs->start, nexts->start, 0);
+  rewind (first);
+
+  rmgr = btor_new_aig_mgr (mem);
+  BTOR_INIT_STACK (inputs);
+  BTOR_INIT_STACK (latches);
+  BTOR_INIT_STACK (latch_nexts);
+  BTOR_INIT_STACK (outputs);
+  err = btor_parse_aiger (rmgr, first,
+			  &inputs, &latches, &latch_nexts, &outputs);
+  if (err)
+    die (1, "round trip: %s", err);
+
+  if (BTOR_COUNT_STACK (outputs) != BTOR_COUNT_STACK (*aigs) ||
+      BTOR_COUNT_STACK (latches) != BTOR_COUNT_STACK (*regs))
+    die (1, "round trip: number of outputs or latches differs");
+
+  btor_dump_aiger (rmgr, binary, second,
+		   BTOR_COUNT_STACK (outputs), outputs.start,
+		   BTOR_COUNT_STACK (latches), latches.start,
+		   latch_nexts.start, 0);
+  same = same_files (first, second);
+
+  for (p = inputs.start; p < inputs.top; p++)
+    btor_release_aig (rmgr, *p);
+  BTOR_RELEASE_STACK (mem, inputs);
+  for (p = latches.start; p < latches.top; p++)
+    btor_release_aig (rmgr, *p);
+  BTOR_RELEASE_STACK (mem, latches);
+  for (p = latch_nexts.start; p < latch_nexts.top; p++)
+    btor_release_aig (rmgr, *p);
+  BTOR_RELEASE_STACK (mem, latch_nexts);
+  for (p = outputs.start; p < outputs.top; p++)
+    btor_release_aig (rmgr, *p);
+  BTOR_RELEASE_STACK (mem, outputs);
+  btor_delete_aig_mgr (rmgr);
+
+  fclose (first);
+  fclose (second);
+
+  if (!same)
+    die (1, "round trip: AIGER files differ");
+
+  fprintf (stderr, "[synthebtor] AIGER round trip succeeded\n");
+}
+
 int
 main (int argc, char ** argv)
 {
-  int i, j, verbosity, close_input, close_output, binary, merge;
+  int i, j, verbosity, close_input, close_output, binary, merge, compact;
+  int roundtrip;
   const char * input_name, * output_name;
   FILE * input_file, * output_file, * file;
   BtorAIG * aig, * tmp, * merged, ** p;
@@ -71,6 +239,8 @@ main (int argc, char ** argv)
   close_output = 0;
   binary = 0;
   merge = 0;
+  compact = 0;
+  roundtrip = 0;
   input_name = "<stdin>";
   output_name = "<stdout>";
   input_file = stdin;
@@ -80,13 +250,17 @@ main (int argc, char ** argv)
     {
       if (!strcmp (argv[i], "-h"))
 	{
-	  printf ("usage: synthebor [-h][-v][-m][<input>[<output>]]\n");
+	  printf ("usage: synthebor [-h][-v][-m][-c][-r][<input>[<output>]]\n");
 	  exit (0);
 	}
       else if (!strcmp (argv[i], "-v"))
 	verbosity++;
       else if (!strcmp (argv[i], "-m"))
 	merge = 1;
+      else if (!strcmp (argv[i], "-c"))
+	compact = 1;
+      else if (!strcmp (argv[i], "-r"))
+	roundtrip = 1;
       else if (argv[i][0] == '-')
 	die (1, "invalid command line option '%s'", argv[i]);
       else if (close_output)
@@ -190,11 +364,16 @@ main (int argc, char ** argv)
   if (merge)
     BTOR_PUSH_STACK (mem, aigs, merged);
 
+  if (compact)
+    compare_compact_aigs (mem, amgr, &aigs);
+
 #ifdef BTOR_HAVE_ISATTY
   if (close_output || !isatty (1))
     binary = 1;
 #endif
   assert (BTOR_COUNT_STACK (regs) == BTOR_COUNT_STACK (nexts));
+  if (roundtrip)
+    roundtrip_aiger (mem, amgr, binary, &aigs, &regs, &nexts);
   btor_dump_aiger (amgr,
                   binary, output_file, 
 		  BTOR_COUNT_STACK (aigs), aigs.start,